@@ -1,12 +1,16 @@
 #include "Base.h"
 #include "AnimationChannel.h"
 #include "Transform.h"
+#include "Quaternion.h"
+
+// The range of the three smallest components of a unit quaternion is [-1/sqrt(2), 1/sqrt(2)].
+#define QUATERNION_COMPONENT_RANGE 0.70710678f
 
 namespace gameplay
 {
 
 AnimationChannel::AnimationChannel(void) :
-    _targetAttrib(0)
+    _targetAttrib(0), _quantized(false)
 {
 }
 
@@ -28,6 +32,13 @@ void AnimationChannel::writeBinary(FILE* file)
     Object::writeBinary(file);
     write(_targetId, file);
     write(_targetAttrib, file);
+    if (_quantized && canQuantize())
+    {
+        write((unsigned int)FORMAT_QUANTIZED, file);
+        writeBinaryQuantized(file);
+        return;
+    }
+    write((unsigned int)FORMAT_FLOAT, file);
     write(_keytimes.size(), file);
     for (std::vector<float>::const_iterator i = _keytimes.begin(); i != _keytimes.end(); ++i)
     {
@@ -169,6 +180,108 @@ void AnimationChannel::removeDuplicates()
     }
 }
 
+void AnimationChannel::reduceKeys(float tolerance)
+{
+    const size_t keyCount = _keytimes.size();
+    if (keyCount < 3 || !isLinear() || _keyValues.size() % keyCount != 0)
+    {
+        return;
+    }
+    const size_t componentCount = _keyValues.size() / keyCount;
+    if ((!_tangentsIn.empty() && _tangentsIn.size() != _keyValues.size()) ||
+        (!_tangentsOut.empty() && _tangentsOut.size() != _keyValues.size()) ||
+        (_interpolations.size() > 1 && _interpolations.size() != keyCount))
+    {
+        return;
+    }
+    const int quaternionOffset = getQuaternionOffset();
+
+    // Extend each segment from the last key kept for as long as interpolating over it
+    // reproduces all of the keys in between.
+    std::vector<size_t> keys;
+    keys.push_back(0);
+    size_t first = 0;
+    for (size_t last = 2; last < keyCount; ++last)
+    {
+        const float* a = &_keyValues[first * componentCount];
+        const float* b = &_keyValues[last * componentCount];
+        const float duration = _keytimes[last] - _keytimes[first];
+        bool reproduced = true;
+        for (size_t key = first + 1; key < last && reproduced; ++key)
+        {
+            const float* value = &_keyValues[key * componentCount];
+            const float t = duration > 0.0f ? (_keytimes[key] - _keytimes[first]) / duration : 0.0f;
+            for (size_t i = 0; i < componentCount && reproduced; ++i)
+            {
+                if (quaternionOffset >= 0 && i == (size_t)quaternionOffset)
+                {
+                    Quaternion q;
+                    Quaternion::slerp(Quaternion(a[i], a[i + 1], a[i + 2], a[i + 3]), Quaternion(b[i], b[i + 1], b[i + 2], b[i + 3]), t, &q);
+                    // q and -q are the same rotation.
+                    float sign = q.x * value[i] + q.y * value[i + 1] + q.z * value[i + 2] + q.w * value[i + 3] < 0.0f ? -1.0f : 1.0f;
+                    reproduced = fabs(q.x * sign - value[i]) <= tolerance && fabs(q.y * sign - value[i + 1]) <= tolerance &&
+                        fabs(q.z * sign - value[i + 2]) <= tolerance && fabs(q.w * sign - value[i + 3]) <= tolerance;
+                    i += 3;
+                }
+                else
+                {
+                    reproduced = fabs(a[i] + (b[i] - a[i]) * t - value[i]) <= tolerance;
+                }
+            }
+        }
+        if (!reproduced)
+        {
+            first = last - 1;
+            keys.push_back(first);
+        }
+    }
+    keys.push_back(keyCount - 1);
+    if (keys.size() == keyCount)
+    {
+        return;
+    }
+
+    std::vector<float> keyTimes;
+    std::vector<float> keyValues;
+    std::vector<float> tangentsIn;
+    std::vector<float> tangentsOut;
+    std::vector<unsigned int> interpolations;
+    for (size_t i = 0, count = keys.size(); i < count; ++i)
+    {
+        const size_t key = keys[i];
+        const size_t begin = key * componentCount;
+        const size_t end = begin + componentCount;
+        keyTimes.push_back(_keytimes[key]);
+        keyValues.insert(keyValues.end(), _keyValues.begin() + begin, _keyValues.begin() + end);
+        if (!_tangentsIn.empty())
+        {
+            tangentsIn.insert(tangentsIn.end(), _tangentsIn.begin() + begin, _tangentsIn.begin() + end);
+        }
+        if (!_tangentsOut.empty())
+        {
+            tangentsOut.insert(tangentsOut.end(), _tangentsOut.begin() + begin, _tangentsOut.begin() + end);
+        }
+        if (_interpolations.size() > 1)
+        {
+            interpolations.push_back(_interpolations[key]);
+        }
+    }
+    DEBUGPRINT_VARG("> Reduced keys of %s from %lu to %lu\n", _targetId.c_str(), keyCount, keys.size());
+    _keytimes.swap(keyTimes);
+    _keyValues.swap(keyValues);
+    _tangentsIn.swap(tangentsIn);
+    _tangentsOut.swap(tangentsOut);
+    if (_interpolations.size() > 1)
+    {
+        _interpolations.swap(interpolations);
+    }
+}
+
+void AnimationChannel::setQuantized(bool quantized)
+{
+    _quantized = quantized;
+}
+
 void AnimationChannel::convertToQuaternion()
 {
     if (_targetAttrib == Transform::ANIMATE_ROTATE_X ||
@@ -272,6 +385,154 @@ unsigned int AnimationChannel::getInterpolationType(const char* str)
     return value;
 }
 
+bool AnimationChannel::isLinear() const
+{
+    for (std::vector<unsigned int>::const_iterator i = _interpolations.begin(); i != _interpolations.end(); ++i)
+    {
+        if (*i != LINEAR)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int AnimationChannel::getQuaternionOffset() const
+{
+    switch (_targetAttrib)
+    {
+    case Transform::ANIMATE_ROTATE:
+    case Transform::ANIMATE_ROTATE_TRANSLATE:
+        return 0;
+    case Transform::ANIMATE_SCALE_ROTATE_TRANSLATE:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+bool AnimationChannel::canQuantize() const
+{
+    const size_t keyCount = _keytimes.size();
+    if (keyCount == 0 || !isLinear() || _keyValues.size() % keyCount != 0)
+    {
+        return false;
+    }
+    const size_t componentCount = _keyValues.size() / keyCount;
+    const int quaternionOffset = getQuaternionOffset();
+    if (quaternionOffset >= 0)
+    {
+        if ((size_t)quaternionOffset + 4 > componentCount)
+        {
+            return false;
+        }
+        // The smallest three encoding only holds unit quaternions.
+        for (size_t i = quaternionOffset; i < _keyValues.size(); i += componentCount)
+        {
+            const float* q = &_keyValues[i];
+            if (fabs(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3] - 1.0f) > 0.01f)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void AnimationChannel::writeBinaryQuantized(FILE* file)
+{
+    const size_t keyCount = _keytimes.size();
+    const size_t componentCount = _keyValues.size() / keyCount;
+    const int quaternionOffset = getQuaternionOffset();
+
+    // Key times, as fractions of the duration of the channel.
+    const unsigned int startTime = (unsigned int)_keytimes.front();
+    const unsigned int duration = (unsigned int)_keytimes.back() - startTime;
+    std::vector<unsigned short> keyTimes(keyCount, 0);
+    if (duration > 0)
+    {
+        for (size_t i = 0; i < keyCount; ++i)
+        {
+            float t = (float)((unsigned int)_keytimes[i] - startTime) / duration;
+            keyTimes[i] = (unsigned short)(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f + 0.5f);
+        }
+    }
+    write(startTime, file);
+    write(duration, file);
+    write(keyTimes, file);
+
+    // The minimum and extent of each component that is not part of the rotation.
+    std::vector<float> ranges;
+    for (size_t i = 0; i < componentCount; ++i)
+    {
+        if (quaternionOffset >= 0 && i == (size_t)quaternionOffset)
+        {
+            i += 3;
+            continue;
+        }
+        float minimum = _keyValues[i];
+        float maximum = _keyValues[i];
+        for (size_t j = i + componentCount; j < _keyValues.size(); j += componentCount)
+        {
+            minimum = std::min(minimum, _keyValues[j]);
+            maximum = std::max(maximum, _keyValues[j]);
+        }
+        ranges.push_back(minimum);
+        ranges.push_back(maximum - minimum);
+    }
+
+    std::vector<unsigned short> values;
+    values.reserve(keyCount * componentCount);
+    for (size_t key = 0; key < keyCount; ++key)
+    {
+        const float* value = &_keyValues[key * componentCount];
+        size_t range = 0;
+        for (size_t i = 0; i < componentCount; ++i)
+        {
+            if (quaternionOffset >= 0 && i == (size_t)quaternionOffset)
+            {
+                // Write the three smallest components, with the index of the largest one in the top bits
+                // of the first two. The largest component is made positive, so that it can be recovered
+                // from the unit length of the quaternion.
+                const float* q = &value[i];
+                unsigned int largest = 0;
+                for (unsigned int j = 1; j < 4; ++j)
+                {
+                    if (fabs(q[j]) > fabs(q[largest]))
+                    {
+                        largest = j;
+                    }
+                }
+                const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+                unsigned short packed[3];
+                for (unsigned int j = 0, k = 0; j < 4; ++j)
+                {
+                    if (j != largest)
+                    {
+                        float t = (q[j] * sign / QUATERNION_COMPONENT_RANGE + 1.0f) * 0.5f;
+                        packed[k++] = (unsigned short)(std::min(std::max(t, 0.0f), 1.0f) * 32766.0f + 0.5f);
+                    }
+                }
+                packed[0] |= (unsigned short)((largest >> 1) << 15);
+                packed[1] |= (unsigned short)((largest & 1) << 15);
+                values.insert(values.end(), packed, packed + 3);
+                i += 3;
+            }
+            else
+            {
+                const float extent = ranges[range + 1];
+                const float t = extent > 0.0f ? (value[i] - ranges[range]) / extent : 0.0f;
+                values.push_back((unsigned short)(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f + 0.5f));
+                range += 2;
+            }
+        }
+    }
+    write((unsigned int)componentCount, file);
+    write((unsigned int)quaternionOffset, file);
+    write(ranges, file);
+    write(values, file);
+}
+
 void AnimationChannel::deleteRange(size_t begin, size_t end, size_t propSize)
 {
     assert(end > begin);
@@ -20,6 +20,15 @@ public:
         STEP = 6
     };
 
+    /**
+     * Defines the formats that the key frames of a channel can be written in.
+     */
+    enum Format
+    {
+        FORMAT_FLOAT = 0,
+        FORMAT_QUANTIZED = 1
+    };
+
     /**
      * Constructor.
      */
@@ -65,6 +74,21 @@ public:
      */
     void removeDuplicates();
 
+    /**
+     * Removes the key frames that interpolating between the remaining key frames reproduces
+     * within the given tolerance. Rotations are interpolated with slerp and all other values
+     * linearly. Only channels with linear interpolation are reduced.
+     *
+     * @param tolerance The largest error allowed in any component of a key value.
+     */
+    void reduceKeys(float tolerance);
+
+    /**
+     * Sets whether the key frames are written in the quantized format.
+     * Channels that cannot be quantized are still written as floats.
+     */
+    void setQuantized(bool quantized);
+
     void convertToQuaternion();
     void convertToTransform();
 
@@ -89,6 +113,28 @@ private:
      */
     void deleteRange(size_t begin, size_t end, size_t propSize);
 
+    /**
+     * Returns true if every key frame of this channel uses linear interpolation.
+     */
+    bool isLinear() const;
+
+    /**
+     * Returns the offset of the rotation quaternion within the key values, or -1 if there is none.
+     */
+    int getQuaternionOffset() const;
+
+    /**
+     * Returns true if the key frames of this channel can be written in the quantized format.
+     */
+    bool canQuantize() const;
+
+    /**
+     * Writes the key frames in the quantized format: key times as 16-bit fractions of the duration
+     * of the channel, rotations as the smallest three components of the quaternion and all other
+     * values as 16-bit fractions of the range of their component.
+     */
+    void writeBinaryQuantized(FILE* file);
+
 private:
 
     std::string _targetId;
@@ -98,6 +144,7 @@ private:
     std::vector<float> _tangentsIn;
     std::vector<float> _tangentsOut;
     std::vector<unsigned int> _interpolations;
+    bool _quantized;
 };
 
 }
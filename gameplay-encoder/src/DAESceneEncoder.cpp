@@ -1798,16 +1798,7 @@ Mesh* DAESceneEncoder::loadMesh(const domMesh* meshElement, const std::string& g
                 // Only add unique vertices, use a hashtable and compare the hash functions of the
                 // vertices. If they exist simply lookup the index of the existing ones.
                 // otherwise add and new one and index it.
-                unsigned int index;
-                if (mesh->contains(vertex))
-                {
-                    index = mesh->getVertexIndex(vertex);
-                }
-                else
-                {
-                    index = mesh->addVertex(vertex);
-                }
-                subset->addIndex(index);
+                subset->addIndex(mesh->weldVertex(vertex));
 
                 poly += (maxOffset+1);
                 k = 0;
@@ -15,10 +15,14 @@ static EncoderArguments* __instance;
 
 EncoderArguments::EncoderArguments(size_t argc, const char** argv) :
     _fontSize(0),
+    _weldEpsilon(0.0f),
+    _keyTolerance(0.0f),
     _parseError(false),
     _fontPreview(false),
     _textOutput(false),
-    _daeOutput(false)
+    _daeOutput(false),
+    _vertexCache(false),
+    _quantizeKeys(false)
 {
     __instance = this;
 
@@ -149,6 +153,11 @@ void EncoderArguments::printUsage() const
         "\t\t\tList of nodes to generate heightmaps for.\n" \
         "\t\t\tNode id list should be in quotes with a space between each id.\n" \
         "\t\t\tHeightmaps will be saved in files named <nodeid>.png.\n");
+    fprintf(stderr,"  -weld <epsilon>\tWeld vertices whose attributes differ by at most epsilon.\n");
+    fprintf(stderr,"  -vertexCache\t\tReorder triangles and vertices for the GPU vertex cache.\n");
+    fprintf(stderr,"  -reduceKeys <tolerance>\n" \
+        "\t\t\tRemove animation key frames that interpolation reproduces within tolerance.\n");
+    fprintf(stderr,"  -quantizeKeys\t\tWrite animation key frames as quantized 16-bit values.\n");
     fprintf(stderr,"\n");
     fprintf(stderr,"COLLADA file options:\n");
     fprintf(stderr,"  -dae <filepath>\tOutput optimized DAE.\n");
@@ -174,6 +183,26 @@ bool EncoderArguments::DAEOutputEnabled() const
     return _daeOutput;
 }
 
+float EncoderArguments::getWeldEpsilon() const
+{
+    return _weldEpsilon;
+}
+
+bool EncoderArguments::vertexCacheOptimizationEnabled() const
+{
+    return _vertexCache;
+}
+
+float EncoderArguments::getKeyReductionTolerance() const
+{
+    return _keyTolerance;
+}
+
+bool EncoderArguments::keyQuantizationEnabled() const
+{
+    return _quantizeKeys;
+}
+
 const char* EncoderArguments::getNodeId() const
 {
     if (_nodeId.length() == 0)
@@ -308,6 +337,28 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
     case 'p':
         _fontPreview = true;
         break;
+    case 'q':
+        if (str.compare("-quantizeKeys") == 0)
+        {
+            _quantizeKeys = true;
+        }
+        break;
+    case 'r':
+        if (str.compare("-reduceKeys") == 0)
+        {
+            (*index)++;
+            if (*index < options.size())
+            {
+                _keyTolerance = (float)atof(options[*index].c_str());
+            }
+            else
+            {
+                fprintf(stderr, "Error: missing argument for -reduceKeys.\n");
+                _parseError = true;
+                return;
+            }
+        }
+        break;
     case 's':
         // Font Size
 
@@ -338,6 +389,28 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
     case 't':
         _textOutput = true;
         break;
+    case 'v':
+        if (str.compare("-vertexCache") == 0)
+        {
+            _vertexCache = true;
+        }
+        break;
+    case 'w':
+        if (str.compare("-weld") == 0)
+        {
+            (*index)++;
+            if (*index < options.size())
+            {
+                _weldEpsilon = (float)atof(options[*index].c_str());
+            }
+            else
+            {
+                fprintf(stderr, "Error: missing argument for -weld.\n");
+                _parseError = true;
+                return;
+            }
+        }
+        break;
     default:
         break;
     }
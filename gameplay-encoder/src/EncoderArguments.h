@@ -89,6 +89,27 @@ public:
     bool textOutputEnabled() const;
     bool DAEOutputEnabled() const;
 
+    /**
+     * Returns the tolerance within which vertex attributes are considered equal when welding vertices.
+     * A tolerance of zero welds only identical vertices.
+     */
+    float getWeldEpsilon() const;
+
+    /**
+     * Returns true if the triangles and vertices of meshes should be reordered for the GPU vertex cache.
+     */
+    bool vertexCacheOptimizationEnabled() const;
+
+    /**
+     * Returns the largest error allowed when removing animation key frames, or zero to keep all key frames.
+     */
+    float getKeyReductionTolerance() const;
+
+    /**
+     * Returns true if animation key frames should be written in the quantized format.
+     */
+    bool keyQuantizationEnabled() const;
+
     const char* getNodeId() const;
     unsigned int getFontSize() const;
 
@@ -117,11 +138,15 @@ private:
     std::string _daeOutputPath;
 
     unsigned int _fontSize;
+    float _weldEpsilon;
+    float _keyTolerance;
 
     bool _parseError;
     bool _fontPreview;
     bool _textOutput;
     bool _daeOutput;
+    bool _vertexCache;
+    bool _quantizeKeys;
 
     std::vector<std::string> _groupAnimationNodeId;
     std::vector<std::string> _groupAnimationAnimationId;
@@ -855,16 +855,7 @@ Mesh* FBXSceneEncoder::loadMesh(KFbxMesh* fbxMesh)
             }
 
             // Add the vertex to the mesh if it hasn't already been added and find the vertex index.
-            unsigned int index;
-            if (mesh->contains(vertex))
-            {
-                index = mesh->getVertexIndex(vertex);
-            }
-            else
-            {
-                index = mesh->addVertex(vertex);
-            }
-            meshParts[meshPartIndex]->addIndex(index);
+            meshParts[meshPartIndex]->addIndex(mesh->weldVertex(vertex));
             vertexIndex++;
         }
     }
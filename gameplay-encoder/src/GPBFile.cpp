@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "GPBFile.h"
 #include "Transform.h"
+#include "EncoderArguments.h"
 
 #define EPSILON 1.2e-7f;
 
@@ -258,9 +259,34 @@ void GPBFile::adjust()
         computeBounds(*i);
     }
 
+    if (EncoderArguments::getInstance()->vertexCacheOptimizationEnabled())
+    {
+        for (std::list<Mesh*>::const_iterator i = _geometry.begin(); i != _geometry.end(); ++i)
+        {
+            (*i)->optimizeVertexCache();
+        }
+    }
+
     // try to convert joint transform animations into rotation animations
     //optimizeTransformAnimations();
 
+    // reduce and quantize the key frames of the animations
+    const float keyTolerance = EncoderArguments::getInstance()->getKeyReductionTolerance();
+    const bool quantizeKeys = EncoderArguments::getInstance()->keyQuantizationEnabled();
+    for (unsigned int i = 0, animationCount = _animations.getAnimationCount(); i < animationCount; ++i)
+    {
+        Animation* animation = _animations.getAnimation(i);
+        for (unsigned int j = 0, channelCount = animation->getAnimationChannelCount(); j < channelCount; ++j)
+        {
+            AnimationChannel* channel = animation->getAnimationChannel(j);
+            if (keyTolerance > 0.0f)
+            {
+                channel->reduceKeys(keyTolerance);
+            }
+            channel->setQuantized(quantizeKeys);
+        }
+    }
+
     // TODO:
     // remove ambient _lights
     // for each node
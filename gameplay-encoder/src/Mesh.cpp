@@ -1,12 +1,17 @@
 #include "Base.h"
 #include "Mesh.h"
 #include "Model.h"
+#include "EncoderArguments.h"
 
 namespace gameplay
 {
 
-Mesh::Mesh(void) : model(NULL)
+Mesh::Mesh(void) : model(NULL), _weldEpsilon(0.0f)
 {
+    if (EncoderArguments::getInstance())
+    {
+        _weldEpsilon = EncoderArguments::getInstance()->getWeldEpsilon();
+    }
 }
 
 Mesh::~Mesh(void)
@@ -358,24 +363,160 @@ const VertexElement& Mesh::getVertexElement(unsigned int index) const
     return _vertexFormat[index];
 }
 
-bool Mesh::contains(const Vertex& vertex) const
+unsigned int Mesh::weldVertex(const Vertex& vertex)
 {
-    return vertexLookupTable.count(vertex) > 0;
+    if (_vertexHashNext.size() != vertices.size() || _vertexHashBuckets.empty())
+    {
+        // Vertices were added without going through the hash table.
+        rebuildVertexHash();
+    }
+
+    // Vertices within the weld tolerance can be in the neighbouring cells.
+    const int range = _weldEpsilon > 0.0f ? 1 : 0;
+    const unsigned int mask = _vertexHashBuckets.size() - 1;
+    for (int x = -range; x <= range; ++x)
+    {
+        for (int y = -range; y <= range; ++y)
+        {
+            for (int z = -range; z <= range; ++z)
+            {
+                for (int i = _vertexHashBuckets[hashVertex(vertex, x, y, z) & mask]; i >= 0; i = _vertexHashNext[i])
+                {
+                    if (_weldEpsilon > 0.0f ? vertices[i].equals(vertex, _weldEpsilon) : vertices[i] == vertex)
+                    {
+                        return i;
+                    }
+                }
+            }
+        }
+    }
+    return addVertex(vertex);
 }
 
 unsigned int Mesh::addVertex(const Vertex& vertex)
 {
     unsigned int index = getVertexCount();
     vertices.push_back(vertex);
-    vertexLookupTable[vertex] = index;
+    if (_vertexHashNext.size() == index && vertices.size() * 2 <= _vertexHashBuckets.size())
+    {
+        insertVertexHash(index);
+    }
+    else
+    {
+        rebuildVertexHash();
+    }
     return index;
 }
 
-unsigned int Mesh::getVertexIndex(const Vertex& vertex)
+void Mesh::optimizeVertexCache()
+{
+    const unsigned int vertexCount = vertices.size();
+    for (std::vector<MeshPart*>::iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        (*i)->optimizeVertexCache(vertexCount);
+    }
+
+    // Order the vertices by first use, so that the GPU fetches them sequentially.
+    // Vertices that are not used by any part are kept at the end.
+    std::vector<unsigned int> remap(vertexCount, vertexCount);
+    std::vector<Vertex> orderedVertices;
+    orderedVertices.reserve(vertexCount);
+    for (std::vector<MeshPart*>::iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        MeshPart* part = *i;
+        for (unsigned int j = 0, indexCount = part->getIndicesCount(); j < indexCount; ++j)
+        {
+            unsigned int index = part->getIndex(j);
+            if (remap[index] == vertexCount)
+            {
+                remap[index] = orderedVertices.size();
+                orderedVertices.push_back(vertices[index]);
+            }
+        }
+    }
+    for (unsigned int i = 0; i < vertexCount; ++i)
+    {
+        if (remap[i] == vertexCount)
+        {
+            remap[i] = orderedVertices.size();
+            orderedVertices.push_back(vertices[i]);
+        }
+    }
+    vertices.swap(orderedVertices);
+
+    for (std::vector<MeshPart*>::iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        (*i)->remapIndices(remap);
+    }
+    rebuildVertexHash();
+}
+
+/**
+ * Returns the hash of the index of the weld cell containing a coordinate, offset by the given number of cells.
+ *
+ * The index is computed in 64 bits and clamped, since large coordinates or small tolerances give
+ * indices that do not fit in an int. Clamped cells share hashes, which only costs extra comparisons.
+ */
+static unsigned int hashWeldCell(float value, float epsilon, int offset)
 {
-    std::map<Vertex,unsigned int>::iterator it;
-    it = vertexLookupTable.find(vertex);
-    return it->second;
+    // Doubles represent every integer up to 2^53 exactly. The negated test also catches NaN.
+    const double limit = 9007199254740992.0;
+    double cell = floor((double)value / epsilon);
+    if (!(cell > -limit))
+        cell = -limit;
+    else if (cell > limit)
+        cell = limit;
+
+    long long index = (long long)cell + offset;
+    return (unsigned int)index ^ (unsigned int)((unsigned long long)index >> 32);
+}
+
+unsigned int Mesh::hashVertex(const Vertex& vertex, int offsetX, int offsetY, int offsetZ) const
+{
+    unsigned int x, y, z;
+    if (_weldEpsilon > 0.0f)
+    {
+        x = hashWeldCell(vertex.position.x, _weldEpsilon, offsetX);
+        y = hashWeldCell(vertex.position.y, _weldEpsilon, offsetY);
+        z = hashWeldCell(vertex.position.z, _weldEpsilon, offsetZ);
+    }
+    else
+    {
+        // Adding zero turns -0 into 0, since the two compare equal.
+        float position[3] = { vertex.position.x + 0.0f, vertex.position.y + 0.0f, vertex.position.z + 0.0f };
+        memcpy(&x, &position[0], sizeof(float));
+        memcpy(&y, &position[1], sizeof(float));
+        memcpy(&z, &position[2], sizeof(float));
+    }
+    unsigned int hash = (x * 73856093) ^ (y * 19349663) ^ (z * 83492791);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+void Mesh::insertVertexHash(unsigned int index)
+{
+    unsigned int bucket = hashVertex(vertices[index], 0, 0, 0) & (_vertexHashBuckets.size() - 1);
+    _vertexHashNext.push_back(_vertexHashBuckets[bucket]);
+    _vertexHashBuckets[bucket] = index;
+}
+
+void Mesh::rebuildVertexHash()
+{
+    // Keep the table at most half full, with a power of two buckets.
+    unsigned int bucketCount = 64;
+    while (bucketCount < vertices.size() * 2)
+    {
+        bucketCount *= 2;
+    }
+    _vertexHashBuckets.assign(bucketCount, -1);
+    _vertexHashNext.clear();
+    _vertexHashNext.reserve(vertices.size());
+    for (unsigned int i = 0, count = vertices.size(); i < count; ++i)
+    {
+        insertVertexHash(i);
+    }
 }
 
 void Mesh::computeBounds()
@@ -49,16 +49,22 @@ public:
     const VertexElement& getVertexElement(unsigned int index) const;
 
     /**
-     * Returns true if this MeshPart contains the given Vertex.
+     * Returns the index of the vertex in this mesh that is equal to the given vertex,
+     * within the weld tolerance of the encoder arguments. If there is no such vertex,
+     * the given vertex is added and its new index is returned.
      */
-    bool contains(const Vertex& vertex) const;
+    unsigned int weldVertex(const Vertex& vertex);
 
     /**
-     * Adds a vertex to this MeshPart and returns the index.
+     * Adds a vertex to this mesh and returns the index.
      */
     unsigned int addVertex(const Vertex& vertex);
 
-    unsigned int getVertexIndex(const Vertex& vertex);
+    /**
+     * Reorders the triangles of each mesh part for the post-transform vertex cache, then
+     * reorders the vertices in the order that the mesh parts first use them.
+     */
+    void optimizeVertexCache();
 
     /**
      * Generates a heightmap with the given filename for this mesh.
@@ -71,10 +77,30 @@ public:
     std::vector<Vertex> vertices;
     std::vector<MeshPart*> parts;
     BoundingVolume bounds;
-    std::map<Vertex, unsigned int> vertexLookupTable;
+
+private:
+
+    /**
+     * Returns the hash of the weld cell of the vertex position, offset by the given number of cells.
+     * When welding exactly, the offsets are ignored and the hash is that of the position itself.
+     */
+    unsigned int hashVertex(const Vertex& vertex, int offsetX, int offsetY, int offsetZ) const;
+
+    /**
+     * Adds the vertex at the given index to the vertex hash table.
+     */
+    void insertVertexHash(unsigned int index);
+
+    /**
+     * Rebuilds the vertex hash table from all the vertices of this mesh.
+     */
+    void rebuildVertexHash();
 
 private:
     std::vector<VertexElement> _vertexFormat;
+    float _weldEpsilon;
+    std::vector<int> _vertexHashBuckets;   // The index of the last vertex added to each bucket, or -1.
+    std::vector<int> _vertexHashNext;      // The index of the previous vertex added to the bucket of each vertex, or -1.
 
 };
 
@@ -1,12 +1,21 @@
 #include "Base.h"
 #include "MeshPart.h"
 
+// The number of vertices in the post-transform vertex cache that triangles are ordered for.
+#define VERTEX_CACHE_SIZE 32
+
 namespace gameplay
 {
 
+/**
+ * Returns the score of a vertex from its position in the vertex cache, or -1 if it is not in the cache,
+ * and the number of triangles using it that are still to be added.
+ */
+static float computeVertexScore(int cachePosition, unsigned int remainingTriangleCount);
+
 MeshPart::MeshPart(void) :
     _primitiveType(TRIANGLES),
-    _indexFormat(INDEX16)
+    _indexFormat(INDEX8)
 {
 }
 
@@ -71,8 +80,10 @@ unsigned int MeshPart::indexFormatSize() const
     {
     case INDEX32:
         return 4;
-    default: // INDEX16
+    case INDEX16:
         return 2;
+    default: // INDEX8
+        return 1;
     }
 }
 
@@ -93,9 +104,12 @@ void MeshPart::writeBinaryIndex(unsigned int index, FILE* file)
     case INDEX32:
         write(index, file);
         break;
-    default: // INDEX16
+    case INDEX16:
         write((unsigned short)index, file);
         break;
+    default: // INDEX8
+        write((unsigned char)index, file);
+        break;
     }
 }
 
@@ -105,10 +119,181 @@ void MeshPart::updateIndexFormat(unsigned int newIndex)
     {
         _indexFormat = INDEX32;
     }
-    else if (newIndex >= 256 && _indexFormat != INDEX32)
+    else if (newIndex >= 256 && _indexFormat == INDEX8)
     {
         _indexFormat = INDEX16;
     }
 }
 
+void MeshPart::optimizeVertexCache(unsigned int vertexCount)
+{
+    if (_primitiveType != TRIANGLES || _indices.size() < 6)
+    {
+        return;
+    }
+    const unsigned int indexCount = _indices.size() - _indices.size() % 3;
+    const unsigned int triangleCount = indexCount / 3;
+
+    // Build the list of triangles that use each vertex. The triangles still to be added
+    // are kept at the front of each list.
+    std::vector<unsigned int> triangleOffsets(vertexCount + 1, 0);
+    for (unsigned int i = 0; i < indexCount; ++i)
+    {
+        ++triangleOffsets[_indices[i] + 1];
+    }
+    for (unsigned int i = 0; i < vertexCount; ++i)
+    {
+        triangleOffsets[i + 1] += triangleOffsets[i];
+    }
+    std::vector<unsigned int> vertexTriangles(indexCount);
+    std::vector<unsigned int> remainingTriangleCounts(vertexCount, 0);
+    for (unsigned int i = 0; i < indexCount; ++i)
+    {
+        unsigned int vertex = _indices[i];
+        vertexTriangles[triangleOffsets[vertex] + remainingTriangleCounts[vertex]++] = i / 3;
+    }
+
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (unsigned int i = 0; i < vertexCount; ++i)
+    {
+        vertexScores[i] = computeVertexScore(-1, remainingTriangleCounts[i]);
+    }
+    std::vector<bool> triangleAdded(triangleCount, false);
+    int bestTriangle = -1;
+    float bestScore = 0.0f;
+    for (unsigned int i = 0; i < triangleCount; ++i)
+    {
+        float score = vertexScores[_indices[i * 3]] + vertexScores[_indices[i * 3 + 1]] + vertexScores[_indices[i * 3 + 2]];
+        if (bestTriangle < 0 || score > bestScore)
+        {
+            bestTriangle = i;
+            bestScore = score;
+        }
+    }
+
+    std::vector<unsigned int> indices;
+    indices.reserve(_indices.size());
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> newCache;
+    unsigned int nextTriangle = 0;
+    while (indices.size() < indexCount)
+    {
+        if (bestTriangle < 0)
+        {
+            // None of the triangles left use a vertex in the cache, so start again from the next one in the original order.
+            while (triangleAdded[nextTriangle])
+            {
+                ++nextTriangle;
+            }
+            bestTriangle = nextTriangle;
+        }
+
+        // Add the triangle and move its vertices to the front of the cache.
+        triangleAdded[bestTriangle] = true;
+        newCache.clear();
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            unsigned int vertex = _indices[bestTriangle * 3 + i];
+            indices.push_back(vertex);
+
+            unsigned int* triangles = &vertexTriangles[triangleOffsets[vertex]];
+            unsigned int count = remainingTriangleCounts[vertex];
+            for (unsigned int j = 0; j < count; ++j)
+            {
+                if (triangles[j] == (unsigned int)bestTriangle)
+                {
+                    std::swap(triangles[j], triangles[count - 1]);
+                    --remainingTriangleCounts[vertex];
+                    break;
+                }
+            }
+            if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+            {
+                newCache.push_back(vertex);
+            }
+        }
+        const unsigned int triangleVertexCount = newCache.size();
+        for (unsigned int i = 0, count = cache.size(); i < count; ++i)
+        {
+            if (std::find(newCache.begin(), newCache.begin() + triangleVertexCount, cache[i]) == newCache.begin() + triangleVertexCount)
+            {
+                newCache.push_back(cache[i]);
+            }
+        }
+
+        // Update the scores of the vertices that moved in or out of the cache and of the triangles that use them.
+        for (unsigned int i = 0, count = newCache.size(); i < count; ++i)
+        {
+            unsigned int vertex = newCache[i];
+            cachePositions[vertex] = i < VERTEX_CACHE_SIZE ? (int)i : -1;
+            vertexScores[vertex] = computeVertexScore(cachePositions[vertex], remainingTriangleCounts[vertex]);
+        }
+        bestTriangle = -1;
+        for (unsigned int i = 0, count = newCache.size(); i < count; ++i)
+        {
+            unsigned int vertex = newCache[i];
+            const unsigned int* triangles = &vertexTriangles[triangleOffsets[vertex]];
+            for (unsigned int j = 0; j < remainingTriangleCounts[vertex]; ++j)
+            {
+                unsigned int triangle = triangles[j];
+                float score = vertexScores[_indices[triangle * 3]] + vertexScores[_indices[triangle * 3 + 1]] + vertexScores[_indices[triangle * 3 + 2]];
+                if (bestTriangle < 0 || score > bestScore)
+                {
+                    bestTriangle = triangle;
+                    bestScore = score;
+                }
+            }
+        }
+
+        if (newCache.size() > VERTEX_CACHE_SIZE)
+        {
+            newCache.resize(VERTEX_CACHE_SIZE);
+        }
+        cache.swap(newCache);
+    }
+
+    // Keep any trailing indices that do not make a whole triangle.
+    indices.insert(indices.end(), _indices.begin() + indexCount, _indices.end());
+    _indices.swap(indices);
+}
+
+void MeshPart::remapIndices(const std::vector<unsigned int>& remap)
+{
+    _indexFormat = INDEX8;
+    for (std::vector<unsigned int>::iterator i = _indices.begin(); i != _indices.end(); ++i)
+    {
+        *i = remap[*i];
+        updateIndexFormat(*i);
+    }
+}
+
+float computeVertexScore(int cachePosition, unsigned int remainingTriangleCount)
+{
+    if (remainingTriangleCount == 0)
+    {
+        // No triangles left to add use this vertex.
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+        {
+            // The vertices of the last triangle get a fixed score, so that the next triangle does not
+            // strongly prefer to reuse the edge it was just added from.
+            score = 0.75f;
+        }
+        else
+        {
+            score = powf(1.0f - (float)(cachePosition - 3) / (VERTEX_CACHE_SIZE - 3), 1.5f);
+        }
+    }
+
+    // Favor vertices with few triangles left, so that lone triangles are not left for later.
+    score += 2.0f / sqrtf((float)remainingTriangleCount);
+    return score;
+}
+
 }
@@ -23,6 +23,7 @@ public:
 
     enum IndexFormat
     {
+        INDEX8 = 0x1401,  // GL_UNSIGNED_BYTE
         INDEX16 = 0x1403, // GL_UNSIGNED_SHORT
         INDEX32 = 0x1405  // GL_UNSIGNED_INT
     };
@@ -62,6 +63,20 @@ public:
      */
     unsigned int getIndex(unsigned int i) const;
 
+    /**
+     * Reorders the triangles of this part to reuse the vertices in the post-transform vertex cache
+     * of the GPU as much as possible, using Tom Forsyth's linear-speed vertex cache optimization.
+     * Parts that are not made of triangles are left unchanged.
+     *
+     * @param vertexCount The number of vertices in the mesh.
+     */
+    void optimizeVertexCache(unsigned int vertexCount);
+
+    /**
+     * Replaces each index with the value at that index in the given table.
+     */
+    void remapIndices(const std::vector<unsigned int>& remap);
+
 private:
 
     /**
@@ -75,7 +90,7 @@ private:
     unsigned int indexFormatSize() const;
 
     /**
-     * Updates the index format if newIndex is larger than 256 or 65536.
+     * Updates the index format to the smallest one that can hold newIndex and all previous indices.
      */
     void updateIndexFormat(unsigned int newIndex);
 
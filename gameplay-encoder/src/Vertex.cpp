@@ -4,6 +4,11 @@
 namespace gameplay
 {
 
+/**
+ * Returns true if the two values are within epsilon of each other.
+ */
+static bool equals(float a, float b, float epsilon);
+
 Vertex::Vertex(void)
     : hasNormal(false), hasTangent(false), hasBinormal(false), hasTexCoord(false), hasDiffuse(false), hasWeights(false)
 {
@@ -13,6 +18,20 @@ Vertex::~Vertex(void)
 {
 }
 
+bool Vertex::equals(const Vertex& v, float epsilon) const
+{
+    return gameplay::equals(position.x, v.position.x, epsilon) && gameplay::equals(position.y, v.position.y, epsilon) && gameplay::equals(position.z, v.position.z, epsilon) &&
+        gameplay::equals(normal.x, v.normal.x, epsilon) && gameplay::equals(normal.y, v.normal.y, epsilon) && gameplay::equals(normal.z, v.normal.z, epsilon) &&
+        gameplay::equals(tangent.x, v.tangent.x, epsilon) && gameplay::equals(tangent.y, v.tangent.y, epsilon) && gameplay::equals(tangent.z, v.tangent.z, epsilon) &&
+        gameplay::equals(binormal.x, v.binormal.x, epsilon) && gameplay::equals(binormal.y, v.binormal.y, epsilon) && gameplay::equals(binormal.z, v.binormal.z, epsilon) &&
+        gameplay::equals(texCoord.x, v.texCoord.x, epsilon) && gameplay::equals(texCoord.y, v.texCoord.y, epsilon) &&
+        gameplay::equals(diffuse.x, v.diffuse.x, epsilon) && gameplay::equals(diffuse.y, v.diffuse.y, epsilon) &&
+        gameplay::equals(diffuse.z, v.diffuse.z, epsilon) && gameplay::equals(diffuse.w, v.diffuse.w, epsilon) &&
+        gameplay::equals(blendWeights.x, v.blendWeights.x, epsilon) && gameplay::equals(blendWeights.y, v.blendWeights.y, epsilon) &&
+        gameplay::equals(blendWeights.z, v.blendWeights.z, epsilon) && gameplay::equals(blendWeights.w, v.blendWeights.w, epsilon) &&
+        blendIndices == v.blendIndices;
+}
+
 unsigned int Vertex::byteSize() const
 {
     unsigned int count = POSITION_COUNT;
@@ -111,4 +130,9 @@ void Vertex::normalizeBlendWeight()
     }   
 }
 
+bool equals(float a, float b, float epsilon)
+{
+    return fabs(a - b) <= epsilon;
+}
+
 }
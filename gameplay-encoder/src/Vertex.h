@@ -87,6 +87,12 @@ public:
             diffuse==v.diffuse && blendWeights==v.blendWeights && blendIndices==v.blendIndices;
     }
 
+    /**
+     * Returns true if every attribute of this vertex is within epsilon of the given vertex.
+     * Blend indices must match exactly.
+     */
+    bool equals(const Vertex& v, float epsilon) const;
+
     /**
      * Returns the size of this vertex in bytes.
      */
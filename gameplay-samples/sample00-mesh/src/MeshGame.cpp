@@ -1,10 +1,16 @@
 #include "MeshGame.h"
 
+// The number of cubes in the ring around the duck.
+#define CUBE_COUNT 48
+
+// The radius of the ring of cubes.
+#define CUBE_RING_RADIUS 12.0f
+
 // Declare our game instance
 MeshGame game;
 
 MeshGame::MeshGame()
-    : _font(NULL), _scene(NULL),_modelNode(NULL), _touched(false), _touchX(0)
+    : _font(NULL), _scene(NULL),_modelNode(NULL), _cubesNode(NULL), _cubes(NULL), _cubesAngle(0.0f), _touched(false), _touchX(0)
 {
 }
 
@@ -44,10 +50,14 @@ void MeshGame::initialize()
     Model* model = createGridModel();
     _scene->addNode("grid")->setModel(model);
     model->release();
+
+    // Create the ring of cubes.
+    createCubeInstances(lightNode);
 }
 
 void MeshGame::finalize()
 {
+    SAFE_DELETE(_cubes);
     SAFE_RELEASE(_font);
     SAFE_RELEASE(_scene);
 }
@@ -57,6 +67,10 @@ void MeshGame::update(long elapsedTime)
     // Rotate model
     if (!_touched)
         _modelNode->rotateY(MATH_DEG_TO_RAD(0.5f));
+
+    // Spin the ring of cubes the other way
+    _cubesAngle -= MATH_DEG_TO_RAD(0.25f);
+    updateCubeInstances();
 }
 
 void MeshGame::render(long elapsedTime)
@@ -64,8 +78,11 @@ void MeshGame::render(long elapsedTime)
     // Clear the color and depth buffers.
     clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
 
-    // Visit all the nodes in the scene, drawing the models/mesh.
-    _scene->visit(this, &MeshGame::drawScene);
+    // Visit the nodes in the scene that are in view of the camera, drawing the models/mesh.
+    _scene->visitVisible(_scene->getActiveCamera()->getFrustum(), this, &MeshGame::drawScene);
+
+    // Draw all of the cubes at once.
+    _cubes->draw();
 
     // Draw the fps
     drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
@@ -114,8 +131,9 @@ void MeshGame::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int cont
 
 bool MeshGame::drawScene(Node* node)
 {
+    // The cubes node only supplies the camera bindings of the instanced cubes, which are drawn separately.
     Model* model = node->getModel();
-    if (model)
+    if (model && node != _cubesNode)
         model->draw();
     return true;
 }
@@ -220,4 +238,88 @@ Model* MeshGame::createGridModel(unsigned int lineCount)
     Model* model = Model::create(mesh);
     model->setMaterial("res/grid.material");
     return model;
-}
\ No newline at end of file
+}
+
+void MeshGame::createCubeInstances(Node* lightNode)
+{
+    // A unit cube with a normal per face, so each face has its own four vertices.
+    static const float normals[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    float vertices[24 * 6];
+    unsigned short indices[36];
+    for (unsigned int face = 0; face < 6; ++face)
+    {
+        Vector3 n(normals[face][0], normals[face][1], normals[face][2]);
+        Vector3 u(n.y, n.z, n.x);
+        Vector3 v;
+        Vector3::cross(n, u, &v);
+        for (unsigned int corner = 0; corner < 4; ++corner)
+        {
+            float su = (corner == 1 || corner == 2) ? 0.5f : -0.5f;
+            float sv = (corner >= 2) ? 0.5f : -0.5f;
+            float* vertex = &vertices[(face * 4 + corner) * 6];
+            vertex[0] = n.x * 0.5f + u.x * su + v.x * sv;
+            vertex[1] = n.y * 0.5f + u.y * su + v.y * sv;
+            vertex[2] = n.z * 0.5f + u.z * su + v.z * sv;
+            vertex[3] = n.x;
+            vertex[4] = n.y;
+            vertex[5] = n.z;
+        }
+        unsigned short first = (unsigned short)(face * 4);
+        unsigned short* quad = &indices[face * 6];
+        quad[0] = first; quad[1] = first + 1; quad[2] = first + 2;
+        quad[3] = first; quad[4] = first + 2; quad[5] = first + 3;
+    }
+
+    VertexFormat::Element elements[] =
+    {
+        VertexFormat::Element(VertexFormat::POSITION, 3),
+        VertexFormat::Element(VertexFormat::NORMAL, 3)
+    };
+    Mesh* mesh = Mesh::createMesh(VertexFormat(elements, 2), 24, false);
+    mesh->setVertexData(vertices, 0, 24);
+    MeshPart* part = mesh->addPart(Mesh::TRIANGLES, Mesh::INDEX16, 36);
+    part->setIndexData(indices, 0, 36);
+
+    Model* model = Model::create(mesh);
+    SAFE_RELEASE(mesh);
+
+    // The shader reads the per-instance inputs that the graphics device supports.
+    Material* material = model->setMaterial("res/instanced.vsh", "res/instanced.fsh", InstancedModel::getShaderDefines());
+    material->setParameterAutoBinding("u_viewProjectionMatrix", RenderState::VIEW_PROJECTION_MATRIX);
+    material->getParameter("u_lightDirection")->bindValue(lightNode, &Node::getForwardVectorWorld);
+    material->getStateBlock()->setCullFace(true);
+    material->getStateBlock()->setDepthTest(true);
+
+    // The node supplies the camera bindings of the material.
+    _cubesNode = _scene->addNode("cubes");
+    _cubesNode->setModel(model);
+
+    _cubes = InstancedModel::create(model, CUBE_COUNT);
+    SAFE_RELEASE(model);
+
+    // Devices without instanced arrays draw the cubes from copies of the mesh, which OpenGL ES cannot read back.
+    const void* indexData[] = { indices };
+    _cubes->setGeometryData(vertices, indexData);
+
+    for (unsigned int i = 0; i < CUBE_COUNT; ++i)
+    {
+        // Shade the cubes around the ring from red through green to blue.
+        float t = (float)i / CUBE_COUNT * 3.0f;
+        Vector4 color(std::max(0.0f, 1.0f - fabs(t)) + std::max(0.0f, t - 2.0f), std::max(0.0f, 1.0f - fabs(t - 1.0f)), std::max(0.0f, 1.0f - fabs(t - 2.0f)), 1.0f);
+        _cubes->add(Matrix::identity(), color);
+    }
+    updateCubeInstances();
+}
+
+void MeshGame::updateCubeInstances()
+{
+    for (unsigned int i = 0; i < CUBE_COUNT; ++i)
+    {
+        float angle = _cubesAngle + MATH_PIX2 * i / CUBE_COUNT;
+
+        Matrix worldMatrix;
+        Matrix::createTranslation(cos(angle) * CUBE_RING_RADIUS, 0.5f, sin(angle) * CUBE_RING_RADIUS, &worldMatrix);
+        worldMatrix.rotateY(-angle * 2.0f);
+        _cubes->setWorldMatrix(i, worldMatrix);
+    }
+}
@@ -71,9 +71,24 @@ private:
      */
     Model* createGridModel(unsigned int lineCount = 41);
 
+    /**
+     * Creates a ring of cubes around the model, drawn as instances of a single cube model.
+     *
+     * @param lightNode The node of the light that shades the cubes.
+     */
+    void createCubeInstances(Node* lightNode);
+
+    /**
+     * Updates the world matrices of the cube instances.
+     */
+    void updateCubeInstances();
+
     Font* _font;
     Scene* _scene;
     Node* _modelNode;
+    Node* _cubesNode;
+    InstancedModel* _cubes;
+    float _cubesAngle;
     bool _touched;
     int _touchX;
 };
@@ -454,11 +454,13 @@ void SpaceshipGame::render(long elapsedTime)
 {
     clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
 
-    // Visit scene nodes for opaque drawing
-    _scene->visit(this, &SpaceshipGame::drawScene, (void*)0);
+    const Frustum& frustum = _scene->getActiveCamera()->getFrustum();
 
-    // Visit scene nodes for transparent drawing
-    _scene->visit(this, &SpaceshipGame::drawScene, (void*)1);
+    // Visit visible scene nodes for opaque drawing
+    _scene->visitVisible(frustum, this, &SpaceshipGame::drawScene, (void*)0);
+
+    // Visit visible scene nodes for transparent drawing
+    _scene->visitVisible(frustum, this, &SpaceshipGame::drawScene, (void*)1);
 
     // Draw game text (yellow)
     drawText();
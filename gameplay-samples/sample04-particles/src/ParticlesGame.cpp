@@ -16,7 +16,7 @@ const static float EMIT_RATE_MAX[] = { 500, 100, 100 };
 const float INPUT_SENSITIVITY = 1.0f;
 const Vector4 BACKGROUND_COLOR = Vector4::zero();
 
-ParticlesGame::ParticlesGame() : _scene(NULL)
+ParticlesGame::ParticlesGame() : _scene(NULL), _particleManager(NULL)
 {
 }
 
@@ -44,6 +44,9 @@ void ParticlesGame::initialize()
     _scene->setActiveCamera(camera);
     SAFE_RELEASE(camera);
 
+    // The particle manager updates the active emitter and computes its sprites on worker threads.
+    _particleManager = ParticleManager::create();
+
     // Load preset emitters.
     loadEmitters();
 
@@ -283,6 +286,7 @@ void ParticlesGame::controlEvent(Control* control, EventType evt)
         if (control == _reset)
         {
             _particleEmitterNode->setParticleEmitter(NULL);
+            _particleManager->removeEmitter(emitter);
             SAFE_RELEASE(emitter);
             emitter = _particleEmitters[_particleEmitterIndex] = ParticleEmitter::create(_particleFiles[_particleEmitterIndex].c_str());
             emitterChanged();
@@ -333,6 +337,7 @@ void ParticlesGame::finalize()
 {
     SAFE_RELEASE(_scene);
     SAFE_RELEASE(_form);
+    SAFE_DELETE(_particleManager);
     
     for (unsigned int i = 0; i < _particleEmitters.size(); i++)
     {
@@ -372,8 +377,9 @@ void ParticlesGame::update(long elapsedTime)
         _scene->getActiveCamera()->getNode()->translate(v);
     }
 
+    _particleManager->update(elapsedTime);
+
     ParticleEmitter* emitter = _particleEmitters[_particleEmitterIndex];
-    emitter->update(elapsedTime);
 
     char buffer[16];
     sprintf(buffer, "Particles: %u", emitter->getParticlesCount());
@@ -390,22 +396,12 @@ void ParticlesGame::render(long elapsedTime)
     // Clear the color and depth buffers
     clear(CLEAR_COLOR_DEPTH, BACKGROUND_COLOR, 1.0f, 0);
 
-    // Visit all the nodes in the scene for drawing
-    _scene->visit(this, &ParticlesGame::drawScene, (void*)0);
+    // Draw the particles of the active emitter
+    _particleManager->draw();
 
     _form->draw();
 }
 
-bool ParticlesGame::drawScene(Node* node, void* cookie)
-{
-    ParticleEmitter* emitter = node->getParticleEmitter();
-    if (emitter)
-    {
-        emitter->draw();
-    }
-    return true;
-}
-
 void ParticlesGame::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
 {
     switch (evt)
@@ -515,10 +511,12 @@ void ParticlesGame::emitterChanged()
     if (prevEmitter)
     {
         prevEmitter->stop();
+        _particleManager->removeEmitter(prevEmitter);
     }
 
     ParticleEmitter* emitter = _particleEmitters[_particleEmitterIndex];
     _particleEmitterNode->setParticleEmitter(emitter);
+    _particleManager->addEmitter(emitter);
 
     if (_particleEmitterIndex == 2)
     {
@@ -56,8 +56,6 @@ protected:
 
 private:
 
-    bool drawScene(Node* node, void* cookie);
-
     void drawSplash(void* param);
 
     void loadEmitters();
@@ -72,6 +70,7 @@ private:
     bool _touched;
     int _prevX, _prevY;
     std::vector<ParticleEmitter*> _particleEmitters;
+    ParticleManager* _particleManager;
     unsigned int _particleEmitterIndex;
     
     Slider* _startRed;
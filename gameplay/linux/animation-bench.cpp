@@ -0,0 +1,147 @@
+// Animation update benchmark. Plays one looping transform clip on each of a number of nodes and
+// measures the average frame time for several clip counts and thread counts (see
+// AnimationController::setThreadCount). A thread count of 1 updates the clips serially.
+//
+// Runs headless: each frame advances the game clock by 16 ms, and nothing is drawn, so the frame
+// time is dominated by the animation update.
+
+#include "gameplay.h"
+
+using namespace gameplay;
+
+// The number of frames updated before and while measuring each configuration.
+#define BENCH_WARMUP_FRAMES 30
+#define BENCH_MEASURED_FRAMES 120
+
+// The number of key frames of each clip, one every 100 ms.
+#define BENCH_KEY_COUNT 60
+
+static const unsigned int __clipCounts[] = { 100, 250, 500, 1000 };
+
+static double getTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+/**
+ * Benchmark game that animates a sequence of configurations and prints their frame times.
+ */
+class AnimationBench : public Game
+{
+public:
+
+    AnimationBench()
+        : _scene(NULL), _configuration(0), _frame(0), _start(0.0)
+    {
+    }
+
+protected:
+
+    void initialize()
+    {
+        // Thread counts double up to the number of processors.
+        for (unsigned int threadCount = 1; threadCount < ThreadPool::getProcessorCount(); threadCount *= 2)
+        {
+            _threadCounts.push_back(threadCount);
+        }
+        _threadCounts.push_back(ThreadPool::getProcessorCount());
+
+        printf("clips threads ms/frame channels\n");
+        createScene();
+    }
+
+    void finalize()
+    {
+        SAFE_RELEASE(_scene);
+    }
+
+    void update(long elapsedTime)
+    {
+        ++_frame;
+        if (_frame == BENCH_WARMUP_FRAMES)
+        {
+            _start = getTime();
+        }
+        else if (_frame == BENCH_WARMUP_FRAMES + BENCH_MEASURED_FRAMES)
+        {
+            printf("%5u %7u %8.3f %8u\n", getClipCount(), getThreadCount(), (getTime() - _start) / BENCH_MEASURED_FRAMES,
+                getAnimationController()->getEvaluatedChannelCount());
+            fflush(stdout);
+
+            if (++_configuration == _threadCounts.size() * (sizeof(__clipCounts) / sizeof(__clipCounts[0])))
+            {
+                exit();
+                return;
+            }
+            createScene();
+        }
+    }
+
+    void render(long elapsedTime)
+    {
+    }
+
+private:
+
+    unsigned int getClipCount() const
+    {
+        return __clipCounts[_configuration / _threadCounts.size()];
+    }
+
+    unsigned int getThreadCount() const
+    {
+        return _threadCounts[_configuration % _threadCounts.size()];
+    }
+
+    /**
+     * Creates the animated nodes of the current configuration and starts their clips.
+     */
+    void createScene()
+    {
+        SAFE_RELEASE(_scene);
+        getAnimationController()->setThreadCount(getThreadCount());
+        _frame = 0;
+
+        _scene = Scene::createScene();
+
+        // Each node spins around the y axis while bobbing and pulsing, with its own phase so that
+        // the clips sample different key frames.
+        unsigned long keyTimes[BENCH_KEY_COUNT];
+        float keyValues[BENCH_KEY_COUNT * 10];
+        unsigned int clipCount = getClipCount();
+        for (unsigned int i = 0; i < clipCount; ++i)
+        {
+            for (unsigned int j = 0; j < BENCH_KEY_COUNT; ++j)
+            {
+                float angle = MATH_PIX2 * ((float)j / (BENCH_KEY_COUNT - 1) + (float)i / clipCount);
+                float* value = &keyValues[j * 10];
+                keyTimes[j] = j * 100L;
+                value[0] = value[1] = value[2] = 1.0f + 0.25f * sin(angle);
+                value[3] = 0.0f;
+                value[4] = sin(angle * 0.5f);
+                value[5] = 0.0f;
+                value[6] = cos(angle * 0.5f);
+                value[7] = (float)(i % 32) * 2.0f;
+                value[8] = cos(angle);
+                value[9] = (float)(i / 32) * 2.0f;
+            }
+
+            Node* node = _scene->addNode();
+            Animation* animation = node->createAnimation("spin", Transform::ANIMATE_SCALE_ROTATE_TRANSLATE, BENCH_KEY_COUNT, keyTimes, keyValues, Curve::LINEAR);
+            AnimationClip* clip = animation->getClip();
+            clip->setRepeatCount(AnimationClip::REPEAT_INDEFINITE);
+            clip->play();
+        }
+    }
+
+    Scene* _scene;
+    std::vector<unsigned int> _threadCounts;
+    unsigned int _configuration;
+    unsigned int _frame;
+    double _start;
+};
+
+// Declare the game instance.
+AnimationBench game;
@@ -0,0 +1,114 @@
+// Times Frustum::cullSpheres() and Frustum::cullBoxes() against per-object Frustum::intersects()
+// tests on the same seeded data. The makefile links it twice, with the SIMD and the scalar culling
+// kernels (see GAMEPLAY_NO_SIMD in Base.h), so that the two kernels can be compared as well.
+
+#include "Base.h"
+#include "Frustum.h"
+#include "BoundingSphere.h"
+#include "BoundingBox.h"
+
+using namespace gameplay;
+
+// The number of objects culled per pass, and the number of timed passes.
+#define BENCH_OBJECT_COUNT 100000
+#define BENCH_PASS_COUNT 100
+
+static double getTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+static float random(float min, float max)
+{
+    return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+int main(int argc, char** argv)
+{
+#if defined(USE_SSE)
+    const char* kernel = "SSE";
+#elif defined(USE_NEON)
+    const char* kernel = "NEON";
+#else
+    const char* kernel = "scalar";
+#endif
+
+    // A camera at the origin looking down -z, with objects scattered around it.
+    Matrix projection;
+    Matrix::createPerspective(45.0f, 16.0f / 9.0f, 1.0f, 500.0f, &projection);
+    Frustum frustum(projection);
+
+    srand(1);
+    std::vector<float> x(BENCH_OBJECT_COUNT), y(BENCH_OBJECT_COUNT), z(BENCH_OBJECT_COUNT), radius(BENCH_OBJECT_COUNT);
+    std::vector<float> minX(BENCH_OBJECT_COUNT), minY(BENCH_OBJECT_COUNT), minZ(BENCH_OBJECT_COUNT);
+    std::vector<float> maxX(BENCH_OBJECT_COUNT), maxY(BENCH_OBJECT_COUNT), maxZ(BENCH_OBJECT_COUNT);
+    std::vector<BoundingSphere> spheres(BENCH_OBJECT_COUNT);
+    std::vector<BoundingBox> boxes(BENCH_OBJECT_COUNT);
+    for (unsigned int i = 0; i < BENCH_OBJECT_COUNT; ++i)
+    {
+        x[i] = random(-500.0f, 500.0f);
+        y[i] = random(-100.0f, 100.0f);
+        z[i] = random(-500.0f, 500.0f);
+        radius[i] = random(0.5f, 5.0f);
+        minX[i] = x[i] - radius[i];
+        minY[i] = y[i] - radius[i];
+        minZ[i] = z[i] - radius[i];
+        maxX[i] = x[i] + radius[i];
+        maxY[i] = y[i] + radius[i];
+        maxZ[i] = z[i] + radius[i];
+        spheres[i].set(Vector3(x[i], y[i], z[i]), radius[i]);
+        boxes[i].set(Vector3(minX[i], minY[i], minZ[i]), Vector3(maxX[i], maxY[i], maxZ[i]));
+    }
+
+    std::vector<unsigned int> visible((BENCH_OBJECT_COUNT + 31) / 32);
+    std::vector<unsigned char> planeCache((BENCH_OBJECT_COUNT + 3) / 4, 0);
+    unsigned int sphereCount = 0, boxCount = 0, sphereCheck = 0, boxCheck = 0;
+
+    double start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        sphereCount = frustum.cullSpheres(&x[0], &y[0], &z[0], &radius[0], BENCH_OBJECT_COUNT, &visible[0], &planeCache[0]);
+    }
+    double cullSpheresTime = (getTime() - start) / BENCH_PASS_COUNT;
+
+    std::fill(planeCache.begin(), planeCache.end(), 0);
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        boxCount = frustum.cullBoxes(&minX[0], &minY[0], &minZ[0], &maxX[0], &maxY[0], &maxZ[0], BENCH_OBJECT_COUNT, &visible[0], &planeCache[0]);
+    }
+    double cullBoxesTime = (getTime() - start) / BENCH_PASS_COUNT;
+
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        sphereCheck = 0;
+        for (unsigned int i = 0; i < BENCH_OBJECT_COUNT; ++i)
+        {
+            if (frustum.intersects(spheres[i]))
+                ++sphereCheck;
+        }
+    }
+    double intersectsSpheresTime = (getTime() - start) / BENCH_PASS_COUNT;
+
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        boxCheck = 0;
+        for (unsigned int i = 0; i < BENCH_OBJECT_COUNT; ++i)
+        {
+            if (frustum.intersects(boxes[i]))
+                ++boxCheck;
+        }
+    }
+    double intersectsBoxesTime = (getTime() - start) / BENCH_PASS_COUNT;
+
+    printf("%u objects, %s culling kernel, milliseconds per pass:\n", BENCH_OBJECT_COUNT, kernel);
+    printf("  spheres: cullSpheres %.3f, intersects %.3f (%u and %u visible)\n", cullSpheresTime, intersectsSpheresTime, sphereCount, sphereCheck);
+    printf("  boxes:   cullBoxes   %.3f, intersects %.3f (%u and %u visible)\n", cullBoxesTime, intersectsBoxesTime, boxCount, boxCheck);
+
+    // The batched and per-object tests must agree.
+    return sphereCount == sphereCheck && boxCount == boxCheck ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,129 @@
+// Times the batch math operations (Matrix::multiply(), Matrix::transformPoints() and Quaternion::slerp()
+// on arrays) against calling the single-element versions in a loop, on the same seeded data. The
+// makefile links it twice, with the SIMD and the scalar math kernels (see GAMEPLAY_NO_SIMD in Base.h),
+// so that the two kernels can be compared as well.
+
+#include "Base.h"
+#include "Matrix.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+
+using namespace gameplay;
+
+// The number of elements processed per pass, and the number of timed passes.
+#define BENCH_ELEMENT_COUNT 10000
+#define BENCH_PASS_COUNT 200
+
+static double getTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+static float random(float min, float max)
+{
+    return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+static Quaternion randomRotation()
+{
+    Quaternion q(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f));
+    q.normalize();
+    return q;
+}
+
+static void print(const char* operation, double batchTime, double loopTime)
+{
+    printf("%-16s %8.3f %8.3f %6.2fx\n", operation, batchTime / BENCH_PASS_COUNT, loopTime / BENCH_PASS_COUNT, loopTime / batchTime);
+}
+
+int main(int argc, char** argv)
+{
+#if defined(USE_SSE)
+    const char* kernel = "SSE";
+#elif defined(USE_NEON)
+    const char* kernel = "NEON";
+#else
+    const char* kernel = "scalar";
+#endif
+
+    srand(1);
+    std::vector<Matrix> m1(BENCH_ELEMENT_COUNT), m2(BENCH_ELEMENT_COUNT), matrices(BENCH_ELEMENT_COUNT);
+    std::vector<Vector3> points(BENCH_ELEMENT_COUNT), transformed(BENCH_ELEMENT_COUNT);
+    std::vector<Quaternion> q1(BENCH_ELEMENT_COUNT), q2(BENCH_ELEMENT_COUNT), rotations(BENCH_ELEMENT_COUNT);
+    std::vector<float> t(BENCH_ELEMENT_COUNT);
+    for (unsigned int i = 0; i < BENCH_ELEMENT_COUNT; ++i)
+    {
+        Matrix::createTranslation(random(-100.0f, 100.0f), random(-100.0f, 100.0f), random(-100.0f, 100.0f), &m1[i]);
+        m1[i].rotate(randomRotation());
+        Matrix::createScale(random(0.5f, 2.0f), random(0.5f, 2.0f), random(0.5f, 2.0f), &m2[i]);
+        m2[i].rotate(randomRotation());
+        points[i].set(random(-100.0f, 100.0f), random(-100.0f, 100.0f), random(-100.0f, 100.0f));
+        q1[i] = randomRotation();
+        q2[i] = randomRotation();
+        t[i] = random(0.0f, 1.0f);
+    }
+    const Matrix& transform = m1[0];
+
+    printf("%u elements, %s kernels\n", BENCH_ELEMENT_COUNT, kernel);
+    printf("operation        batch ms  loop ms  speedup\n");
+
+    double start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        Matrix::multiply(&m1[0], &m2[0], &matrices[0], BENCH_ELEMENT_COUNT);
+    }
+    double batchTime = getTime() - start;
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        for (unsigned int i = 0; i < BENCH_ELEMENT_COUNT; ++i)
+        {
+            Matrix::multiply(m1[i], m2[i], &matrices[i]);
+        }
+    }
+    print("multiply", batchTime, getTime() - start);
+
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        transform.transformPoints(&points[0], &transformed[0], BENCH_ELEMENT_COUNT);
+    }
+    batchTime = getTime() - start;
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        for (unsigned int i = 0; i < BENCH_ELEMENT_COUNT; ++i)
+        {
+            transform.transformPoint(points[i], &transformed[i]);
+        }
+    }
+    print("transformPoints", batchTime, getTime() - start);
+
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        Quaternion::slerp(&q1[0], &q2[0], &t[0], &rotations[0], BENCH_ELEMENT_COUNT);
+    }
+    batchTime = getTime() - start;
+    start = getTime();
+    for (unsigned int pass = 0; pass < BENCH_PASS_COUNT; ++pass)
+    {
+        for (unsigned int i = 0; i < BENCH_ELEMENT_COUNT; ++i)
+        {
+            Quaternion::slerp(q1[i], q2[i], t[i], &rotations[i]);
+        }
+    }
+    print("slerp", batchTime, getTime() - start);
+
+    // Keep the results alive so that the timed loops are not optimized away.
+    float checksum = 0.0f;
+    for (unsigned int i = 0; i < BENCH_ELEMENT_COUNT; ++i)
+    {
+        checksum += matrices[i].m[12] + transformed[i].x + rotations[i].w;
+    }
+    printf("checksum %f\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,392 @@
+// Checks the buffer object traffic of MeshBatch against a recording GL shim. The GL entry points that
+// the batch and its material reach are defined here, so the check links without a GL library or a
+// context: each call is counted, and the sizes passed to glBufferData() and glBufferSubData() are
+// recorded so that the orphaning and upload behavior of streaming batches can be verified.
+//
+// Prints each failed expectation and exits with a non-zero status if any fail.
+
+#include "Base.h"
+#include "MeshBatch.h"
+#include "Effect.h"
+#include "Material.h"
+
+using namespace gameplay;
+
+/**
+ * Creates and releases the default render state block, which Game::startup() normally does along
+ * with starting the physics and audio systems.
+ */
+class DefaultRenderState : public RenderState
+{
+public:
+
+    static void initialize()
+    {
+        RenderState::initialize();
+    }
+
+    static void finalize()
+    {
+        RenderState::finalize();
+    }
+};
+
+/**
+ * The GL calls recorded by the shim.
+ */
+struct GLRecord
+{
+    unsigned int genBuffers;
+    unsigned int deleteBuffers;
+    unsigned int arrayBufferData;                   // glBufferData() calls on GL_ARRAY_BUFFER.
+    unsigned int elementBufferData;                 // glBufferData() calls on GL_ELEMENT_ARRAY_BUFFER.
+    unsigned int arrayBufferSubData;
+    unsigned int elementBufferSubData;
+    unsigned int draws;
+    std::vector<GLsizeiptr> arrayBufferSizes;       // The size of each glBufferData() call on GL_ARRAY_BUFFER.
+    std::vector<GLsizeiptr> elementBufferSizes;
+    std::vector<GLsizeiptr> arrayUploadSizes;       // The size of each glBufferSubData() call on GL_ARRAY_BUFFER.
+    std::vector<GLsizeiptr> elementUploadSizes;
+    std::vector<unsigned short> firstIndices;       // The first index of each glBufferSubData() call on GL_ELEMENT_ARRAY_BUFFER.
+    bool orphaned;                                  // True if every glBufferData() call passed NULL data.
+};
+
+static GLRecord __gl;
+static GLuint __nextName = 1;
+static unsigned int __failures = 0;
+
+static void resetRecord()
+{
+    __gl = GLRecord();
+    __gl.orphaned = true;
+}
+
+static void expect(bool condition, const char* test, const char* expectation)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s: %s\n", test, expectation);
+        ++__failures;
+    }
+}
+
+extern "C"
+{
+
+GLAPI void APIENTRY glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        buffers[i] = __nextName++;
+    }
+    __gl.genBuffers += n;
+}
+
+GLAPI void APIENTRY glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    __gl.deleteBuffers += n;
+}
+
+GLAPI void APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    if (data != NULL)
+        __gl.orphaned = false;
+    if (target == GL_ARRAY_BUFFER)
+    {
+        ++__gl.arrayBufferData;
+        __gl.arrayBufferSizes.push_back(size);
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        ++__gl.elementBufferData;
+        __gl.elementBufferSizes.push_back(size);
+    }
+}
+
+GLAPI void APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    if (target == GL_ARRAY_BUFFER)
+    {
+        ++__gl.arrayBufferSubData;
+        __gl.arrayUploadSizes.push_back(size);
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        ++__gl.elementBufferSubData;
+        __gl.elementUploadSizes.push_back(size);
+        __gl.firstIndices.push_back(*(const unsigned short*)data);
+    }
+}
+
+GLAPI void APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    ++__gl.draws;
+}
+
+GLAPI void APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    ++__gl.draws;
+}
+
+// Shader compilation and linking always succeed. Programs have the position and color attributes
+// of the batches' vertices at locations 0 and 1, and no active uniforms.
+static const char* __attributes[] = { VERTEX_ATTRIBUTE_POSITION_NAME, VERTEX_ATTRIBUTE_COLOR_NAME };
+
+GLAPI GLuint APIENTRY glCreateShader(GLenum type)
+{
+    return __nextName++;
+}
+
+GLAPI GLuint APIENTRY glCreateProgram()
+{
+    return __nextName++;
+}
+
+GLAPI void APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+GLAPI void APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    switch (pname)
+    {
+    case GL_LINK_STATUS:
+        *params = GL_TRUE;
+        break;
+    case GL_ACTIVE_ATTRIBUTES:
+        *params = 2;
+        break;
+    case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+        *params = 32;
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+GLAPI void APIENTRY glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    strncpy(name, __attributes[index], bufSize);
+    *size = 1;
+    *type = index == 0 ? GL_FLOAT_VEC3 : GL_FLOAT_VEC4;
+}
+
+GLAPI GLint APIENTRY glGetAttribLocation(GLuint program, const GLchar* name)
+{
+    return strcmp(name, __attributes[0]) == 0 ? 0 : (strcmp(name, __attributes[1]) == 0 ? 1 : -1);
+}
+
+GLAPI GLint APIENTRY glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    return -1;
+}
+
+GLAPI void APIENTRY glGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        arrays[i] = __nextName++;
+    }
+}
+
+GLAPI GLenum APIENTRY glGetError()
+{
+    return GL_NO_ERROR;
+}
+
+GLAPI void APIENTRY glGetIntegerv(GLenum pname, GLint* data)
+{
+    *data = pname == GL_MAX_VERTEX_ATTRIBS ? 16 : 0;
+}
+
+// State changes are not recorded.
+GLAPI void APIENTRY glBindBuffer(GLenum target, GLuint buffer) { }
+GLAPI void APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) { }
+GLAPI void APIENTRY glCompileShader(GLuint shader) { }
+GLAPI void APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) { }
+GLAPI void APIENTRY glDeleteShader(GLuint shader) { }
+GLAPI void APIENTRY glAttachShader(GLuint program, GLuint shader) { }
+GLAPI void APIENTRY glLinkProgram(GLuint program) { }
+GLAPI void APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) { }
+GLAPI void APIENTRY glDeleteProgram(GLuint program) { }
+GLAPI void APIENTRY glUseProgram(GLuint program) { }
+GLAPI void APIENTRY glDeleteVertexArrays(GLsizei n, const GLuint* arrays) { }
+GLAPI void APIENTRY glBindVertexArray(GLuint array) { }
+GLAPI void APIENTRY glEnableVertexAttribArray(GLuint index) { }
+GLAPI void APIENTRY glDisableVertexAttribArray(GLuint index) { }
+GLAPI void APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) { }
+GLAPI void APIENTRY glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) { }
+GLAPI void APIENTRY glUniform1f(GLint location, GLfloat v0) { }
+GLAPI void APIENTRY glUniform1i(GLint location, GLint v0) { }
+GLAPI void APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat* value) { }
+GLAPI void APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint* value) { }
+GLAPI void APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat* value) { }
+GLAPI void APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat* value) { }
+GLAPI void APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat* value) { }
+GLAPI void APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { }
+GLAPI void APIENTRY glActiveTexture(GLenum texture) { }
+GLAPI void APIENTRY glBindTexture(GLenum target, GLuint texture) { }
+GLAPI void APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) { }
+GLAPI void APIENTRY glEnable(GLenum cap) { }
+GLAPI void APIENTRY glDisable(GLenum cap) { }
+GLAPI void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) { }
+GLAPI void APIENTRY glDepthMask(GLboolean flag) { }
+
+}
+
+/**
+ * The vertex of the batches: a position and a color.
+ */
+struct Vertex
+{
+    float x, y, z;
+    float r, g, b, a;
+};
+
+static const char* __vertexShader = "attribute vec3 a_position; void main() { gl_Position = vec4(a_position, 1.0); }";
+static const char* __fragmentShader = "void main() { gl_FragColor = vec4(1.0); }";
+
+static MeshBatch* createBatch(bool indexed, unsigned int capacity, bool streaming)
+{
+    VertexFormat::Element elements[] =
+    {
+        VertexFormat::Element(VertexFormat::POSITION, 3),
+        VertexFormat::Element(VertexFormat::COLOR, 4)
+    };
+    Effect* effect = Effect::createFromSource(__vertexShader, __fragmentShader);
+    Material* material = Material::create(effect);
+    SAFE_RELEASE(effect);
+    MeshBatch* batch = MeshBatch::create(VertexFormat(elements, 2), Mesh::TRIANGLES, material, indexed, capacity, capacity, streaming);
+    SAFE_RELEASE(material);
+    return batch;
+}
+
+/**
+ * Adds count separate triangles to the batch.
+ */
+static void addTriangles(MeshBatch* batch, unsigned int count)
+{
+    Vertex vertices[3];
+    memset(vertices, 0, sizeof(vertices));
+    unsigned short indices[] = { 0, 1, 2 };
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        batch->add(vertices, 3, indices, 3);
+    }
+}
+
+static void checkCreation()
+{
+    const char* test = "creation";
+    resetRecord();
+    MeshBatch* batch = createBatch(true, 1024, true);
+    expect(batch->isStreaming(), test, "the batch streams");
+    expect(__gl.genBuffers == 2, test, "one vertex and one index buffer object are generated");
+    expect(__gl.arrayBufferData == 0 && __gl.elementBufferData == 0, test, "no buffer storage is allocated before drawing");
+    SAFE_DELETE(batch);
+    expect(__gl.deleteBuffers == 2, test, "both buffer objects are deleted with the batch");
+}
+
+static void checkOrphaning()
+{
+    const char* test = "orphaning";
+    MeshBatch* batch = createBatch(true, 1024, true);
+    resetRecord();
+    for (unsigned int frame = 0; frame < 3; ++frame)
+    {
+        batch->begin();
+        addTriangles(batch, 100 + frame * 100);
+        batch->end();
+        batch->draw();
+    }
+    expect(__gl.genBuffers == 0, test, "no buffer objects are generated after creation");
+    expect(__gl.arrayBufferData == 3 && __gl.elementBufferData == 3, test, "each buffer is orphaned once per draw");
+    expect(__gl.orphaned, test, "orphaning passes no data to glBufferData");
+    expect(__gl.arrayBufferSizes[0] == __gl.arrayBufferSizes[1] && __gl.arrayBufferSizes[1] == __gl.arrayBufferSizes[2] &&
+           __gl.elementBufferSizes[0] == __gl.elementBufferSizes[1] && __gl.elementBufferSizes[1] == __gl.elementBufferSizes[2],
+           test, "orphaned buffers keep the same size while the capacity is unchanged");
+    expect(__gl.arrayBufferSizes[0] == (GLsizeiptr)(3072 * sizeof(Vertex)), test, "the vertex buffer holds the capacity of the batch");
+    expect(__gl.arrayBufferSubData == 3 && __gl.elementBufferSubData == 3, test, "each buffer is uploaded once per draw");
+    expect(__gl.arrayUploadSizes[2] == (GLsizeiptr)(900 * sizeof(Vertex)) && __gl.elementUploadSizes[2] == (GLsizeiptr)(900 * sizeof(unsigned short)),
+           test, "only the vertices and indices in use are uploaded");
+    expect(__gl.draws == 3, test, "one draw call per frame");
+    SAFE_DELETE(batch);
+}
+
+static void checkGrowth()
+{
+    const char* test = "growth";
+    MeshBatch* batch = createBatch(true, 16, true);
+    resetRecord();
+    batch->begin();
+    addTriangles(batch, 1000);
+    batch->end();
+    batch->draw();
+    expect(batch->getCapacity() >= 1000, test, "the batch grows to hold the triangles");
+    expect(__gl.genBuffers == 0, test, "growing does not generate buffer objects");
+    expect(__gl.arrayBufferData == 1 && __gl.arrayBufferSizes[0] == (GLsizeiptr)(batch->getCapacity() * 3 * sizeof(Vertex)),
+           test, "the vertex buffer is sized for the grown capacity when drawn");
+    expect(__gl.arrayUploadSizes[0] == (GLsizeiptr)(3000 * sizeof(Vertex)), test, "all vertices are uploaded");
+    SAFE_DELETE(batch);
+}
+
+static void checkSplitDraws()
+{
+    const char* test = "split draws";
+    MeshBatch* batch = createBatch(true, 1024, true);
+    resetRecord();
+
+    // 30000 triangles use 90000 vertices, more than 16-bit indices can address in one draw call.
+    batch->begin();
+    addTriangles(batch, 30000);
+    batch->end();
+    batch->draw();
+    unsigned int drawCount = batch->getDrawCount();
+    expect(drawCount == 2, test, "the vertices are split into two draw calls");
+    expect(__gl.arrayBufferData == drawCount && __gl.elementBufferData == drawCount, test, "each draw call orphans the buffers");
+    expect(__gl.arrayBufferSubData == drawCount && __gl.elementBufferSubData == drawCount, test, "each draw call uploads its own range");
+    expect(__gl.arrayBufferSizes[0] == (GLsizeiptr)(MESHBATCH_MAX_DRAW_VERTICES * sizeof(Vertex)), test, "the vertex buffer is sized for one draw call");
+    expect(__gl.arrayUploadSizes[0] + __gl.arrayUploadSizes[1] == (GLsizeiptr)(90000 * sizeof(Vertex)), test, "every vertex is uploaded once");
+    expect(__gl.firstIndices[1] == 0, test, "the indices of each draw call are relative to its first vertex");
+    expect(__gl.draws == drawCount, test, "one draw call per range");
+    SAFE_DELETE(batch);
+}
+
+static void checkClientArrays()
+{
+    const char* test = "client arrays";
+    MeshBatch* batch = createBatch(true, 1024, false);
+    resetRecord();
+    batch->begin();
+    addTriangles(batch, 100);
+    batch->end();
+    batch->draw();
+    expect(!batch->isStreaming(), test, "the batch does not stream");
+    expect(__gl.genBuffers == 0 && __gl.arrayBufferData == 0 && __gl.elementBufferData == 0 &&
+           __gl.arrayBufferSubData == 0 && __gl.elementBufferSubData == 0, test, "no buffer objects are used");
+    expect(__gl.draws == 1, test, "one draw call");
+    SAFE_DELETE(batch);
+}
+
+int main(int argc, char** argv)
+{
+    DefaultRenderState::initialize();
+
+    checkCreation();
+    checkOrphaning();
+    checkGrowth();
+    checkSplitDraws();
+    checkClientArrays();
+
+    if (__failures > 0)
+    {
+        printf("%u expectations failed.\n", __failures);
+        DefaultRenderState::finalize();
+        return 1;
+    }
+    DefaultRenderState::finalize();
+    printf("All mesh batch checks passed.\n");
+    return 0;
+}
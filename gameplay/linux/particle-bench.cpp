@@ -0,0 +1,116 @@
+// Particle update benchmark. Fills an emitter with 100000 rotating, animated particles and measures
+// the average time of ParticleEmitter::update(). The makefile links it twice, with the SIMD and the
+// scalar particle kernels (see GAMEPLAY_NO_SIMD in Base.h), so that the two kernels can be compared.
+//
+// Runs headless: the particles live longer than the benchmark and nothing is drawn, so every update
+// processes all of the particles whatever the wall-clock time.
+
+#include "gameplay.h"
+
+using namespace gameplay;
+
+// The number of particles in the emitter.
+#define BENCH_PARTICLE_COUNT 100000
+
+// The number of updates before and while measuring each configuration.
+#define BENCH_WARMUP_UPDATES 10
+#define BENCH_MEASURED_UPDATES 100
+
+// The texture of the particles, relative to the gameplay/linux directory.
+#define BENCH_TEXTURE "../res/logo_white.png"
+
+static double getTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+/**
+ * Benchmark game that updates an emitter with looped and with single-play sprite animations.
+ */
+class ParticleBench : public Game
+{
+public:
+
+    ParticleBench()
+    {
+    }
+
+protected:
+
+    void initialize()
+    {
+#if defined(USE_SSE)
+        const char* kernel = "SSE";
+#elif defined(USE_NEON)
+        const char* kernel = "NEON";
+#else
+        const char* kernel = "scalar";
+#endif
+
+        printf("%u particles, %s kernels\n", BENCH_PARTICLE_COUNT, kernel);
+        printf("animation ms/update\n");
+    }
+
+    void finalize()
+    {
+    }
+
+    void update(long elapsedTime)
+    {
+        measure(true);
+        measure(false);
+        exit();
+    }
+
+    void render(long elapsedTime)
+    {
+    }
+
+private:
+
+    /**
+     * Prints the average update time of a full emitter.
+     */
+    void measure(bool looped)
+    {
+        ParticleEmitter* emitter = ParticleEmitter::create(BENCH_TEXTURE, ParticleEmitter::BLEND_ADDITIVE, BENCH_PARTICLE_COUNT);
+        if (emitter == NULL)
+        {
+            printf("Failed to create the emitter.\n");
+            return;
+        }
+
+        // Particles that outlive the benchmark, each rotating around its own axis.
+        emitter->setEnergy(1000000L, 1000000L);
+        emitter->setVelocity(Vector3::zero(), Vector3(10.0f, 10.0f, 10.0f));
+        emitter->setAcceleration(Vector3(0.0f, -9.8f, 0.0f), Vector3::one());
+        emitter->setRotation(0.5f, 2.0f, Vector3::unitY(), Vector3::one());
+        emitter->setRotationPerParticle(-1.0f, 1.0f);
+        emitter->setSpriteFrameCoords(16, 32, 32);
+        emitter->setSpriteAnimated(true);
+        emitter->setSpriteLooped(looped);
+        emitter->setSpriteFrameDuration(50L);
+        emitter->start();
+        emitter->emit(BENCH_PARTICLE_COUNT);
+
+        for (unsigned int i = 0; i < BENCH_WARMUP_UPDATES; ++i)
+        {
+            emitter->update(16L);
+        }
+
+        double start = getTime();
+        for (unsigned int i = 0; i < BENCH_MEASURED_UPDATES; ++i)
+        {
+            emitter->update(16L);
+        }
+        printf("%-9s %9.3f\n", looped ? "looped" : "once", (getTime() - start) / BENCH_MEASURED_UPDATES);
+        fflush(stdout);
+
+        SAFE_RELEASE(emitter);
+    }
+};
+
+// Declare the game instance.
+ParticleBench game;
@@ -0,0 +1,137 @@
+// Physics stress benchmark. Drops piles of boxes onto the ground and measures the average time of
+// a physics step for several body counts and thread counts (see PhysicsController::setThreadCount).
+//
+// Runs headless: each frame advances the game clock by 16 ms, and the simulation is set to variable
+// steps, so every frame simulates exactly one step whatever the wall-clock time.
+
+#include "gameplay.h"
+
+using namespace gameplay;
+
+// The number of frames simulated before and while measuring each configuration.
+#define BENCH_WARMUP_FRAMES 60
+#define BENCH_MEASURED_FRAMES 120
+
+// The number of boxes in each pile.
+#define BENCH_PILE_HEIGHT 10
+
+static const unsigned int __bodyCounts[] = { 500, 1000, 2000, 4000 };
+
+static double getTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+/**
+ * Benchmark game that simulates a sequence of configurations and prints their step times.
+ */
+class PhysicsBench : public Game
+{
+public:
+
+    PhysicsBench()
+        : _scene(NULL), _configuration(0), _frame(0), _start(0.0)
+    {
+    }
+
+protected:
+
+    void initialize()
+    {
+        getPhysicsController()->setTimeStep(1.0f / 60.0f, 0);
+
+        // Thread counts double up to the number of processors.
+        for (unsigned int threadCount = 1; threadCount < ThreadPool::getProcessorCount(); threadCount *= 2)
+        {
+            _threadCounts.push_back(threadCount);
+        }
+        _threadCounts.push_back(ThreadPool::getProcessorCount());
+
+        printf("bodies threads ms/step\n");
+        createScene();
+    }
+
+    void finalize()
+    {
+        SAFE_RELEASE(_scene);
+    }
+
+    void update(long elapsedTime)
+    {
+        ++_frame;
+        if (_frame == BENCH_WARMUP_FRAMES)
+        {
+            _start = getTime();
+        }
+        else if (_frame == BENCH_WARMUP_FRAMES + BENCH_MEASURED_FRAMES)
+        {
+            printf("%6u %7u %7.3f\n", getBodyCount(), getThreadCount(), (getTime() - _start) / BENCH_MEASURED_FRAMES);
+            fflush(stdout);
+
+            if (++_configuration == _threadCounts.size() * (sizeof(__bodyCounts) / sizeof(__bodyCounts[0])))
+            {
+                exit();
+                return;
+            }
+            createScene();
+        }
+    }
+
+    void render(long elapsedTime)
+    {
+    }
+
+private:
+
+    unsigned int getBodyCount() const
+    {
+        return __bodyCounts[_configuration / _threadCounts.size()];
+    }
+
+    unsigned int getThreadCount() const
+    {
+        return _threadCounts[_configuration % _threadCounts.size()];
+    }
+
+    /**
+     * Creates the ground and the piles of boxes of the current configuration.
+     */
+    void createScene()
+    {
+        SAFE_RELEASE(_scene);
+        getPhysicsController()->setThreadCount(getThreadCount());
+        _frame = 0;
+
+        _scene = Scene::createScene();
+
+        Node* ground = _scene->addNode("ground");
+        ground->setTranslation(0.0f, -1.0f, 0.0f);
+        PhysicsRigidBody::Parameters groundParameters(0.0f);
+        ground->setCollisionObject(PhysicsCollisionObject::RIGID_BODY, PhysicsCollisionShape::box(Vector3(1000.0f, 2.0f, 1000.0f)), &groundParameters);
+
+        // Piles are laid out on a square grid, with the boxes of each pile slightly offset so that they topple.
+        unsigned int bodyCount = getBodyCount();
+        unsigned int pileCount = (bodyCount + BENCH_PILE_HEIGHT - 1) / BENCH_PILE_HEIGHT;
+        unsigned int gridSize = (unsigned int)ceil(sqrt((float)pileCount));
+        PhysicsRigidBody::Parameters boxParameters(1.0f);
+        for (unsigned int i = 0; i < bodyCount; ++i)
+        {
+            unsigned int pile = i / BENCH_PILE_HEIGHT;
+            unsigned int level = i % BENCH_PILE_HEIGHT;
+            Node* box = _scene->addNode();
+            box->setTranslation((pile % gridSize) * 3.0f + (level % 2) * 0.3f, 0.5f + level * 1.05f, (pile / gridSize) * 3.0f);
+            box->setCollisionObject(PhysicsCollisionObject::RIGID_BODY, PhysicsCollisionShape::box(Vector3::one()), &boxParameters);
+        }
+    }
+
+    Scene* _scene;
+    std::vector<unsigned int> _threadCounts;
+    unsigned int _configuration;
+    unsigned int _frame;
+    double _start;
+};
+
+// Declare the game instance.
+PhysicsBench game;
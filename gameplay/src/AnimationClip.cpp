@@ -3,6 +3,7 @@
 #include "Animation.h"
 #include "AnimationTarget.h"
 #include "Game.h"
+#include "Node.h"
 #include "Quaternion.h"
 
 namespace gameplay
@@ -12,7 +13,8 @@ AnimationClip::AnimationClip(const char* id, Animation* animation, unsigned long
     : _id(id), _animation(animation), _startTime(startTime), _endTime(endTime), _duration(_endTime - _startTime), 
       _stateBits(0x00), _repeatCount(1.0f), _activeDuration(_duration * _repeatCount), _speed(1.0f), _timeStarted(0), 
       _elapsedTime(0), _crossFadeToClip(NULL), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f), 
-      _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL)
+      _percentComplete(0.0f), _lodNode(NULL), _lodLevel(0), _lodInterval(1), _lodFrame(0), _lodCulled(false), _lodSample(true),
+      _lodReset(true), _evaluatedChannelCount(0), _skippedChannelCount(0), _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL)
 {
     assert(0 <= startTime && startTime <= animation->_duration && 0 <= endTime && endTime <= animation->_duration);
     
@@ -21,6 +23,7 @@ AnimationClip::AnimationClip(const char* id, Animation* animation, unsigned long
     {
         _values.push_back(new AnimationValue(_animation->_channels[i]->getCurve()->getComponentCount()));
     }
+    _cursors.resize(channelCount, 0);
 }
 
 AnimationClip::~AnimationClip()
@@ -32,8 +35,14 @@ AnimationClip::~AnimationClip()
         valueIter++;
     }
     _values.clear();
+    for (unsigned int i = 0, count = _lodValues.size(); i < count; i++)
+    {
+        SAFE_DELETE(_lodPreviousValues[i]);
+        SAFE_DELETE(_lodValues[i]);
+    }
 
     SAFE_RELEASE(_crossFadeToClip);
+    setLodNode(NULL);
     SAFE_DELETE(_beginListeners);
     SAFE_DELETE(_endListeners);
 
@@ -304,18 +313,53 @@ void AnimationClip::addEndListener(AnimationClip::Listener* listener)
     _endListeners->push_back(listener);
 }
 
-bool AnimationClip::update(unsigned long elapsedTime, std::list<AnimationTarget*>* activeTargets)
+void AnimationClip::setLodNode(Node* node)
+{
+    if (node == _lodNode)
+        return;
+
+    // The node is not retained, since it usually owns this clip through its animation channels.
+    // Instead, the node keeps a list of its clips and clears their LOD node when it is destroyed.
+    if (_lodNode)
+    {
+        std::vector<AnimationClip*>* clips = _lodNode->_lodClips;
+        clips->erase(std::find(clips->begin(), clips->end(), this));
+        if (clips->empty())
+            SAFE_DELETE(_lodNode->_lodClips);
+    }
+
+    _lodNode = node;
+
+    if (_lodNode)
+    {
+        if (_lodNode->_lodClips == NULL)
+            _lodNode->_lodClips = new std::vector<AnimationClip*>();
+        _lodNode->_lodClips->push_back(this);
+    }
+}
+
+Node* AnimationClip::getLodNode() const
+{
+    return _lodNode;
+}
+
+unsigned int AnimationClip::getLodLevel() const
+{
+    return _lodLevel;
+}
+
+AnimationClip::AdvanceResult AnimationClip::advance(unsigned long elapsedTime)
 {
     if (isClipStateBitSet(CLIP_IS_PAUSED_BIT))
     {
-        return false;
+        return ADVANCE_SKIP;
     }
     else if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT))
     {   // If the marked for removal bit is set, it means stop() was called on the AnimationClip at some point
-        // after the last update call. Reset the flag, and return true so the AnimationClip is removed from the 
+        // after the last update call. Reset the flag, and return ADVANCE_REMOVE so the AnimationClip is removed from the 
         // running clips on the AnimationController.
         onEnd();
-        return true;
+        return ADVANCE_REMOVE;
     }
     else if (!isClipStateBitSet(CLIP_IS_STARTED_BIT))
     {
@@ -384,7 +428,7 @@ bool AnimationClip::update(unsigned long elapsedTime, std::list<AnimationTarget*
     }
 
     // Add back in start time, and divide by the total animation's duration to get the actual percentage complete
-    float percentComplete = (float)(_startTime + currentTime) / (float) _animation->_duration;
+    _percentComplete = (float)(_startTime + currentTime) / (float) _animation->_duration;
     
     if (isClipStateBitSet(CLIP_IS_FADING_OUT_BIT))
     {
@@ -428,30 +472,134 @@ bool AnimationClip::update(unsigned long elapsedTime, std::list<AnimationTarget*
         }
     }
     
-    // Evaluate this clip.
+    return ADVANCE_EVALUATE;
+}
+
+void AnimationClip::evaluate()
+{
+    unsigned int channelCount = _animation->_channels.size();
+    _evaluatedChannelCount = 0;
+    _skippedChannelCount = 0;
+    if (_lodCulled)
+    {
+        _skippedChannelCount = channelCount;
+        return;
+    }
+
+    bool interpolate = _lodInterval > 1;
+    float t = (float)(_lodFrame + 1) / (float)_lodInterval;
+    for (unsigned int i = 0; i < channelCount; i++)
+    {
+        Animation::Channel* channel = _animation->_channels[i];
+        if (channel->_target->_maxAnimationLod < _lodLevel)
+        {
+            _skippedChannelCount++;
+            continue;
+        }
+
+        Curve* curve = channel->getCurve();
+        AnimationValue* value = _values[i];
+        if (_lodSample)
+        {
+            // Keep the last sample to interpolate from until the next one.
+            if (interpolate)
+                memcpy(_lodPreviousValues[i]->_value, value->_value, value->_componentCount * sizeof(float));
+
+            // Evaluate the point on Curve, resuming from the segment used on the previous update.
+            curve->evaluate(_percentComplete, value->_value, &_cursors[i]);
+            _evaluatedChannelCount++;
+
+            if (interpolate && _lodReset)
+                memcpy(_lodPreviousValues[i]->_value, value->_value, value->_componentCount * sizeof(float));
+        }
+        else
+        {
+            _skippedChannelCount++;
+        }
+
+        if (interpolate)
+            interpolateValue(curve, t, _lodPreviousValues[i]->_value, value->_value, _lodValues[i]->_value);
+    }
+
+    if (_lodSample)
+        _lodReset = false;
+}
+
+void AnimationClip::apply()
+{
+    if (_lodCulled)
+        return;
+
+    AnimationController* controller = _animation->_controller;
     Animation::Channel* channel = NULL;
-    AnimationValue* value = NULL;
-    AnimationTarget* target = NULL;
     unsigned int channelCount = _animation->_channels.size();
     for (unsigned int i = 0; i < channelCount; i++)
     {
         channel = _animation->_channels[i];
-        target = channel->_target;
-        value = _values[i];
+        if (channel->_target->_maxAnimationLod < _lodLevel)
+            continue;
+
+        AnimationValue* value = _lodInterval > 1 ? _lodValues[i] : _values[i];
+        controller->applyAnimationValue(channel->_target, channel->_propertyId, value, _blendWeight);
+    }
+}
+
+void AnimationClip::setLod(unsigned int level, unsigned int updateInterval, bool culled)
+{
+    if (culled)
+    {
+        // Start over with a new sample once the clip is visible again.
+        _lodCulled = true;
+        _lodSample = false;
+        _lodReset = true;
+        return;
+    }
+    _lodCulled = false;
+
+    if (level != _lodLevel || updateInterval != _lodInterval)
+    {
+        _lodLevel = level;
+        _lodInterval = updateInterval;
+        _lodReset = true;
+
+        if (_lodInterval > 1 && _lodValues.empty())
+        {
+            for (unsigned int i = 0, count = _values.size(); i < count; i++)
+            {
+                _lodPreviousValues.push_back(new AnimationValue(_values[i]->_componentCount));
+                _lodValues.push_back(new AnimationValue(_values[i]->_componentCount));
+            }
+        }
+    }
+
+    if (_lodReset || ++_lodFrame >= _lodInterval)
+    {
+        _lodFrame = 0;
+        _lodSample = true;
+    }
+    else
+    {
+        _lodSample = false;
+    }
+}
 
-        // If the target's _animationPropertyBitFlag is clear, we can assume that this is the first
-        // animation channel to act on the target and we can add the target to the list of
-        // active targets stored by the AnimationController.
-        if (target->_animationPropertyBitFlag == 0x00)
-            activeTargets->push_front(target);
+void AnimationClip::interpolateValue(Curve* curve, float t, float* from, float* to, float* dst)
+{
+    for (unsigned int i = 0, count = curve->getComponentCount(); i < count; i++)
+    {
+        dst[i] = Curve::lerp(t, from[i], to[i]);
+    }
 
-        // Evaluate the point on Curve
-        channel->getCurve()->evaluate(percentComplete, value->_value);
-        // Set the animation value on the target property.
-        target->setAnimationPropertyValue(channel->_propertyId, value, _blendWeight);
+    if (curve->_quaternionOffset)
+    {
+        unsigned int offset = *curve->_quaternionOffset;
+        curve->interpolateQuaternion(t, from + offset, to + offset, dst + offset);
     }
+}
 
-    // When ended. Probably should move to it's own method so we can call it when the clip is ended early.
+bool AnimationClip::endUpdate()
+{
+    // The clip has ended if it was stopped during this update or has played to completion.
     if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT) || !isClipStateBitSet(CLIP_IS_STARTED_BIT))
     {
         onEnd();
@@ -465,6 +613,7 @@ void AnimationClip::onBegin()
 {
     // Initialize animation to play.
     setClipStateBit(CLIP_IS_STARTED_BIT);
+    _lodReset = true;
     if (_speed >= 0)
     {
         _elapsedTime = (Game::getGameTime() - _timeStarted) * _speed;
@@ -11,6 +11,7 @@ namespace gameplay
 
 class Animation;
 class AnimationValue;
+class Node;
 
 /**
  * Defines the runtime session of an Animation to be played.
@@ -19,6 +20,7 @@ class AnimationClip : public Ref
 {
     friend class AnimationController;
     friend class Animation;
+    friend class Node;
 
 public:
 
@@ -227,6 +229,33 @@ public:
      */
     void addListener(AnimationClip::Listener* listener, unsigned long eventTime);
 
+    /**
+     * Sets the node that determines the clip's animation level of detail (LOD).
+     *
+     * This is typically the node of the model that the clip animates, such as the node of a
+     * skinned model rather than its joints. The node is not retained by the clip, since the node
+     * usually owns the clip through its animations. If the node is destroyed, the clip reverts
+     * to updating at full detail.
+     *
+     * @param node The node, or NULL to always update the clip at full detail (the default).
+     * @see AnimationController::setLodLevels
+     */
+    void setLodNode(Node* node);
+
+    /**
+     * Gets the node that determines the clip's animation level of detail.
+     *
+     * @return The node, or NULL if the clip is always updated at full detail.
+     */
+    Node* getLodNode() const;
+
+    /**
+     * Gets the level of detail the clip was last updated at.
+     *
+     * @return The LOD level, where 0 is full detail.
+     */
+    unsigned int getLodLevel() const;
+
 private:
     
     static const unsigned char CLIP_IS_PLAYING_BIT = 0x01;             // Bit representing whether AnimationClip is a running clip in AnimationController
@@ -281,9 +310,57 @@ private:
     ~AnimationClip();
 
     /**
-     * Updates the animation with the elapsed time.
+     * The result of advancing an AnimationClip's playback time.
+     */
+    enum AdvanceResult
+    {
+        ADVANCE_SKIP,       // The clip is paused and should not be evaluated.
+        ADVANCE_EVALUATE,   // The clip should be evaluated and applied.
+        ADVANCE_REMOVE      // The clip has ended and should be removed from the AnimationController.
+    };
+
+    /**
+     * Advances the playback time, calls any listeners that are due and updates cross fade blend weights.
+     *
+     * This is the first step of an update. It must be called from the main thread.
+     */
+    AdvanceResult advance(unsigned long elapsedTime);
+
+    /**
+     * Samples the curve of each channel into the clip's animation values at the time computed by advance().
+     *
+     * This is the second step of an update. It only writes to data owned by the clip, so
+     * different clips may be evaluated concurrently.
+     */
+    void evaluate();
+
+    /**
+     * Applies the clip's evaluated animation values to the animation targets through the AnimationController.
+     *
+     * This is the third step of an update. It must be called from the main thread.
+     */
+    void apply();
+
+    /**
+     * Sets the level of detail of the clip for the current update and decides whether its curves are sampled.
+     *
+     * This must be called from the main thread, between advance() and evaluate().
+     */
+    void setLod(unsigned int level, unsigned int updateInterval, bool culled);
+
+    /**
+     * Interpolates the values of a channel between two samples of its curve.
+     */
+    static void interpolateValue(Curve* curve, float t, float* from, float* to, float* dst);
+
+    /**
+     * Ends the clip if it was stopped or has completed.
+     *
+     * This is the last step of an update. It must be called from the main thread.
+     *
+     * @return true if the clip has ended and should be removed from the AnimationController.
      */
-    bool update(unsigned long elapsedTime, std::list<AnimationTarget*>* activeTargets);
+    bool endUpdate();
 
     /**
      * Handles when the AnimationClip begins.
@@ -325,7 +402,20 @@ private:
     unsigned long _crossFadeOutElapsed;                 // The amount of time that has elapsed for the crossfade.
     unsigned long _crossFadeOutDuration;                // The duration of the cross fade.
     float _blendWeight;                                 // The clip's blendweight.
+    float _percentComplete;                             // The position within the animation to evaluate the clip at.
     std::vector<AnimationValue*> _values;               // AnimationValue holder.
+    std::vector<unsigned int> _cursors;                 // The keyframe segment last evaluated on each channel's curve.
+    Node* _lodNode;                                     // The node that determines the clip's level of detail.
+    unsigned int _lodLevel;                             // The current level of detail.
+    unsigned int _lodInterval;                          // The number of updates between samples at the current level of detail.
+    unsigned int _lodFrame;                             // The number of updates since the curves were last sampled.
+    bool _lodCulled;                                    // Whether the LOD node is outside the view frustum on the current update.
+    bool _lodSample;                                    // Whether the curves are sampled on the current update.
+    bool _lodReset;                                     // Whether the next sample starts over rather than interpolating from the last one.
+    std::vector<AnimationValue*> _lodPreviousValues;    // The values of the previous sample, to interpolate from.
+    std::vector<AnimationValue*> _lodValues;            // The interpolated values applied when sampling less than once per update.
+    unsigned int _evaluatedChannelCount;                // The number of channels sampled on the current update.
+    unsigned int _skippedChannelCount;                  // The number of channels not sampled on the current update.
     std::vector<Listener*>* _beginListeners;            // Collection of begin listeners on the clip.
     std::vector<Listener*>* _endListeners;              // Collection of end listeners on the clip.
     std::list<ListenerEvent*>* _listeners;              // Ordered collection of listeners on the clip.
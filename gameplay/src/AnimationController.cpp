@@ -2,17 +2,22 @@
 #include "AnimationController.h"
 #include "Game.h"
 #include "Curve.h"
+#include "Transform.h"
+#include "Node.h"
+#include "Scene.h"
+#include "Camera.h"
 
 namespace gameplay
 {
 
 AnimationController::AnimationController()
-    : _state(STOPPED)
+    : _state(STOPPED), _threadPool(NULL), _evaluatedChannelCount(0), _skippedChannelCount(0)
 {
 }
 
 AnimationController::~AnimationController()
 {
+    SAFE_DELETE(_threadPool);
 }
 
 void AnimationController::stopAllAnimations() 
@@ -26,6 +31,24 @@ void AnimationController::stopAllAnimations()
     }
 }
 
+unsigned int AnimationController::getThreadCount() const
+{
+    return _threadPool ? _threadPool->getThreadCount() : 1;
+}
+
+void AnimationController::setThreadCount(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+
+    if (threadCount == getThreadCount())
+        return;
+
+    SAFE_DELETE(_threadPool);
+    if (threadCount > 1)
+        _threadPool = ThreadPool::create(threadCount);
+}
+
 AnimationController::State AnimationController::getState() const
 {
     return _state;
@@ -91,12 +114,42 @@ void AnimationController::unschedule(AnimationClip* clip)
         _state = IDLE;
 }
 
+void AnimationController::setLodLevels(unsigned int count, const float* minScreenSizes, const unsigned int* updateIntervals)
+{
+    assert(count == 0 || (minScreenSizes && updateIntervals));
+
+    _lodScreenSizes.assign(minScreenSizes, minScreenSizes + count);
+    _lodUpdateIntervals.resize(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        _lodUpdateIntervals[i] = std::max(updateIntervals[i], 1u);
+    }
+}
+
+unsigned int AnimationController::getLodLevelCount() const
+{
+    return _lodScreenSizes.size();
+}
+
+unsigned int AnimationController::getEvaluatedChannelCount() const
+{
+    return _evaluatedChannelCount;
+}
+
+unsigned int AnimationController::getSkippedChannelCount() const
+{
+    return _skippedChannelCount;
+}
+
 void AnimationController::update(long elapsedTime)
 {
+    _evaluatedChannelCount = 0;
+    _skippedChannelCount = 0;
+
     if (_state != RUNNING)
         return;
 
-    // Loop through running clips and call update() on them.
+    // Advance the running clips on the main thread, collecting the ones to evaluate.
     std::list<AnimationClip*>::iterator clipIter = _runningClips.begin();
     while (clipIter != _runningClips.end())
     {
@@ -108,30 +161,173 @@ void AnimationController::update(long elapsedTime)
             clip->setClipStateBit(AnimationClip::CLIP_IS_PLAYING_BIT);
             _runningClips.push_back(clip);
             clipIter = _runningClips.erase(clipIter);
+            continue;
         }
-        else if (clip->update(elapsedTime, &_activeTargets))
+
+        switch (clip->advance(elapsedTime))
         {
-            SAFE_RELEASE(clip);
-            clipIter = _runningClips.erase(clipIter);
+            case AnimationClip::ADVANCE_REMOVE:
+                SAFE_RELEASE(clip);
+                clipIter = _runningClips.erase(clipIter);
+                continue;
+            case AnimationClip::ADVANCE_EVALUATE:
+                updateLod(clip);
+
+                // Hold a reference in case a listener unschedules the clip before it is applied.
+                clip->addRef();
+                _evaluateClips.push_back(clip);
+                break;
+            default:
+                break;
         }
-        else
+        clipIter++;
+    }
+
+    // Sample the curves of all clips, on the thread pool if there is one.
+    if (_threadPool)
+    {
+        _threadPool->run(evaluateClip, this, _evaluateClips.size());
+    }
+    else
+    {
+        for (unsigned int i = 0; i < _evaluateClips.size(); i++)
         {
-            clipIter++;
+            evaluateClip(this, i);
         }
     }
 
-    // Loop through active AnimationTarget's and reset their _animationPropertyBitFlag for the next frame.
-    std::list<AnimationTarget*>::iterator targetItr = _activeTargets.begin();
-    while (targetItr != _activeTargets.end())
+    // Blend the sampled values in schedule order so that blending is deterministic.
+    for (unsigned int i = 0; i < _evaluateClips.size(); i++)
     {
-        AnimationTarget* target = (*targetItr);
-        target->_animationPropertyBitFlag = 0x00;
-        targetItr++;
+        AnimationClip* clip = _evaluateClips[i];
+        clip->apply();
+        _evaluatedChannelCount += clip->_evaluatedChannelCount;
+        _skippedChannelCount += clip->_skippedChannelCount;
     }
-    _activeTargets.clear();
-    
+
+    // Write the blended poses back to the targets before any end listener can observe them.
+    commitPoses();
+
+    for (unsigned int i = 0; i < _evaluateClips.size(); i++)
+    {
+        AnimationClip* clip = _evaluateClips[i];
+        if (clip->endUpdate())
+        {
+            std::list<AnimationClip*>::iterator itr = std::find(_runningClips.begin(), _runningClips.end(), clip);
+            if (itr != _runningClips.end())
+            {
+                _runningClips.erase(itr);
+                clip->release();
+            }
+        }
+        SAFE_RELEASE(clip);
+    }
+    _evaluateClips.clear();
+
     if (_runningClips.empty())
         _state = IDLE;
 }
 
+void AnimationController::updateLod(AnimationClip* clip)
+{
+    Node* node = clip->_lodNode;
+    Scene* scene = node ? node->getScene() : NULL;
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (!camera || !camera->getNode())
+    {
+        clip->setLod(0, 1, false);
+        return;
+    }
+
+    const BoundingSphere& sphere = node->getBoundingSphere();
+    if (!sphere.isEmpty() && !camera->getFrustum().intersects(sphere))
+    {
+        clip->setLod(0, 1, true);
+        return;
+    }
+
+    unsigned int levelCount = _lodScreenSizes.size();
+    if (levelCount == 0)
+    {
+        clip->setLod(0, 1, false);
+        return;
+    }
+
+    // Measure the diameter of the bounding sphere relative to the height of the view at its distance.
+    float viewHeight;
+    if (camera->getCameraType() == Camera::PERSPECTIVE)
+    {
+        float distance = sphere.center.distance(camera->getNode()->getTranslationWorld());
+        viewHeight = 2.0f * distance * tan(MATH_DEG_TO_RAD(camera->getFieldOfView()) * 0.5f);
+    }
+    else
+    {
+        viewHeight = camera->getZoomY();
+    }
+    float screenSize = viewHeight > 0.0f ? 2.0f * sphere.radius / viewHeight : _lodScreenSizes[0];
+
+    unsigned int level = levelCount - 1;
+    for (unsigned int i = 0; i < levelCount - 1; i++)
+    {
+        if (screenSize >= _lodScreenSizes[i])
+        {
+            level = i;
+            break;
+        }
+    }
+    clip->setLod(level, _lodUpdateIntervals[level], false);
+}
+
+void AnimationController::applyAnimationValue(AnimationTarget* target, int propertyId, AnimationValue* value, float blendWeight)
+{
+    // If the target's _animationPropertyBitFlag is clear, we can assume that this is the first
+    // animation channel to act on the target during this update.
+    if (target->_animationPropertyBitFlag == 0x00)
+    {
+        _activeTargets.push_back(target);
+        if (target->_targetType == AnimationTarget::TRANSFORM)
+        {
+            static_cast<Transform*>(target)->_animationPoseIndex = _poses.size();
+            _poses.push_back(Pose());
+        }
+    }
+
+    if (target->_targetType == AnimationTarget::TRANSFORM)
+    {
+        // Transforms are blended into their pose, so that they only change once per update.
+        Transform* transform = static_cast<Transform*>(target);
+        Pose& pose = _poses[transform->_animationPoseIndex];
+        transform->blendAnimationValue(propertyId, value, blendWeight, &pose.scale, &pose.rotation, &pose.translation);
+    }
+    else
+    {
+        target->setAnimationPropertyValue(propertyId, value, blendWeight);
+    }
+}
+
+void AnimationController::commitPoses()
+{
+    for (unsigned int i = 0; i < _activeTargets.size(); i++)
+    {
+        AnimationTarget* target = _activeTargets[i];
+        if (target->_targetType == AnimationTarget::TRANSFORM)
+        {
+            Transform* transform = static_cast<Transform*>(target);
+            const Pose& pose = _poses[transform->_animationPoseIndex];
+            transform->commitAnimationPose(pose.scale, pose.rotation, pose.translation);
+        }
+
+        // Reset the target's _animationPropertyBitFlag for the next frame.
+        target->_animationPropertyBitFlag = 0x00;
+    }
+    _activeTargets.clear();
+    _poses.clear();
+}
+
+void AnimationController::evaluateClip(void* cookie, unsigned int index)
+{
+    AnimationController* controller = static_cast<AnimationController*>(cookie);
+    controller->_evaluateClips[index]->evaluate();
+}
+
 }
@@ -5,6 +5,9 @@
 #include "Animation.h"
 #include "AnimationTarget.h"
 #include "Properties.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+#include "Quaternion.h"
 
 namespace gameplay
 {
@@ -25,6 +28,78 @@ public:
      * Stops all AnimationClips currently playing on the AnimationController.
      */
     void stopAllAnimations();
+
+    /**
+     * Gets the number of threads used to evaluate animation clips.
+     *
+     * @return The thread count, including the main thread.
+     * @see setThreadCount(unsigned int)
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Sets the number of threads used to evaluate animation clips.
+     *
+     * Each update is split into steps: clip playback times, listeners and cross fades are
+     * advanced on the main thread; the curves of all running clips are then sampled; finally
+     * the sampled values are blended on the main thread, in the order the clips were scheduled.
+     * Transforms are blended into a pose buffer and each animated transform is written and
+     * notifies its listeners once per update, before the end listeners of the clips are called.
+     *
+     * By default the curves are sampled on the main thread. With more than one thread, they
+     * are sampled in parallel on a pool of worker threads, and the blended results are the same.
+     *
+     * @param threadCount The number of threads to use, including the main thread. A value of 1
+     *      updates serially. A value of 0 uses one thread for each processor.
+     */
+    void setThreadCount(unsigned int threadCount);
+
+    /**
+     * Sets the animation level of detail (LOD) levels.
+     *
+     * Clips that have a LOD node (see AnimationClip::setLodNode) select a level on each update
+     * from the size of the node's bounding sphere on screen, as seen by the active camera of the
+     * node's scene. The screen size is the fraction of the viewport height covered by the diameter
+     * of the sphere. Level i is used when the screen size is at least minScreenSizes[i] and no
+     * lower level applies; the last level is used for all smaller sizes.
+     *
+     * At level i a clip samples its curves once every updateIntervals[i] updates, and on the
+     * updates in between it applies values interpolated between its last two samples. This delays
+     * its motion by up to updateIntervals[i] - 1 updates. Channels whose target only animates up
+     * to a lower level are not updated at all (see AnimationTarget::setMaxAnimationLod).
+     *
+     * Regardless of the levels, clips whose LOD node is outside the view frustum of the active
+     * camera are neither sampled nor applied, although their playback time still advances.
+     *
+     * @param count The number of levels, or 0 to update all visible clips at full detail (the default).
+     * @param minScreenSizes The minimum screen size of each level, in decreasing order.
+     * @param updateIntervals The number of updates between samples for each level. A value of 1 samples on every update.
+     */
+    void setLodLevels(unsigned int count, const float* minScreenSizes, const unsigned int* updateIntervals);
+
+    /**
+     * Gets the number of animation level of detail levels.
+     *
+     * @return The number of levels.
+     * @see setLodLevels
+     */
+    unsigned int getLodLevelCount() const;
+
+    /**
+     * Gets the number of animation channels whose curves were sampled on the last update.
+     *
+     * @return The number of channels sampled.
+     */
+    unsigned int getEvaluatedChannelCount() const;
+
+    /**
+     * Gets the number of animation channels of running clips whose curves were not sampled on
+     * the last update, because the clip was culled or interpolated between samples, or because
+     * the channel's target does not animate at the clip's level of detail.
+     *
+     * @return The number of channels skipped.
+     */
+    unsigned int getSkippedChannelCount() const;
        
 private:
 
@@ -95,10 +170,51 @@ private:
      * Callback for when the controller receives a frame update event.
      */
     void update(long elapsedTime);
+
+    /**
+     * Selects the level of detail of a clip for the current update.
+     */
+    void updateLod(AnimationClip* clip);
+
+    /**
+     * Applies an animation value of a clip to its target.
+     *
+     * Values for transforms are blended into the transform's pose for the current update
+     * instead of being set on the transform.
+     */
+    void applyAnimationValue(AnimationTarget* target, int propertyId, AnimationValue* value, float blendWeight);
+
+    /**
+     * Writes the blended pose of each animating transform back to it, with one transform
+     * change per transform, and clears the active targets for the next update.
+     */
+    void commitPoses();
+
+    /**
+     * Thread pool task that samples the curves of the clip at the given index of _evaluateClips.
+     */
+    static void evaluateClip(void* cookie, unsigned int index);
     
+    /**
+     * The blended local scale, rotation and translation of an animating transform.
+     */
+    struct Pose
+    {
+        Vector3 scale;
+        Quaternion rotation;
+        Vector3 translation;
+    };
+
     State _state;                                 // The current state of the AnimationController.
     std::list<AnimationClip*> _runningClips;      // A list of running AnimationClips.
-    std::list<AnimationTarget*> _activeTargets;   // A list of animating AnimationTargets.
+    std::vector<AnimationTarget*> _activeTargets; // A list of animating AnimationTargets.
+    ThreadPool* _threadPool;                      // The worker threads used to sample clips, or NULL to update serially.
+    std::vector<AnimationClip*> _evaluateClips;   // The clips to sample on the current update.
+    std::vector<Pose> _poses;                     // The poses of the animating transforms, indexed by Transform::_animationPoseIndex.
+    std::vector<float> _lodScreenSizes;           // The minimum screen size of each LOD level.
+    std::vector<unsigned int> _lodUpdateIntervals;// The number of updates between samples at each LOD level.
+    unsigned int _evaluatedChannelCount;          // The number of channels sampled on the last update.
+    unsigned int _skippedChannelCount;            // The number of channels not sampled on the last update.
 };
 
 }
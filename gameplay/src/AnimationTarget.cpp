@@ -8,7 +8,7 @@ namespace gameplay
 {
 
 AnimationTarget::AnimationTarget()
-    : _targetType(SCALAR), _animationPropertyBitFlag(0x00), _animationChannels(NULL)
+    : _targetType(SCALAR), _animationPropertyBitFlag(0x00), _maxAnimationLod(std::numeric_limits<unsigned int>::max()), _animationChannels(NULL)
 {
 }
 
@@ -388,8 +388,20 @@ Animation::Channel* AnimationTarget::getChannel(const char* id) const
     return NULL;
 }
 
+void AnimationTarget::setMaxAnimationLod(unsigned int level)
+{
+    _maxAnimationLod = level;
+}
+
+unsigned int AnimationTarget::getMaxAnimationLod() const
+{
+    return _maxAnimationLod;
+}
+
 void AnimationTarget::cloneInto(AnimationTarget* target, NodeCloneContext &context) const
 {
+    target->_maxAnimationLod = _maxAnimationLod;
+
     if (_animationChannels)
     {
         for (std::vector<Animation::Channel*>::const_iterator it = _animationChannels->begin(); it != _animationChannels->end(); ++it)
@@ -144,6 +144,25 @@ public:
      */
     Animation* getAnimation(const char* id = NULL) const;
 
+    /**
+     * Sets the coarsest animation level of detail (LOD) at which this target is animated.
+     *
+     * Clips updated at a coarser level skip their channels for this target, leaving it at its
+     * last animated value. This is useful to stop animating fine details of distant models,
+     * such as the finger joints of a skeleton.
+     *
+     * @param level The coarsest LOD level at which the target is animated. The default animates the target at every level.
+     * @see AnimationController::setLodLevels
+     */
+    void setMaxAnimationLod(unsigned int level);
+
+    /**
+     * Gets the coarsest animation level of detail at which this target is animated.
+     *
+     * @return The coarsest LOD level at which the target is animated.
+     */
+    unsigned int getMaxAnimationLod() const;
+
 protected:
     
     /**
@@ -207,6 +226,11 @@ protected:
      */ 
     unsigned char _animationPropertyBitFlag;
 
+    /**
+     * The coarsest animation level of detail at which the target is animated.
+     */
+    unsigned int _maxAnimationLod;
+
 private:
 
     /**
@@ -50,11 +50,73 @@ AudioBuffer* AudioBuffer::create(const char* path)
     assert(path);
 
     // Search the cache for a stream from this file.
+    AudioBuffer* buffer = find(path);
+    if (buffer)
+        return buffer;
+
+#ifndef __ANDROID__
+    PCMData pcm;
+    if (!decode(path, &pcm))
+        return NULL;
+
+    return create(path, &pcm);
+#else
+    // Get the file header in order to determine the type.
+    AAsset* asset = AAssetManager_open(__assetManager, path, AASSET_MODE_RANDOM);
+    char header[12];
+    if (AAsset_read(asset, header, 12) != 12)
+    {
+        LOG_ERROR_VARG("Invalid audio buffer file: %s", path);
+        return NULL;
+    }
+
+    // Get the file descriptor for the audio file.
+    off_t start, length;
+    int fd = AAsset_openFileDescriptor(asset, &start, &length);
+    if (fd < 0)
+    {
+        LOG_ERROR_VARG("Failed to open file descriptor for asset: %s", path);
+        return NULL;
+    }
+    AAsset_close(asset);
+    SLDataLocator_AndroidFD data = {SL_DATALOCATOR_ANDROIDFD, fd, start, length};
+
+    // Set the appropriate mime type information.
+    SLDataFormat_MIME mime;
+    mime.formatType = SL_DATAFORMAT_MIME;
+    std::string pathStr = path;
+    if (memcmp(header, "RIFF", 4) == 0)
+    {
+        mime.mimeType = (SLchar*)"audio/x-wav";
+        mime.containerType = SL_CONTAINERTYPE_WAV;
+    }
+    else if (memcmp(header, "OggS", 4) == 0)
+    {
+        mime.mimeType = (SLchar*)"application/ogg";
+        mime.containerType = SL_CONTAINERTYPE_OGG;
+    }
+    else
+    {
+        LOG_ERROR_VARG("Unsupported audio file: %s", path);
+    }
+
+    buffer = new AudioBuffer(path);
+    buffer->_data = data;
+    buffer->_mime = mime;
+
+    // Add the buffer to the cache.
+    __buffers.push_back(buffer);
+
+    return buffer;
+#endif
+}
+
+AudioBuffer* AudioBuffer::find(const char* path)
+{
     unsigned int bufferCount = (unsigned int)__buffers.size();
-    AudioBuffer* buffer = NULL;
     for (unsigned int i = 0; i < bufferCount; i++)
     {
-        buffer = __buffers[i];
+        AudioBuffer* buffer = __buffers[i];
         if (buffer->_filePath.compare(path) == 0)
         {
             buffer->addRef();
@@ -62,26 +124,30 @@ AudioBuffer* AudioBuffer::create(const char* path)
         }
     }
 
+    return NULL;
+}
+
 #ifndef __ANDROID__
-    ALuint alBuffer;
-    ALCenum al_error;
+AudioBuffer::PCMData::PCMData() : format(0), frequency(0), data(NULL), size(0)
+{
+}
+
+AudioBuffer::PCMData::~PCMData()
+{
+    SAFE_DELETE_ARRAY(data);
+}
+
+bool AudioBuffer::decode(const char* path, PCMData* pcm)
+{
+    assert(path);
+    assert(pcm);
 
-    // Load audio data into a buffer.
-    alGenBuffers(1, &alBuffer);
-    al_error = alGetError();
-    if (al_error != AL_NO_ERROR)
-    {
-        LOG_ERROR_VARG("AudioBuffer alGenBuffers AL error: %d", al_error);
-        alDeleteBuffers(1, &alBuffer);
-        return NULL;
-    }
-    
     // Load sound file.
     FILE* file = FileSystem::openFile(path, "rb");
     if (!file)
     {
         LOG_ERROR_VARG("Invalid audio buffer file: %s", path);
-        goto cleanup;
+        return false;
     }
     
     // Read the file header
@@ -89,100 +155,73 @@ AudioBuffer* AudioBuffer::create(const char* path)
     if (fread(header, 1, 12, file) != 12)
     {
         LOG_ERROR_VARG("Invalid audio buffer file: %s", path);
-        goto cleanup;
+        fclose(file);
+        return false;
     }
     
     // Check the file format
     if (memcmp(header, "RIFF", 4) == 0)
     {
-        if (!AudioBuffer::loadWav(file, alBuffer))
+        bool result = AudioBuffer::loadWav(file, pcm);
+        fclose(file);
+        if (!result)
         {
             LOG_ERROR_VARG("Invalid wave file: %s", path);
-            goto cleanup;
+            return false;
         }
     }
     else if (memcmp(header, "OggS", 4) == 0)
     {
-        if (!AudioBuffer::loadOgg(file, alBuffer))
+        if (!AudioBuffer::loadOgg(file, pcm))
         {
             LOG_ERROR_VARG("Invalid ogg file: %s", path);
-            goto cleanup;
+            return false;
         }
     }
     else
     {
         LOG_ERROR_VARG("Unsupported audio file: %s", path);
+        fclose(file);
+        return false;
     }
-    
-    fclose(file);
 
-    buffer = new AudioBuffer(path, alBuffer);
+    return true;
+}
 
-    // Add the buffer to the cache.
-    __buffers.push_back(buffer);
+AudioBuffer* AudioBuffer::create(const char* path, const PCMData* pcm)
+{
+    assert(path);
+    assert(pcm);
 
-    return buffer;
-    
-cleanup:
-    
-    if (file)
-        fclose(file);
-    if (alBuffer)
-        alDeleteBuffers(1, &alBuffer);
-    return NULL;
-#else
-    // Get the file header in order to determine the type.
-    AAsset* asset = AAssetManager_open(__assetManager, path, AASSET_MODE_RANDOM);
-    char header[12];
-    if (AAsset_read(asset, header, 12) != 12)
-    {
-        LOG_ERROR_VARG("Invalid audio buffer file: %s", path);
-        return NULL;
-    }
+    // The buffer may have been created while the sample data was being decoded.
+    AudioBuffer* buffer = find(path);
+    if (buffer)
+        return buffer;
 
-    // Get the file descriptor for the audio file.
-    off_t start, length;
-    int fd = AAsset_openFileDescriptor(asset, &start, &length);
-    if (fd < 0)
+    ALuint alBuffer;
+    ALCenum al_error;
+
+    // Load audio data into a buffer.
+    alGenBuffers(1, &alBuffer);
+    al_error = alGetError();
+    if (al_error != AL_NO_ERROR)
     {
-        LOG_ERROR_VARG("Failed to open file descriptor for asset: %s", path);
+        LOG_ERROR_VARG("AudioBuffer alGenBuffers AL error: %d", al_error);
+        alDeleteBuffers(1, &alBuffer);
         return NULL;
     }
-    AAsset_close(asset);
-    SLDataLocator_AndroidFD data = {SL_DATALOCATOR_ANDROIDFD, fd, start, length};
 
-    // Set the appropriate mime type information.
-    SLDataFormat_MIME mime;
-    mime.formatType = SL_DATAFORMAT_MIME;
-    std::string pathStr = path;
-    if (memcmp(header, "RIFF", 4) == 0)
-    {
-        mime.mimeType = (SLchar*)"audio/x-wav";
-        mime.containerType = SL_CONTAINERTYPE_WAV;
-    }
-    else if (memcmp(header, "OggS", 4) == 0)
-    {
-        mime.mimeType = (SLchar*)"application/ogg";
-        mime.containerType = SL_CONTAINERTYPE_OGG;
-    }
-    else
-    {
-        LOG_ERROR_VARG("Unsupported audio file: %s", path);
-    }
+    alBufferData(alBuffer, pcm->format, pcm->data, pcm->size, pcm->frequency);
 
-    buffer = new AudioBuffer(path);
-    buffer->_data = data;
-    buffer->_mime = mime;
+    buffer = new AudioBuffer(path, alBuffer);
 
     // Add the buffer to the cache.
     __buffers.push_back(buffer);
 
     return buffer;
-#endif
 }
 
-#ifndef __ANDROID__
-bool AudioBuffer::loadWav(FILE* file, ALuint buffer)
+bool AudioBuffer::loadWav(FILE* file, PCMData* pcm)
 {
     unsigned char stream[12];
     
@@ -306,12 +345,14 @@ bool AudioBuffer::loadWav(FILE* file, ALuint buffer)
         return false;
     }
 
-    alBufferData(buffer, format, data, dataSize, frequency);
-    SAFE_DELETE_ARRAY(data);
+    pcm->format = format;
+    pcm->frequency = frequency;
+    pcm->data = data;
+    pcm->size = dataSize;
     return true;
 }
     
-bool AudioBuffer::loadOgg(FILE* file, ALuint buffer)
+bool AudioBuffer::loadOgg(FILE* file, PCMData* pcm)
 {
     OggVorbis_File ogg_file;
     vorbis_info* info;
@@ -350,6 +391,7 @@ bool AudioBuffer::loadOgg(FILE* file, ALuint buffer)
         else if (result < 0)
         {
             SAFE_DELETE_ARRAY(data);
+            ov_clear(&ogg_file);
             LOG_ERROR("OGG file missing data.");
             return false;
         }
@@ -362,17 +404,18 @@ bool AudioBuffer::loadOgg(FILE* file, ALuint buffer)
     if (size == 0)
     {
         SAFE_DELETE_ARRAY(data);
+        ov_clear(&ogg_file);
         LOG_ERROR("Unable to read OGG data.");
         return false;
     }
 
-    alBufferData(buffer, format, data, data_size, info->rate);
-
-    SAFE_DELETE_ARRAY(data);
-    ov_clear(&ogg_file);
+    pcm->format = format;
+    pcm->frequency = info->rate;
+    pcm->data = data;
+    pcm->size = data_size;
 
     // ov_clear actually closes the file pointer as well
-    file = 0;
+    ov_clear(&ogg_file);
 
     return true;
 }
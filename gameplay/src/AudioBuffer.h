@@ -16,6 +16,7 @@ class AudioSource;
 class AudioBuffer : public Ref
 {
     friend class AudioSource;
+    friend class ResourceLoader;
 
 private:
     
@@ -44,11 +45,58 @@ private:
      * @return The buffer from a file.
      */
     static AudioBuffer* create(const char* path);
+
+    /**
+     * Finds an audio buffer loaded from the given path in the cache.
+     *
+     * @param path The path the buffer was loaded from.
+     *
+     * @return The cached buffer with an added reference, or NULL if it is not cached.
+     */
+    static AudioBuffer* find(const char* path);
     
 #ifndef __ANDROID__
-    static bool loadWav(FILE* file, ALuint buffer);
+    /**
+     * Decoded sample data, ready to be copied into an OpenAL buffer.
+     */
+    struct PCMData
+    {
+        PCMData();
+        ~PCMData();
+
+        ALenum format;
+        ALsizei frequency;
+        char* data;
+        unsigned int size;
+    };
+
+    /**
+     * Reads and decodes an audio file. This does not call into OpenAL, so it may
+     * be called from a background thread.
+     *
+     * @param path The path to the audio file on the filesystem.
+     * @param pcm The decoded sample data.
+     *
+     * @return true if the file was decoded, false otherwise.
+     */
+    static bool decode(const char* path, PCMData* pcm);
+
+    /**
+     * Creates an audio buffer from decoded sample data and adds it to the cache.
+     *
+     * @param path The path the sample data was loaded from.
+     * @param pcm The decoded sample data.
+     *
+     * @return The buffer, or NULL if the OpenAL buffer could not be created.
+     */
+    static AudioBuffer* create(const char* path, const PCMData* pcm);
+
+    static bool loadWav(FILE* file, PCMData* pcm);
     
-    static bool loadOgg(FILE* file, ALuint buffer);
+    /**
+     * Decodes an Ogg Vorbis stream. The file is always closed by this method.
+     */
+    static bool loadOgg(FILE* file, PCMData* pcm);
 #endif
 
     std::string _filePath;
@@ -129,6 +129,13 @@ AudioSource* AudioSource::create(const char* path)
     if (buffer == NULL)
         return NULL;
 
+    return create(buffer);
+}
+
+AudioSource* AudioSource::create(AudioBuffer* buffer)
+{
+    assert(buffer);
+
 #ifndef __ANDROID__
     // Load the audio source.
     ALuint alSource = 0;
@@ -21,6 +21,7 @@ public:
 
     friend class Node;
     friend class AudioController;
+    friend class ResourceLoader;
 
     /**
      * The audio source's audio state.
@@ -164,6 +165,15 @@ private:
      */
     virtual ~AudioSource();
 
+    /**
+     * Creates an audio source that plays the given buffer.
+     *
+     * @param buffer The audio buffer. The audio source takes ownership of the caller's reference.
+     *
+     * @return The newly created audio source, or NULL if an audio source cannot be created.
+     */
+    static AudioSource* create(AudioBuffer* buffer);
+
     /**
      * Sets the node for this audio source.
      */
@@ -6,6 +6,7 @@
 #include <memory>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <cassert>
 #include <cwchar>
 #include <cwctype>
@@ -17,6 +18,7 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <deque>
 #include <set>
 #include <stack>
 #include <map>
@@ -151,6 +153,18 @@ extern void printError(const char* format, ...);
 #define M_1_PI                      0.31830988618379067154
 #endif
 
+// SIMD math kernels (see MathUtil.h). Define GAMEPLAY_NO_SIMD to force the scalar implementations.
+#ifndef GAMEPLAY_NO_SIMD
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define USE_SSE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#endif
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define USE_NEON
+#endif
+#endif
+
 #ifdef WIN32
     inline float round(float r)
     {
@@ -177,6 +191,9 @@ extern void printError(const char* format, ...);
 #elif __APPLE__
 #include <OpenAL/al.h>
 #include <OpenAL/alc.h>
+#elif __linux__
+#include <AL/al.h>
+#include <AL/alc.h>
 #endif
 #include <vorbis/vorbisfile.h>
 #endif
@@ -203,6 +220,7 @@ extern void printError(const char* format, ...);
     #define WIN32_LEAN_AND_MEAN
     #include <GL/glew.h>
     #define USE_VAO
+    #define USE_INSTANCED_ARRAYS
 #elif __APPLE__
     #include "TargetConditionals.h"
     #if TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR
@@ -227,6 +245,14 @@ extern void printError(const char* format, ...);
     #else
         #error "Unsupported Apple Device"
     #endif
+#elif __linux__
+    // The Linux platform creates its context through EGL without a display, which a GLX build of
+    // GLEW cannot load entry points for, so the GL entry points are linked directly instead.
+    #define GL_GLEXT_PROTOTYPES
+    #include <GL/gl.h>
+    #include <GL/glext.h>
+    #define USE_VAO
+    #define USE_INSTANCED_ARRAYS
 #endif
 
 // Graphics (GLSL)
@@ -0,0 +1,464 @@
+#include "Base.h"
+#include "BoundingVolumeTree.h"
+
+// The null node index.
+#define BVT_NULL_NODE -1
+
+// The fraction of a proxy's extents that its fat box is enlarged by on each side.
+#define BVT_FAT_MARGIN 0.1f
+
+namespace gameplay
+{
+
+/**
+ * Returns the surface area of a box, used as the cost of a node when inserting leaves.
+ */
+static float surfaceArea(const BoundingBox& box)
+{
+    float x = box.max.x - box.min.x;
+    float y = box.max.y - box.min.y;
+    float z = box.max.z - box.min.z;
+    return 2.0f * (x * y + y * z + z * x);
+}
+
+/**
+ * Returns the surface area of the union of two boxes.
+ */
+static float mergedSurfaceArea(const BoundingBox& a, const BoundingBox& b)
+{
+    BoundingBox box(a);
+    box.merge(b);
+    return surfaceArea(box);
+}
+
+/**
+ * Returns whether the first box contains the second one.
+ */
+static bool contains(const BoundingBox& a, const BoundingBox& b)
+{
+    return a.min.x <= b.min.x && a.min.y <= b.min.y && a.min.z <= b.min.z &&
+           a.max.x >= b.max.x && a.max.y >= b.max.y && a.max.z >= b.max.z;
+}
+
+/**
+ * Classifies a box against the planes of a frustum.
+ *
+ * @return Plane::INTERSECTS_BACK if the box is outside the frustum, Plane::INTERSECTS_FRONT
+ *      if it is entirely inside, and Plane::INTERSECTS_INTERSECTING otherwise.
+ */
+static int classify(const BoundingBox& box, const Plane* planes[6])
+{
+    Vector3 center((box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f);
+    Vector3 extent((box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f, (box.max.z - box.min.z) * 0.5f);
+
+    int result = Plane::INTERSECTS_FRONT;
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+        const Vector3& normal = planes[i]->getNormal();
+        float distance = planes[i]->distance(center);
+        float radius = fabsf(extent.x * normal.x) + fabsf(extent.y * normal.y) + fabsf(extent.z * normal.z);
+        if (distance < -radius)
+            return Plane::INTERSECTS_BACK;
+        if (distance <= radius)
+            result = Plane::INTERSECTS_INTERSECTING;
+    }
+    return result;
+}
+
+BoundingVolumeTree::BoundingVolumeTree() : _root(BVT_NULL_NODE), _freeList(BVT_NULL_NODE), _proxyCount(0)
+{
+}
+
+BoundingVolumeTree::BoundingVolumeTree(const BoundingVolumeTree& copy)
+{
+}
+
+BoundingVolumeTree::~BoundingVolumeTree()
+{
+}
+
+int BoundingVolumeTree::createProxy(const BoundingBox& box, void* userData)
+{
+    int proxy = allocateNode();
+    TreeNode& node = _nodes[proxy];
+
+    // Enlarge the box so that small movements do not change the tree.
+    Vector3 margin((box.max.x - box.min.x) * BVT_FAT_MARGIN, (box.max.y - box.min.y) * BVT_FAT_MARGIN, (box.max.z - box.min.z) * BVT_FAT_MARGIN);
+    node.box.set(box.min - margin, box.max + margin);
+    node.userData = userData;
+    node.height = 0;
+
+    insertLeaf(proxy);
+    ++_proxyCount;
+
+    return proxy;
+}
+
+void BoundingVolumeTree::destroyProxy(int proxy)
+{
+    assert(proxy >= 0 && proxy < (int)_nodes.size() && _nodes[proxy].height == 0);
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --_proxyCount;
+}
+
+bool BoundingVolumeTree::moveProxy(int proxy, const BoundingBox& box)
+{
+    assert(proxy >= 0 && proxy < (int)_nodes.size() && _nodes[proxy].height == 0);
+
+    if (contains(_nodes[proxy].box, box))
+        return false;
+
+    removeLeaf(proxy);
+
+    Vector3 margin((box.max.x - box.min.x) * BVT_FAT_MARGIN, (box.max.y - box.min.y) * BVT_FAT_MARGIN, (box.max.z - box.min.z) * BVT_FAT_MARGIN);
+    _nodes[proxy].box.set(box.min - margin, box.max + margin);
+
+    insertLeaf(proxy);
+
+    return true;
+}
+
+void* BoundingVolumeTree::getUserData(int proxy) const
+{
+    assert(proxy >= 0 && proxy < (int)_nodes.size());
+
+    return _nodes[proxy].userData;
+}
+
+unsigned int BoundingVolumeTree::getProxyCount() const
+{
+    return _proxyCount;
+}
+
+void BoundingVolumeTree::clear()
+{
+    _nodes.clear();
+    _root = BVT_NULL_NODE;
+    _freeList = BVT_NULL_NODE;
+    _proxyCount = 0;
+}
+
+unsigned int BoundingVolumeTree::query(const Frustum& frustum, std::vector<void*>& results) const
+{
+    if (_root == BVT_NULL_NODE)
+        return 0;
+
+    const Plane* planes[6] = { &frustum.getNear(), &frustum.getFar(), &frustum.getLeft(), &frustum.getRight(), &frustum.getBottom(), &frustum.getTop() };
+
+    unsigned int count = results.size();
+
+    // Each stack entry is a node index, negated and offset by one for subtrees known to be inside the frustum.
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty())
+    {
+        int entry = stack.back();
+        stack.pop_back();
+
+        bool inside = entry < 0;
+        int index = inside ? -entry - 1 : entry;
+        const TreeNode& node = _nodes[index];
+
+        if (!inside)
+        {
+            int result = classify(node.box, planes);
+            if (result == Plane::INTERSECTS_BACK)
+                continue;
+            inside = (result == Plane::INTERSECTS_FRONT);
+        }
+
+        if (node.height == 0)
+        {
+            results.push_back(node.userData);
+        }
+        else if (inside)
+        {
+            // The whole subtree is visible, so its nodes no longer need to be tested.
+            stack.push_back(-node.child1 - 1);
+            stack.push_back(-node.child2 - 1);
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+
+    return results.size() - count;
+}
+
+int BoundingVolumeTree::allocateNode()
+{
+    int index;
+    if (_freeList == BVT_NULL_NODE)
+    {
+        index = _nodes.size();
+        _nodes.push_back(TreeNode());
+    }
+    else
+    {
+        index = _freeList;
+        _freeList = _nodes[index].parent;
+    }
+
+    TreeNode& node = _nodes[index];
+    node.userData = NULL;
+    node.parent = BVT_NULL_NODE;
+    node.child1 = BVT_NULL_NODE;
+    node.child2 = BVT_NULL_NODE;
+    node.height = 0;
+
+    return index;
+}
+
+void BoundingVolumeTree::freeNode(int node)
+{
+    _nodes[node].parent = _freeList;
+    _nodes[node].userData = NULL;
+    _nodes[node].height = -1;
+    _freeList = node;
+}
+
+void BoundingVolumeTree::insertLeaf(int leaf)
+{
+    if (_root == BVT_NULL_NODE)
+    {
+        _root = leaf;
+        _nodes[leaf].parent = BVT_NULL_NODE;
+        return;
+    }
+
+    // Find the best sibling for the leaf, descending while a child is cheaper than a new parent here.
+    const BoundingBox leafBox = _nodes[leaf].box;
+    int index = _root;
+    while (_nodes[index].height > 0)
+    {
+        const TreeNode& node = _nodes[index];
+        float area = surfaceArea(node.box);
+        float mergedArea = mergedSurfaceArea(node.box, leafBox);
+
+        // The cost of creating a new parent for this node and the leaf.
+        float cost = 2.0f * mergedArea;
+
+        // The minimum cost of pushing the leaf further down the tree.
+        float inheritanceCost = 2.0f * (mergedArea - area);
+
+        const TreeNode& child1 = _nodes[node.child1];
+        float cost1 = mergedSurfaceArea(child1.box, leafBox) + inheritanceCost;
+        if (child1.height > 0)
+            cost1 -= surfaceArea(child1.box);
+
+        const TreeNode& child2 = _nodes[node.child2];
+        float cost2 = mergedSurfaceArea(child2.box, leafBox) + inheritanceCost;
+        if (child2.height > 0)
+            cost2 -= surfaceArea(child2.box);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // Create a new parent for the sibling and the leaf.
+    int sibling = index;
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].box = leafBox;
+    _nodes[newParent].box.merge(_nodes[sibling].box);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != BVT_NULL_NODE)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+
+    refit(oldParent);
+}
+
+void BoundingVolumeTree::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = BVT_NULL_NODE;
+        return;
+    }
+
+    // Replace the leaf's parent with the leaf's sibling.
+    int parent = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != BVT_NULL_NODE)
+    {
+        if (_nodes[grandParent].child1 == parent)
+            _nodes[grandParent].child1 = sibling;
+        else
+            _nodes[grandParent].child2 = sibling;
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refit(grandParent);
+    }
+    else
+    {
+        _root = sibling;
+        _nodes[sibling].parent = BVT_NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void BoundingVolumeTree::refit(int node)
+{
+    while (node != BVT_NULL_NODE)
+    {
+        node = balance(node);
+
+        TreeNode& n = _nodes[node];
+        const TreeNode& child1 = _nodes[n.child1];
+        const TreeNode& child2 = _nodes[n.child2];
+        n.height = 1 + std::max(child1.height, child2.height);
+        n.box = child1.box;
+        n.box.merge(child2.box);
+
+        node = n.parent;
+    }
+}
+
+int BoundingVolumeTree::balance(int iA)
+{
+    TreeNode& A = _nodes[iA];
+    if (A.height < 2)
+        return iA;
+
+    int iB = A.child1;
+    int iC = A.child2;
+    TreeNode& B = _nodes[iB];
+    TreeNode& C = _nodes[iC];
+
+    int difference = C.height - B.height;
+
+    if (difference > 1)
+    {
+        // Rotate C up.
+        int iF = C.child1;
+        int iG = C.child2;
+        TreeNode& F = _nodes[iF];
+        TreeNode& G = _nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != BVT_NULL_NODE)
+        {
+            if (_nodes[C.parent].child1 == iA)
+                _nodes[C.parent].child1 = iC;
+            else
+                _nodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            _root = iC;
+        }
+
+        // Keep the taller of C's children under C, and move the other one under A.
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.box = B.box;
+            A.box.merge(G.box);
+            C.box = A.box;
+            C.box.merge(F.box);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.box = B.box;
+            A.box.merge(F.box);
+            C.box = A.box;
+            C.box.merge(G.box);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    if (difference < -1)
+    {
+        // Rotate B up.
+        int iD = B.child1;
+        int iE = B.child2;
+        TreeNode& D = _nodes[iD];
+        TreeNode& E = _nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != BVT_NULL_NODE)
+        {
+            if (_nodes[B.parent].child1 == iA)
+                _nodes[B.parent].child1 = iB;
+            else
+                _nodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            _root = iB;
+        }
+
+        // Keep the taller of B's children under B, and move the other one under A.
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.box = C.box;
+            A.box.merge(E.box);
+            B.box = A.box;
+            B.box.merge(D.box);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.box = C.box;
+            A.box.merge(D.box);
+            B.box = A.box;
+            B.box.merge(E.box);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+}
@@ -0,0 +1,152 @@
+#ifndef BOUNDINGVOLUMETREE_H_
+#define BOUNDINGVOLUMETREE_H_
+
+#include "BoundingBox.h"
+#include "Frustum.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a dynamic bounding volume hierarchy of axis-aligned boxes.
+ *
+ * Each object in the tree is represented by a proxy, a leaf whose box is a slightly
+ * enlarged ("fat") copy of the object's bounds. Moving an object only changes the tree
+ * when its new bounds leave the fat box, so small movements are nearly free. Leaves are
+ * inserted where they increase the surface area of the tree the least, and the tree is
+ * kept balanced with rotations, so queries visit a number of nodes that grows with the
+ * logarithm of the number of proxies rather than linearly.
+ */
+class BoundingVolumeTree
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    BoundingVolumeTree();
+
+    /**
+     * Destructor.
+     */
+    ~BoundingVolumeTree();
+
+    /**
+     * Creates a proxy for an object.
+     *
+     * @param box The bounds of the object.
+     * @param userData The user data to associate with the proxy.
+     *
+     * @return The proxy identifier.
+     */
+    int createProxy(const BoundingBox& box, void* userData);
+
+    /**
+     * Destroys a proxy.
+     *
+     * @param proxy The proxy identifier.
+     */
+    void destroyProxy(int proxy);
+
+    /**
+     * Updates the bounds of a proxy.
+     *
+     * @param proxy The proxy identifier.
+     * @param box The new bounds of the object.
+     *
+     * @return true if the proxy was reinserted into the tree, false if the new bounds still fit its fat box.
+     */
+    bool moveProxy(int proxy, const BoundingBox& box);
+
+    /**
+     * Gets the user data associated with a proxy.
+     *
+     * @param proxy The proxy identifier.
+     *
+     * @return The user data.
+     */
+    void* getUserData(int proxy) const;
+
+    /**
+     * Gets the number of proxies in the tree.
+     *
+     * @return The proxy count.
+     */
+    unsigned int getProxyCount() const;
+
+    /**
+     * Removes all proxies from the tree.
+     */
+    void clear();
+
+    /**
+     * Finds the proxies whose fat boxes intersect the given frustum.
+     *
+     * The user data of each proxy found is appended to the given vector.
+     *
+     * @param frustum The frustum to test against.
+     * @param results The vector to append the user data of the proxies found to.
+     *
+     * @return The number of proxies found.
+     */
+    unsigned int query(const Frustum& frustum, std::vector<void*>& results) const;
+
+private:
+
+    /**
+     * A node of the tree. Leaves hold proxies, internal nodes bound their two children.
+     */
+    struct TreeNode
+    {
+        BoundingBox box;
+        void* userData;
+        int parent;     // The parent node, or the next free node while the node is unused.
+        int child1;
+        int child2;
+        int height;     // 0 for leaves, -1 for unused nodes.
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    BoundingVolumeTree(const BoundingVolumeTree& copy);
+
+    /**
+     * Takes a node from the free list, growing the node array if needed.
+     */
+    int allocateNode();
+
+    /**
+     * Returns a node to the free list.
+     */
+    void freeNode(int node);
+
+    /**
+     * Inserts a leaf into the tree.
+     */
+    void insertLeaf(int leaf);
+
+    /**
+     * Removes a leaf from the tree.
+     */
+    void removeLeaf(int leaf);
+
+    /**
+     * Recomputes the boxes and heights of the ancestors of a node, rebalancing them along the way.
+     */
+    void refit(int node);
+
+    /**
+     * Rotates the subtree at the given node if it is unbalanced, and returns the new subtree root.
+     */
+    int balance(int node);
+
+    std::vector<TreeNode> _nodes;
+    int _root;
+    int _freeList;
+    unsigned int _proxyCount;
+};
+
+}
+
+#endif
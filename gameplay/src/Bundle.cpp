@@ -6,7 +6,20 @@
 #include "Joint.h"
 
 #define BUNDLE_VERSION_MAJOR            1
-#define BUNDLE_VERSION_MINOR            1
+#define BUNDLE_VERSION_MINOR            2
+
+// The oldest minor version that can still be read
+#define BUNDLE_VERSION_MINOR_MIN        1
+
+// The first minor version that stores the format of animation channels
+#define BUNDLE_VERSION_MINOR_CHANNEL_FORMAT 2
+
+// The formats of the key frames of animation channels
+#define BUNDLE_CHANNEL_FORMAT_FLOAT     0
+#define BUNDLE_CHANNEL_FORMAT_QUANTIZED 1
+
+// The range of the three smallest components of a quantized unit quaternion is [-1/sqrt(2), 1/sqrt(2)].
+#define BUNDLE_QUATERNION_COMPONENT_RANGE 0.70710678f
 
 #define BUNDLE_TYPE_SCENE               1
 #define BUNDLE_TYPE_NODE                2
@@ -26,14 +39,19 @@
 // For sanity checking string reads
 #define BUNDLE_MAX_STRING_LENGTH        5000
 
+// Marks an unused slot in the reference hash tables
+#define BUNDLE_EMPTY_SLOT               0xFFFFFFFF
+
 namespace gameplay
 {
 
 static std::vector<Bundle*> __bundleCache;
 
 Bundle::Bundle(const char* path) :
-    _path(path), _referenceCount(0), _references(NULL), _file(NULL)
+    _path(path), _referenceCount(0), _references(NULL), _tableSize(0), _idTable(NULL), _offsetTable(NULL),
+    _file(NULL), _data(NULL), _dataSize(0), _position(0), _animationsPreloaded(false)
 {
+    _version[0] = _version[1] = 0;
 }
 
 Bundle::~Bundle()
@@ -47,7 +65,29 @@ Bundle::~Bundle()
         __bundleCache.erase(itr);
     }
 
+    // Release the preloaded data of objects that were never loaded.
+    for (std::map<std::string, MeshData*>::iterator itr = _meshData.begin(); itr != _meshData.end(); ++itr)
+    {
+        SAFE_DELETE(itr->second);
+    }
+    for (std::map<std::string, FontData*>::iterator itr = _fontData.begin(); itr != _fontData.end(); ++itr)
+    {
+        SAFE_DELETE(itr->second);
+    }
+    for (unsigned int i = 0, count = _animationData.size(); i < count; ++i)
+    {
+        SAFE_DELETE(_animationData[i]);
+    }
+
     SAFE_DELETE_ARRAY(_references);
+    SAFE_DELETE_ARRAY(_idTable);
+    SAFE_DELETE_ARRAY(_offsetTable);
+
+    if (_data)
+    {
+        FileSystem::unmapFile(_data, _dataSize);
+        _data = NULL;
+    }
 
     if (_file)
     {
@@ -66,7 +106,7 @@ bool Bundle::readArray(unsigned int* length, T** ptr)
     if (*length > 0)
     {
         *ptr = new T[*length];
-        if (fread(*ptr, sizeof(T), *length, _file) != *length)
+        if (read(*ptr, sizeof(T), *length) != *length)
         {
             SAFE_DELETE_ARRAY(*ptr);
             return false;
@@ -85,7 +125,7 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values)
     if (*length > 0 && values)
     {
         values->resize(*length);
-        if (fread(&(*values)[0], sizeof(T), *length, _file) != *length)
+        if (read(&(*values)[0], sizeof(T), *length) != *length)
         {
             return false;
         }
@@ -105,7 +145,7 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     if (*length > 0 && values)
     {
         values->resize(*length);
-        if (fread(&(*values)[0], readSize, *length, _file) != *length)
+        if (read(&(*values)[0], readSize, *length) != *length)
         {
             return false;
         }
@@ -113,10 +153,10 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     return true;
 }
 
-std::string readString(FILE* fp)
+std::string Bundle::readString()
 {
     unsigned int length;
-    if (fread(&length, 4, 1, fp) != 1)
+    if (read(&length, 4, 1) != 1)
     {
         return std::string();
     }
@@ -128,7 +168,7 @@ std::string readString(FILE* fp)
     if (length > 0)
     {
         str.resize(length);
-        if (fread(&str[0], 1, length, fp) != length)
+        if (read(&str[0], 1, length) != length)
         {
             return std::string();
         }
@@ -158,64 +198,143 @@ Bundle* Bundle::create(const char* path)
         return NULL;
     }
 
+    Bundle* bundle = new Bundle(path);
+    bundle->_file = fp;
+
+    // Map the whole file so that objects are read directly from memory. The mapping stays
+    // valid once the file is closed. Otherwise fall back to reading through the open file.
+    bundle->_data = (const unsigned char*)FileSystem::mapFile(fp, &bundle->_dataSize);
+    if (bundle->_data)
+    {
+        fclose(fp);
+        bundle->_file = NULL;
+    }
+
     // Read the GPG header info
     char sig[9];
-    if (fread(sig, 1, 9, fp) != 9 || memcmp(sig, "GPB\r\n\x1A\n", 9) != 0)
+    if (bundle->read(sig, 1, 9) != 9 || memcmp(sig, "GPB\r\n\x1A\n", 9) != 0)
     {
         LOG_ERROR_VARG("Invalid bundle header: %s", path);
-        fclose(fp);
+        SAFE_RELEASE(bundle);
         return NULL;
     }
 
     // Read version
     unsigned char ver[2];
-    if (fread(ver, 1, 2, fp) != 2 || ver[0] != BUNDLE_VERSION_MAJOR || ver[1] != BUNDLE_VERSION_MINOR)
+    if (bundle->read(ver, 1, 2) != 2 || ver[0] != BUNDLE_VERSION_MAJOR || ver[1] < BUNDLE_VERSION_MINOR_MIN || ver[1] > BUNDLE_VERSION_MINOR)
     {
         LOG_ERROR_VARG("Unsupported version (%d.%d) for bundle: %s (expected %d.%d)", (int)ver[0], (int)ver[1], path, BUNDLE_VERSION_MAJOR, BUNDLE_VERSION_MINOR);
-        fclose(fp);
+        SAFE_RELEASE(bundle);
         return NULL;
     }
+    bundle->_version[0] = ver[0];
+    bundle->_version[1] = ver[1];
 
     // Read ref table
     unsigned int refCount;
-    if (fread(&refCount, 4, 1, fp) != 1)
+    if (bundle->read(&refCount, 4, 1) != 1)
     {
-        fclose(fp);
+        SAFE_RELEASE(bundle);
         return NULL;
     }
 
     // Read all refs
     Reference* refs = new Reference[refCount];
+    bundle->_referenceCount = refCount;
+    bundle->_references = refs;
     for (unsigned int i = 0; i < refCount; ++i)
     {
-        if ((refs[i].id = readString(fp)).empty() ||
-            fread(&refs[i].type, 4, 1, fp) != 1 ||
-            fread(&refs[i].offset, 4, 1, fp) != 1)
+        if ((refs[i].id = bundle->readString()).empty() ||
+            bundle->read(&refs[i].type, 4, 1) != 1 ||
+            bundle->read(&refs[i].offset, 4, 1) != 1)
         {
-            fclose(fp);
-            SAFE_DELETE_ARRAY(refs);
+            SAFE_RELEASE(bundle);
             return NULL;
         }
     }
 
-    // Keep file open for faster reading later
-    Bundle* bundle = new Bundle(path);
-    bundle->_referenceCount = refCount;
-    bundle->_references = refs;
-    bundle->_file = fp;
+    bundle->buildReferenceTables();
 
     return bundle;
 }
 
-Bundle::Reference* Bundle::find(const char* id) const
+void Bundle::buildReferenceTables()
 {
-    // Search the ref table for the given id (case-sensitive)
+    // Size the tables to a power of two at least twice the reference count to keep probe sequences short.
+    _tableSize = 16;
+    while (_tableSize < _referenceCount * 2)
+    {
+        _tableSize <<= 1;
+    }
+    _idTable = new unsigned int[_tableSize];
+    _offsetTable = new unsigned int[_tableSize];
+    memset(_idTable, 0xFF, sizeof(unsigned int) * _tableSize);
+    memset(_offsetTable, 0xFF, sizeof(unsigned int) * _tableSize);
+
+    const unsigned int mask = _tableSize - 1;
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
-        if (_references[i].id == id)
+        const Reference& ref = _references[i];
+
+        // Keep the first reference with a given ID, as a linear search of the table would.
+        unsigned int slot = hashId(ref.id.c_str()) & mask;
+        while (_idTable[slot] != BUNDLE_EMPTY_SLOT && _references[_idTable[slot]].id != ref.id)
+        {
+            slot = (slot + 1) & mask;
+        }
+        if (_idTable[slot] == BUNDLE_EMPTY_SLOT)
+        {
+            _idTable[slot] = i;
+        }
+
+        // Likewise keep the first reference with a given offset.
+        slot = hashOffset(ref.offset) & mask;
+        while (_offsetTable[slot] != BUNDLE_EMPTY_SLOT && _references[_offsetTable[slot]].offset != ref.offset)
+        {
+            slot = (slot + 1) & mask;
+        }
+        if (_offsetTable[slot] == BUNDLE_EMPTY_SLOT)
+        {
+            _offsetTable[slot] = i;
+        }
+    }
+}
+
+unsigned int Bundle::hashId(const char* id)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)id; *c; ++c)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+unsigned int Bundle::hashOffset(unsigned int offset)
+{
+    // Knuth's multiplicative hash, folded so that the high bits reach the low bits used for the slot.
+    unsigned int hash = offset * 2654435761u;
+    return hash ^ (hash >> 16);
+}
+
+Bundle::Reference* Bundle::find(const char* id) const
+{
+    if (_idTable == NULL)
+    {
+        return NULL;
+    }
+
+    // Look up the given id (case-sensitive) in the id hash table
+    const unsigned int mask = _tableSize - 1;
+    for (unsigned int slot = hashId(id) & mask; _idTable[slot] != BUNDLE_EMPTY_SLOT; slot = (slot + 1) & mask)
+    {
+        Reference* ref = &_references[_idTable[slot]];
+        if (ref->id == id)
         {
             // Found a match
-            return &_references[i];
+            return ref;
         }
     }
 
@@ -233,19 +352,21 @@ void Bundle::clearLoadSession()
 
 const char* Bundle::getIdFromOffset() const
 {
-    return getIdFromOffset((unsigned int) ftell(_file));
+    return getIdFromOffset(tell());
 }
 
 const char* Bundle::getIdFromOffset(unsigned int offset) const
 {
-    // Search the ref table for the given offset
-    if (offset > 0)
+    // Look up the given offset in the offset hash table
+    if (offset > 0 && _offsetTable)
     {
-        for (unsigned int i = 0; i < _referenceCount; ++i)
+        const unsigned int mask = _tableSize - 1;
+        for (unsigned int slot = hashOffset(offset) & mask; _offsetTable[slot] != BUNDLE_EMPTY_SLOT; slot = (slot + 1) & mask)
         {
-            if (_references[i].offset == offset && _references[i].id.length() > 0)
+            const Reference& ref = _references[_offsetTable[slot]];
+            if (ref.offset == offset)
             {
-                return _references[i].id.c_str();
+                return ref.id.c_str();
             }
         }
     }
@@ -268,7 +389,7 @@ Bundle::Reference* Bundle::seekTo(const char* id, unsigned int type)
     }
 
     // Seek to the offset of this object
-    if (fseek(_file, ref->offset, SEEK_SET) != 0)
+    if (!seek(ref->offset))
     {
         LOG_ERROR_VARG("Failed to seek to object '%s' in bundle '%s'.", id, _path.c_str());
         return NULL;
@@ -286,7 +407,7 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
         if (ref->type == type)
         {
             // Found a match
-            if (fseek(_file, ref->offset, SEEK_SET) != 0)
+            if (!seek(ref->offset))
             {
                 LOG_ERROR_VARG("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 return NULL;
@@ -297,24 +418,75 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
     return NULL;
 }
 
+size_t Bundle::read(void* ptr, size_t size, size_t count)
+{
+    if (_data == NULL)
+    {
+        return fread(ptr, size, count, _file);
+    }
+
+    // Like fread, read as many whole elements as remain in the mapping.
+    assert(size > 0);
+    size_t available = (_dataSize - _position) / size;
+    if (count > available)
+    {
+        count = available;
+    }
+    memcpy(ptr, _data + _position, size * count);
+    _position += size * count;
+    return count;
+}
+
+const unsigned char* Bundle::readMapped(unsigned int byteCount)
+{
+    if (_data == NULL || byteCount > _dataSize - _position)
+    {
+        return NULL;
+    }
+
+    const unsigned char* ptr = _data + _position;
+    _position += byteCount;
+    return ptr;
+}
+
+bool Bundle::seek(unsigned int offset)
+{
+    if (_data == NULL)
+    {
+        return fseek(_file, offset, SEEK_SET) == 0;
+    }
+
+    if (offset > _dataSize)
+    {
+        return false;
+    }
+    _position = offset;
+    return true;
+}
+
+unsigned int Bundle::tell() const
+{
+    return _data ? _position : (unsigned int)ftell(_file);
+}
+
 bool Bundle::read(unsigned int* ptr)
 {
-    return fread(ptr, sizeof(unsigned int), 1, _file) == 1;
+    return read(ptr, sizeof(unsigned int), 1) == 1;
 }
 
 bool Bundle::read(unsigned char* ptr)
 {
-    return fread(ptr, sizeof(unsigned char), 1, _file) == 1;
+    return read(ptr, sizeof(unsigned char), 1) == 1;
 }
 
 bool Bundle::read(float* ptr)
 {
-    return fread(ptr, sizeof(float), 1, _file) == 1;
+    return read(ptr, sizeof(float), 1) == 1;
 }
 
 bool Bundle::readMatrix(float* m)
 {
-    return (fread(m, sizeof(float), 16, _file) == 16);
+    return (read(m, sizeof(float), 16) == 16);
 }
 
 Scene* Bundle::loadScene(const char* id)
@@ -358,7 +530,7 @@ Scene* Bundle::loadScene(const char* id)
         }
     }
     // Read active camera
-    std::string xref = readString(_file);
+    std::string xref = readString();
     if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
     {
         Node* node = scene->findNode(xref.c_str() + 1, true);
@@ -389,21 +561,35 @@ Scene* Bundle::loadScene(const char* id)
     }
     scene->setAmbientColor(red, green, blue);
 
-    // parse animations
-    for (unsigned int i = 0; i < _referenceCount; ++i)
+    // parse animations, unless they were decoded when the bundle was loaded in the background
+    std::vector<AnimationData*> animations;
+    if (_animationsPreloaded)
     {
-        Reference* ref = &_references[i];
-        if (ref->type == BUNDLE_TYPE_ANIMATIONS)
+        animations.swap(_animationData);
+        _animationsPreloaded = false;
+    }
+    else
+    {
+        for (unsigned int i = 0; i < _referenceCount; ++i)
         {
-            // Found a match
-            if (fseek(_file, ref->offset, SEEK_SET) != 0)
+            Reference* ref = &_references[i];
+            if (ref->type == BUNDLE_TYPE_ANIMATIONS)
             {
-                LOG_ERROR_VARG("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
-                return NULL;
+                // Found a match
+                if (!seek(ref->offset))
+                {
+                    LOG_ERROR_VARG("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
+                    break;
+                }
+                readAnimations(&animations);
             }
-            readAnimations(scene);
         }
     }
+    createAnimations(scene, animations);
+    for (unsigned int i = 0, count = animations.size(); i < count; ++i)
+    {
+        SAFE_DELETE(animations[i]);
+    }
 
     resolveJointReferences(scene, NULL);
 
@@ -490,7 +676,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
 
     // Read transform
     float transform[16];
-    if (fread(transform, sizeof(float), 16, _file) != 16)
+    if (read(transform, sizeof(float), 16) != 16)
     {
         SAFE_RELEASE(node);
         return NULL;
@@ -670,7 +856,7 @@ Model* Bundle::readModel(Scene* sceneContext, Node* nodeContext, const char* nod
 {
     // Read mesh
     Mesh* mesh = NULL;
-    std::string xref = readString(_file);
+    std::string xref = readString();
     if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
     {
         mesh = loadMesh(xref.c_str() + 1, nodeId);
@@ -749,7 +935,7 @@ MeshSkin* Bundle::readMeshSkin(Scene* sceneContext, Node* nodeContext)
     // Read joint xref strings for all joints in the list
     for (unsigned int i = 0; i < jointCount; i++)
     {
-        skinData->joints.push_back(readString(_file));
+        skinData->joints.push_back(readString());
     }
 
     // read bindposes
@@ -834,80 +1020,73 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
     _meshSkins.clear();
 }
 
-void Bundle::readAnimation(Scene* scene)
+Bundle::AnimationData* Bundle::readAnimation()
 {
-    const std::string animationId = readString(_file);
+    AnimationData* animation = new AnimationData();
+    animation->id = readString();
 
     // read the number of animation channels in this animation
     unsigned int animationChannelCount;
     if (!read(&animationChannelCount))
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "animationChannelCount", "animation", animationId.c_str());
-        return;
+        LOG_ERROR_VARG("Failed to read %s for %s: %s", "animationChannelCount", "animation", animation->id.c_str());
+        SAFE_DELETE(animation);
+        return NULL;
     }
 
-    Animation* animation = NULL;
-
     for (unsigned int i = 0; i < animationChannelCount; i++)
     {
-        animation = readAnimationChannel(scene, animation, animationId.c_str());
+        AnimationChannelData* channel = new AnimationChannelData();
+        if (!readAnimationChannel(animation->id.c_str(), channel))
+        {
+            // The rest of the animation cannot be located once a channel fails to read.
+            SAFE_DELETE(channel);
+            break;
+        }
+        animation->channels.push_back(channel);
     }
+
+    return animation;
 }
 
-void Bundle::readAnimations(Scene* scene)
+void Bundle::readAnimations(std::vector<AnimationData*>* animations)
 {
     // read the number of animations in this object
     unsigned int animationCount;
     if (!read(&animationCount))
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "animationCount", "Animations");
+        LOG_ERROR_VARG("Failed to read %s for %s: %s", "animationCount", "Animations", _path.c_str());
         return;
     }
 
     for (unsigned int i = 0; i < animationCount; i++)
     {
-        readAnimation(scene);
+        AnimationData* animation = readAnimation();
+        if (animation == NULL)
+            return;
+        animations->push_back(animation);
     }
 }
 
-Animation* Bundle::readAnimationChannel(Scene* scene, Animation* animation, const char* animationId)
+bool Bundle::readAnimationChannel(const char* animationId, AnimationChannelData* channel)
 {
     const char* id = animationId;
 
     // read targetId
-    std::string targetId = readString(_file);
-    if (targetId.empty())
+    channel->targetId = readString();
+    if (channel->targetId.empty())
     {
         LOG_ERROR_VARG("Failed to read %s for %s: %s", "targetId", "animation", id);
-        return NULL;
+        return false;
     }
 
     // read target attribute
-    unsigned int targetAttribute;
-    if (!read(&targetAttribute))
+    if (!read(&channel->targetAttribute))
     {
         LOG_ERROR_VARG("Failed to read %s for %s: %s", "targetAttribute", "animation", id);
-        return NULL;
-    }
-
-    //long position = ftell(_file);
-    //fseek(_file, position, SEEK_SET);
-
-    AnimationTarget* target = NULL;
-
-    // Search for a node that matches target
-    if (!target)
-    {
-        target = scene->findNode(targetId.c_str());
-        if (!target)
-        {
-            LOG_ERROR_VARG("Failed to read %s for %s: %s", "animation target", targetId.c_str(), id);
-            return NULL;
-        }
+        return false;
     }
 
-    std::vector<unsigned long> keyTimes;
-    std::vector<float> values;
     std::vector<float> tangentsIn;
     std::vector<float> tangentsOut;
     std::vector<unsigned long> interpolation;
@@ -919,60 +1098,174 @@ Animation* Bundle::readAnimationChannel(Scene* scene, Animation* animation, cons
     unsigned int tangentsOutCount;
     unsigned int interpolationCount;
 
-    // read key times
-    if (!readArray(&keyTimesCount, &keyTimes, sizeof(unsigned int)))
+    // read the key frame format, which older bundles do not store
+    unsigned int format = BUNDLE_CHANNEL_FORMAT_FLOAT;
+    if (_version[1] >= BUNDLE_VERSION_MINOR_CHANNEL_FORMAT && !read(&format))
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "keyTimes", "animation", id);
-        return NULL;
+        LOG_ERROR_VARG("Failed to read %s for %s: %s", "format", "animation", id);
+        return false;
     }
-    
-    // read key values
-    if (!readArray(&valuesCount, &values))
+
+    if (format == BUNDLE_CHANNEL_FORMAT_QUANTIZED)
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "values", "animation", id);
-        return NULL;
+        // read and decode quantized key times and values
+        if (!readQuantizedKeys(&channel->keyTimes, &channel->values))
+        {
+            LOG_ERROR_VARG("Failed to read %s for %s: %s", "quantized keys", "animation", id);
+            return false;
+        }
     }
+    else
+    {
+        // read key times
+        if (!readArray(&keyTimesCount, &channel->keyTimes, sizeof(unsigned int)))
+        {
+            LOG_ERROR_VARG("Failed to read %s for %s: %s", "keyTimes", "animation", id);
+            return false;
+        }
+    
+        // read key values
+        if (!readArray(&valuesCount, &channel->values))
+        {
+            LOG_ERROR_VARG("Failed to read %s for %s: %s", "values", "animation", id);
+            return false;
+        }
+    
+        // read tangentsIn
+        if (!readArray(&tangentsInCount, &tangentsIn))
+        {
+            LOG_ERROR_VARG("Failed to read %s for %s: %s", "tangentsIn", "animation", id);
+            return false;
+        }
+    
+        // read tangent_out
+        if (!readArray(&tangentsOutCount, &tangentsOut))
+        {
+            LOG_ERROR_VARG("Failed to read %s for %s: %s", "tangentsOut", "animation", id);
+            return false;
+        }
     
-    // read tangentsIn
-    if (!readArray(&tangentsInCount, &tangentsIn))
+        // read interpolations
+        if (!readArray(&interpolationCount, &interpolation, sizeof(unsigned int)))
+        {
+            LOG_ERROR_VARG("Failed to read %s for %s: %s", "interpolation", "animation", id);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Bundle::createAnimations(Scene* scene, const std::vector<AnimationData*>& animations)
+{
+    for (unsigned int i = 0, count = animations.size(); i < count; ++i)
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "tangentsIn", "animation", id);
-        return NULL;
+        const AnimationData* data = animations[i];
+        const char* id = data->id.c_str();
+        Animation* animation = NULL;
+        for (unsigned int j = 0, channelCount = data->channels.size(); j < channelCount; ++j)
+        {
+            const AnimationChannelData* channel = data->channels[j];
+
+            // Search for a node that matches target
+            AnimationTarget* target = scene->findNode(channel->targetId.c_str());
+            if (!target)
+            {
+                LOG_ERROR_VARG("Failed to read %s for %s: %s", "animation target", channel->targetId.c_str(), id);
+                continue;
+            }
+
+            // TODO: Handle other target attributes later.
+            if (channel->targetAttribute > 0)
+            {
+                assert(channel->keyTimes.size() > 0 && channel->values.size() > 0);
+                unsigned int keyCount = channel->keyTimes.size();
+                unsigned long* keyTimes = const_cast<unsigned long*>(&channel->keyTimes[0]);
+                float* values = const_cast<float*>(&channel->values[0]);
+                if (animation == NULL)
+                {
+                    // TODO: This code currently assumes LINEAR only
+                    animation = target->createAnimation(id, channel->targetAttribute, keyCount, keyTimes, values, Curve::LINEAR);
+                }
+                else
+                {
+                    animation->createChannel(target, channel->targetAttribute, keyCount, keyTimes, values, Curve::LINEAR);
+                }
+            }
+        }
     }
-    
-    // read tangent_out
-    if (!readArray(&tangentsOutCount, &tangentsOut))
+}
+
+bool Bundle::readQuantizedKeys(std::vector<unsigned long>* keyTimes, std::vector<float>* values)
+{
+    // Key times are stored as fractions of the duration of the channel.
+    unsigned int startTime;
+    unsigned int duration;
+    unsigned int keyCount;
+    std::vector<unsigned short> times;
+    if (!read(&startTime) || !read(&duration) || !readArray(&keyCount, &times) || keyCount == 0)
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "tangentsOut", "animation", id);
-        return NULL;
+        return false;
     }
-    
-    // read interpolations
-    if (!readArray(&interpolationCount, &interpolation, sizeof(unsigned int)))
+    keyTimes->resize(keyCount);
+    for (unsigned int i = 0; i < keyCount; ++i)
     {
-        LOG_ERROR_VARG("Failed to read %s for %s: %s", "interpolation", "animation", id);
-        return NULL;
+        (*keyTimes)[i] = startTime + (unsigned long)((double)duration * times[i] / 65535.0 + 0.5);
     }
 
-    Game* game = Game::getInstance();
-    AnimationController* controller = game->getAnimationController();
+    unsigned int componentCount;
+    unsigned int quaternionOffset;
+    unsigned int rangeCount;
+    unsigned int quantizedCount;
+    std::vector<float> ranges;
+    std::vector<unsigned short> quantizedValues;
+    if (!read(&componentCount) || !read(&quaternionOffset) || !readArray(&rangeCount, &ranges) || !readArray(&quantizedCount, &quantizedValues))
+    {
+        return false;
+    }
+    bool hasQuaternion = quaternionOffset < componentCount && componentCount - quaternionOffset >= 4;
+    unsigned int rangedCount = hasQuaternion ? componentCount - 4 : componentCount;
+    if (componentCount == 0 || rangeCount != rangedCount * 2 || quantizedCount != keyCount * (rangedCount + (hasQuaternion ? 3 : 0)))
+    {
+        return false;
+    }
 
-    // TODO: Handle other target attributes later.
-    if (targetAttribute > 0)
+    values->resize(keyCount * componentCount);
+    const unsigned short* src = quantizedCount > 0 ? &quantizedValues[0] : NULL;
+    float* dst = &(*values)[0];
+    for (unsigned int i = 0; i < keyCount; ++i)
     {
-        assert(keyTimes.size() > 0 && values.size() > 0);
-        if (animation == NULL)
-        {
-            // TODO: This code currently assumes LINEAR only
-            animation = target->createAnimation(animationId, targetAttribute, keyTimesCount, &keyTimes[0], &values[0], Curve::LINEAR);
-        }
-        else
+        unsigned int range = 0;
+        for (unsigned int j = 0; j < componentCount; ++j)
         {
-            animation->createChannel(target, targetAttribute, keyTimesCount, &keyTimes[0], &values[0], Curve::LINEAR);
+            if (hasQuaternion && j == quaternionOffset)
+            {
+                // Rotations store their three smallest components, with the index of the largest one in the
+                // top bits of the first two. The largest component is positive and follows from the unit length.
+                unsigned int largest = ((src[0] >> 15) << 1) | (src[1] >> 15);
+                float lengthSquared = 0.0f;
+                for (unsigned int k = 0, l = 0; k < 4; ++k)
+                {
+                    if (k != largest)
+                    {
+                        float v = ((src[l++] & 0x7FFF) / 32766.0f * 2.0f - 1.0f) * BUNDLE_QUATERNION_COMPONENT_RANGE;
+                        dst[k] = v;
+                        lengthSquared += v * v;
+                    }
+                }
+                dst[largest] = sqrt(std::max(1.0f - lengthSquared, 0.0f));
+                src += 3;
+                dst += 4;
+                j += 3;
+            }
+            else
+            {
+                *dst++ = ranges[range] + ranges[range + 1] * (*src++ / 65535.0f);
+                range += 2;
+            }
         }
     }
-
-    return animation;
+    return true;
 }
 
 Mesh* Bundle::loadMesh(const char* id)
@@ -983,20 +1276,31 @@ Mesh* Bundle::loadMesh(const char* id)
 Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
 {
     // Save the file position
-    long position = ftell(_file);
+    unsigned int position = tell();
 
-    // Seek to the specified Mesh
-    Reference* ref = seekTo(id, BUNDLE_TYPE_MESH);
-    if (ref == NULL)
+    // Use the mesh data decoded by preload(), if any
+    MeshData* meshData = NULL;
+    std::map<std::string, MeshData*>::iterator itr = _meshData.find(id);
+    if (itr != _meshData.end())
     {
-        return NULL;
+        meshData = itr->second;
+        _meshData.erase(itr);
     }
-
-    // Read mesh data
-    MeshData* meshData = readMeshData();
-    if (meshData == NULL)
+    else
     {
-        return NULL;
+        // Seek to the specified Mesh
+        Reference* ref = seekTo(id, BUNDLE_TYPE_MESH);
+        if (ref == NULL)
+        {
+            return NULL;
+        }
+
+        // Read mesh data, referencing vertex and index data in place when the bundle is mapped
+        meshData = readMeshData(true);
+        if (meshData == NULL)
+        {
+            return NULL;
+        }
     }
 
     // Create Mesh
@@ -1004,7 +1308,7 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
     if (mesh == NULL)
     {
         LOG_ERROR_VARG("Failed to create mesh: %s", id);
-        SAFE_DELETE_ARRAY(meshData);
+        SAFE_DELETE(meshData);
         return NULL;
     }
 
@@ -1035,16 +1339,16 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
     SAFE_DELETE(meshData);
 
     // Restore file pointer
-    fseek(_file, position, SEEK_SET);
+    seek(position);
 
     return mesh;
 }
 
-Bundle::MeshData* Bundle::readMeshData()
+Bundle::MeshData* Bundle::readMeshData(bool mapData)
 {
     // Read vertex format/elements
     unsigned int vertexElementCount;
-    if (fread(&vertexElementCount, 4, 1, _file) != 1 || vertexElementCount < 1)
+    if (read(&vertexElementCount, 4, 1) != 1 || vertexElementCount < 1)
     {
         return NULL;
     }
@@ -1052,7 +1356,7 @@ Bundle::MeshData* Bundle::readMeshData()
     for (unsigned int i = 0; i < vertexElementCount; ++i)
     {
         unsigned int vUsage, vSize;
-        if (fread(&vUsage, 4, 1, _file) != 1 || fread(&vSize, 4, 1, _file) != 1)
+        if (read(&vUsage, 4, 1) != 1 || read(&vSize, 4, 1) != 1)
         {
             SAFE_DELETE_ARRAY(vertexElements);
             return NULL;
@@ -1068,26 +1372,39 @@ Bundle::MeshData* Bundle::readMeshData()
 
     // Read vertex data
     unsigned int vertexByteCount;
-    if (fread(&vertexByteCount, 4, 1, _file) != 1 || vertexByteCount == 0)
+    if (read(&vertexByteCount, 4, 1) != 1 || vertexByteCount == 0)
     {
         SAFE_DELETE(meshData);
         return NULL;
     }
     meshData->vertexCount = vertexByteCount / meshData->vertexFormat.getVertexSize();
-    meshData->vertexData = new unsigned char[vertexByteCount];
-    if (fread(meshData->vertexData, 1, vertexByteCount, _file) != vertexByteCount)
+    if (mapData && _data)
     {
-        SAFE_DELETE(meshData);
-        return NULL;
+        meshData->mapped = true;
+        meshData->vertexData = const_cast<unsigned char*>(readMapped(vertexByteCount));
+        if (meshData->vertexData == NULL)
+        {
+            SAFE_DELETE(meshData);
+            return NULL;
+        }
+    }
+    else
+    {
+        meshData->vertexData = new unsigned char[vertexByteCount];
+        if (read(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
+        {
+            SAFE_DELETE(meshData);
+            return NULL;
+        }
     }
 
     // Read mesh bounds (bounding box and bounding sphere)
-    if (fread(&meshData->boundingBox.min.x, 4, 3, _file) != 3 || fread(&meshData->boundingBox.max.x, 4, 3, _file) != 3)
+    if (read(&meshData->boundingBox.min.x, 4, 3) != 3 || read(&meshData->boundingBox.max.x, 4, 3) != 3)
     {
         SAFE_DELETE(meshData);
         return NULL;
     }
-    if (fread(&meshData->boundingSphere.center.x, 4, 3, _file) != 3 || fread(&meshData->boundingSphere.radius, 4, 1, _file) != 1)
+    if (read(&meshData->boundingSphere.center.x, 4, 3) != 3 || read(&meshData->boundingSphere.radius, 4, 1) != 1)
     {
         SAFE_DELETE(meshData);
         return NULL;
@@ -1095,7 +1412,7 @@ Bundle::MeshData* Bundle::readMeshData()
 
     // Read mesh parts
     unsigned int meshPartCount;
-    if (fread(&meshPartCount, 4, 1, _file) != 1)
+    if (read(&meshPartCount, 4, 1) != 1)
     {
         SAFE_DELETE(meshData);
         return NULL;
@@ -1104,9 +1421,9 @@ Bundle::MeshData* Bundle::readMeshData()
     {
         // Read primitive type, index format and index count
         unsigned int pType, iFormat, iByteCount;
-        if (fread(&pType, 4, 1, _file) != 1 ||
-            fread(&iFormat, 4, 1, _file) != 1 ||
-            fread(&iByteCount, 4, 1, _file) != 1)
+        if (read(&pType, 4, 1) != 1 ||
+            read(&iFormat, 4, 1) != 1 ||
+            read(&iByteCount, 4, 1) != 1)
         {
             SAFE_DELETE(meshData);
             return NULL;
@@ -1134,11 +1451,23 @@ Bundle::MeshData* Bundle::readMeshData()
 
         partData->indexCount = iByteCount / indexSize;
 
-        partData->indexData = new unsigned char[iByteCount];
-        if (fread(partData->indexData, 1, iByteCount, _file) != iByteCount)
+        if (meshData->mapped)
         {
-            SAFE_DELETE(meshData);
-            return NULL;
+            partData->indexData = const_cast<unsigned char*>(readMapped(iByteCount));
+            if (partData->indexData == NULL)
+            {
+                SAFE_DELETE(meshData);
+                return NULL;
+            }
+        }
+        else
+        {
+            partData->indexData = new unsigned char[iByteCount];
+            if (read(partData->indexData, 1, iByteCount) != iByteCount)
+            {
+                SAFE_DELETE(meshData);
+                return NULL;
+            }
         }
     }
 
@@ -1172,101 +1501,122 @@ Bundle::MeshData* Bundle::readMeshData(const char* url)
     if (ref == NULL)
         return NULL;
 
-    // Read mesh data from current file position
-    MeshData* meshData = bundle->readMeshData();
+    // Read mesh data from current file position, copying it since the bundle is released below
+    MeshData* meshData = bundle->readMeshData(false);
 
     SAFE_RELEASE(bundle);
 
     return meshData;
 }
 
-Font* Bundle::loadFont(const char* id)
+Bundle::FontData* Bundle::readFontData(const char* id)
 {
-    // Seek to the specified Font
-    Reference* ref = seekTo(id, BUNDLE_TYPE_FONT);
-    if (ref == NULL)
-    {
-        return NULL;
-    }
+    FontData* fontData = new FontData();
 
     // Read font family
-    std::string family = readString(_file);
-    if (family.empty())
+    fontData->family = readString();
+    if (fontData->family.empty())
     {
         LOG_ERROR_VARG("Failed to read font family for font: %s", id);
+        SAFE_DELETE(fontData);
         return NULL;
     }
 
     // Read font style and size
-    unsigned int style, size;
-    if (fread(&style, 4, 1, _file) != 1 ||
-        fread(&size, 4, 1, _file) != 1)
+    if (read(&fontData->style, 4, 1) != 1 ||
+        read(&fontData->size, 4, 1) != 1)
     {
         LOG_ERROR_VARG("Failed to read style and/or size for font: %s", id);
+        SAFE_DELETE(fontData);
         return NULL;
     }
 
     // Read character set
-    std::string charset = readString(_file);
+    std::string charset = readString();
 
     // Read font glyphs
     unsigned int glyphCount;
-    if (fread(&glyphCount, 4, 1, _file) != 1 || glyphCount == 0)
+    if (read(&glyphCount, 4, 1) != 1 || glyphCount == 0)
     {
         LOG_ERROR_VARG("Failed to read glyph count for font: %s", id);
+        SAFE_DELETE(fontData);
         return NULL;
     }
-    Font::Glyph* glyphs = new Font::Glyph[glyphCount];
-    if (fread(glyphs, sizeof(Font::Glyph), glyphCount, _file) != glyphCount)
+    fontData->glyphs.resize(glyphCount);
+    if (read(&fontData->glyphs[0], sizeof(Font::Glyph), glyphCount) != glyphCount)
     {
         LOG_ERROR_VARG("Failed to read %d glyphs for font: %s", glyphCount, id);
-        SAFE_DELETE_ARRAY(glyphs);
+        SAFE_DELETE(fontData);
         return NULL;
     }
 
     // Read texture
-    unsigned int width, height, textureByteCount;
-    if (fread(&width, 4, 1, _file) != 1 ||
-        fread(&height, 4, 1, _file) != 1 ||
-        fread(&textureByteCount, 4, 1, _file) != 1)
+    unsigned int textureByteCount;
+    if (read(&fontData->width, 4, 1) != 1 ||
+        read(&fontData->height, 4, 1) != 1 ||
+        read(&textureByteCount, 4, 1) != 1)
     {
         LOG_ERROR_VARG("Failed to read texture attributes for font: %s", id);
-        SAFE_DELETE_ARRAY(glyphs);
+        SAFE_DELETE(fontData);
         return NULL;
     }
-    if (textureByteCount != (width * height))
+    if (textureByteCount != (fontData->width * fontData->height) || textureByteCount == 0)
     {
         LOG_ERROR_VARG("Invalid texture byte for font: %s", id);
-        SAFE_DELETE_ARRAY(glyphs);
+        SAFE_DELETE(fontData);
         return NULL;
     }
-    unsigned char* textureData = new unsigned char[textureByteCount];
-    if (fread(textureData, 1, textureByteCount, _file) != textureByteCount)
+    fontData->textureData.resize(textureByteCount);
+    if (read(&fontData->textureData[0], 1, textureByteCount) != textureByteCount)
     {
         LOG_ERROR_VARG("Failed to read %d texture bytes for font: %s", textureByteCount, id);
-        SAFE_DELETE_ARRAY(glyphs);
-        SAFE_DELETE_ARRAY(textureData);
+        SAFE_DELETE(fontData);
         return NULL;
     }
 
-    // Load the texture for the font
-    Texture* texture = Texture::create(Texture::ALPHA, width, height, textureData, true);
+    return fontData;
+}
 
-    // Free the texture data (no longer needed)
-    SAFE_DELETE_ARRAY(textureData);
+Font* Bundle::loadFont(const char* id)
+{
+    // Use the font data decoded by preload(), if any
+    FontData* fontData = NULL;
+    std::map<std::string, FontData*>::iterator itr = _fontData.find(id);
+    if (itr != _fontData.end())
+    {
+        fontData = itr->second;
+        _fontData.erase(itr);
+    }
+    else
+    {
+        // Seek to the specified Font
+        Reference* ref = seekTo(id, BUNDLE_TYPE_FONT);
+        if (ref == NULL)
+        {
+            return NULL;
+        }
 
+        fontData = readFontData(id);
+        if (fontData == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    // Load the texture for the font
+    Texture* texture = Texture::create(Texture::ALPHA, fontData->width, fontData->height, &fontData->textureData[0], true);
     if (texture == NULL)
     {
         LOG_ERROR_VARG("Failed to create texture for font: %s", id);
-        SAFE_DELETE_ARRAY(glyphs);
+        SAFE_DELETE(fontData);
         return NULL;
     }
 
     // Create the font
-    Font* font = Font::create(family.c_str(), Font::PLAIN, size, glyphs, glyphCount, texture);
+    Font* font = Font::create(fontData->family.c_str(), Font::PLAIN, fontData->size, &fontData->glyphs[0], fontData->glyphs.size(), texture);
 
-    // Free the glyph array
-    SAFE_DELETE_ARRAY(glyphs);
+    // Free the decoded glyphs and texture data (no longer needed)
+    SAFE_DELETE(fontData);
 
     // Release the texture since the Font now owns it
     SAFE_RELEASE(texture);
@@ -1280,6 +1630,48 @@ Font* Bundle::loadFont(const char* id)
     return font;
 }
 
+void Bundle::preload()
+{
+    // Save the file position
+    unsigned int position = tell();
+
+    for (unsigned int i = 0; i < _referenceCount; ++i)
+    {
+        Reference* ref = &_references[i];
+        if (!seek(ref->offset))
+            continue;
+
+        switch (ref->type)
+        {
+        case BUNDLE_TYPE_MESH:
+            if (_meshData.find(ref->id) == _meshData.end())
+            {
+                // Vertex and index data stay in place when the bundle is mapped
+                MeshData* meshData = readMeshData(true);
+                if (meshData)
+                    _meshData[ref->id] = meshData;
+            }
+            break;
+        case BUNDLE_TYPE_FONT:
+            if (_fontData.find(ref->id) == _fontData.end())
+            {
+                FontData* fontData = readFontData(ref->id.c_str());
+                if (fontData)
+                    _fontData[ref->id] = fontData;
+            }
+            break;
+        case BUNDLE_TYPE_ANIMATIONS:
+            if (!_animationsPreloaded)
+                readAnimations(&_animationData);
+            break;
+        }
+    }
+    _animationsPreloaded = true;
+
+    // Restore file pointer
+    seek(position);
+}
+
 void Bundle::setTransform(const float* values, Transform* transform)
 {
     // Load array into transform
@@ -1327,12 +1719,21 @@ Bundle::MeshPartData::~MeshPartData()
 }
 
 Bundle::MeshData::MeshData(const VertexFormat& vertexFormat)
-    : vertexFormat(vertexFormat), vertexCount(0), vertexData(NULL)
+    : vertexFormat(vertexFormat), vertexCount(0), vertexData(NULL), mapped(false)
 {
 }
 
 Bundle::MeshData::~MeshData()
 {
+    if (mapped)
+    {
+        // The vertex and index data belong to the bundle's file mapping.
+        vertexData = NULL;
+        for (unsigned int i = 0; i < parts.size(); ++i)
+        {
+            parts[i]->indexData = NULL;
+        }
+    }
     SAFE_DELETE_ARRAY(vertexData);
 
     for (unsigned int i = 0; i < parts.size(); ++i)
@@ -1341,4 +1742,12 @@ Bundle::MeshData::~MeshData()
     }
 }
 
+Bundle::AnimationData::~AnimationData()
+{
+    for (unsigned int i = 0; i < channels.size(); ++i)
+    {
+        SAFE_DELETE(channels[i]);
+    }
+}
+
 }
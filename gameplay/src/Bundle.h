@@ -16,6 +16,8 @@ namespace gameplay
 class Bundle : public Ref
 {
     friend class PhysicsController;
+    friend class ResourceLoader;
+    friend class StaticBatcher;
 
 public:
 
@@ -141,6 +143,34 @@ private:
         BoundingSphere boundingSphere;
         Mesh::PrimitiveType primitiveType;
         std::vector<MeshPartData*> parts;
+        bool mapped;                            // True if the vertex and index data point into the bundle's file mapping.
+    };
+
+    struct AnimationChannelData
+    {
+        std::string targetId;
+        unsigned int targetAttribute;
+        std::vector<unsigned long> keyTimes;
+        std::vector<float> values;
+    };
+
+    struct AnimationData
+    {
+        ~AnimationData();
+
+        std::string id;
+        std::vector<AnimationChannelData*> channels;
+    };
+
+    struct FontData
+    {
+        std::string family;
+        unsigned int style;
+        unsigned int size;
+        std::vector<Font::Glyph> glyphs;
+        unsigned int width;
+        unsigned int height;
+        std::vector<unsigned char> textureData;
     };
 
     Bundle(const char* path);
@@ -215,6 +245,76 @@ private:
      */
     Mesh* loadMesh(const char* id, const char* nodeId);
 
+    /**
+     * Decodes the payloads of the meshes, animations and fonts in the bundle ahead of time.
+     *
+     * This is called on a worker thread by the ResourceLoader, before the bundle is handed to
+     * the main thread. It only reads the bundle, so that loading objects from the bundle later
+     * is left with building nodes and creating GL objects from the decoded data. The decoded
+     * data of each object is released once the object is first loaded.
+     */
+    void preload();
+
+    /**
+     * Builds the hash tables used to look up references by ID and by offset.
+     */
+    void buildReferenceTables();
+
+    /**
+     * Hashes a reference ID.
+     */
+    static unsigned int hashId(const char* id);
+
+    /**
+     * Hashes a reference offset.
+     */
+    static unsigned int hashOffset(unsigned int offset);
+
+    /**
+     * Reads count elements of the given size from the current file position, like fread.
+     *
+     * @param ptr The buffer to read the elements into.
+     * @param size The size of each element in bytes.
+     * @param count The number of elements to read.
+     * 
+     * @return The number of whole elements read.
+     */
+    size_t read(void* ptr, size_t size, size_t count);
+
+    /**
+     * Returns a pointer to the given number of bytes at the current file position
+     * within the file mapping, and advances the file position past them.
+     *
+     * @param byteCount The number of bytes to read.
+     * 
+     * @return A pointer into the file mapping, or NULL if the bundle is not mapped
+     *      or fewer than byteCount bytes remain.
+     */
+    const unsigned char* readMapped(unsigned int byteCount);
+
+    /**
+     * Sets the current file position.
+     *
+     * @param offset The offset from the beginning of the file.
+     * 
+     * @return True if successful, false if an error occurred.
+     */
+    bool seek(unsigned int offset);
+
+    /**
+     * Gets the current file position.
+     *
+     * @return The offset from the beginning of the file.
+     */
+    unsigned int tell() const;
+
+    /**
+     * Reads a length-prefixed string from the current file position.
+     *
+     * @return The string, or an empty string if an error occurred.
+     */
+    std::string readString();
+
     /**
      * Reads an unsigned int from the current file position.
      *
@@ -325,8 +425,12 @@ private:
 
     /**
      * Reads mesh data from the current file position.
+     *
+     * @param mapData true to reference the vertex and index data directly in the bundle's
+     *      file mapping instead of copying it, if the bundle is mapped. Such data is only
+     *      valid for as long as the bundle is alive.
      */
-    MeshData* readMeshData();
+    MeshData* readMeshData(bool mapData);
 
     /**
      * Reads mesh data for the specified URL.
@@ -351,27 +455,53 @@ private:
     /**
      * Reads an animation from the current file position.
      * 
-     * @param scene The scene to load the animations into.
+     * @return The animation data, or NULL if there was an error.
      */
-    void readAnimation(Scene* scene);
+    AnimationData* readAnimation();
 
     /**
      * Reads an "animations" object from the current file position and all of the animations contained in it.
      * 
-     * @param scene The scene to load the animations into.
+     * @param animations The vector to append the animations to.
      */
-    void readAnimations(Scene* scene);
+    void readAnimations(std::vector<AnimationData*>* animations);
 
     /**
-     * Reads an animation channel at the current file position into the given animation.
+     * Reads an animation channel at the current file position.
      * 
-     * @param scene The scene that the animation is in.
-     * @param animation The animation to the load channel into.
-     * @param animationId The ID of the animation that this channel is loaded into.
+     * @param animationId The ID of the animation that the channel belongs to.
+     * @param channel The channel data to load the channel into.
      * 
-     * @return The animation that the channel was loaded into.
+     * @return True if successful, false if an error occurred.
      */
-    Animation* readAnimationChannel(Scene* scene, Animation* animation, const char* animationId);
+    bool readAnimationChannel(const char* animationId, AnimationChannelData* channel);
+
+    /**
+     * Creates the animations of the given animation data in a scene.
+     *
+     * @param scene The scene containing the animation targets.
+     * @param animations The animations to create.
+     */
+    void createAnimations(Scene* scene, const std::vector<AnimationData*>& animations);
+
+    /**
+     * Reads and decodes the key frames of an animation channel stored in the quantized format.
+     *
+     * @param keyTimes The vector to load the key times into, in milliseconds.
+     * @param values The vector to load the key values into.
+     *
+     * @return True if successful, false if an error occurred.
+     */
+    bool readQuantizedKeys(std::vector<unsigned long>* keyTimes, std::vector<float>* values);
+
+    /**
+     * Reads a font from the current file position.
+     *
+     * @param id The ID of the font, used in error messages.
+     *
+     * @return The font data, or NULL if there was an error.
+     */
+    FontData* readFontData(const char* id);
 
     /**
      * Sets the transformation matrix.
@@ -389,11 +519,23 @@ private:
 private:
 
     std::string _path;
+    unsigned char _version[2];          // The major and minor version of the bundle file.
     unsigned int _referenceCount;
     Reference* _references;
-    FILE* _file;
+    unsigned int _tableSize;            // The number of slots in each reference hash table (a power of two).
+    unsigned int* _idTable;             // Open addressed hash table of reference indices, keyed by ID.
+    unsigned int* _offsetTable;         // Open addressed hash table of reference indices, keyed by offset.
+    FILE* _file;                        // The open bundle file, or NULL if the file is mapped.
+    const unsigned char* _data;         // The mapped contents of the bundle file, or NULL if it is read through _file.
+    unsigned int _dataSize;             // The size of the mapping in bytes.
+    unsigned int _position;             // The current read position within the mapping.
 
     std::vector<MeshSkinData*> _meshSkins;
+
+    std::map<std::string, MeshData*> _meshData;             // Mesh data decoded by preload(), keyed by mesh ID.
+    std::map<std::string, FontData*> _fontData;             // Font data decoded by preload(), keyed by font ID.
+    std::vector<AnimationData*> _animationData;             // The animations of the bundle decoded by preload().
+    bool _animationsPreloaded;                              // True if _animationData holds all the animations of the bundle.
 };
 
 }
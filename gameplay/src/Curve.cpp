@@ -5,6 +5,7 @@
 #include <cassert>
 #include <cmath>
 #include <memory>
+#include <cstring>
 
 using std::memcpy;
 using std::fabs;
@@ -60,15 +61,22 @@ Curve* Curve::create(unsigned int pointCount, unsigned int componentCount)
 }
 
 Curve::Curve(unsigned int pointCount, unsigned int componentCount)
-    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL)
+    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL), _values(NULL)
 {
+    // Store the values of all points contiguously, followed by all in tangents and then all out tangents,
+    // so that neighbouring keys share cache lines and the whole curve is a single allocation.
+    unsigned int valueCount = _pointCount * _componentCount;
+    _values = new float[valueCount * 3];
+    float* inValues = _values + valueCount;
+    float* outValues = inValues + valueCount;
+
     _points = new Point[_pointCount];
     for (unsigned int i = 0; i < _pointCount; i++)
     {
         _points[i].time = 0.0f;
-        _points[i].value = new float[_componentCount];
-        _points[i].inValue = new float[_componentCount];
-        _points[i].outValue = new float[_componentCount];
+        _points[i].value = _values + i * _componentCount;
+        _points[i].inValue = inValues + i * _componentCount;
+        _points[i].outValue = outValues + i * _componentCount;
         _points[i].type = LINEAR;
     }
     _points[_pointCount - 1].time = 1.0f;
@@ -77,6 +85,7 @@ Curve::Curve(unsigned int pointCount, unsigned int componentCount)
 Curve::~Curve()
 {
     SAFE_DELETE_ARRAY(_points);
+    SAFE_DELETE_ARRAY(_values);
     SAFE_DELETE_ARRAY(_quaternionOffset);
 }
 
@@ -85,13 +94,6 @@ Curve::Point::Point()
 {
 }
 
-Curve::Point::~Point()
-{
-    SAFE_DELETE_ARRAY(value);
-    SAFE_DELETE_ARRAY(inValue);
-    SAFE_DELETE_ARRAY(outValue);
-}
-
 unsigned int Curve::getPointCount() const
 {
     return _pointCount;
@@ -148,6 +150,11 @@ void Curve::setTangent(unsigned int index, InterpolationType type, float* inValu
 }
 
 void Curve::evaluate(float time, float* dst) const
+{
+    evaluate(time, dst, NULL);
+}
+
+void Curve::evaluate(float time, float* dst, unsigned int* cursor) const
 {
     assert(dst && time >= 0 && time <= 1.0f);
 
@@ -164,8 +171,17 @@ void Curve::evaluate(float time, float* dst) const
         return;
     }
 
-    // Locate the points we are interpolating between using a binary search.
-    unsigned int index = determineIndex(time);
+    // Locate the points we are interpolating between, resuming from the cursor if one was given.
+    unsigned int index;
+    if (cursor)
+    {
+        index = determineIndex(time, *cursor);
+        *cursor = index;
+    }
+    else
+    {
+        index = determineIndex(time);
+    }
     
     Point* from = _points + index;
     Point* to = _points + (index + 1);
@@ -1155,6 +1171,28 @@ int Curve::determineIndex(float time) const
     return -1;
 }
 
+unsigned int Curve::determineIndex(float time, unsigned int cursor) const
+{
+    // Playback usually stays within the same segment or moves into an adjacent one.
+    if (cursor < _pointCount - 1)
+    {
+        if (time >= _points[cursor].time)
+        {
+            if (time <= _points[cursor + 1].time)
+                return cursor;
+            if (cursor + 2 < _pointCount && time <= _points[cursor + 2].time)
+                return cursor + 1;
+        }
+        else if (cursor > 0 && time >= _points[cursor - 1].time)
+        {
+            return cursor - 1;
+        }
+    }
+
+    // Fall back to a binary search after a seek or a large time step.
+    return (unsigned int)determineIndex(time);
+}
+
 int Curve::getInterpolationType(const char* curveId)
 {
     if (strcmp(curveId, "BEZIER") == 0)
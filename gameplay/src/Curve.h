@@ -351,6 +351,22 @@ public:
      */
     void evaluate(float time, float* dst) const;
 
+    /**
+     * Evaluates the curve at the given position value (between 0.0 and 1.0 inclusive),
+     * resuming the keyframe search from a cursor.
+     *
+     * The cursor holds the index of the segment that was last evaluated. When the curve is
+     * evaluated at steadily increasing (or decreasing) times, as it is during playback, the
+     * segment containing the new time is usually the same as, or adjacent to, the previous
+     * one. It is then found in constant time instead of by a binary search over all keys.
+     * The cursor is updated to the segment used for this evaluation.
+     *
+     * @param time The position to evaluate the curve at.
+     * @param dst The evaluated value of the curve at the given time.
+     * @param cursor The segment index to resume searching from (initialize to 0).
+     */
+    void evaluate(float time, float* dst, unsigned int* cursor) const;
+
     /**
      * Linear interpolation function.
      */
@@ -360,6 +376,9 @@ private:
 
     /**
      * Defines a single point within a curve.
+     *
+     * The value arrays of a point refer into the curve's packed value storage
+     * and are not owned by the point.
      */
     class Point
     {
@@ -380,11 +399,6 @@ private:
          * Constructor.
          */
         Point();
-
-        /**
-         * Destructor.
-         */
-        ~Point();
     };
 
     /**
@@ -455,6 +469,12 @@ private:
      */ 
     int determineIndex(float time) const;
 
+    /**
+     * Determines the current keyframe to interpolate from based on the specified time,
+     * checking the segment at the given cursor and its neighbours before searching.
+     */
+    unsigned int determineIndex(float time, unsigned int cursor) const;
+
     /**
      * Sets the offset for the beginning of a Quaternion piece of data within the curve's value span at the specified
      * index. The next four components of data starting at the given index will be interpolated as a Quaternion.
@@ -478,6 +498,7 @@ private:
     unsigned int _componentSize;        // The component size (in bytes).
     unsigned int* _quaternionOffset;    // Offset for the rotation component.
     Point* _points;                     // The points on the curve.
+    float* _values;                     // Packed storage for the values, then in tangents, then out tangents, of all points.
 };
 
 inline static float bezier(float eq0, float eq1, float eq2, float eq3, float from, float out, float to, float in);
@@ -11,6 +11,63 @@ namespace gameplay
 static std::map<std::string, Effect*> __effectCache;
 static Effect* __currentEffect = NULL;
 
+// Uniform upload statistics for the current and the last frame.
+static unsigned int __uniformUploadCount = 0;
+static unsigned int __uniformSkipCount = 0;
+static unsigned int __lastUniformUploadCount = 0;
+static unsigned int __lastUniformSkipCount = 0;
+
+/**
+ * Orders interned names by their characters rather than their addresses.
+ */
+struct UniformNameLess
+{
+    bool operator()(const char* a, const char* b) const
+    {
+        return strcmp(a, b) < 0;
+    }
+};
+
+// Interned uniform and material parameter names, indexed by their identifiers. The map is keyed
+// with the names stored in the deque, which never moves them, so lookups do not allocate strings.
+static std::deque<std::string> __uniformNames;
+static std::map<const char*, unsigned int, UniformNameLess> __uniformNameIds;
+
+/**
+ * Returns the size in bytes of a single element of a uniform of the given type.
+ */
+static unsigned int getUniformElementSize(GLenum type)
+{
+    switch (type)
+    {
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_BOOL:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_CUBE:
+        return 4;
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2:
+        return 8;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3:
+        return 12;
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4:
+    case GL_FLOAT_MAT2:
+        return 16;
+    case GL_FLOAT_MAT3:
+        return 36;
+    case GL_FLOAT_MAT4:
+        return 64;
+    default:
+        return 0;
+    }
+}
+
 Effect::Effect() : _program(0)
 {
 }
@@ -281,7 +338,23 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
                 uniform->_type = uniformType;
                 uniform->_index = uniformType == GL_SAMPLER_2D ? (samplerIndex++) : 0;
 
+                // Uniforms are initialized to zero when the program is linked, so the shadow copy starts zeroed as well.
+                uniform->_valueSize = getUniformElementSize(uniformType) * uniformSize;
+                if (uniform->_valueSize > 0)
+                {
+                    uniform->_value = new unsigned char[uniform->_valueSize];
+                    memset(uniform->_value, 0, uniform->_valueSize);
+                }
+
                 effect->_uniforms[uniformName] = uniform;
+
+                // Index the uniform by the interned id of its name.
+                unsigned int nameId = getUniformNameId(uniformName);
+                if (nameId >= effect->_uniformsByNameId.size())
+                {
+                    effect->_uniformsByNameId.resize(nameId + 1, NULL);
+                }
+                effect->_uniformsByNameId[nameId] = uniform;
             }
             SAFE_DELETE_ARRAY(uniformName);
         }
@@ -325,64 +398,143 @@ unsigned int Effect::getUniformCount() const
     return _uniforms.size();
 }
 
+unsigned int Effect::getUniformNameId(const char* name)
+{
+    assert(name);
+
+    unsigned int nameId;
+    if (findUniformNameId(name, &nameId))
+    {
+        return nameId;
+    }
+
+    nameId = __uniformNames.size();
+    __uniformNames.push_back(name);
+    __uniformNameIds[__uniformNames.back().c_str()] = nameId;
+    return nameId;
+}
+
+bool Effect::findUniformNameId(const char* name, unsigned int* nameId)
+{
+    assert(name);
+    assert(nameId);
+
+    std::map<const char*, unsigned int, UniformNameLess>::const_iterator itr = __uniformNameIds.find(name);
+    if (itr == __uniformNameIds.end())
+    {
+        return false;
+    }
+
+    *nameId = itr->second;
+    return true;
+}
+
+const char* Effect::getUniformName(unsigned int nameId)
+{
+    assert(nameId < __uniformNames.size());
+
+    return __uniformNames[nameId].c_str();
+}
+
+Uniform* Effect::getUniformByNameId(unsigned int nameId) const
+{
+    return nameId < _uniformsByNameId.size() ? _uniformsByNameId[nameId] : NULL;
+}
+
 void Effect::setValue(Uniform* uniform, float value)
 {
-    GL_ASSERT( glUniform1f(uniform->_location, value) );
+    if (updateUniformValue(uniform, &value, sizeof(float)))
+    {
+        GL_ASSERT( glUniform1f(uniform->_location, value) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const float* values, unsigned int count)
 {
-    GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
+    if (updateUniformValue(uniform, values, sizeof(float) * count))
+    {
+        GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, int value)
 {
-    GL_ASSERT( glUniform1i(uniform->_location, value) );
+    if (updateUniformValue(uniform, &value, sizeof(int)))
+    {
+        GL_ASSERT( glUniform1i(uniform->_location, value) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const int* values, unsigned int count)
 {
-    GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
+    if (updateUniformValue(uniform, values, sizeof(int) * count))
+    {
+        GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix& value)
 {
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
+    if (updateUniformValue(uniform, value.m, sizeof(float) * 16))
+    {
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix* values, unsigned int count)
 {
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(float) * 16 * count))
+    {
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2& value)
 {
-    GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
+    if (updateUniformValue(uniform, &value.x, sizeof(float) * 2))
+    {
+        GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2* values, unsigned int count)
 {
-    GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(float) * 2 * count))
+    {
+        GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3& value)
 {
-    GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
+    if (updateUniformValue(uniform, &value.x, sizeof(float) * 3))
+    {
+        GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3* values, unsigned int count)
 {
-    GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(float) * 3 * count))
+    {
+        GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4& value)
 {
-    GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
+    if (updateUniformValue(uniform, &value.x, sizeof(float) * 4))
+    {
+        GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4* values, unsigned int count)
 {
-    GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(float) * 4 * count))
+    {
+        GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
@@ -394,14 +546,22 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
     // Bind the sampler - this binds the texture and applies sampler state
     const_cast<Texture::Sampler*>(sampler)->bind();
 
-    GL_ASSERT( glUniform1i(uniform->_location, uniform->_index) );
+    GLint index = uniform->_index;
+    if (updateUniformValue(uniform, &index, sizeof(GLint)))
+    {
+        GL_ASSERT( glUniform1i(uniform->_location, index) );
+    }
 }
 
 void Effect::bind()
 {
-    GL_ASSERT( glUseProgram(_program) );
+    // Uniform values are stored with the program, so they do not need to be re-sent when rebinding.
+    if (__currentEffect != this)
+    {
+        GL_ASSERT( glUseProgram(_program) );
 
-    __currentEffect = this;
+        __currentEffect = this;
+    }
 }
 
 Effect* Effect::getCurrentEffect()
@@ -409,8 +569,46 @@ Effect* Effect::getCurrentEffect()
     return __currentEffect;
 }
 
+unsigned int Effect::getUniformUploadCount()
+{
+    return __lastUniformUploadCount;
+}
+
+unsigned int Effect::getUniformSkipCount()
+{
+    return __lastUniformSkipCount;
+}
+
+void Effect::endFrame()
+{
+    __lastUniformUploadCount = __uniformUploadCount;
+    __lastUniformSkipCount = __uniformSkipCount;
+    __uniformUploadCount = 0;
+    __uniformSkipCount = 0;
+}
+
+bool Effect::updateUniformValue(Uniform* uniform, const void* value, unsigned int size)
+{
+    // Values that do not fit the shadow copy (for example, invalid uniforms) are always uploaded.
+    if (size > uniform->_valueSize)
+    {
+        ++__uniformUploadCount;
+        return true;
+    }
+
+    if (memcmp(uniform->_value, value, size) == 0)
+    {
+        ++__uniformSkipCount;
+        return false;
+    }
+
+    memcpy(uniform->_value, value, size);
+    ++__uniformUploadCount;
+    return true;
+}
+
 Uniform::Uniform() :
-    _location(-1), _type(0), _index(0)
+    _location(-1), _type(0), _index(0), _value(NULL), _valueSize(0)
 {
 }
 
@@ -421,7 +619,7 @@ Uniform::Uniform(const Uniform& copy)
 
 Uniform::~Uniform()
 {
-    // hidden
+    SAFE_DELETE_ARRAY(_value);
 }
 
 Effect* Uniform::getEffect() const
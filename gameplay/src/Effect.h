@@ -25,6 +25,9 @@ class Uniform;
  */
 class Effect: public Ref
 {
+    friend class Game;
+    friend class RenderState;
+
 public:
 
     /**
@@ -89,6 +92,38 @@ public:
      */
     unsigned int getUniformCount() const;
 
+    /**
+     * Returns the unique integer identifier of the given uniform name.
+     *
+     * Names are interned the first time they are seen, so that uniforms can be
+     * matched with material parameters without comparing strings.
+     *
+     * @param name The uniform name.
+     *
+     * @return The identifier of the name.
+     */
+    static unsigned int getUniformNameId(const char* name);
+
+    /**
+     * Looks up the identifier of the given uniform name, without interning the name if it has
+     * not been seen before.
+     *
+     * @param name The uniform name.
+     * @param nameId Receives the identifier of the name, if it has one.
+     *
+     * @return true if the name has an identifier, false otherwise.
+     */
+    static bool findUniformNameId(const char* name, unsigned int* nameId);
+
+    /**
+     * Returns the uniform name that has the given identifier.
+     *
+     * @param nameId The identifier returned by getUniformNameId().
+     *
+     * @return The uniform name.
+     */
+    static const char* getUniformName(unsigned int nameId);
+
     /**
      * Sets a float uniform value.
      *
@@ -211,6 +246,21 @@ public:
      */
     static Effect* getCurrentEffect();
 
+    /**
+     * Returns the number of uniform values sent to the rendering system during the last frame.
+     *
+     * @return The number of uniform uploads.
+     */
+    static unsigned int getUniformUploadCount();
+
+    /**
+     * Returns the number of uniform values that were not sent to the rendering system during
+     * the last frame, because the uniform already held the same value.
+     *
+     * @return The number of skipped uniform uploads.
+     */
+    static unsigned int getUniformSkipCount();
+
 private:
 
     /**
@@ -225,10 +275,36 @@ private:
 
     static Effect* createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines = NULL);
 
+    /**
+     * Records the uniform upload statistics of the frame that just ended. Called by Game.
+     */
+    static void endFrame();
+
+    /**
+     * Compares a value with the last value sent for the given uniform, and records it if it differs.
+     *
+     * @param uniform The uniform being set.
+     * @param value The new value.
+     * @param size The size of the new value in bytes.
+     *
+     * @return true if the value must be sent to the rendering system, false if the uniform already holds it.
+     */
+    static bool updateUniformValue(Uniform* uniform, const void* value, unsigned int size);
+
+    /**
+     * Returns the uniform whose name has the given identifier.
+     *
+     * @param nameId The identifier returned by getUniformNameId().
+     *
+     * @return The uniform, or NULL if this effect has no such uniform.
+     */
+    Uniform* getUniformByNameId(unsigned int nameId) const;
+
     GLuint _program;
     std::string _id;
     std::map<std::string, VertexAttribute> _vertexAttributes;
     std::map<std::string, Uniform*> _uniforms;
+    std::vector<Uniform*> _uniformsByNameId;
     static Uniform _emptyUniform;
 };
 
@@ -284,6 +360,8 @@ private:
     GLenum _type;
     unsigned int _index;
     Effect* _effect;
+    unsigned char* _value;          // Shadow copy of the value last sent for this uniform.
+    unsigned int _valueSize;        // The size of the shadow copy in bytes.
 };
 
 }
@@ -5,9 +5,11 @@
     #include <windows.h>
     #include <tchar.h>
     #include <stdio.h>
+    #include <io.h>
 #else
     #include <dirent.h>
     #include <sys/stat.h>
+    #include <sys/mman.h>
 #endif
 
 #ifdef __ANDROID__
@@ -174,8 +176,8 @@ FILE* FileSystem::openFile(const char* path, const char* mode)
     
     FILE* fp = fopen(fullPath.c_str(), mode);
     
-// Win32 doesn't support an asset or bundle definitions.
-#ifdef WIN32
+// Win32 and Linux don't support an asset or bundle definitions.
+#if defined(WIN32) || (defined(__linux__) && !defined(__ANDROID__))
     if (fp == NULL)
     {
         fullPath = __resourcePath;
@@ -227,4 +229,59 @@ char* FileSystem::readAll(const char* filePath, int* fileSize)
     return buffer;
 }
 
+const void* FileSystem::mapFile(FILE* file, unsigned int* size)
+{
+    assert(file);
+    assert(size);
+
+    *size = 0;
+
+#ifdef WIN32
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+    if (handle == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0 || fileSize.HighPart != 0)
+        return NULL;
+
+    HANDLE mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+        return NULL;
+
+    // The view keeps the mapping object alive after its handle is closed.
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL)
+        return NULL;
+
+    *size = (unsigned int)fileSize.LowPart;
+    return data;
+#else
+    int fd = fileno(file);
+    struct stat s;
+    if (fd < 0 || fstat(fd, &s) != 0 || s.st_size <= 0)
+        return NULL;
+
+    void* data = mmap(NULL, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    *size = (unsigned int)s.st_size;
+    return data;
+#endif
+}
+
+void FileSystem::unmapFile(const void* data, unsigned int size)
+{
+    if (data == NULL)
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<void*>(data), size);
+#endif
+}
+
 }
@@ -70,6 +70,29 @@ public:
      */
     static char* readAll(const char* filePath, int* fileSize = NULL);
 
+    /**
+     * Maps the entire contents of an open file into memory for reading.
+     *
+     * The mapping remains valid after the file is closed, until it is released by calling
+     * unmapFile(). Pages of the file are loaded on demand by the operating system, so no
+     * copy of the file contents is made up front.
+     *
+     * @param file The file to map, which must have been opened for reading in binary mode.
+     * @param size Populated with the size of the mapping in bytes.
+     * 
+     * @return A pointer to the read-only contents of the file, or NULL if the file could
+     *      not be mapped (for example, if it is empty or the platform does not support it).
+     */
+    static const void* mapFile(FILE* file, unsigned int* size);
+
+    /**
+     * Releases a mapping returned by mapFile().
+     *
+     * @param data The pointer returned by mapFile().
+     * @param size The size of the mapping returned by mapFile().
+     */
+    static void unmapFile(const void* data, unsigned int size);
+
 private:
 
     /**
@@ -2,10 +2,14 @@
 #include "Frustum.h"
 #include "BoundingSphere.h"
 #include "BoundingBox.h"
+#include "MathUtil.h"
 
 namespace gameplay
 {
 
+// The number of visible objects in each four bit culling mask.
+static const unsigned char __maskBitCounts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
 Frustum::Frustum()
 {
     set(Matrix::identity());
@@ -94,6 +98,106 @@ float Frustum::intersects(const Ray& ray) const
     return ray.intersects(*this);
 }
 
+unsigned int Frustum::cullSpheres(const float* x, const float* y, const float* z, const float* radius,
+                                  unsigned int count, unsigned int* visible, unsigned char* planeCache) const
+{
+    assert(x && y && z && radius && visible);
+
+    float planes[48];
+    getCullPlanes(planes);
+    memset(visible, 0, ((count + 31) / 32) * sizeof(unsigned int));
+
+    // Without a cache, neighbouring groups share the last culling plane.
+    unsigned char sharedPlane = 0;
+    unsigned int visibleCount = 0;
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        unsigned char* plane = planeCache ? &planeCache[i / 4] : &sharedPlane;
+        unsigned int mask;
+        if (i + 4 <= count)
+        {
+            mask = MathUtil::cullSpheres4(planes, &x[i], &y[i], &z[i], &radius[i], plane);
+        }
+        else
+        {
+            // Pad the last group; the padding results are discarded.
+            float px[4] = { 0 }, py[4] = { 0 }, pz[4] = { 0 }, pr[4] = { 0 };
+            for (unsigned int j = 0; i + j < count; ++j)
+            {
+                px[j] = x[i + j];
+                py[j] = y[i + j];
+                pz[j] = z[i + j];
+                pr[j] = radius[i + j];
+            }
+            mask = MathUtil::cullSpheres4(planes, px, py, pz, pr, plane) & ((1 << (count - i)) - 1);
+        }
+        visible[i / 32] |= mask << (i % 32);
+        visibleCount += __maskBitCounts[mask];
+    }
+
+    return visibleCount;
+}
+
+unsigned int Frustum::cullBoxes(const float* minX, const float* minY, const float* minZ,
+                                const float* maxX, const float* maxY, const float* maxZ,
+                                unsigned int count, unsigned int* visible, unsigned char* planeCache) const
+{
+    assert(minX && minY && minZ && maxX && maxY && maxZ && visible);
+
+    float planes[48];
+    getCullPlanes(planes);
+    memset(visible, 0, ((count + 31) / 32) * sizeof(unsigned int));
+
+    // Without a cache, neighbouring groups share the last culling plane.
+    unsigned char sharedPlane = 0;
+    unsigned int visibleCount = 0;
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        unsigned char* plane = planeCache ? &planeCache[i / 4] : &sharedPlane;
+        unsigned int mask;
+        if (i + 4 <= count)
+        {
+            mask = MathUtil::cullBoxes4(planes, &minX[i], &minY[i], &minZ[i], &maxX[i], &maxY[i], &maxZ[i], plane);
+        }
+        else
+        {
+            // Pad the last group; the padding results are discarded.
+            float p[6][4] = { { 0 } };
+            for (unsigned int j = 0; i + j < count; ++j)
+            {
+                p[0][j] = minX[i + j];
+                p[1][j] = minY[i + j];
+                p[2][j] = minZ[i + j];
+                p[3][j] = maxX[i + j];
+                p[4][j] = maxY[i + j];
+                p[5][j] = maxZ[i + j];
+            }
+            mask = MathUtil::cullBoxes4(planes, p[0], p[1], p[2], p[3], p[4], p[5], plane) & ((1 << (count - i)) - 1);
+        }
+        visible[i / 32] |= mask << (i % 32);
+        visibleCount += __maskBitCounts[mask];
+    }
+
+    return visibleCount;
+}
+
+void Frustum::getCullPlanes(float* planes) const
+{
+    const Plane* source[6] = { &_near, &_far, &_left, &_right, &_bottom, &_top };
+    for (unsigned int i = 0; i < 6; ++i, planes += 8)
+    {
+        const Vector3& normal = source[i]->getNormal();
+        planes[0] = normal.x;
+        planes[1] = normal.y;
+        planes[2] = normal.z;
+        planes[3] = source[i]->getDistance();
+        planes[4] = fabsf(normal.x);
+        planes[5] = fabsf(normal.y);
+        planes[6] = fabsf(normal.z);
+        planes[7] = 0.0f;
+    }
+}
+
 void Frustum::set(const Frustum& frustum)
 {
     _near = frustum._near;
@@ -153,6 +153,57 @@ public:
      */
     float intersects(const Ray& ray) const;
 
+    /**
+     * Tests an array of bounding spheres against this frustum.
+     *
+     * The spheres are given as separate arrays of center coordinates and radii, and are
+     * tested four at a time using SIMD instructions where available. A group of spheres stops
+     * being tested as soon as all of them are outside one plane. The results are written
+     * to a bit mask, with bit (i % 32) of visible[i / 32] set if sphere i intersects this
+     * frustum, as Frustum::intersects(const BoundingSphere&) would report.
+     *
+     * Objects that are culled in consecutive frames are usually culled by the same plane.
+     * If planeCache is given, it remembers the plane that culled each group of four spheres
+     * and tests that plane first the next time. It must hold (count + 3) / 4 bytes, zeroed
+     * before the first call and kept unchanged between calls for the same spheres.
+     *
+     * @param x The x coordinates of the sphere centers.
+     * @param y The y coordinates of the sphere centers.
+     * @param z The z coordinates of the sphere centers.
+     * @param radius The radii of the spheres.
+     * @param count The number of spheres.
+     * @param visible The bit mask to store the results in. It must hold (count + 31) / 32 elements.
+     * @param planeCache The per-group plane cache, or NULL.
+     *
+     * @return The number of spheres that intersect this frustum.
+     */
+    unsigned int cullSpheres(const float* x, const float* y, const float* z, const float* radius,
+                             unsigned int count, unsigned int* visible, unsigned char* planeCache = NULL) const;
+
+    /**
+     * Tests an array of axis-aligned bounding boxes against this frustum.
+     *
+     * The boxes are given as separate arrays of minimum and maximum coordinates. They are
+     * tested, and the results written to visible and planeCache, as for cullSpheres(). Bit i
+     * is set if box i intersects this frustum, as Frustum::intersects(const BoundingBox&)
+     * would report.
+     *
+     * @param minX The minimum x coordinates of the boxes.
+     * @param minY The minimum y coordinates of the boxes.
+     * @param minZ The minimum z coordinates of the boxes.
+     * @param maxX The maximum x coordinates of the boxes.
+     * @param maxY The maximum y coordinates of the boxes.
+     * @param maxZ The maximum z coordinates of the boxes.
+     * @param count The number of boxes.
+     * @param visible The bit mask to store the results in. It must hold (count + 31) / 32 elements.
+     * @param planeCache The per-group plane cache, or NULL.
+     *
+     * @return The number of boxes that intersect this frustum.
+     */
+    unsigned int cullBoxes(const float* minX, const float* minY, const float* minZ,
+                           const float* maxX, const float* maxY, const float* maxZ,
+                           unsigned int count, unsigned int* visible, unsigned char* planeCache = NULL) const;
+
     /**
      * Sets this frustum to the specified frustum.
      *
@@ -174,6 +225,11 @@ private:
      */
     void updatePlanes();
 
+    /**
+     * Stores the planes in the layout expected by the MathUtil culling kernels.
+     */
+    void getCullPlanes(float* planes) const;
+
     Plane _near;
     Plane _far;
     Plane _bottom;
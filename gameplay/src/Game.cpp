@@ -15,9 +15,9 @@ long Game::_pausedTimeTotal = 0L;
 
 Game::Game() 
     : _initialized(false), _state(UNINITIALIZED), 
-      _frameLastFPS(0), _frameCount(0), _frameRate(0), 
+      _frameLastFPS(0), _frameCount(0), _frameRate(0), _frameNumber(0), 
       _clearDepth(1.0f), _clearStencil(0),
-      _animationController(NULL), _audioController(NULL), _physicsController(NULL), _audioListener(NULL)
+      _animationController(NULL), _audioController(NULL), _physicsController(NULL), _resourceLoader(NULL), _audioListener(NULL)
 {
     assert(__gameInstance == NULL);
     __gameInstance = this;
@@ -106,6 +106,9 @@ bool Game::startup()
     _physicsController = new PhysicsController();
     _physicsController->initialize();
 
+    _resourceLoader = new ResourceLoader();
+    _resourceLoader->initialize();
+
     _state = RUNNING;
 
     return true;
@@ -119,6 +122,9 @@ void Game::shutdown()
         Platform::signalShutdown();
         finalize();
 
+        _resourceLoader->finalize();
+        SAFE_DELETE(_resourceLoader);
+
         _animationController->finalize();
         SAFE_DELETE(_animationController);
 
@@ -181,6 +187,9 @@ void Game::frame()
         long elapsedTime = (frameTime - lastFrameTime);
         lastFrameTime = frameTime;
 
+        // Complete resources loaded in the background.
+        _resourceLoader->update();
+
         // Update the scheduled and running animations.
         _animationController->update(elapsedTime);
 
@@ -196,6 +205,7 @@ void Game::frame()
         _audioController->update(elapsedTime);
         // Graphics Rendering.
         render(elapsedTime);
+        Effect::endFrame();
 
         // Update FPS.
         ++_frameCount;
@@ -213,7 +223,9 @@ void Game::frame()
 
         // Graphics Rendering.
         render(0);
+        Effect::endFrame();
     }
+    ++_frameNumber;
 }
 
 void Game::setViewport(const Rectangle& viewport)
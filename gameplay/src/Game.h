@@ -9,6 +9,7 @@
 #include "AudioController.h"
 #include "AnimationController.h"
 #include "PhysicsController.h"
+#include "ResourceLoader.h"
 #include "AudioListener.h"
 #include "Rectangle.h"
 #include "Vector4.h"
@@ -138,6 +139,15 @@ public:
      */
     inline unsigned int getFrameRate() const;
 
+    /**
+     * Gets the number of frames since the game started.
+     *
+     * This is incremented at the end of every frame and can be used to cache results once per frame.
+     *
+     * @return The current frame number.
+     */
+    inline unsigned int getFrameNumber() const;
+
     /**
      * Gets the game window width.
      * 
@@ -202,6 +212,13 @@ public:
      */
     inline PhysicsController* getPhysicsController() const;
 
+    /**
+     * Gets the resource loader for loading resources in the background.
+     * 
+     * @return The resource loader for this game.
+     */
+    inline ResourceLoader* getResourceLoader() const;
+
     /**
      * Gets the audio listener for 3D audio.
      * 
@@ -400,6 +417,7 @@ private:
     long _frameLastFPS;                         // The last time the frame count was updated.
     unsigned int _frameCount;                   // The current frame count.
     unsigned int _frameRate;                    // The current frame rate.
+    unsigned int _frameNumber;                  // The number of frames since the game started.
     unsigned int _width;                        // The game's display width.
     unsigned int _height;                       // The game's display height.
     Rectangle _viewport;                        // the games's current viewport.
@@ -409,6 +427,7 @@ private:
     AnimationController* _animationController;  // Controls the scheduling and running of animations.
     AudioController* _audioController;          // Controls audio sources that are playing in the game.
     PhysicsController* _physicsController;      // Controls the simulation of a physics scene and entities.
+    ResourceLoader* _resourceLoader;            // Loads resources in the background.
     AudioListener* _audioListener;              // The audio listener in 3D space.
     std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >* _timeEvents; // Contains the scheduled time events.
 
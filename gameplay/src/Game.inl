@@ -14,6 +14,11 @@ inline unsigned int Game::getFrameRate() const
     return _frameRate;
 }
 
+inline unsigned int Game::getFrameNumber() const
+{
+    return _frameNumber;
+}
+
 inline unsigned int Game::getWidth() const
 {
     return _width;
@@ -44,6 +49,11 @@ inline PhysicsController* Game::getPhysicsController() const
     return _physicsController;
 }
 
+inline ResourceLoader* Game::getResourceLoader() const
+{
+    return _resourceLoader;
+}
+
 template <class T>
 void Game::renderOnce(T* instance, void (T::*method)(void*), void* cookie)
 {
@@ -0,0 +1,576 @@
+#include "Base.h"
+#include "InstancedModel.h"
+#include "Technique.h"
+#include "Pass.h"
+#include "MeshPart.h"
+
+// The size of the data stored for each instance in the instance buffer.
+#define INSTANCEDMODEL_MATRIX_SIZE (sizeof(float) * 16)
+#define INSTANCEDMODEL_PARAMETERS_SIZE (sizeof(float) * 4)
+
+// The largest number of vertices that uniform array batches can index, with 16-bit indices.
+#define INSTANCEDMODEL_BATCH_MAX_VERTICES 65536
+
+// Expands a macro into a string literal.
+#define INSTANCEDMODEL_STRINGIFY(x) #x
+#define INSTANCEDMODEL_TOSTRING(x) INSTANCEDMODEL_STRINGIFY(x)
+
+namespace gameplay
+{
+
+// Whether the device supports instanced arrays: 1 if it does, 0 if not, or -1 until first queried.
+static int __hardwareInstancingSupported = -1;
+
+static unsigned int getIndexSize(Mesh::IndexFormat format)
+{
+    switch (format)
+    {
+    case Mesh::INDEX8:
+        return 1;
+    case Mesh::INDEX16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+static unsigned int getIndex(const unsigned char* indexData, Mesh::IndexFormat format, unsigned int i)
+{
+    switch (format)
+    {
+    case Mesh::INDEX8:
+        return indexData[i];
+    case Mesh::INDEX16:
+        return ((const unsigned short*)indexData)[i];
+    default:
+        return ((const unsigned int*)indexData)[i];
+    }
+}
+
+InstancedModel::InstancedModel(Model* model)
+    : _model(model), _instanceBuffer(0), _instanceBufferCapacity(0), _dirty(true), _drawCount(0),
+      _batchVertexBuffer(0), _batchIndexAttributeBuffer(0), _batchSize(0), _batchGeometryFailed(false)
+{
+}
+
+InstancedModel::InstancedModel(const InstancedModel& copy)
+{
+    // hidden
+}
+
+InstancedModel::~InstancedModel()
+{
+    deleteBatchGeometry();
+    SAFE_RELEASE(_model);
+
+    if (_instanceBuffer)
+    {
+        glDeleteBuffers(1, &_instanceBuffer);
+        _instanceBuffer = 0;
+    }
+}
+
+InstancedModel* InstancedModel::create(Model* model, unsigned int initialCapacity)
+{
+    assert(model);
+
+    InstancedModel* instancedModel = new InstancedModel(model);
+    model->addRef();
+    instancedModel->_matrices.reserve(initialCapacity);
+    instancedModel->_parameters.reserve(initialCapacity);
+    return instancedModel;
+}
+
+bool InstancedModel::isHardwareInstancingSupported()
+{
+#ifdef USE_INSTANCED_ARRAYS
+    if (__hardwareInstancingSupported < 0)
+    {
+        // Instanced arrays are core in OpenGL 3.3, and available through extensions before that.
+        // The entry points alone say nothing, since they may be linked whatever the driver supports.
+        int major = 0;
+        int minor = 0;
+        const char* version = (const char*)glGetString(GL_VERSION);
+        bool supported = version && sscanf(version, "%d.%d", &major, &minor) == 2 && (major > 3 || (major == 3 && minor >= 3));
+        if (!supported)
+        {
+            const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+            supported = extensions && (strstr(extensions, "GL_ARB_instanced_arrays") || strstr(extensions, "GL_EXT_instanced_arrays"));
+        }
+#ifdef __GLEW_H__
+        // GLEW leaves the entry points that the driver does not export NULL.
+        supported = supported && glVertexAttribDivisor && glDrawArraysInstanced && glDrawElementsInstanced;
+#endif
+        __hardwareInstancingSupported = supported ? 1 : 0;
+    }
+    return __hardwareInstancingSupported == 1;
+#else
+    return false;
+#endif
+}
+
+const char* InstancedModel::getShaderDefines()
+{
+    if (isHardwareInstancingSupported())
+        return "#define INSTANCING";
+    return "#define INSTANCING\n#define INSTANCING_UNIFORMS\n#define INSTANCING_BATCH_SIZE " INSTANCEDMODEL_TOSTRING(INSTANCEDMODEL_UNIFORM_BATCH_SIZE);
+}
+
+Model* InstancedModel::getModel() const
+{
+    return _model;
+}
+
+unsigned int InstancedModel::getInstanceCount() const
+{
+    return _matrices.size();
+}
+
+unsigned int InstancedModel::getDrawCount() const
+{
+    return _drawCount;
+}
+
+unsigned int InstancedModel::add(const Matrix& worldMatrix)
+{
+    return add(worldMatrix, Vector4::zero());
+}
+
+unsigned int InstancedModel::add(const Matrix& worldMatrix, const Vector4& parameters)
+{
+    _matrices.push_back(worldMatrix);
+    _parameters.push_back(parameters);
+    _dirty = true;
+    return _matrices.size() - 1;
+}
+
+void InstancedModel::setWorldMatrix(unsigned int index, const Matrix& worldMatrix)
+{
+    assert(index < _matrices.size());
+
+    _matrices[index] = worldMatrix;
+    _dirty = true;
+}
+
+void InstancedModel::setParameters(unsigned int index, const Vector4& parameters)
+{
+    assert(index < _parameters.size());
+
+    _parameters[index] = parameters;
+    _dirty = true;
+}
+
+void InstancedModel::clear()
+{
+    _matrices.clear();
+    _parameters.clear();
+    _dirty = true;
+}
+
+void InstancedModel::setGeometryData(const void* vertexData, const void* const* indexData)
+{
+    assert(vertexData);
+    assert(indexData || _model->getMesh()->getPartCount() == 0);
+
+    if (isHardwareInstancingSupported())
+        return;
+
+    deleteBatchGeometry();
+    _batchGeometryFailed = !createBatchGeometry((const unsigned char*)vertexData, (const unsigned char* const*)indexData);
+}
+
+void InstancedModel::draw()
+{
+    _drawCount = 0;
+    if (_matrices.empty())
+        return;
+
+    bool hardware = isHardwareInstancingSupported();
+    Mesh* mesh = _model->getMesh();
+    unsigned int partCount = mesh->getPartCount();
+
+    // A mesh without parts is drawn once with the shared material.
+    for (unsigned int i = 0, count = partCount > 0 ? partCount : 1; i < count; ++i)
+    {
+        MeshPart* part = partCount > 0 ? mesh->getPart(i) : NULL;
+        Material* material = partCount > 0 ? _model->getMaterial(i) : _model->getMaterial();
+        if (material == NULL)
+            continue;
+
+        Technique* technique = material->getTechnique();
+        for (unsigned int j = 0, passCount = technique->getPassCount(); j < passCount; ++j)
+        {
+            Pass* pass = technique->getPass(j);
+            Effect* effect = pass->getEffect();
+
+            VertexAttribute matrixAttribute = effect->getVertexAttribute(INSTANCE_ATTRIBUTE_MATRIX_NAME);
+            Uniform* matricesUniform = effect->getUniform(INSTANCE_UNIFORM_MATRICES_NAME);
+            if (hardware && matrixAttribute != -1)
+            {
+                if (_dirty && !upload())
+                    return;
+                drawInstanced(pass, part, matrixAttribute);
+            }
+            else if (matricesUniform)
+            {
+                drawUniformBatches(pass, i, part, matricesUniform);
+            }
+            else if (_skippedPasses.insert(pass).second)
+            {
+                // Only warn the first time a pass is skipped, rather than on every draw.
+                WARN_VARG("Effect of pass '%s' has no per-instance inputs; skipping it.", pass->getId());
+            }
+        }
+    }
+}
+
+bool InstancedModel::upload()
+{
+    unsigned int count = _matrices.size();
+    unsigned int capacity = _matrices.capacity();
+
+    if (_instanceBuffer == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &_instanceBuffer) );
+        if (GL_LAST_ERROR())
+        {
+            LOG_ERROR("Failed to create the instance buffer of an instanced model.");
+            _instanceBuffer = 0;
+            return false;
+        }
+    }
+
+    // Matrices are stored at the start of the buffer and parameters after them. Orphaning the previous
+    // contents lets the driver keep drawing from them while the new data is written.
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, capacity * (INSTANCEDMODEL_MATRIX_SIZE + INSTANCEDMODEL_PARAMETERS_SIZE), NULL, GL_STREAM_DRAW) );
+    GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, 0, count * INSTANCEDMODEL_MATRIX_SIZE, &_matrices[0]) );
+    GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, capacity * INSTANCEDMODEL_MATRIX_SIZE, count * INSTANCEDMODEL_PARAMETERS_SIZE, &_parameters[0]) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    _instanceBufferCapacity = capacity;
+    _dirty = false;
+    return true;
+}
+
+void InstancedModel::drawInstanced(Pass* pass, MeshPart* part, VertexAttribute matrixAttribute)
+{
+#ifdef USE_INSTANCED_ARRAYS
+    pass->bind();
+
+    // The matrix attribute occupies four consecutive locations, one per column. The attributes
+    // are reset after drawing, so that they are not left enabled in the mesh's vertex array object.
+    VertexAttribute parametersAttribute = pass->getEffect()->getVertexAttribute(INSTANCE_ATTRIBUTE_PARAMETERS_NAME);
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        GL_ASSERT( glVertexAttribPointer(matrixAttribute + i, 4, GL_FLOAT, GL_FALSE, INSTANCEDMODEL_MATRIX_SIZE, (GLvoid*)(i * sizeof(float) * 4)) );
+        GL_ASSERT( glEnableVertexAttribArray(matrixAttribute + i) );
+        GL_ASSERT( glVertexAttribDivisor(matrixAttribute + i, 1) );
+    }
+    if (parametersAttribute != -1)
+    {
+        GL_ASSERT( glVertexAttribPointer(parametersAttribute, 4, GL_FLOAT, GL_FALSE, INSTANCEDMODEL_PARAMETERS_SIZE, (GLvoid*)(_instanceBufferCapacity * INSTANCEDMODEL_MATRIX_SIZE)) );
+        GL_ASSERT( glEnableVertexAttribArray(parametersAttribute) );
+        GL_ASSERT( glVertexAttribDivisor(parametersAttribute, 1) );
+    }
+
+    drawGeometry(part, _matrices.size());
+
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        GL_ASSERT( glVertexAttribDivisor(matrixAttribute + i, 0) );
+        GL_ASSERT( glDisableVertexAttribArray(matrixAttribute + i) );
+    }
+    if (parametersAttribute != -1)
+    {
+        GL_ASSERT( glVertexAttribDivisor(parametersAttribute, 0) );
+        GL_ASSERT( glDisableVertexAttribArray(parametersAttribute) );
+    }
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    pass->unbind();
+#endif
+}
+
+void InstancedModel::drawUniformBatches(Pass* pass, unsigned int partIndex, MeshPart* part, Uniform* matricesUniform)
+{
+    Effect* effect = pass->getEffect();
+    Uniform* parametersUniform = effect->getUniform(INSTANCE_UNIFORM_PARAMETERS_NAME);
+    VertexAttribute indexAttribute = effect->getVertexAttribute(INSTANCE_ATTRIBUTE_INDEX_NAME);
+
+    // Without an index attribute the shader can only read the first element of the arrays.
+    VertexAttributeBinding* batchBinding = NULL;
+    if (indexAttribute != -1 && prepareBatchGeometry())
+    {
+        batchBinding = getBatchBinding(effect);
+    }
+
+    if (batchBinding == NULL)
+    {
+        // Draw the mesh once per instance, selecting the instance with the constant value of the index attribute.
+        unsigned int batchSize = indexAttribute != -1 ? INSTANCEDMODEL_UNIFORM_BATCH_SIZE : 1;
+        pass->bind();
+        for (unsigned int first = 0, count = _matrices.size(); first < count; first += batchSize)
+        {
+            unsigned int batchCount = std::min(batchSize, count - first);
+            effect->setValue(matricesUniform, &_matrices[first], batchCount);
+            if (parametersUniform)
+                effect->setValue(parametersUniform, &_parameters[first], batchCount);
+
+            for (unsigned int i = 0; i < batchCount; ++i)
+            {
+                if (indexAttribute != -1)
+                {
+                    GL_ASSERT( glVertexAttrib1f(indexAttribute, (GLfloat)i) );
+                }
+                drawGeometry(part, 0);
+            }
+        }
+        pass->unbind();
+        return;
+    }
+
+    // Bind the pass with the repeated vertices in place of the mesh's, restoring the mesh's binding afterwards.
+    VertexAttributeBinding* meshBinding = pass->getVertexAttributeBinding();
+    if (meshBinding)
+        meshBinding->addRef();
+    pass->setVertexAttributeBinding(batchBinding);
+    pass->bind();
+
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _batchIndexAttributeBuffer) );
+    GL_ASSERT( glVertexAttribPointer(indexAttribute, 1, GL_FLOAT, GL_FALSE, 0, 0) );
+    GL_ASSERT( glEnableVertexAttribArray(indexAttribute) );
+
+    for (unsigned int first = 0, count = _matrices.size(); first < count; first += _batchSize)
+    {
+        unsigned int batchCount = std::min(_batchSize, count - first);
+        effect->setValue(matricesUniform, &_matrices[first], batchCount);
+        if (parametersUniform)
+            effect->setValue(parametersUniform, &_parameters[first], batchCount);
+
+        drawBatchGeometry(partIndex, part, batchCount);
+    }
+
+    GL_ASSERT( glDisableVertexAttribArray(indexAttribute) );
+
+    pass->unbind();
+    pass->setVertexAttributeBinding(meshBinding);
+    SAFE_RELEASE(meshBinding);
+}
+
+bool InstancedModel::prepareBatchGeometry()
+{
+    if (_batchSize > 0)
+        return true;
+    if (_batchGeometryFailed)
+        return false;
+
+    // Only fail once, rather than on every draw.
+    _batchGeometryFailed = true;
+
+#ifdef OPENGL_ES
+    WARN("The mesh data of an instanced model has not been set; its instances are drawn one at a time.");
+    return false;
+#else
+    Mesh* mesh = _model->getMesh();
+    unsigned int partCount = mesh->getPartCount();
+
+    std::vector<unsigned char> vertexData(mesh->getVertexCount() * mesh->getVertexSize());
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer()) );
+    GL_ASSERT( glGetBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size(), &vertexData[0]) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    std::vector< std::vector<unsigned char> > indexData(partCount);
+    std::vector<const unsigned char*> indexPointers(partCount);
+    for (unsigned int i = 0; i < partCount; ++i)
+    {
+        MeshPart* part = mesh->getPart(i);
+        indexData[i].resize(part->getIndexCount() * getIndexSize(part->getIndexFormat()));
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->getIndexBuffer()) );
+        GL_ASSERT( glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexData[i].size(), &indexData[i][0]) );
+        indexPointers[i] = &indexData[i][0];
+    }
+    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+
+    _batchGeometryFailed = !createBatchGeometry(&vertexData[0], partCount > 0 ? &indexPointers[0] : NULL);
+    return !_batchGeometryFailed;
+#endif
+}
+
+bool InstancedModel::createBatchGeometry(const unsigned char* vertexData, const unsigned char* const* indexData)
+{
+    Mesh* mesh = _model->getMesh();
+    unsigned int vertexCount = mesh->getVertexCount();
+    unsigned int vertexSize = mesh->getVertexSize();
+    unsigned int partCount = mesh->getPartCount();
+
+    // Copies of line strips cannot be joined, and neither can copies of unindexed triangle strips.
+    bool joinable = partCount > 0 || (mesh->getPrimitiveType() != Mesh::TRIANGLE_STRIP && mesh->getPrimitiveType() != Mesh::LINE_STRIP);
+    for (unsigned int i = 0; i < partCount; ++i)
+    {
+        if (mesh->getPart(i)->getPrimitiveType() == Mesh::LINE_STRIP)
+            joinable = false;
+    }
+
+    // The copies are indexed with 16-bit indices, which every graphics device supports.
+    unsigned int copyCount = std::min((unsigned int)INSTANCEDMODEL_UNIFORM_BATCH_SIZE, INSTANCEDMODEL_BATCH_MAX_VERTICES / std::max(vertexCount, 1u));
+    if (!joinable || copyCount < 2)
+    {
+        WARN("The mesh of an instanced model cannot be repeated in uniform array batches; its instances are drawn one at a time.");
+        return false;
+    }
+
+    std::vector<unsigned char> vertices(copyCount * vertexCount * vertexSize);
+    std::vector<float> copyIndices(copyCount * vertexCount);
+    for (unsigned int c = 0; c < copyCount; ++c)
+    {
+        memcpy(&vertices[c * vertexCount * vertexSize], vertexData, vertexCount * vertexSize);
+        std::fill(copyIndices.begin() + c * vertexCount, copyIndices.begin() + (c + 1) * vertexCount, (float)c);
+    }
+
+    GL_ASSERT( glGenBuffers(1, &_batchVertexBuffer) );
+    GL_ASSERT( glGenBuffers(1, &_batchIndexAttributeBuffer) );
+    if (GL_LAST_ERROR())
+    {
+        LOG_ERROR("Failed to create the batch buffers of an instanced model.");
+        deleteBatchGeometry();
+        return false;
+    }
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _batchVertexBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, vertices.size(), &vertices[0], GL_STATIC_DRAW) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _batchIndexAttributeBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, copyIndices.size() * sizeof(float), &copyIndices[0], GL_STATIC_DRAW) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    for (unsigned int i = 0; i < partCount; ++i)
+    {
+        MeshPart* part = mesh->getPart(i);
+        Mesh::IndexFormat format = part->getIndexFormat();
+        unsigned int indexCount = part->getIndexCount();
+
+        // Copies of triangle strips are joined with degenerate triangles, and each copy starts
+        // on an even index so that its triangles keep their winding.
+        bool strip = part->getPrimitiveType() == Mesh::TRIANGLE_STRIP && indexCount > 0;
+        unsigned int stride = strip ? indexCount + 2 + (indexCount & 1) : indexCount;
+
+        std::vector<unsigned short> indices(copyCount * stride);
+        for (unsigned int c = 0; c < copyCount; ++c)
+        {
+            unsigned short* copy = &indices[c * stride];
+            for (unsigned int k = 0; k < indexCount; ++k)
+            {
+                copy[k] = (unsigned short)(getIndex(indexData[i], format, k) + c * vertexCount);
+            }
+            for (unsigned int k = indexCount; k < stride && c + 1 < copyCount; ++k)
+            {
+                copy[k] = k == indexCount ? copy[indexCount - 1] : (unsigned short)(getIndex(indexData[i], format, 0) + (c + 1) * vertexCount);
+            }
+        }
+
+        IndexBufferHandle indexBuffer;
+        GL_ASSERT( glGenBuffers(1, &indexBuffer) );
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer) );
+        GL_ASSERT( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), indices.empty() ? NULL : &indices[0], GL_STATIC_DRAW) );
+        _batchIndexBuffers.push_back(indexBuffer);
+        _batchIndexStrides.push_back(stride);
+    }
+    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+
+    _batchSize = copyCount;
+    return true;
+}
+
+void InstancedModel::deleteBatchGeometry()
+{
+    for (std::map<Effect*, VertexAttributeBinding*>::iterator itr = _batchBindings.begin(); itr != _batchBindings.end(); ++itr)
+    {
+        SAFE_RELEASE(itr->second);
+    }
+    _batchBindings.clear();
+
+    if (_batchVertexBuffer)
+    {
+        glDeleteBuffers(1, &_batchVertexBuffer);
+        _batchVertexBuffer = 0;
+    }
+    if (_batchIndexAttributeBuffer)
+    {
+        glDeleteBuffers(1, &_batchIndexAttributeBuffer);
+        _batchIndexAttributeBuffer = 0;
+    }
+    if (!_batchIndexBuffers.empty())
+    {
+        glDeleteBuffers(_batchIndexBuffers.size(), &_batchIndexBuffers[0]);
+        _batchIndexBuffers.clear();
+    }
+    _batchIndexStrides.clear();
+    _batchSize = 0;
+}
+
+VertexAttributeBinding* InstancedModel::getBatchBinding(Effect* effect)
+{
+    std::map<Effect*, VertexAttributeBinding*>::iterator itr = _batchBindings.find(effect);
+    if (itr != _batchBindings.end())
+        return itr->second;
+
+    VertexAttributeBinding* binding = VertexAttributeBinding::create(_batchVertexBuffer, _model->getMesh()->getVertexFormat(), effect);
+    if (binding)
+    {
+        _batchBindings[effect] = binding;
+    }
+    return binding;
+}
+
+void InstancedModel::drawBatchGeometry(unsigned int partIndex, MeshPart* part, unsigned int copyCount)
+{
+    Mesh* mesh = _model->getMesh();
+    if (part)
+    {
+        unsigned int indexCount = (copyCount - 1) * _batchIndexStrides[partIndex] + part->getIndexCount();
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _batchIndexBuffers[partIndex]) );
+        GL_ASSERT( glDrawElements(part->getPrimitiveType(), indexCount, GL_UNSIGNED_SHORT, 0) );
+    }
+    else
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+        GL_ASSERT( glDrawArrays(mesh->getPrimitiveType(), 0, copyCount * mesh->getVertexCount()) );
+    }
+    ++_drawCount;
+}
+
+void InstancedModel::drawGeometry(MeshPart* part, unsigned int instanceCount)
+{
+    Mesh* mesh = _model->getMesh();
+    if (part)
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->getIndexBuffer()) );
+#ifdef USE_INSTANCED_ARRAYS
+        if (instanceCount > 0)
+        {
+            GL_ASSERT( glDrawElementsInstanced(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0, instanceCount) );
+        }
+        else
+#endif
+        {
+            GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
+        }
+    }
+    else
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+#ifdef USE_INSTANCED_ARRAYS
+        if (instanceCount > 0)
+        {
+            GL_ASSERT( glDrawArraysInstanced(mesh->getPrimitiveType(), 0, mesh->getVertexCount(), instanceCount) );
+        }
+        else
+#endif
+        {
+            GL_ASSERT( glDrawArrays(mesh->getPrimitiveType(), 0, mesh->getVertexCount()) );
+        }
+    }
+    ++_drawCount;
+}
+
+}
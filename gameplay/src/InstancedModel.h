@@ -0,0 +1,247 @@
+#ifndef INSTANCEDMODEL_H_
+#define INSTANCEDMODEL_H_
+
+#include "Model.h"
+#include "VertexAttributeBinding.h"
+
+// The names of the shader inputs that receive per-instance data.
+#define INSTANCE_ATTRIBUTE_MATRIX_NAME              "a_instanceMatrix"
+#define INSTANCE_ATTRIBUTE_PARAMETERS_NAME          "a_instanceParameters"
+#define INSTANCE_ATTRIBUTE_INDEX_NAME               "a_instanceIndex"
+#define INSTANCE_UNIFORM_MATRICES_NAME              "u_instanceMatrices"
+#define INSTANCE_UNIFORM_PARAMETERS_NAME            "u_instanceParameters"
+
+// The number of instances uploaded per uniform array when instanced arrays are not supported.
+#define INSTANCEDMODEL_UNIFORM_BATCH_SIZE 16
+
+namespace gameplay
+{
+
+/**
+ * Defines a class for drawing many copies of a model with as few draw calls as possible.
+ *
+ * Each instance has a world matrix and an optional Vector4 of custom parameters (for example,
+ * a color or an animation phase). Instances are drawn with the mesh and materials of the
+ * model they are created from, and the model's node, if it has one, supplies the camera
+ * auto-bindings of the materials. The node's own transform is not used.
+ *
+ * Where the graphics device supports instanced arrays, the instance data is streamed into a
+ * vertex buffer and each mesh part and pass is drawn with a single instanced draw call. Vertex
+ * shaders receive the world matrix in the "a_instanceMatrix" attribute (a mat4) and the custom
+ * parameters in "a_instanceParameters".
+ *
+ * Otherwise, instances are drawn in batches of INSTANCEDMODEL_UNIFORM_BATCH_SIZE: the world
+ * matrices and parameters of a batch are uploaded in the "u_instanceMatrices" and
+ * "u_instanceParameters" uniform arrays, and each batch is drawn with a single draw call from
+ * a copy of the mesh that repeats its geometry once per instance. The "a_instanceIndex"
+ * attribute holds the index of the copy, and thus of the instance, within the batch.
+ *
+ * The repeated geometry is built from the mesh's buffers where the graphics device can read
+ * them back. OpenGL ES cannot, so there the geometry must be supplied with setGeometryData();
+ * until it is, each instance is drawn with a draw call of its own.
+ *
+ * The defines returned by getShaderDefines() tell a shader which of the two inputs to use.
+ */
+class InstancedModel
+{
+public:
+
+    /**
+     * Creates a new instanced model.
+     *
+     * @param model The model to draw instances of.
+     * @param initialCapacity The initial number of instances to reserve space for.
+     *
+     * @return The new instanced model.
+     */
+    static InstancedModel* create(Model* model, unsigned int initialCapacity = 64);
+
+    /**
+     * Destructor.
+     */
+    ~InstancedModel();
+
+    /**
+     * Determines whether the graphics device supports instanced arrays.
+     *
+     * The device is queried the first time this is called, which requires a current GL context,
+     * and the result is cached.
+     *
+     * @return true if instances are drawn with instanced draw calls, false if they are drawn in uniform array batches.
+     */
+    static bool isHardwareInstancingSupported();
+
+    /**
+     * Gets the shader defines that select the per-instance inputs used on this graphics device.
+     *
+     * The defines always include INSTANCING. When instanced arrays are not supported, they also
+     * include INSTANCING_UNIFORMS and INSTANCING_BATCH_SIZE, the size of the uniform arrays.
+     *
+     * @return The defines, in the form expected by Material::create().
+     */
+    static const char* getShaderDefines();
+
+    /**
+     * Gets the model that instances are drawn of.
+     *
+     * @return The model.
+     */
+    Model* getModel() const;
+
+    /**
+     * Gets the number of instances.
+     *
+     * @return The instance count.
+     */
+    unsigned int getInstanceCount() const;
+
+    /**
+     * Gets the number of draw calls made by the last call to draw().
+     *
+     * @return The draw call count.
+     */
+    unsigned int getDrawCount() const;
+
+    /**
+     * Adds an instance.
+     *
+     * @param worldMatrix The world matrix of the instance.
+     *
+     * @return The index of the new instance.
+     */
+    unsigned int add(const Matrix& worldMatrix);
+
+    /**
+     * Adds an instance with custom parameters.
+     *
+     * @param worldMatrix The world matrix of the instance.
+     * @param parameters The custom parameters of the instance.
+     *
+     * @return The index of the new instance.
+     */
+    unsigned int add(const Matrix& worldMatrix, const Vector4& parameters);
+
+    /**
+     * Sets the world matrix of an instance.
+     *
+     * @param index The index of the instance.
+     * @param worldMatrix The new world matrix.
+     */
+    void setWorldMatrix(unsigned int index, const Matrix& worldMatrix);
+
+    /**
+     * Sets the custom parameters of an instance.
+     *
+     * @param index The index of the instance.
+     * @param parameters The new custom parameters.
+     */
+    void setParameters(unsigned int index, const Vector4& parameters);
+
+    /**
+     * Removes all instances.
+     */
+    void clear();
+
+    /**
+     * Sets the vertex and index data of the model's mesh, from which the geometry of uniform array
+     * batches is built.
+     *
+     * This is only needed when instanced arrays are not supported and the graphics device cannot
+     * read back the mesh's buffers; otherwise it does nothing. The data is copied, and it must
+     * match the vertex format, vertex count and parts of the mesh.
+     *
+     * @param vertexData The vertex data of the mesh.
+     * @param indexData The index data of each part of the mesh, or NULL if the mesh has no parts.
+     */
+    void setGeometryData(const void* vertexData, const void* const* indexData);
+
+    /**
+     * Draws all instances.
+     *
+     * Instance data that changed since the last draw is uploaded before drawing.
+     */
+    void draw();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    InstancedModel(Model* model);
+
+    /**
+     * Hidden copy constructor.
+     */
+    InstancedModel(const InstancedModel& copy);
+
+    /**
+     * Copies the instance data into the instance buffer, creating or resizing it if needed.
+     */
+    bool upload();
+
+    /**
+     * Draws the instances with a pass that reads the instance attributes, in a single draw call.
+     */
+    void drawInstanced(Pass* pass, MeshPart* part, VertexAttribute matrixAttribute);
+
+    /**
+     * Draws the instances with a pass that reads the instance uniform arrays, a batch at a time.
+     */
+    void drawUniformBatches(Pass* pass, unsigned int partIndex, MeshPart* part, Uniform* matricesUniform);
+
+    /**
+     * Creates the repeated geometry of uniform array batches, reading the mesh's data back from
+     * its buffers if it has not been supplied.
+     *
+     * @return true if batches can be drawn from the repeated geometry, false otherwise.
+     */
+    bool prepareBatchGeometry();
+
+    /**
+     * Creates the repeated geometry of uniform array batches from the mesh's data.
+     */
+    bool createBatchGeometry(const unsigned char* vertexData, const unsigned char* const* indexData);
+
+    /**
+     * Deletes the repeated geometry of uniform array batches and the bindings that read it.
+     */
+    void deleteBatchGeometry();
+
+    /**
+     * Gets the binding of the repeated vertices to the attributes of an effect, creating it if needed.
+     */
+    VertexAttributeBinding* getBatchBinding(Effect* effect);
+
+    /**
+     * Draws a number of copies of the repeated geometry of the mesh or one of its parts.
+     */
+    void drawBatchGeometry(unsigned int partIndex, MeshPart* part, unsigned int copyCount);
+
+    /**
+     * Draws the geometry of the model or one of its parts.
+     *
+     * @param part The part to draw, or NULL if the mesh has no parts.
+     * @param instanceCount The number of instances to draw with an instanced draw call, or zero for a regular draw call.
+     */
+    void drawGeometry(MeshPart* part, unsigned int instanceCount);
+
+    Model* _model;
+    std::vector<Matrix> _matrices;
+    std::vector<Vector4> _parameters;
+    VertexBufferHandle _instanceBuffer;
+    unsigned int _instanceBufferCapacity;
+    bool _dirty;
+    unsigned int _drawCount;
+    VertexBufferHandle _batchVertexBuffer;
+    VertexBufferHandle _batchIndexAttributeBuffer;
+    std::vector<IndexBufferHandle> _batchIndexBuffers;
+    std::vector<unsigned int> _batchIndexStrides;
+    unsigned int _batchSize;
+    bool _batchGeometryFailed;
+    std::map<Effect*, VertexAttributeBinding*> _batchBindings;
+    std::set<Pass*> _skippedPasses;                 // The passes that could not be drawn, which have already been warned about.
+};
+
+}
+
+#endif
@@ -70,14 +70,6 @@ protected:
      */
     void setInverseBindPose(const Matrix& m);
 
-    /**
-     * Updates the joint matrix.
-     * 
-     * @param bindShape The bind shape matrix.
-     * @param matrixPalette The matrix palette to update.
-     */
-    void updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette);
-
     /**
      * Called when this Joint's transform changes.
      */
@@ -95,6 +87,11 @@ private:
      */
     Joint& operator=(const Joint&);
 
+    /**
+     * Marks the matrix palettes of the skins influenced by this Joint as dirty.
+     */
+    void setMatrixPalettesDirty();
+
 protected:
 
     /** 
@@ -102,15 +99,15 @@ protected:
      */
     Matrix _bindPose;
     
-    /** 
-     * Flag used to mark if the Joint's matrix is dirty.
-     */
-    bool _jointMatrixDirty;
-    
     /** 
      * The number of MeshSkin's influencing the Joint.
      */
     unsigned int _skinCount;
+
+    /**
+     * The MeshSkin's influencing the Joint, whose matrix palettes are marked dirty when it changes.
+     */
+    std::vector<MeshSkin*> _skins;
 };
 
 }
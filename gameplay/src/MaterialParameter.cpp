@@ -5,7 +5,13 @@ namespace gameplay
 {
 
 MaterialParameter::MaterialParameter(const char* name) :
-    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name), _uniform(NULL)
+    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name), _nameId(Effect::getUniformNameId(name)), _uniform(NULL)
+{
+    clearValue();
+}
+
+MaterialParameter::MaterialParameter(const char* name, unsigned int nameId) :
+    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name), _nameId(nameId), _uniform(NULL)
 {
     clearValue();
 }
@@ -221,21 +227,12 @@ Texture::Sampler* MaterialParameter::setValue(const char* texturePath, bool gene
     return NULL;
 }
 
-void MaterialParameter::bind(Effect* effect)
+void MaterialParameter::bind(Effect* effect, Uniform* uniform)
 {
-    // If we had a Uniform cached that is not from the passed in effect,
-    // we need to update our uniform to point to the new effect's uniform.
-    if (!_uniform || _uniform->getEffect() != effect)
-    {
-        _uniform = effect->getUniform(_name.c_str());
+    assert(uniform && uniform->getEffect() == effect);
 
-        if (!_uniform)
-        {
-            // This parameter was not found in the specified effect, so do nothing.
-            WARN_VARG("Warning: Material parameter '%s' not found in effect '%s'.", _name.c_str(), effect->getId());
-            return;
-        }
-    }
+    // Method bindings read the uniform to set from this parameter.
+    _uniform = uniform;
 
     switch (_type)
     {
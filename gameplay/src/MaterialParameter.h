@@ -30,6 +30,8 @@ namespace gameplay
 class MaterialParameter : public AnimationTarget, public Ref
 {
     friend class RenderState;
+    friend class RenderQueue;
+    friend class StaticBatcher;
 
 public:
 
@@ -174,6 +176,14 @@ private:
      * Constructor.
      */
     MaterialParameter(const char* name);
+
+    /**
+     * Constructor.
+     *
+     * @param name The name of the parameter.
+     * @param nameId The identifier of the name, returned by Effect::getUniformNameId().
+     */
+    MaterialParameter(const char* name, unsigned int nameId);
     
     /**
      * Destructor.
@@ -232,7 +242,10 @@ private:
 
     void clearValue();
 
-    void bind(Effect* effect);
+    /**
+     * Sets the value of this parameter to the given uniform of the currently bound effect.
+     */
+    void bind(Effect* effect, Uniform* uniform);
 
     void applyAnimationValue(AnimationValue* value, float blendWeight, int components);
 
@@ -264,6 +277,7 @@ private:
     unsigned int _count;
     bool _dynamic;
     std::string _name;
+    unsigned int _nameId;
     Uniform* _uniform;
 };
 
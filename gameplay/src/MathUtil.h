@@ -0,0 +1,161 @@
+#ifndef MATHUTIL_H_
+#define MATHUTIL_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines the low-level math kernels used by the math classes.
+ *
+ * The kernels operate on raw float arrays using the same column-major layout as Matrix.
+ * An SSE or NEON implementation is selected at compile time (see USE_SSE and USE_NEON
+ * in Base.h), with a portable scalar implementation used otherwise.
+ */
+class MathUtil
+{
+    friend class Matrix;
+    friend class Quaternion;
+    friend class Frustum;
+    friend class ParticleEmitter;
+    friend class MeshSkin;
+
+private:
+
+    /**
+     * Multiplies two column-major 4x4 matrices. dst may alias m1 or m2.
+     */
+    inline static void multiplyMatrix(const float* m1, const float* m2, float* dst);
+
+    /**
+     * Transforms the vector (x, y, z, w) by the matrix m and stores the first three components in dst.
+     */
+    inline static void transformVector3(const float* m, float x, float y, float z, float w, float* dst);
+
+    /**
+     * Transforms the four component vector v by the matrix m and stores the result in dst. dst may alias v.
+     */
+    inline static void transformVector4(const float* m, const float* v, float* dst);
+
+    /**
+     * Transforms an array of three component vectors by the matrix m, using w as the fourth component.
+     *
+     * src and dst are arrays of count tightly packed (x, y, z) triples; dst may alias src.
+     */
+    inline static void transformVector3Array(const float* m, const float* src, float* dst, unsigned int count, float w);
+
+    /**
+     * Spherically interpolates four pairs of quaternions at once.
+     *
+     * q1, q2 and dst each point at four tightly packed (x, y, z, w) quaternions and
+     * t points at four interpolation coefficients. dst may alias q1 or q2.
+     */
+    inline static void slerpQuaternion4(const float* q1, const float* q2, const float* t, float* dst);
+
+    /**
+     * Tests four spheres against the six planes of a frustum.
+     *
+     * planes points at six groups of eight floats, one per plane: the normal (x, y, z), the distance,
+     * the absolute values of the normal components and one unused float. x, y, z and radius each point
+     * at four floats. The planes are tested starting with the plane at index *plane. If all four spheres
+     * are outside a plane, the remaining planes are skipped and the index of that plane is stored in *plane.
+     *
+     * @return A four bit mask with bit i set if sphere i intersects or is inside the frustum.
+     */
+    inline static unsigned int cullSpheres4(const float* planes, const float* x, const float* y, const float* z,
+                                            const float* radius, unsigned char* plane);
+
+    /**
+     * Tests four axis-aligned boxes against the six planes of a frustum.
+     *
+     * The planes are laid out and tested as for cullSpheres4(). The min and max arguments each
+     * point at four floats.
+     *
+     * @return A four bit mask with bit i set if box i intersects or is inside the frustum.
+     */
+    inline static unsigned int cullBoxes4(const float* planes, const float* minX, const float* minY, const float* minZ,
+                                          const float* maxX, const float* maxY, const float* maxZ, unsigned char* plane);
+
+    /**
+     * Adds each element of src multiplied by scale to the corresponding element of dst.
+     *
+     * count must be a multiple of four.
+     */
+    inline static void addScaledArray(const float* src, float scale, float* dst, unsigned int count);
+
+    /**
+     * Linearly interpolates between the elements of from and to by the corresponding elements of t.
+     *
+     * count must be a multiple of four. dst may alias from or to.
+     */
+    inline static void lerpArray(const float* from, const float* to, const float* t, float* dst, unsigned int count);
+
+    /**
+     * Adds delta to each element of values, then stores each element multiplied by the
+     * corresponding element of scale in dst.
+     *
+     * count must be a multiple of four.
+     */
+    inline static void accumulateArray(float* values, float delta, const float* scale, float* dst, unsigned int count);
+
+    /**
+     * Computes the sine and cosine of each element of angles multiplied by scale.
+     *
+     * The SIMD implementations reduce the angles to [-pi/4, pi/4] and evaluate a polynomial approximation,
+     * which is accurate to a few units in the last place for angles of up to a few thousand radians.
+     * count must be a multiple of four.
+     */
+    inline static void sinCosArray(const float* angles, float scale, float* s, float* c, unsigned int count);
+
+    /**
+     * Rotates the vectors (x[i], y[i], z[i]) around the normalized axes (axisX[i], axisY[i], axisZ[i])
+     * by the angles whose sines and cosines are s[i] and c[i].
+     *
+     * count must be a multiple of four.
+     */
+    inline static void rotateArrays(const float* axisX, const float* axisY, const float* axisZ, const float* s, const float* c,
+                                    float* x, float* y, float* z, unsigned int count);
+
+    /**
+     * Advances sprite animation frames that are played once over a lifetime.
+     *
+     * Stores percent[i] - frames[i] * percentPerFrame, the part of the lifetime spent on the current frame,
+     * in time[i], and moves frames[i] to the next frame once that reaches percentPerFrame, unless frames[i]
+     * is already lastFrame. count must be a multiple of four.
+     */
+    inline static void advanceFrames(const float* percent, float percentPerFrame, unsigned int lastFrame,
+                                     float* time, unsigned int* frames, unsigned int count);
+
+    /**
+     * Advances looping sprite animation frames.
+     *
+     * Adds delta to time[i], and once that reaches duration, subtracts duration and moves frames[i]
+     * to the next frame, wrapping around to zero after frameCount frames. count must be a multiple of four.
+     */
+    inline static void loopFrames(float delta, float duration, unsigned int frameCount,
+                                  float* time, unsigned int* frames, unsigned int count);
+
+    /**
+     * Multiplies two column-major 4x4 matrices and stores the first three rows of the product
+     * in dst, row by row, as twelve floats. dst may not alias m1 or m2.
+     *
+     * This is the layout of the 4x3 matrices of a skin's matrix palette.
+     */
+    inline static void multiplyMatrixRows3(const float* m1, const float* m2, float* dst);
+
+    /**
+     * Hidden constructor.
+     */
+    MathUtil();
+};
+
+}
+
+#if defined(USE_SSE)
+#include "MathUtilSSE.inl"
+#elif defined(USE_NEON)
+#include "MathUtilNeon.inl"
+#else
+#include "MathUtil.inl"
+#endif
+
+#endif
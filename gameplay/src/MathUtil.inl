@@ -0,0 +1,211 @@
+#include "Quaternion.h"
+
+namespace gameplay
+{
+
+inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
+{
+    // Support the case where m1 or m2 is the same array as dst.
+    float product[16];
+
+    product[0]  = m1[0] * m2[0]  + m1[4] * m2[1] + m1[8]   * m2[2]  + m1[12] * m2[3];
+    product[1]  = m1[1] * m2[0]  + m1[5] * m2[1] + m1[9]   * m2[2]  + m1[13] * m2[3];
+    product[2]  = m1[2] * m2[0]  + m1[6] * m2[1] + m1[10]  * m2[2]  + m1[14] * m2[3];
+    product[3]  = m1[3] * m2[0]  + m1[7] * m2[1] + m1[11]  * m2[2]  + m1[15] * m2[3];
+
+    product[4]  = m1[0] * m2[4]  + m1[4] * m2[5] + m1[8]   * m2[6]  + m1[12] * m2[7];
+    product[5]  = m1[1] * m2[4]  + m1[5] * m2[5] + m1[9]   * m2[6]  + m1[13] * m2[7];
+    product[6]  = m1[2] * m2[4]  + m1[6] * m2[5] + m1[10]  * m2[6]  + m1[14] * m2[7];
+    product[7]  = m1[3] * m2[4]  + m1[7] * m2[5] + m1[11]  * m2[6]  + m1[15] * m2[7];
+
+    product[8]  = m1[0] * m2[8]  + m1[4] * m2[9] + m1[8]   * m2[10] + m1[12] * m2[11];
+    product[9]  = m1[1] * m2[8]  + m1[5] * m2[9] + m1[9]   * m2[10] + m1[13] * m2[11];
+    product[10] = m1[2] * m2[8]  + m1[6] * m2[9] + m1[10]  * m2[10] + m1[14] * m2[11];
+    product[11] = m1[3] * m2[8]  + m1[7] * m2[9] + m1[11]  * m2[10] + m1[15] * m2[11];
+
+    product[12] = m1[0] * m2[12] + m1[4] * m2[13] + m1[8]  * m2[14] + m1[12] * m2[15];
+    product[13] = m1[1] * m2[12] + m1[5] * m2[13] + m1[9]  * m2[14] + m1[13] * m2[15];
+    product[14] = m1[2] * m2[12] + m1[6] * m2[13] + m1[10] * m2[14] + m1[14] * m2[15];
+    product[15] = m1[3] * m2[12] + m1[7] * m2[13] + m1[11] * m2[14] + m1[15] * m2[15];
+
+    memcpy(dst, product, sizeof(float) * 16);
+}
+
+inline void MathUtil::transformVector3(const float* m, float x, float y, float z, float w, float* dst)
+{
+    dst[0] = x * m[0] + y * m[4] + z * m[8] + w * m[12];
+    dst[1] = x * m[1] + y * m[5] + z * m[9] + w * m[13];
+    dst[2] = x * m[2] + y * m[6] + z * m[10] + w * m[14];
+}
+
+inline void MathUtil::transformVector4(const float* m, const float* v, float* dst)
+{
+    // Support the case where v is the same array as dst.
+    float x = v[0] * m[0] + v[1] * m[4] + v[2] * m[8] + v[3] * m[12];
+    float y = v[0] * m[1] + v[1] * m[5] + v[2] * m[9] + v[3] * m[13];
+    float z = v[0] * m[2] + v[1] * m[6] + v[2] * m[10] + v[3] * m[14];
+    float w = v[0] * m[3] + v[1] * m[7] + v[2] * m[11] + v[3] * m[15];
+
+    dst[0] = x;
+    dst[1] = y;
+    dst[2] = z;
+    dst[3] = w;
+}
+
+inline void MathUtil::transformVector3Array(const float* m, const float* src, float* dst, unsigned int count, float w)
+{
+    for (unsigned int i = 0; i < count; ++i, src += 3, dst += 3)
+    {
+        transformVector3(m, src[0], src[1], src[2], w, dst);
+    }
+}
+
+inline void MathUtil::slerpQuaternion4(const float* q1, const float* q2, const float* t, float* dst)
+{
+    for (unsigned int i = 0; i < 4; ++i, q1 += 4, q2 += 4, dst += 4)
+    {
+        Quaternion::slerp(q1[0], q1[1], q1[2], q1[3], q2[0], q2[1], q2[2], q2[3], t[i], &dst[0], &dst[1], &dst[2], &dst[3]);
+    }
+}
+
+inline unsigned int MathUtil::cullSpheres4(const float* planes, const float* x, const float* y, const float* z,
+                                           const float* radius, unsigned char* plane)
+{
+    unsigned int outside = 0;
+    unsigned int p = *plane < 6 ? *plane : 0;
+    for (unsigned int i = 0; i < 6; ++i, p = (p == 5) ? 0 : p + 1)
+    {
+        const float* n = &planes[p * 8];
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            if (n[0] * x[j] + n[1] * y[j] + n[2] * z[j] + n[3] < -radius[j])
+                outside |= 1 << j;
+        }
+        if (outside == 0xF)
+        {
+            *plane = p;
+            return 0;
+        }
+    }
+    return ~outside & 0xF;
+}
+
+inline unsigned int MathUtil::cullBoxes4(const float* planes, const float* minX, const float* minY, const float* minZ,
+                                         const float* maxX, const float* maxY, const float* maxZ, unsigned char* plane)
+{
+    unsigned int outside = 0;
+    unsigned int p = *plane < 6 ? *plane : 0;
+    for (unsigned int i = 0; i < 6; ++i, p = (p == 5) ? 0 : p + 1)
+    {
+        const float* n = &planes[p * 8];
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            // Twice the distance from the box center to the plane, and twice the projected box extent.
+            float distance = n[0] * (minX[j] + maxX[j]) + n[1] * (minY[j] + maxY[j]) + n[2] * (minZ[j] + maxZ[j]) + 2.0f * n[3];
+            float extent = n[4] * (maxX[j] - minX[j]) + n[5] * (maxY[j] - minY[j]) + n[6] * (maxZ[j] - minZ[j]);
+            if (distance < -extent)
+                outside |= 1 << j;
+        }
+        if (outside == 0xF)
+        {
+            *plane = p;
+            return 0;
+        }
+    }
+    return ~outside & 0xF;
+}
+
+inline void MathUtil::addScaledArray(const float* src, float scale, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        dst[i] += src[i] * scale;
+    }
+}
+
+inline void MathUtil::lerpArray(const float* from, const float* to, const float* t, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        dst[i] = from[i] + (to[i] - from[i]) * t[i];
+    }
+}
+
+inline void MathUtil::accumulateArray(float* values, float delta, const float* scale, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        values[i] += delta;
+        dst[i] = values[i] * scale[i];
+    }
+}
+
+inline void MathUtil::sinCosArray(const float* angles, float scale, float* s, float* c, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float angle = angles[i] * scale;
+        s[i] = sin(angle);
+        c[i] = cos(angle);
+    }
+}
+
+inline void MathUtil::rotateArrays(const float* axisX, const float* axisY, const float* axisZ, const float* s, const float* c,
+                                   float* x, float* y, float* z, unsigned int count)
+{
+    // Rodrigues' formula: v' = v * cos + (axis x v) * sin + axis * (axis . v) * (1 - cos).
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float vx = x[i];
+        float vy = y[i];
+        float vz = z[i];
+        float d = (axisX[i] * vx + axisY[i] * vy + axisZ[i] * vz) * (1.0f - c[i]);
+        x[i] = vx * c[i] + (axisY[i] * vz - axisZ[i] * vy) * s[i] + axisX[i] * d;
+        y[i] = vy * c[i] + (axisZ[i] * vx - axisX[i] * vz) * s[i] + axisY[i] * d;
+        z[i] = vz * c[i] + (axisX[i] * vy - axisY[i] * vx) * s[i] + axisZ[i] * d;
+    }
+}
+
+inline void MathUtil::advanceFrames(const float* percent, float percentPerFrame, unsigned int lastFrame,
+                                    float* time, unsigned int* frames, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        time[i] = percent[i] - (float)frames[i] * percentPerFrame;
+        if (frames[i] < lastFrame && time[i] >= percentPerFrame)
+        {
+            ++frames[i];
+        }
+    }
+}
+
+inline void MathUtil::loopFrames(float delta, float duration, unsigned int frameCount,
+                                 float* time, unsigned int* frames, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        time[i] += delta;
+        if (time[i] >= duration)
+        {
+            time[i] -= duration;
+            if (++frames[i] == frameCount)
+            {
+                frames[i] = 0;
+            }
+        }
+    }
+}
+
+
+inline void MathUtil::multiplyMatrixRows3(const float* m1, const float* m2, float* dst)
+{
+    for (unsigned int row = 0; row < 3; ++row, dst += 4)
+    {
+        for (unsigned int column = 0; column < 4; ++column)
+        {
+            const float* b = &m2[column * 4];
+            dst[column] = m1[row] * b[0] + m1[row + 4] * b[1] + m1[row + 8] * b[2] + m1[row + 12] * b[3];
+        }
+    }
+}
+}
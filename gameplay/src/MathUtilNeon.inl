@@ -0,0 +1,384 @@
+#include <arm_neon.h>
+
+namespace gameplay
+{
+
+inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
+{
+    // Each column of the product is a linear combination of the columns of m1.
+    float32x4_t c0 = vld1q_f32(&m1[0]);
+    float32x4_t c1 = vld1q_f32(&m1[4]);
+    float32x4_t c2 = vld1q_f32(&m1[8]);
+    float32x4_t c3 = vld1q_f32(&m1[12]);
+
+    float32x4_t p[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        float32x4_t b = vld1q_f32(&m2[i * 4]);
+        p[i] = vmulq_lane_f32(c0, vget_low_f32(b), 0);
+        p[i] = vmlaq_lane_f32(p[i], c1, vget_low_f32(b), 1);
+        p[i] = vmlaq_lane_f32(p[i], c2, vget_high_f32(b), 0);
+        p[i] = vmlaq_lane_f32(p[i], c3, vget_high_f32(b), 1);
+    }
+
+    // Store only after all columns are computed to support m1 or m2 being the same array as dst.
+    vst1q_f32(&dst[0], p[0]);
+    vst1q_f32(&dst[4], p[1]);
+    vst1q_f32(&dst[8], p[2]);
+    vst1q_f32(&dst[12], p[3]);
+}
+
+inline void MathUtil::transformVector3(const float* m, float x, float y, float z, float w, float* dst)
+{
+    float32x4_t r = vmulq_n_f32(vld1q_f32(&m[0]), x);
+    r = vmlaq_n_f32(r, vld1q_f32(&m[4]), y);
+    r = vmlaq_n_f32(r, vld1q_f32(&m[8]), z);
+    r = vmlaq_n_f32(r, vld1q_f32(&m[12]), w);
+
+    // Store x and y, then z, without writing past the end of a three component destination.
+    vst1_f32(dst, vget_low_f32(r));
+    vst1q_lane_f32(&dst[2], r, 2);
+}
+
+inline void MathUtil::transformVector4(const float* m, const float* v, float* dst)
+{
+    float32x4_t r = vmulq_n_f32(vld1q_f32(&m[0]), v[0]);
+    r = vmlaq_n_f32(r, vld1q_f32(&m[4]), v[1]);
+    r = vmlaq_n_f32(r, vld1q_f32(&m[8]), v[2]);
+    r = vmlaq_n_f32(r, vld1q_f32(&m[12]), v[3]);
+    vst1q_f32(dst, r);
+}
+
+inline void MathUtil::transformVector3Array(const float* m, const float* src, float* dst, unsigned int count, float w)
+{
+    // Load the matrix columns once for the whole array.
+    float32x4_t c0 = vld1q_f32(&m[0]);
+    float32x4_t c1 = vld1q_f32(&m[4]);
+    float32x4_t c2 = vld1q_f32(&m[8]);
+    float32x4_t c3 = vmulq_n_f32(vld1q_f32(&m[12]), w);
+
+    for (unsigned int i = 0; i < count; ++i, src += 3, dst += 3)
+    {
+        float32x4_t r = vmlaq_n_f32(c3, c0, src[0]);
+        r = vmlaq_n_f32(r, c1, src[1]);
+        r = vmlaq_n_f32(r, c2, src[2]);
+        vst1_f32(dst, vget_low_f32(r));
+        vst1q_lane_f32(&dst[2], r, 2);
+    }
+}
+
+inline void MathUtil::slerpQuaternion4(const float* q1, const float* q2, const float* t, float* dst)
+{
+    // Vectorized form of Quaternion::slerp(): each lane interpolates one pair of quaternions.
+    float32x4x4_t a = vld4q_f32(q1);
+    float32x4x4_t b = vld4q_f32(q2);
+    float32x4_t vt = vld1q_f32(t);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    float32x4_t cosTheta = vmulq_f32(a.val[3], b.val[3]);
+    cosTheta = vmlaq_f32(cosTheta, a.val[0], b.val[0]);
+    cosTheta = vmlaq_f32(cosTheta, a.val[1], b.val[1]);
+    cosTheta = vmlaq_f32(cosTheta, a.val[2], b.val[2]);
+
+    // Fold theta: alpha is +1 or -1 with the sign of cosTheta.
+    float32x4_t alpha = vbslq_f32(vcgeq_f32(cosTheta, zero), one, vdupq_n_f32(-1.0f));
+    float32x4_t halfY = vmlaq_f32(one, alpha, cosTheta);
+
+    // Bisect the interval and fold t.
+    float32x4_t f2b = vsubq_f32(vt, vdupq_n_f32(0.5f));
+    float32x4_t u = vabsq_f32(f2b);
+    float32x4_t f2a = vsubq_f32(u, f2b);
+    f2b = vaddq_f32(f2b, u);
+    u = vaddq_f32(u, u);
+    float32x4_t f1 = vsubq_f32(one, u);
+
+    // One iteration of Newton to get 1-cos(theta / 2) to good accuracy.
+    float32x4_t halfSecHalfTheta = vmlsq_f32(vdupq_n_f32(1.09f),
+        vmlsq_f32(vdupq_n_f32(0.476537f), vdupq_n_f32(0.0903321f), halfY), halfY);
+    halfSecHalfTheta = vmulq_f32(halfSecHalfTheta,
+        vmlsq_f32(vdupq_n_f32(1.5f), vmulq_f32(halfY, halfSecHalfTheta), halfSecHalfTheta));
+    float32x4_t versHalfTheta = vmlsq_f32(one, halfY, halfSecHalfTheta);
+
+    // Evaluate series expansions of the coefficients.
+    const float32x4_t c1 = vdupq_n_f32(-0.00158730159f);
+    const float32x4_t c2 = vdupq_n_f32(0.0333333333f);
+    const float32x4_t c3 = vdupq_n_f32(-0.333333333f);
+    const float32x4_t k16 = vdupq_n_f32(16.0f);
+    const float32x4_t k9 = vdupq_n_f32(9.0f);
+    const float32x4_t k4 = vdupq_n_f32(4.0f);
+
+    float32x4_t sqNotU = vmulq_f32(f1, f1);
+    float32x4_t ratio2 = vmulq_n_f32(versHalfTheta, 0.0000440917108f);
+    float32x4_t ratio1 = vmlaq_f32(c1, vsubq_f32(sqNotU, k16), ratio2);
+    ratio1 = vmlaq_f32(c2, vmulq_f32(ratio1, vsubq_f32(sqNotU, k9)), versHalfTheta);
+    ratio1 = vmlaq_f32(c3, vmulq_f32(ratio1, vsubq_f32(sqNotU, k4)), versHalfTheta);
+    ratio1 = vmlaq_f32(one, vmulq_f32(ratio1, vsubq_f32(sqNotU, one)), versHalfTheta);
+
+    float32x4_t sqU = vmulq_f32(u, u);
+    ratio2 = vmlaq_f32(c1, vsubq_f32(sqU, k16), ratio2);
+    ratio2 = vmlaq_f32(c2, vmulq_f32(ratio2, vsubq_f32(sqU, k9)), versHalfTheta);
+    ratio2 = vmlaq_f32(c3, vmulq_f32(ratio2, vsubq_f32(sqU, k4)), versHalfTheta);
+    ratio2 = vmlaq_f32(one, vmulq_f32(ratio2, vsubq_f32(sqU, one)), versHalfTheta);
+
+    // Perform the bisection and resolve the folding done earlier.
+    f1 = vmulq_f32(f1, vmulq_f32(ratio1, halfSecHalfTheta));
+    f2a = vmulq_f32(f2a, ratio2);
+    f2b = vmulq_f32(f2b, ratio2);
+    alpha = vmulq_f32(alpha, vaddq_f32(f1, f2a));
+    float32x4_t beta = vaddq_f32(f1, f2b);
+
+    // Apply final coefficients to a and b as usual.
+    float32x4x4_t r;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        r.val[i] = vmlaq_f32(vmulq_f32(alpha, a.val[i]), beta, b.val[i]);
+    }
+
+    // Correct for small constraint errors in the inputs.
+    float32x4_t lengthSq = vmulq_f32(r.val[0], r.val[0]);
+    lengthSq = vmlaq_f32(lengthSq, r.val[1], r.val[1]);
+    lengthSq = vmlaq_f32(lengthSq, r.val[2], r.val[2]);
+    lengthSq = vmlaq_f32(lengthSq, r.val[3], r.val[3]);
+    f1 = vmlsq_f32(vdupq_n_f32(1.5f), vdupq_n_f32(0.5f), lengthSq);
+
+    // Lanes with t == 0 or identical inputs return q1 exactly; lanes with t == 1 return q2 exactly.
+    uint32x4_t equal = vandq_u32(vandq_u32(vceqq_f32(a.val[0], b.val[0]), vceqq_f32(a.val[1], b.val[1])),
+                                 vandq_u32(vceqq_f32(a.val[2], b.val[2]), vceqq_f32(a.val[3], b.val[3])));
+    uint32x4_t useQ1 = vorrq_u32(vceqq_f32(vt, zero), equal);
+    uint32x4_t useQ2 = vceqq_f32(vt, one);
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        r.val[i] = vmulq_f32(r.val[i], f1);
+        r.val[i] = vbslq_f32(useQ2, b.val[i], r.val[i]);
+        r.val[i] = vbslq_f32(useQ1, a.val[i], r.val[i]);
+    }
+
+    vst4q_f32(dst, r);
+}
+
+/**
+ * Packs the lanes of a comparison result into a four bit mask.
+ */
+inline unsigned int neonMovemask(uint32x4_t v)
+{
+    static const uint32_t bits[4] = { 1, 2, 4, 8 };
+    uint32x4_t masked = vandq_u32(v, vld1q_u32(bits));
+    uint32x2_t sum = vpadd_u32(vget_low_u32(masked), vget_high_u32(masked));
+    return vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+
+inline unsigned int MathUtil::cullSpheres4(const float* planes, const float* x, const float* y, const float* z,
+                                           const float* radius, unsigned char* plane)
+{
+    float32x4_t cx = vld1q_f32(x);
+    float32x4_t cy = vld1q_f32(y);
+    float32x4_t cz = vld1q_f32(z);
+    float32x4_t negRadius = vnegq_f32(vld1q_f32(radius));
+
+    uint32x4_t outside = vdupq_n_u32(0);
+    unsigned int p = *plane < 6 ? *plane : 0;
+    for (unsigned int i = 0; i < 6; ++i, p = (p == 5) ? 0 : p + 1)
+    {
+        const float* n = &planes[p * 8];
+        float32x4_t distance = vmlaq_n_f32(vdupq_n_f32(n[3]), cx, n[0]);
+        distance = vmlaq_n_f32(distance, cy, n[1]);
+        distance = vmlaq_n_f32(distance, cz, n[2]);
+        outside = vorrq_u32(outside, vcltq_f32(distance, negRadius));
+        if (neonMovemask(outside) == 0xF)
+        {
+            *plane = p;
+            return 0;
+        }
+    }
+    return ~neonMovemask(outside) & 0xF;
+}
+
+inline unsigned int MathUtil::cullBoxes4(const float* planes, const float* minX, const float* minY, const float* minZ,
+                                         const float* maxX, const float* maxY, const float* maxZ, unsigned char* plane)
+{
+    // Work with twice the box centers and extents to save the multiplications by one half.
+    float32x4_t x0 = vld1q_f32(minX);
+    float32x4_t y0 = vld1q_f32(minY);
+    float32x4_t z0 = vld1q_f32(minZ);
+    float32x4_t x1 = vld1q_f32(maxX);
+    float32x4_t y1 = vld1q_f32(maxY);
+    float32x4_t z1 = vld1q_f32(maxZ);
+    float32x4_t cx = vaddq_f32(x0, x1);
+    float32x4_t cy = vaddq_f32(y0, y1);
+    float32x4_t cz = vaddq_f32(z0, z1);
+    float32x4_t ex = vsubq_f32(x1, x0);
+    float32x4_t ey = vsubq_f32(y1, y0);
+    float32x4_t ez = vsubq_f32(z1, z0);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+
+    uint32x4_t outside = vdupq_n_u32(0);
+    unsigned int p = *plane < 6 ? *plane : 0;
+    for (unsigned int i = 0; i < 6; ++i, p = (p == 5) ? 0 : p + 1)
+    {
+        const float* n = &planes[p * 8];
+        float32x4_t sum = vmlaq_n_f32(vdupq_n_f32(2.0f * n[3]), cx, n[0]);
+        sum = vmlaq_n_f32(sum, cy, n[1]);
+        sum = vmlaq_n_f32(sum, cz, n[2]);
+        sum = vmlaq_n_f32(sum, ex, n[4]);
+        sum = vmlaq_n_f32(sum, ey, n[5]);
+        sum = vmlaq_n_f32(sum, ez, n[6]);
+        outside = vorrq_u32(outside, vcltq_f32(sum, zero));
+        if (neonMovemask(outside) == 0xF)
+        {
+            *plane = p;
+            return 0;
+        }
+    }
+    return ~neonMovemask(outside) & 0xF;
+}
+
+inline void MathUtil::addScaledArray(const float* src, float scale, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        vst1q_f32(&dst[i], vmlaq_n_f32(vld1q_f32(&dst[i]), vld1q_f32(&src[i]), scale));
+    }
+}
+
+inline void MathUtil::lerpArray(const float* from, const float* to, const float* t, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        float32x4_t a = vld1q_f32(&from[i]);
+        float32x4_t b = vld1q_f32(&to[i]);
+        vst1q_f32(&dst[i], vmlaq_f32(a, vsubq_f32(b, a), vld1q_f32(&t[i])));
+    }
+}
+
+inline void MathUtil::accumulateArray(float* values, float delta, const float* scale, float* dst, unsigned int count)
+{
+    float32x4_t d = vdupq_n_f32(delta);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        float32x4_t v = vaddq_f32(vld1q_f32(&values[i]), d);
+        vst1q_f32(&values[i], v);
+        vst1q_f32(&dst[i], vmulq_f32(v, vld1q_f32(&scale[i])));
+    }
+}
+
+inline void MathUtil::sinCosArray(const float* angles, float scale, float* s, float* c, unsigned int count)
+{
+    uint32x4_t signMask = vdupq_n_u32(0x80000000);
+    uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        float32x4_t x = vmulq_n_f32(vld1q_f32(&angles[i]), scale);
+
+        // Reduce the angle to [-pi/4, pi/4] by subtracting the nearest multiple q of pi/2,
+        // split into three parts to keep the precision of the remainder. The conversion
+        // truncates, so add one half with the sign of the quotient to round it.
+        float32x4_t y = vmulq_n_f32(x, 0.636619772f);
+        int32x4_t q = vcvtq_s32_f32(vaddq_f32(y, vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(y), signMask), half))));
+        float32x4_t qf = vcvtq_f32_s32(q);
+        x = vmlsq_n_f32(x, qf, 1.5703125f);
+        x = vmlsq_n_f32(x, qf, 4.837512969970703125e-4f);
+        x = vmlsq_n_f32(x, qf, 7.54978995489188216e-8f);
+
+        // Minimax polynomials for the sine and cosine of the reduced angle.
+        float32x4_t x2 = vmulq_f32(x, x);
+        float32x4_t ps = vmlaq_n_f32(vdupq_n_f32(8.3321608736e-3f), x2, -1.9515295891e-4f);
+        ps = vmlaq_f32(vdupq_n_f32(-1.6666654611e-1f), ps, x2);
+        ps = vmlaq_f32(x, vmulq_f32(ps, x2), x);
+        float32x4_t pc = vmlaq_n_f32(vdupq_n_f32(-1.388731625493765e-3f), x2, 2.443315711809948e-5f);
+        pc = vmlaq_f32(vdupq_n_f32(4.166664568298827e-2f), pc, x2);
+        pc = vmlaq_f32(vmlsq_n_f32(vdupq_n_f32(1.0f), x2, 0.5f), vmulq_f32(pc, x2), x2);
+
+        // Swap and negate the results according to the quadrant of the angle.
+        uint32x4_t qu = vreinterpretq_u32_s32(q);
+        uint32x4_t swap = vtstq_u32(qu, vdupq_n_u32(1));
+        uint32x4_t sinSign = vshlq_n_u32(vandq_u32(qu, vdupq_n_u32(2)), 30);
+        uint32x4_t cosSign = vshlq_n_u32(vandq_u32(vaddq_u32(qu, vdupq_n_u32(1)), vdupq_n_u32(2)), 30);
+        vst1q_f32(&s[i], vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, pc, ps)), sinSign)));
+        vst1q_f32(&c[i], vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, ps, pc)), cosSign)));
+    }
+}
+
+inline void MathUtil::rotateArrays(const float* axisX, const float* axisY, const float* axisZ, const float* s, const float* c,
+                                   float* x, float* y, float* z, unsigned int count)
+{
+    // Rodrigues' formula: v' = v * cos + (axis x v) * sin + axis * (axis . v) * (1 - cos).
+    float32x4_t one = vdupq_n_f32(1.0f);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        float32x4_t ax = vld1q_f32(&axisX[i]);
+        float32x4_t ay = vld1q_f32(&axisY[i]);
+        float32x4_t az = vld1q_f32(&axisZ[i]);
+        float32x4_t vx = vld1q_f32(&x[i]);
+        float32x4_t vy = vld1q_f32(&y[i]);
+        float32x4_t vz = vld1q_f32(&z[i]);
+        float32x4_t sn = vld1q_f32(&s[i]);
+        float32x4_t cs = vld1q_f32(&c[i]);
+        float32x4_t d = vmulq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(ax, vx), ay, vy), az, vz), vsubq_f32(one, cs));
+        vst1q_f32(&x[i], vmlaq_f32(vmlaq_f32(vmulq_f32(vx, cs), vmlsq_f32(vmulq_f32(ay, vz), az, vy), sn), ax, d));
+        vst1q_f32(&y[i], vmlaq_f32(vmlaq_f32(vmulq_f32(vy, cs), vmlsq_f32(vmulq_f32(az, vx), ax, vz), sn), ay, d));
+        vst1q_f32(&z[i], vmlaq_f32(vmlaq_f32(vmulq_f32(vz, cs), vmlsq_f32(vmulq_f32(ax, vy), ay, vx), sn), az, d));
+    }
+}
+
+inline void MathUtil::advanceFrames(const float* percent, float percentPerFrame, unsigned int lastFrame,
+                                    float* time, unsigned int* frames, unsigned int count)
+{
+    float32x4_t ppf = vdupq_n_f32(percentPerFrame);
+    uint32x4_t last = vdupq_n_u32(lastFrame);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        uint32x4_t f = vld1q_u32(&frames[i]);
+        float32x4_t t = vmlsq_f32(vld1q_f32(&percent[i]), vcvtq_f32_u32(f), ppf);
+        vst1q_f32(&time[i], t);
+
+        // Subtracting the all-ones comparison mask adds one to the frames that advance.
+        uint32x4_t advance = vandq_u32(vcltq_u32(f, last), vcgeq_f32(t, ppf));
+        vst1q_u32(&frames[i], vsubq_u32(f, advance));
+    }
+}
+
+inline void MathUtil::loopFrames(float delta, float duration, unsigned int frameCount,
+                                 float* time, unsigned int* frames, unsigned int count)
+{
+    float32x4_t d = vdupq_n_f32(delta);
+    float32x4_t dur = vdupq_n_f32(duration);
+    uint32x4_t n = vdupq_n_u32(frameCount);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        float32x4_t t = vaddq_f32(vld1q_f32(&time[i]), d);
+        uint32x4_t wrap = vcgeq_f32(t, dur);
+        vst1q_f32(&time[i], vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(wrap, vreinterpretq_u32_f32(dur)))));
+
+        // Subtracting the all-ones comparison mask adds one to the frames that advance.
+        uint32x4_t f = vsubq_u32(vld1q_u32(&frames[i]), wrap);
+        vst1q_u32(&frames[i], vbicq_u32(f, vceqq_u32(f, n)));
+    }
+}
+
+
+inline void MathUtil::multiplyMatrixRows3(const float* m1, const float* m2, float* dst)
+{
+    float32x4_t c0 = vld1q_f32(&m1[0]);
+    float32x4_t c1 = vld1q_f32(&m1[4]);
+    float32x4_t c2 = vld1q_f32(&m1[8]);
+    float32x4_t c3 = vld1q_f32(&m1[12]);
+
+    float32x4_t p[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        float32x4_t b = vld1q_f32(&m2[i * 4]);
+        p[i] = vmulq_lane_f32(c0, vget_low_f32(b), 0);
+        p[i] = vmlaq_lane_f32(p[i], c1, vget_low_f32(b), 1);
+        p[i] = vmlaq_lane_f32(p[i], c2, vget_high_f32(b), 0);
+        p[i] = vmlaq_lane_f32(p[i], c3, vget_high_f32(b), 1);
+    }
+
+    // Turn the columns of the product into rows and drop the last one.
+    float32x4x2_t t01 = vtrnq_f32(p[0], p[1]);
+    float32x4x2_t t23 = vtrnq_f32(p[2], p[3]);
+    vst1q_f32(&dst[0], vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+    vst1q_f32(&dst[4], vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+    vst1q_f32(&dst[8], vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+}
+}
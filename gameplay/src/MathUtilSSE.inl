@@ -0,0 +1,417 @@
+#include <xmmintrin.h>
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace gameplay
+{
+
+inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
+{
+    // Each column of the product is a linear combination of the columns of m1.
+    __m128 c0 = _mm_loadu_ps(&m1[0]);
+    __m128 c1 = _mm_loadu_ps(&m1[4]);
+    __m128 c2 = _mm_loadu_ps(&m1[8]);
+    __m128 c3 = _mm_loadu_ps(&m1[12]);
+
+    __m128 p[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        const float* b = &m2[i * 4];
+        p[i] = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(b[0])), _mm_mul_ps(c1, _mm_set1_ps(b[1]))),
+            _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(b[2])), _mm_mul_ps(c3, _mm_set1_ps(b[3]))));
+    }
+
+    // Store only after all columns are computed to support m1 or m2 being the same array as dst.
+    _mm_storeu_ps(&dst[0], p[0]);
+    _mm_storeu_ps(&dst[4], p[1]);
+    _mm_storeu_ps(&dst[8], p[2]);
+    _mm_storeu_ps(&dst[12], p[3]);
+}
+
+inline void MathUtil::transformVector3(const float* m, float x, float y, float z, float w, float* dst)
+{
+    __m128 r = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(x)), _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(y))),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(z)), _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(w))));
+
+    // Store x and y, then z, without writing past the end of a three component destination.
+    _mm_storel_pi((__m64*)dst, r);
+    _mm_store_ss(&dst[2], _mm_movehl_ps(r, r));
+}
+
+inline void MathUtil::transformVector4(const float* m, const float* v, float* dst)
+{
+    __m128 r = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(v[0])), _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(v[1]))),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(v[2])), _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(v[3]))));
+    _mm_storeu_ps(dst, r);
+}
+
+inline void MathUtil::transformVector3Array(const float* m, const float* src, float* dst, unsigned int count, float w)
+{
+    // Load the matrix columns once for the whole array.
+    __m128 c0 = _mm_loadu_ps(&m[0]);
+    __m128 c1 = _mm_loadu_ps(&m[4]);
+    __m128 c2 = _mm_loadu_ps(&m[8]);
+    __m128 c3 = _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(w));
+
+    for (unsigned int i = 0; i < count; ++i, src += 3, dst += 3)
+    {
+        __m128 r = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(src[0])), _mm_mul_ps(c1, _mm_set1_ps(src[1]))),
+            _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(src[2])), c3));
+        _mm_storel_pi((__m64*)dst, r);
+        _mm_store_ss(&dst[2], _mm_movehl_ps(r, r));
+    }
+}
+
+inline void MathUtil::slerpQuaternion4(const float* q1, const float* q2, const float* t, float* dst)
+{
+    // Vectorized form of Quaternion::slerp(): each lane interpolates one pair of quaternions.
+    __m128 q1x = _mm_loadu_ps(&q1[0]);
+    __m128 q1y = _mm_loadu_ps(&q1[4]);
+    __m128 q1z = _mm_loadu_ps(&q1[8]);
+    __m128 q1w = _mm_loadu_ps(&q1[12]);
+    _MM_TRANSPOSE4_PS(q1x, q1y, q1z, q1w);
+
+    __m128 q2x = _mm_loadu_ps(&q2[0]);
+    __m128 q2y = _mm_loadu_ps(&q2[4]);
+    __m128 q2z = _mm_loadu_ps(&q2[8]);
+    __m128 q2w = _mm_loadu_ps(&q2[12]);
+    _MM_TRANSPOSE4_PS(q2x, q2y, q2z, q2w);
+
+    __m128 vt = _mm_loadu_ps(t);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    __m128 cosTheta = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(q1w, q2w), _mm_mul_ps(q1x, q2x)),
+        _mm_add_ps(_mm_mul_ps(q1y, q2y), _mm_mul_ps(q1z, q2z)));
+
+    // Fold theta: alpha is +1 or -1 with the sign of cosTheta.
+    __m128 alpha = _mm_or_ps(one, _mm_andnot_ps(_mm_cmpge_ps(cosTheta, zero), signMask));
+    __m128 halfY = _mm_add_ps(one, _mm_mul_ps(alpha, cosTheta));
+
+    // Bisect the interval and fold t.
+    __m128 f2b = _mm_sub_ps(vt, _mm_set1_ps(0.5f));
+    __m128 u = _mm_andnot_ps(signMask, f2b);
+    __m128 f2a = _mm_sub_ps(u, f2b);
+    f2b = _mm_add_ps(f2b, u);
+    u = _mm_add_ps(u, u);
+    __m128 f1 = _mm_sub_ps(one, u);
+
+    // One iteration of Newton to get 1-cos(theta / 2) to good accuracy.
+    __m128 halfSecHalfTheta = _mm_sub_ps(_mm_set1_ps(1.09f),
+        _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(0.476537f), _mm_mul_ps(_mm_set1_ps(0.0903321f), halfY)), halfY));
+    halfSecHalfTheta = _mm_mul_ps(halfSecHalfTheta,
+        _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(halfY, halfSecHalfTheta), halfSecHalfTheta)));
+    __m128 versHalfTheta = _mm_sub_ps(one, _mm_mul_ps(halfY, halfSecHalfTheta));
+
+    // Evaluate series expansions of the coefficients.
+    const __m128 c0 = _mm_set1_ps(0.0000440917108f);
+    const __m128 c1 = _mm_set1_ps(-0.00158730159f);
+    const __m128 c2 = _mm_set1_ps(0.0333333333f);
+    const __m128 c3 = _mm_set1_ps(-0.333333333f);
+    const __m128 k16 = _mm_set1_ps(16.0f);
+    const __m128 k9 = _mm_set1_ps(9.0f);
+    const __m128 k4 = _mm_set1_ps(4.0f);
+
+    __m128 sqNotU = _mm_mul_ps(f1, f1);
+    __m128 ratio2 = _mm_mul_ps(c0, versHalfTheta);
+    __m128 ratio1 = _mm_add_ps(c1, _mm_mul_ps(_mm_sub_ps(sqNotU, k16), ratio2));
+    ratio1 = _mm_add_ps(c2, _mm_mul_ps(_mm_mul_ps(ratio1, _mm_sub_ps(sqNotU, k9)), versHalfTheta));
+    ratio1 = _mm_add_ps(c3, _mm_mul_ps(_mm_mul_ps(ratio1, _mm_sub_ps(sqNotU, k4)), versHalfTheta));
+    ratio1 = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(ratio1, _mm_sub_ps(sqNotU, one)), versHalfTheta));
+
+    __m128 sqU = _mm_mul_ps(u, u);
+    ratio2 = _mm_add_ps(c1, _mm_mul_ps(_mm_sub_ps(sqU, k16), ratio2));
+    ratio2 = _mm_add_ps(c2, _mm_mul_ps(_mm_mul_ps(ratio2, _mm_sub_ps(sqU, k9)), versHalfTheta));
+    ratio2 = _mm_add_ps(c3, _mm_mul_ps(_mm_mul_ps(ratio2, _mm_sub_ps(sqU, k4)), versHalfTheta));
+    ratio2 = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(ratio2, _mm_sub_ps(sqU, one)), versHalfTheta));
+
+    // Perform the bisection and resolve the folding done earlier.
+    f1 = _mm_mul_ps(f1, _mm_mul_ps(ratio1, halfSecHalfTheta));
+    f2a = _mm_mul_ps(f2a, ratio2);
+    f2b = _mm_mul_ps(f2b, ratio2);
+    alpha = _mm_mul_ps(alpha, _mm_add_ps(f1, f2a));
+    __m128 beta = _mm_add_ps(f1, f2b);
+
+    // Apply final coefficients to a and b as usual.
+    __m128 w = _mm_add_ps(_mm_mul_ps(alpha, q1w), _mm_mul_ps(beta, q2w));
+    __m128 x = _mm_add_ps(_mm_mul_ps(alpha, q1x), _mm_mul_ps(beta, q2x));
+    __m128 y = _mm_add_ps(_mm_mul_ps(alpha, q1y), _mm_mul_ps(beta, q2y));
+    __m128 z = _mm_add_ps(_mm_mul_ps(alpha, q1z), _mm_mul_ps(beta, q2z));
+
+    // Correct for small constraint errors in the inputs.
+    f1 = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_set1_ps(0.5f),
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(w, w), _mm_mul_ps(x, x)), _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(z, z)))));
+    x = _mm_mul_ps(x, f1);
+    y = _mm_mul_ps(y, f1);
+    z = _mm_mul_ps(z, f1);
+    w = _mm_mul_ps(w, f1);
+
+    // Lanes with t == 0 or identical inputs return q1 exactly; lanes with t == 1 return q2 exactly.
+    __m128 equal = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(q1x, q2x), _mm_cmpeq_ps(q1y, q2y)),
+                              _mm_and_ps(_mm_cmpeq_ps(q1z, q2z), _mm_cmpeq_ps(q1w, q2w)));
+    __m128 useQ1 = _mm_or_ps(_mm_cmpeq_ps(vt, zero), equal);
+    __m128 useQ2 = _mm_andnot_ps(useQ1, _mm_cmpeq_ps(vt, one));
+    x = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(useQ1, useQ2), x), _mm_or_ps(_mm_and_ps(useQ1, q1x), _mm_and_ps(useQ2, q2x)));
+    y = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(useQ1, useQ2), y), _mm_or_ps(_mm_and_ps(useQ1, q1y), _mm_and_ps(useQ2, q2y)));
+    z = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(useQ1, useQ2), z), _mm_or_ps(_mm_and_ps(useQ1, q1z), _mm_and_ps(useQ2, q2z)));
+    w = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(useQ1, useQ2), w), _mm_or_ps(_mm_and_ps(useQ1, q1w), _mm_and_ps(useQ2, q2w)));
+
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&dst[0], x);
+    _mm_storeu_ps(&dst[4], y);
+    _mm_storeu_ps(&dst[8], z);
+    _mm_storeu_ps(&dst[12], w);
+}
+
+inline unsigned int MathUtil::cullSpheres4(const float* planes, const float* x, const float* y, const float* z,
+                                           const float* radius, unsigned char* plane)
+{
+    __m128 cx = _mm_loadu_ps(x);
+    __m128 cy = _mm_loadu_ps(y);
+    __m128 cz = _mm_loadu_ps(z);
+    __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius));
+
+    __m128 outside = _mm_setzero_ps();
+    unsigned int p = *plane < 6 ? *plane : 0;
+    for (unsigned int i = 0; i < 6; ++i, p = (p == 5) ? 0 : p + 1)
+    {
+        const float* n = &planes[p * 8];
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), cx), _mm_mul_ps(_mm_set1_ps(n[1]), cy)),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[2]), cz), _mm_set1_ps(n[3])));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+        if (_mm_movemask_ps(outside) == 0xF)
+        {
+            *plane = p;
+            return 0;
+        }
+    }
+    return ~_mm_movemask_ps(outside) & 0xF;
+}
+
+inline unsigned int MathUtil::cullBoxes4(const float* planes, const float* minX, const float* minY, const float* minZ,
+                                         const float* maxX, const float* maxY, const float* maxZ, unsigned char* plane)
+{
+    // Work with twice the box centers and extents to save the multiplications by one half.
+    __m128 x0 = _mm_loadu_ps(minX);
+    __m128 y0 = _mm_loadu_ps(minY);
+    __m128 z0 = _mm_loadu_ps(minZ);
+    __m128 x1 = _mm_loadu_ps(maxX);
+    __m128 y1 = _mm_loadu_ps(maxY);
+    __m128 z1 = _mm_loadu_ps(maxZ);
+    __m128 cx = _mm_add_ps(x0, x1);
+    __m128 cy = _mm_add_ps(y0, y1);
+    __m128 cz = _mm_add_ps(z0, z1);
+    __m128 ex = _mm_sub_ps(x1, x0);
+    __m128 ey = _mm_sub_ps(y1, y0);
+    __m128 ez = _mm_sub_ps(z1, z0);
+
+    __m128 outside = _mm_setzero_ps();
+    unsigned int p = *plane < 6 ? *plane : 0;
+    for (unsigned int i = 0; i < 6; ++i, p = (p == 5) ? 0 : p + 1)
+    {
+        const float* n = &planes[p * 8];
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), cx), _mm_mul_ps(_mm_set1_ps(n[1]), cy)),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[2]), cz), _mm_set1_ps(2.0f * n[3])));
+        __m128 extent = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[4]), ex), _mm_mul_ps(_mm_set1_ps(n[5]), ey)),
+            _mm_mul_ps(_mm_set1_ps(n[6]), ez));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, extent), _mm_setzero_ps()));
+        if (_mm_movemask_ps(outside) == 0xF)
+        {
+            *plane = p;
+            return 0;
+        }
+    }
+    return ~_mm_movemask_ps(outside) & 0xF;
+}
+
+inline void MathUtil::addScaledArray(const float* src, float scale, float* dst, unsigned int count)
+{
+    __m128 s = _mm_set1_ps(scale);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        _mm_storeu_ps(&dst[i], _mm_add_ps(_mm_loadu_ps(&dst[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), s)));
+    }
+}
+
+inline void MathUtil::lerpArray(const float* from, const float* to, const float* t, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(&from[i]);
+        __m128 b = _mm_loadu_ps(&to[i]);
+        _mm_storeu_ps(&dst[i], _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_loadu_ps(&t[i]))));
+    }
+}
+
+inline void MathUtil::accumulateArray(float* values, float delta, const float* scale, float* dst, unsigned int count)
+{
+    __m128 d = _mm_set1_ps(delta);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(&values[i]), d);
+        _mm_storeu_ps(&values[i], v);
+        _mm_storeu_ps(&dst[i], _mm_mul_ps(v, _mm_loadu_ps(&scale[i])));
+    }
+}
+
+inline void MathUtil::sinCosArray(const float* angles, float scale, float* s, float* c, unsigned int count)
+{
+#ifdef USE_SSE2
+    __m128 sc = _mm_set1_ps(scale);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        __m128 x = _mm_mul_ps(_mm_loadu_ps(&angles[i]), sc);
+
+        // Reduce the angle to [-pi/4, pi/4] by subtracting the nearest multiple q of pi/2,
+        // split into three parts to keep the precision of the remainder.
+        __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.636619772f)));
+        __m128 qf = _mm_cvtepi32_ps(q);
+        x = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+        x = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+        x = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+
+        // Minimax polynomials for the sine and cosine of the reduced angle.
+        __m128 x2 = _mm_mul_ps(x, x);
+        __m128 ps = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(-1.9515295891e-4f)), _mm_set1_ps(8.3321608736e-3f));
+        ps = _mm_add_ps(_mm_mul_ps(ps, x2), _mm_set1_ps(-1.6666654611e-1f));
+        ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, x2), x), x);
+        __m128 pc = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(2.443315711809948e-5f)), _mm_set1_ps(-1.388731625493765e-3f));
+        pc = _mm_add_ps(_mm_mul_ps(pc, x2), _mm_set1_ps(4.166664568298827e-2f));
+        pc = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(pc, x2), x2), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, _mm_set1_ps(0.5f))));
+
+        // Swap and negate the results according to the quadrant of the angle.
+        __m128i one = _mm_set1_epi32(1);
+        __m128i two = _mm_set1_epi32(2);
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+        __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+        __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+        _mm_storeu_ps(&s[i], _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps)), sinSign));
+        _mm_storeu_ps(&c[i], _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc)), cosSign));
+    }
+#else
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float angle = angles[i] * scale;
+        s[i] = sin(angle);
+        c[i] = cos(angle);
+    }
+#endif
+}
+
+inline void MathUtil::rotateArrays(const float* axisX, const float* axisY, const float* axisZ, const float* s, const float* c,
+                                   float* x, float* y, float* z, unsigned int count)
+{
+    // Rodrigues' formula: v' = v * cos + (axis x v) * sin + axis * (axis . v) * (1 - cos).
+    __m128 one = _mm_set1_ps(1.0f);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        __m128 ax = _mm_loadu_ps(&axisX[i]);
+        __m128 ay = _mm_loadu_ps(&axisY[i]);
+        __m128 az = _mm_loadu_ps(&axisZ[i]);
+        __m128 vx = _mm_loadu_ps(&x[i]);
+        __m128 vy = _mm_loadu_ps(&y[i]);
+        __m128 vz = _mm_loadu_ps(&z[i]);
+        __m128 sn = _mm_loadu_ps(&s[i]);
+        __m128 cs = _mm_loadu_ps(&c[i]);
+        __m128 d = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, vx), _mm_mul_ps(ay, vy)), _mm_mul_ps(az, vz)), _mm_sub_ps(one, cs));
+        _mm_storeu_ps(&x[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, cs), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ay, vz), _mm_mul_ps(az, vy)), sn)), _mm_mul_ps(ax, d)));
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vy, cs), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(az, vx), _mm_mul_ps(ax, vz)), sn)), _mm_mul_ps(ay, d)));
+        _mm_storeu_ps(&z[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vz, cs), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ax, vy), _mm_mul_ps(ay, vx)), sn)), _mm_mul_ps(az, d)));
+    }
+}
+
+inline void MathUtil::advanceFrames(const float* percent, float percentPerFrame, unsigned int lastFrame,
+                                    float* time, unsigned int* frames, unsigned int count)
+{
+#ifdef USE_SSE2
+    __m128 ppf = _mm_set1_ps(percentPerFrame);
+    __m128i last = _mm_set1_epi32((int)lastFrame);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        __m128i f = _mm_loadu_si128((const __m128i*)&frames[i]);
+        __m128 t = _mm_sub_ps(_mm_loadu_ps(&percent[i]), _mm_mul_ps(_mm_cvtepi32_ps(f), ppf));
+        _mm_storeu_ps(&time[i], t);
+
+        // Subtracting the all-ones comparison mask adds one to the frames that advance.
+        __m128i advance = _mm_and_si128(_mm_cmplt_epi32(f, last), _mm_castps_si128(_mm_cmpge_ps(t, ppf)));
+        _mm_storeu_si128((__m128i*)&frames[i], _mm_sub_epi32(f, advance));
+    }
+#else
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        time[i] = percent[i] - (float)frames[i] * percentPerFrame;
+        if (frames[i] < lastFrame && time[i] >= percentPerFrame)
+        {
+            ++frames[i];
+        }
+    }
+#endif
+}
+
+inline void MathUtil::loopFrames(float delta, float duration, unsigned int frameCount,
+                                 float* time, unsigned int* frames, unsigned int count)
+{
+#ifdef USE_SSE2
+    __m128 d = _mm_set1_ps(delta);
+    __m128 dur = _mm_set1_ps(duration);
+    __m128i n = _mm_set1_epi32((int)frameCount);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        __m128 t = _mm_add_ps(_mm_loadu_ps(&time[i]), d);
+        __m128 wrap = _mm_cmpge_ps(t, dur);
+        _mm_storeu_ps(&time[i], _mm_sub_ps(t, _mm_and_ps(wrap, dur)));
+
+        // Subtracting the all-ones comparison mask adds one to the frames that advance.
+        __m128i f = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)&frames[i]), _mm_castps_si128(wrap));
+        _mm_storeu_si128((__m128i*)&frames[i], _mm_andnot_si128(_mm_cmpeq_epi32(f, n), f));
+    }
+#else
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        time[i] += delta;
+        if (time[i] >= duration)
+        {
+            time[i] -= duration;
+            if (++frames[i] == frameCount)
+            {
+                frames[i] = 0;
+            }
+        }
+    }
+#endif
+}
+
+
+inline void MathUtil::multiplyMatrixRows3(const float* m1, const float* m2, float* dst)
+{
+    __m128 c0 = _mm_loadu_ps(&m1[0]);
+    __m128 c1 = _mm_loadu_ps(&m1[4]);
+    __m128 c2 = _mm_loadu_ps(&m1[8]);
+    __m128 c3 = _mm_loadu_ps(&m1[12]);
+
+    __m128 p[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        const float* b = &m2[i * 4];
+        p[i] = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(b[0])), _mm_mul_ps(c1, _mm_set1_ps(b[1]))),
+            _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(b[2])), _mm_mul_ps(c3, _mm_set1_ps(b[3]))));
+    }
+
+    // Turn the columns of the product into rows and drop the last one.
+    _MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);
+    _mm_storeu_ps(&dst[0], p[0]);
+    _mm_storeu_ps(&dst[4], p[1]);
+    _mm_storeu_ps(&dst[8], p[2]);
+}
+}
@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "Matrix.h"
 #include "Quaternion.h"
+#include "MathUtil.h"
 
 #define MATRIX_SIZE     ( sizeof(float) * 16 )
 
@@ -686,30 +687,19 @@ void Matrix::multiply(const Matrix& m1, const Matrix& m2, Matrix* dst)
 {
     assert(dst);
 
-    // Support the case where m1 or m2 is the same array as dst.
-    float product[16];
-
-    product[0]  = m1.m[0] * m2.m[0]  + m1.m[4] * m2.m[1] + m1.m[8]   * m2.m[2]  + m1.m[12] * m2.m[3];
-    product[1]  = m1.m[1] * m2.m[0]  + m1.m[5] * m2.m[1] + m1.m[9]   * m2.m[2]  + m1.m[13] * m2.m[3];
-    product[2]  = m1.m[2] * m2.m[0]  + m1.m[6] * m2.m[1] + m1.m[10]  * m2.m[2]  + m1.m[14] * m2.m[3];
-    product[3]  = m1.m[3] * m2.m[0]  + m1.m[7] * m2.m[1] + m1.m[11]  * m2.m[2]  + m1.m[15] * m2.m[3];
-
-    product[4]  = m1.m[0] * m2.m[4]  + m1.m[4] * m2.m[5] + m1.m[8]   * m2.m[6]  + m1.m[12] * m2.m[7];
-    product[5]  = m1.m[1] * m2.m[4]  + m1.m[5] * m2.m[5] + m1.m[9]   * m2.m[6]  + m1.m[13] * m2.m[7];
-    product[6]  = m1.m[2] * m2.m[4]  + m1.m[6] * m2.m[5] + m1.m[10]  * m2.m[6]  + m1.m[14] * m2.m[7];
-    product[7]  = m1.m[3] * m2.m[4]  + m1.m[7] * m2.m[5] + m1.m[11]  * m2.m[6]  + m1.m[15] * m2.m[7];
-
-    product[8]  = m1.m[0] * m2.m[8]  + m1.m[4] * m2.m[9] + m1.m[8]   * m2.m[10] + m1.m[12] * m2.m[11];
-    product[9]  = m1.m[1] * m2.m[8]  + m1.m[5] * m2.m[9] + m1.m[9]   * m2.m[10] + m1.m[13] * m2.m[11];
-    product[10] = m1.m[2] * m2.m[8]  + m1.m[6] * m2.m[9] + m1.m[10]  * m2.m[10] + m1.m[14] * m2.m[11];
-    product[11] = m1.m[3] * m2.m[8]  + m1.m[7] * m2.m[9] + m1.m[11]  * m2.m[10] + m1.m[15] * m2.m[11];
+    MathUtil::multiplyMatrix(m1.m, m2.m, dst->m);
+}
 
-    product[12] = m1.m[0] * m2.m[12] + m1.m[4] * m2.m[13] + m1.m[8]  * m2.m[14] + m1.m[12] * m2.m[15];
-    product[13] = m1.m[1] * m2.m[12] + m1.m[5] * m2.m[13] + m1.m[9]  * m2.m[14] + m1.m[13] * m2.m[15];
-    product[14] = m1.m[2] * m2.m[12] + m1.m[6] * m2.m[13] + m1.m[10] * m2.m[14] + m1.m[14] * m2.m[15];
-    product[15] = m1.m[3] * m2.m[12] + m1.m[7] * m2.m[13] + m1.m[11] * m2.m[14] + m1.m[15] * m2.m[15];
+void Matrix::multiply(const Matrix* m1, const Matrix* m2, Matrix* dst, unsigned int count)
+{
+    assert(m1);
+    assert(m2);
+    assert(dst);
 
-    memcpy(dst->m, product, MATRIX_SIZE);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        MathUtil::multiplyMatrix(m1[i].m, m2[i].m, dst[i].m);
+    }
 }
 
 void Matrix::negate()
@@ -922,11 +912,8 @@ void Matrix::transformVector(const Vector3& vector, Vector3* dst) const
 void Matrix::transformVector(float x, float y, float z, float w, Vector3* dst) const
 {
     assert(dst);
-    
-    dst->set(
-        x * m[0] + y * m[4] + z * m[8] + w * m[12],
-        x * m[1] + y * m[5] + z * m[9] + w * m[13],
-        x * m[2] + y * m[6] + z * m[10] + w * m[14] );
+
+    MathUtil::transformVector3(m, x, y, z, w, (float*)dst);
 }
 
 void Matrix::transformVector(Vector4* vector) const
@@ -938,11 +925,23 @@ void Matrix::transformVector(const Vector4& vector, Vector4* dst) const
 {
     assert(dst);
 
-    dst->set(
-        vector.x * m[0] + vector.y * m[4] + vector.z * m[8] + vector.w * m[12],
-        vector.x * m[1] + vector.y * m[5] + vector.z * m[9] + vector.w * m[13],
-        vector.x * m[2] + vector.y * m[6] + vector.z * m[10] + vector.w * m[14],
-        vector.x * m[3] + vector.y * m[7] + vector.z * m[11] + vector.w * m[15] );
+    MathUtil::transformVector4(m, (const float*)&vector, (float*)dst);
+}
+
+void Matrix::transformPoints(const Vector3* points, Vector3* dst, unsigned int count) const
+{
+    assert(points);
+    assert(dst);
+
+    MathUtil::transformVector3Array(m, (const float*)points, (float*)dst, count, 1.0f);
+}
+
+void Matrix::transformVectors(const Vector3* vectors, Vector3* dst, unsigned int count) const
+{
+    assert(vectors);
+    assert(dst);
+
+    MathUtil::transformVector3Array(m, (const float*)vectors, (float*)dst, count, 0.0f);
 }
 
 void Matrix::translate(float x, float y, float z)
@@ -490,6 +490,20 @@ public:
      */
     static void multiply(const Matrix& m1, const Matrix& m2, Matrix* dst);
 
+    /**
+     * Multiplies arrays of matrices pairwise, so that dst[i] = m1[i] * m2[i].
+     *
+     * This is equivalent to calling multiply(const Matrix&, const Matrix&, Matrix*) for each
+     * element, but avoids the per-call overhead when many products are needed at once
+     * (for example, when updating a skin's matrix palette). dst may alias m1 or m2.
+     *
+     * @param m1 The array of first matrices.
+     * @param m2 The array of second matrices.
+     * @param dst An array to store the products in.
+     * @param count The number of matrices in each array.
+     */
+    static void multiply(const Matrix* m1, const Matrix* m2, Matrix* dst, unsigned int count);
+
     /**
      * Negates this matrix.
      */
@@ -773,6 +787,25 @@ public:
      */
     void transformVector(const Vector4& vector, Vector4* dst) const;
 
+    /**
+     * Transforms an array of points by this matrix.
+     *
+     * @param points The array of points to transform.
+     * @param dst An array to store the transformed points in (may be the same as points).
+     * @param count The number of points in each array.
+     */
+    void transformPoints(const Vector3* points, Vector3* dst, unsigned int count) const;
+
+    /**
+     * Transforms an array of vectors by this matrix by
+     * treating the fourth (w) coordinate as zero.
+     *
+     * @param vectors The array of vectors to transform.
+     * @param dst An array to store the transformed vectors in (may be the same as vectors).
+     * @param count The number of vectors in each array.
+     */
+    void transformVectors(const Vector3* vectors, Vector3* dst, unsigned int count) const;
+
     /**
      * Post-multiplies this matrix by the matrix corresponding to the
      * specified translation.
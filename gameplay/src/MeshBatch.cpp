@@ -4,11 +4,39 @@
 namespace gameplay
 {
 
-MeshBatch::MeshBatch(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed, unsigned int initialCapacity, unsigned int growSize)
+MeshBatch::MeshBatch(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed,
+                     unsigned int initialCapacity, unsigned int growSize, bool streaming)
     : _vertexFormat(vertexFormat), _primitiveType(primitiveType), _material(material), _indexed(indexed), _capacity(0), _growSize(growSize),
-      _vertexCapacity(0), _indexCapacity(0), _vertexCount(0), _indexCount(0), _vertices(NULL), _verticesPtr(NULL), _indices(NULL), _indicesPtr(NULL)
+      _vertexCapacity(0), _indexCapacity(0), _vertexCount(0), _indexCount(0), _vertices(NULL), _verticesPtr(NULL), _indices(NULL), _indicesPtr(NULL),
+      _streaming(streaming), _vertexBuffer(0), _indexBuffer(0), _drawFirstVertex(0)
 {
+    if (_streaming)
+    {
+        GL_ASSERT( glGenBuffers(1, &_vertexBuffer) );
+        if (_indexed)
+        {
+            GL_ASSERT( glGenBuffers(1, &_indexBuffer) );
+        }
+        if (GL_LAST_ERROR())
+        {
+            // Fall back to client-side arrays.
+            WARN("Failed to create buffer objects for a streaming mesh batch.");
+            if (_vertexBuffer)
+                glDeleteBuffers(1, &_vertexBuffer);
+            if (_indexBuffer)
+                glDeleteBuffers(1, &_indexBuffer);
+            _vertexBuffer = _indexBuffer = 0;
+            _streaming = false;
+        }
+    }
+
     resize(initialCapacity);
+
+    if (_streaming)
+    {
+        // The bindings refer to the start of the vertex buffer object, so they do not change when the batch resizes.
+        updateVertexAttributeBinding();
+    }
 }
 
 MeshBatch::MeshBatch(const MeshBatch& copy)
@@ -22,23 +50,36 @@ MeshBatch::~MeshBatch()
     SAFE_RELEASE(_material);
     SAFE_DELETE_ARRAY(_vertices);
     SAFE_DELETE_ARRAY(_indices);
+
+    if (_vertexBuffer)
+    {
+        glDeleteBuffers(1, &_vertexBuffer);
+        _vertexBuffer = 0;
+    }
+    if (_indexBuffer)
+    {
+        glDeleteBuffers(1, &_indexBuffer);
+        _indexBuffer = 0;
+    }
 }
 
-MeshBatch* MeshBatch::create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, const char* materialPath, bool indexed, unsigned int initialCapacity, unsigned int growSize)
+MeshBatch* MeshBatch::create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, const char* materialPath, bool indexed,
+                             unsigned int initialCapacity, unsigned int growSize, bool streaming)
 {
     Material* material = Material::create(materialPath);
     if (material == NULL)
         return NULL;
-    MeshBatch* batch = create(vertexFormat, primitiveType, material, indexed, initialCapacity, growSize);
+    MeshBatch* batch = create(vertexFormat, primitiveType, material, indexed, initialCapacity, growSize, streaming);
     SAFE_RELEASE(material); // batch now owns the material
     return batch;
 }
 
-MeshBatch* MeshBatch::create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed, unsigned int initialCapacity, unsigned int growSize)
+MeshBatch* MeshBatch::create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed,
+                             unsigned int initialCapacity, unsigned int growSize, bool streaming)
 {
     assert(material);
 
-    MeshBatch* batch = new MeshBatch(vertexFormat, primitiveType, material, indexed, initialCapacity, growSize);
+    MeshBatch* batch = new MeshBatch(vertexFormat, primitiveType, material, indexed, initialCapacity, growSize, streaming);
 
     material->addRef();
 
@@ -54,7 +95,9 @@ void MeshBatch::updateVertexAttributeBinding()
         for (unsigned int j = 0, passCount = t->getPassCount(); j < passCount; ++j)
         {
             Pass* p = t->getPass(j);
-            VertexAttributeBinding* b = VertexAttributeBinding::create(_vertexFormat, _vertices, p->getEffect());
+            VertexAttributeBinding* b = _streaming ?
+                VertexAttributeBinding::create(_vertexBuffer, _vertexFormat, p->getEffect()) :
+                VertexAttributeBinding::create(_vertexFormat, _vertices, p->getEffect());
             p->setVertexAttributeBinding(b);
             SAFE_RELEASE(b);
         }
@@ -71,49 +114,86 @@ void MeshBatch::setCapacity(unsigned int capacity)
     resize(capacity);
 }
 
-bool MeshBatch::resize(unsigned int capacity)
+bool MeshBatch::isStreaming() const
 {
-    assert(capacity > 0);
-    if (capacity == 0)
-        return false;
+    return _streaming;
+}
 
-    if (capacity == _capacity)
-        return true;
+unsigned int MeshBatch::getDrawCount() const
+{
+    if (_vertexCount == 0 || (_indexed && _indexCount == 0))
+        return 0;
 
-    // Store old batch data
-    unsigned char* oldVertices = _vertices;
-    unsigned short* oldIndices = _indices;
+    return _drawRanges.size() + 1;
+}
 
-    unsigned int vertexCapacity = 0;
+unsigned int MeshBatch::getVertexCapacity(unsigned int capacity) const
+{
     switch (_primitiveType)
     {
     case Mesh::LINES:
-        vertexCapacity = capacity * 2;
-        break;
+        return capacity * 2;
     case Mesh::LINE_STRIP:
-        vertexCapacity = capacity + 1;
-        break;
+        return capacity + 1;
     case Mesh::POINTS:
-        vertexCapacity = capacity;
-        break;
+        return capacity;
     case Mesh::TRIANGLES:
-        vertexCapacity = capacity * 3;
-        break;
+        return capacity * 3;
     case Mesh::TRIANGLE_STRIP:
-        vertexCapacity = capacity + 2;
-        break;
+        return capacity + 2;
     default:
         assert(0); // unexpected
-        break;
+        return 0;
+    }
+}
+
+bool MeshBatch::grow(unsigned int vertexCount, unsigned int indexCount)
+{
+    if (_growSize == 0)
+        return false;
+
+    // Grow geometrically, by at least the grow size.
+    unsigned int capacity = _capacity;
+    do
+    {
+        capacity = std::max(capacity + _growSize, capacity * 2);
+    } while (getVertexCapacity(capacity) < vertexCount || (_indexed && getVertexCapacity(capacity) < indexCount));
+
+    // Client-side arrays are limited to 16-bit indices, so never grow past that limit.
+    if (!_streaming && getVertexCapacity(capacity) > USHRT_MAX)
+    {
+        unsigned int base = getVertexCapacity(0);
+        capacity = (USHRT_MAX - base) / (getVertexCapacity(1) - base);
+        if (capacity <= _capacity || getVertexCapacity(capacity) < vertexCount || (_indexed && getVertexCapacity(capacity) < indexCount))
+            return false;
     }
 
+    return resize(capacity);
+}
+
+bool MeshBatch::resize(unsigned int capacity)
+{
+    assert(capacity > 0);
+    if (capacity == 0)
+        return false;
+
+    if (capacity == _capacity)
+        return true;
+
+    // Store old batch data
+    unsigned char* oldVertices = _vertices;
+    unsigned short* oldIndices = _indices;
+
+    unsigned int vertexCapacity = getVertexCapacity(capacity);
+
     // We have no way of knowing how many vertices will be stored in the batch
     // (we only know how many indices will be stored). Assume the worst case
     // for now, which is the same number of vertices as indices.
     unsigned int indexCapacity = vertexCapacity;
 
-    assert(indexCapacity <= USHRT_MAX);
-    if (indexCapacity > USHRT_MAX)
+    // Client-side arrays are drawn in a single call, limited to 16-bit indices.
+    assert(_streaming || indexCapacity <= USHRT_MAX);
+    if (!_streaming && indexCapacity > USHRT_MAX)
         return false;
 
     // Allocate new data and reset pointers
@@ -147,7 +227,8 @@ bool MeshBatch::resize(unsigned int capacity)
     _indexCapacity = indexCapacity;
 
     // Update our vertex attribute bindings now that our client array pointers have changed
-    updateVertexAttributeBinding();
+    if (!_streaming)
+        updateVertexAttributeBinding();
 
     return true;
 }
@@ -158,6 +239,8 @@ void MeshBatch::begin()
     _indexCount = 0;
     _verticesPtr = _vertices;
     _indicesPtr = _indices;
+    _drawRanges.clear();
+    _drawFirstVertex = 0;
 }
 
 void MeshBatch::end()
@@ -169,6 +252,45 @@ void MeshBatch::draw()
     if (_vertexCount == 0 || (_indexed && _indexCount == 0))
         return; // nothing to draw
 
+    if (_streaming)
+    {
+        Technique* technique = _material->getTechnique();
+        unsigned int passCount = technique->getPassCount();
+
+        // Upload and draw each range of vertices that fits in 16-bit indices in turn.
+        for (unsigned int i = 0, drawCount = _drawRanges.size() + 1; i < drawCount; ++i)
+        {
+            unsigned int firstVertex = i > 0 ? _drawRanges[i - 1].firstVertex : 0;
+            unsigned int firstIndex = i > 0 ? _drawRanges[i - 1].firstIndex : 0;
+            unsigned int vertexCount = (i < _drawRanges.size() ? _drawRanges[i].firstVertex : _vertexCount) - firstVertex;
+            unsigned int indexCount = (i < _drawRanges.size() ? _drawRanges[i].firstIndex : _indexCount) - firstIndex;
+            upload(firstVertex, vertexCount, firstIndex, indexCount);
+
+            for (unsigned int j = 0; j < passCount; ++j)
+            {
+                Pass* pass = technique->getPass(j);
+                pass->bind();
+
+                if (_indexed)
+                {
+                    GL_ASSERT( glDrawElements(_primitiveType, indexCount, GL_UNSIGNED_SHORT, (GLvoid*)0) );
+                }
+                else
+                {
+                    GL_ASSERT( glDrawArrays(_primitiveType, 0, vertexCount) );
+                }
+
+                pass->unbind();
+            }
+        }
+
+        if (_indexed)
+        {
+            GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+        }
+        return;
+    }
+
     // Not using VBOs, so unbind the element array buffer.
     // ARRAY_BUFFER will be unbound automatically during pass->bind().
     GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0 ) );
@@ -193,6 +315,25 @@ void MeshBatch::draw()
         pass->unbind();
     }
 }
+
+void MeshBatch::upload(unsigned int firstVertex, unsigned int vertexCount, unsigned int firstIndex, unsigned int indexCount)
+{
+    // Size the buffers for the largest draw call the batch can hold, so that the driver can recycle
+    // the storage of orphaned buffers, which all have the same size.
+    unsigned int vertexSize = _vertexFormat.getVertexSize();
+    unsigned int maxVertices = _indexed ? std::min(_vertexCapacity, (unsigned int)MESHBATCH_MAX_DRAW_VERTICES) : _vertexCapacity;
+
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, maxVertices * vertexSize, NULL, GL_STREAM_DRAW) );
+    GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount * vertexSize, _vertices + firstVertex * vertexSize) );
+
+    if (_indexed)
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer) );
+        GL_ASSERT( glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexCapacity * sizeof(unsigned short), NULL, GL_STREAM_DRAW) );
+        GL_ASSERT( glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * sizeof(unsigned short), _indices + firstIndex) );
+    }
+}
     
 
 }
@@ -4,11 +4,23 @@
 #include "Mesh.h"
 #include "Material.h"
 
+// The maximum number of vertices a single draw call can address with 16-bit indices.
+#define MESHBATCH_MAX_DRAW_VERTICES (USHRT_MAX + 1)
+
 namespace gameplay
 {
 
 /**
  * Defines a class for rendering multiple mesh into a single draw call on the graphics device.
+ *
+ * Primitives are accumulated in client-side arrays between begin() and end(). By default they are
+ * drawn directly from those arrays. A streaming batch instead copies them into vertex and index
+ * buffer objects when it is drawn, orphaning the previous buffer contents so that the upload does
+ * not wait for earlier draws to complete. A streaming indexed batch is not limited to 16-bit index
+ * space: once the vertices of a draw call would no longer fit, the batch starts a new one.
+ *
+ * When a batch overflows, its capacity at least doubles, so filling a batch takes a logarithmic
+ * number of reallocations.
  */
 class MeshBatch
 {
@@ -22,11 +34,13 @@ public:
      * @param materialPath Path to a material file to be used for drawing the batch.
      * @param indexed True if the batched primivites will contain index data, false otherwise.
      * @param initialCapacity The initial capacity of the batch, in triangles.
-     * @param growSize Amount to grow the batch by when it overflows (a value of zero prevents batch growing).
+     * @param growSize Minimum amount to grow the batch by when it overflows (a value of zero prevents batch growing).
+     * @param streaming True to draw the batch from streamed vertex and index buffer objects, false to draw from client-side arrays.
      *
      * @return A new mesh batch.
      */
-    static MeshBatch* create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, const char* materialPath, bool indexed, unsigned int initialCapacity = 1024, unsigned int growSize = 1024);
+    static MeshBatch* create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, const char* materialPath, bool indexed,
+                             unsigned int initialCapacity = 1024, unsigned int growSize = 1024, bool streaming = false);
 
     /**
      * Creates a new mesh batch.
@@ -36,11 +50,13 @@ public:
      * @param material Material to be used for drawing the batch.
      * @param indexed True if the batched primivites will contain index data, false otherwise.
      * @param initialCapacity The initial capacity of the batch, in triangles.
-     * @param growSize Amount to grow the batch by when it overflows (a value of zero prevents batch growing).
+     * @param growSize Minimum amount to grow the batch by when it overflows (a value of zero prevents batch growing).
+     * @param streaming True to draw the batch from streamed vertex and index buffer objects, false to draw from client-side arrays.
      *
      * @return A new mesh batch.
      */
-    static MeshBatch* create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed, unsigned int initialCapacity = 1024, unsigned int growSize = 1024);
+    static MeshBatch* create(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed,
+                             unsigned int initialCapacity = 1024, unsigned int growSize = 1024, bool streaming = false);
 
     /**
      * Destructor.
@@ -61,6 +77,20 @@ public:
      */
     void setCapacity(unsigned int capacity);
 
+    /**
+     * Returns whether the batch is drawn from streamed vertex and index buffer objects.
+     *
+     * @return True if the batch is streaming, false if it draws from client-side arrays.
+     */
+    bool isStreaming() const;
+
+    /**
+     * Returns the number of draw calls needed to draw the primitives currently in the batch, per material pass.
+     *
+     * @return The draw call count.
+     */
+    unsigned int getDrawCount() const;
+
     /**
      * Returns the material for this mesh batch.
      *
@@ -117,7 +147,8 @@ private:
     /**
      * Constructor.
      */
-    MeshBatch(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed, unsigned int initialCapacity, unsigned int growSize);
+    MeshBatch(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed,
+              unsigned int initialCapacity, unsigned int growSize, bool streaming);
 
     /**
      * Constructor.
@@ -128,6 +159,30 @@ private:
 
     bool resize(unsigned int capacity);
 
+    /**
+     * Grows the batch to hold at least the given number of vertices and indices.
+     */
+    bool grow(unsigned int vertexCount, unsigned int indexCount);
+
+    /**
+     * Returns the number of vertices needed to hold the given number of primitives.
+     */
+    unsigned int getVertexCapacity(unsigned int capacity) const;
+
+    /**
+     * Copies a range of vertices and indices into the batch's buffer objects, orphaning their previous contents.
+     */
+    void upload(unsigned int firstVertex, unsigned int vertexCount, unsigned int firstIndex, unsigned int indexCount);
+
+    /**
+     * The first vertex and index of a draw call of a streaming batch.
+     */
+    struct DrawRange
+    {
+        unsigned int firstVertex;
+        unsigned int firstIndex;
+    };
+
     const VertexFormat _vertexFormat;
     Mesh::PrimitiveType _primitiveType;
     Material* _material;
@@ -142,7 +197,11 @@ private:
     unsigned char* _verticesPtr;
     unsigned short* _indices;
     unsigned short* _indicesPtr;
-
+    bool _streaming;
+    VertexBufferHandle _vertexBuffer;
+    IndexBufferHandle _indexBuffer;
+    std::vector<DrawRange> _drawRanges;     // The draw calls after the first one.
+    unsigned int _drawFirstVertex;          // The first vertex of the current draw call.
 };
 
 }
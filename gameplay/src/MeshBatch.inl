@@ -12,19 +12,22 @@ template <class T>
 void MeshBatch::add(T* vertices, unsigned int vertexCount, unsigned short* indices, unsigned int indexCount)
 {
     assert(sizeof(T) == _vertexFormat.getVertexSize());
-    
+    assert(!_indexed || vertexCount <= MESHBATCH_MAX_DRAW_VERTICES);
+
+    // A streaming batch starts a new draw call when the new vertices cannot be indexed from the current one.
+    bool newDraw = _streaming && _indexed && _vertexCount > _drawFirstVertex &&
+        _vertexCount - _drawFirstVertex + vertexCount > MESHBATCH_MAX_DRAW_VERTICES;
+
     unsigned int newVertexCount = _vertexCount + vertexCount;
     unsigned int newIndexCount = _indexCount + indexCount;
-    if (_primitiveType == Mesh::TRIANGLE_STRIP && _vertexCount > 0)
+    if (_primitiveType == Mesh::TRIANGLE_STRIP && _vertexCount > 0 && !newDraw)
         newIndexCount += 2; // need an extra 2 indices for connecting strips with degenerate triangles
     
     // Do we need to grow the batch?
-    while (newVertexCount > _vertexCapacity || (_indexed && newIndexCount > _indexCapacity))
+    if (newVertexCount > _vertexCapacity || (_indexed && newIndexCount > _indexCapacity))
     {
-        if (_growSize == 0)
-            return; // growing disabled, just clip batch
-        if (!resize(_capacity + _growSize))
-            return; // failed to grow
+        if (!grow(newVertexCount, newIndexCount))
+            return; // growing disabled or failed, just clip batch
     }
     
     // Copy vertex data
@@ -34,7 +37,18 @@ void MeshBatch::add(T* vertices, unsigned int vertexCount, unsigned short* indic
     // Copy index data
     if (_indexed)
     {
-        if (_vertexCount == 0)
+        if (newDraw)
+        {
+            DrawRange range;
+            range.firstVertex = _vertexCount;
+            range.firstIndex = _indexCount;
+            _drawRanges.push_back(range);
+            _drawFirstVertex = _vertexCount;
+        }
+
+        // Indices are relative to the first vertex of the current draw call.
+        unsigned int baseVertex = _vertexCount - _drawFirstVertex;
+        if (baseVertex == 0)
         {
             // Simply copy values directly into the start of the index array
             memcpy(_indicesPtr, indices, indexCount * sizeof(unsigned short));
@@ -46,15 +60,15 @@ void MeshBatch::add(T* vertices, unsigned int vertexCount, unsigned short* indic
                 // Create a degenerate triangle to connect separate triangle strips
                 // by duplicating the previous and next vertices.
                 _indicesPtr[0] = *(_indicesPtr-1);
-                _indicesPtr[1] = _vertexCount;
+                _indicesPtr[1] = baseVertex;
                 _indicesPtr += 2;
             }
             
             // Loop through all indices and insert them, their their value offset by
-            // 'vertexCount' so that they are relative to the first newly insertted vertex
+            // 'baseVertex' so that they are relative to the first newly insertted vertex
             for (unsigned int i = 0; i < indexCount; ++i)
             {
-                _indicesPtr[i] = indices[i] + _vertexCount;
+                _indicesPtr[i] = indices[i] + baseVertex;
             }
         }
         _indicesPtr += indexCount;
@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "MeshSkin.h"
 #include "Joint.h"
+#include "MathUtil.h"
 
 // The number of rows in each palette matrix.
 #define PALETTE_ROWS 3
@@ -9,7 +10,7 @@ namespace gameplay
 {
 
 MeshSkin::MeshSkin()
-    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _model(NULL)
+    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _matrixPaletteDirty(true), _model(NULL)
 {
 }
 
@@ -28,6 +29,7 @@ const Matrix& MeshSkin::getBindShape() const
 void MeshSkin::setBindShape(const float* matrix)
 {
     _bindShape.set(matrix);
+    _matrixPaletteDirty = true;
 }
 
 unsigned int MeshSkin::getJointCount() const
@@ -102,6 +104,7 @@ void MeshSkin::setJointCount(unsigned int jointCount)
 
     // Rebuild the matrix palette. Each matrix is 3 rows of Vector4.
     SAFE_DELETE_ARRAY(_matrixPalette);
+    _matrixPaletteDirty = true;
 
     if (jointCount > 0)
     {
@@ -121,7 +124,7 @@ void MeshSkin::setJoint(Joint* joint, unsigned int index)
 
     if (_joints[index])
     {
-        _joints[index]->_skinCount--;
+        removeFromJoint(_joints[index]);
         SAFE_RELEASE(_joints[index]);
     }
 
@@ -131,19 +134,33 @@ void MeshSkin::setJoint(Joint* joint, unsigned int index)
     {
         joint->addRef();
         joint->_skinCount++;
+        joint->_skins.push_back(this);
     }
+    _matrixPaletteDirty = true;
 }
 
 Vector4* MeshSkin::getMatrixPalette() const
 {
-    unsigned int count = _joints.size();
-    for (unsigned int i = 0; i < count; i++)
+    // The palette is bound for every pass of every mesh part, so only compute it when a joint changed.
+    if (_matrixPaletteDirty)
     {
-        _joints[i]->updateJointMatrix(getBindShape(), &_matrixPalette[i * PALETTE_ROWS]);
+        computeMatrixPalette();
+        _matrixPaletteDirty = false;
     }
     return _matrixPalette;
 }
 
+void MeshSkin::computeMatrixPalette() const
+{
+    Matrix m;
+    for (unsigned int i = 0, count = _joints.size(); i < count; i++)
+    {
+        Joint* joint = _joints[i];
+        MathUtil::multiplyMatrix(joint->getWorldMatrix().m, joint->getInverseBindPose().m, m.m);
+        MathUtil::multiplyMatrixRows3(m.m, _bindShape.m, &_matrixPalette[i * PALETTE_ROWS].x);
+    }
+}
+
 unsigned int MeshSkin::getMatrixPaletteSize() const
 {
     return _joints.size() * PALETTE_ROWS;
@@ -244,9 +261,24 @@ void MeshSkin::clearJoints()
 
     for (unsigned int i = 0, count = _joints.size(); i < count; ++i)
     {
-        SAFE_RELEASE(_joints[i]);
+        if (_joints[i])
+        {
+            removeFromJoint(_joints[i]);
+            SAFE_RELEASE(_joints[i]);
+        }
     }
     _joints.clear();
 }
 
+void MeshSkin::removeFromJoint(Joint* joint)
+{
+    // A joint may appear more than once in a skin, so only one registration is removed per index.
+    std::vector<MeshSkin*>::iterator itr = std::find(joint->_skins.begin(), joint->_skins.end(), this);
+    if (itr != joint->_skins.end())
+    {
+        joint->_skins.erase(itr);
+    }
+    joint->_skinCount--;
+}
+
 }
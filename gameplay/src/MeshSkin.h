@@ -20,6 +20,7 @@ class MeshSkin : public Transform::Listener
     friend class Bundle;
     friend class Model;
     friend class Joint;
+    friend class Scene;
 
 public:
 
@@ -85,6 +86,9 @@ public:
 
     /**
      * Returns the pointer to the Vector4 array for the purpose of binding to a shader.
+     *
+     * The palette is computed from the joints when it is requested after any of the joints,
+     * the bind shape or the joint list changed, and the cached palette is returned otherwise.
      * 
      * @return The pointer to the matrix palette.
      */
@@ -166,6 +170,21 @@ private:
      */
     void clearJoints();
 
+    /**
+     * Removes this skin from the skins influencing the specified joint.
+     *
+     * @param joint The joint to remove this skin from.
+     */
+    void removeFromJoint(Joint* joint);
+
+    /**
+     * Computes the matrix palette from the world matrices of the joints.
+     *
+     * This only reads the joints once their world matrices are resolved, so the palettes of
+     * different skins may then be computed concurrently.
+     */
+    void computeMatrixPalette() const;
+
     Matrix _bindShape;
     std::vector<Joint*> _joints;
     Joint* _rootJoint;
@@ -180,6 +199,7 @@ private:
     // Each 4x3 row-wise matrix is represented as 3 Vector4's.
     // The number of Vector4's is (_joints.size() * 3).
     Vector4* _matrixPalette;
+    mutable bool _matrixPaletteDirty;   // Set by the joints when they change, cleared when the palette is computed.
     Model* _model;
 };
 
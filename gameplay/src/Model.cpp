@@ -256,22 +256,7 @@ void Model::draw(bool wireframe)
             unsigned int passCount = technique->getPassCount();
             for (unsigned int i = 0; i < passCount; ++i)
             {
-                Pass* pass = technique->getPass(i);
-                pass->bind();
-                GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
-                if (wireframe && (_mesh->getPrimitiveType() == Mesh::TRIANGLES || _mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP))
-                {
-                    unsigned int vertexCount = _mesh->getVertexCount();
-                    for (unsigned int j = 0; j < vertexCount; j += 3)
-                    {
-                        GL_ASSERT( glDrawArrays(GL_LINE_LOOP, j, 3) );
-                    }
-                }
-                else
-                {
-                    GL_ASSERT( glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()) );
-                }
-                pass->unbind();
+                drawPass(technique->getPass(i), NULL, wireframe);
             }
         }
     }
@@ -289,42 +274,65 @@ void Model::draw(bool wireframe)
                 unsigned int passCount = technique->getPassCount();
                 for (unsigned int j = 0; j < passCount; ++j)
                 {
-                    Pass* pass = technique->getPass(j);
-                    pass->bind();
-                    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer) );
-                    if (wireframe && (_mesh->getPrimitiveType() == Mesh::TRIANGLES || _mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP))
-                    {
-                        unsigned int indexCount = part->getIndexCount();
-                        unsigned int indexSize = 0;
-                        switch (part->getIndexFormat())
-                        {
-                        case Mesh::INDEX8:
-                            indexSize = 1;
-                            break;
-                        case Mesh::INDEX16:
-                            indexSize = 2;
-                            break;
-                        case Mesh::INDEX32:
-                            indexSize = 4;
-                            break;
-                        }
-
-                        for (unsigned int k = 0; k < indexCount; k += 3)
-                        {
-                            GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(k*indexSize))) );
-                        }
-                    }
-                    else
-                    {
-                        GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
-                    }
-                    pass->unbind();
+                    drawPass(technique->getPass(j), part, wireframe);
                 }
             }
         }
     }
 }
 
+void Model::drawPass(Pass* pass, MeshPart* part, bool wireframe)
+{
+    pass->bind();
+    if (part == NULL)
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+        if (wireframe && (_mesh->getPrimitiveType() == Mesh::TRIANGLES || _mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP))
+        {
+            unsigned int vertexCount = _mesh->getVertexCount();
+            for (unsigned int j = 0; j < vertexCount; j += 3)
+            {
+                GL_ASSERT( glDrawArrays(GL_LINE_LOOP, j, 3) );
+            }
+        }
+        else
+        {
+            GL_ASSERT( glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()) );
+        }
+    }
+    else
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer) );
+        if (wireframe && (_mesh->getPrimitiveType() == Mesh::TRIANGLES || _mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP))
+        {
+            unsigned int indexCount = part->getIndexCount();
+            unsigned int indexSize = 0;
+            switch (part->getIndexFormat())
+            {
+            case Mesh::INDEX8:
+                indexSize = 1;
+                break;
+            case Mesh::INDEX16:
+                indexSize = 2;
+                break;
+            case Mesh::INDEX32:
+                indexSize = 4;
+                break;
+            }
+
+            for (unsigned int k = 0; k < indexCount; k += 3)
+            {
+                GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(k*indexSize))) );
+            }
+        }
+        else
+        {
+            GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
+        }
+    }
+    pass->unbind();
+}
+
 void Model::validatePartCount()
 {
     unsigned int partCount = _mesh->getPartCount();
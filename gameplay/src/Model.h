@@ -22,6 +22,7 @@ class Model : public Ref
     friend class Node;
     friend class Mesh;
     friend class Bundle;
+    friend class RenderQueue;
 
 public:
 
@@ -178,6 +179,15 @@ private:
 
     void validatePartCount();
 
+    /**
+     * Draws a single pass of the given mesh part, or of the whole mesh if part is NULL.
+     *
+     * @param pass The pass to draw with.
+     * @param part The mesh part to draw, or NULL for meshes without parts.
+     * @param wireframe If true, draw the model in wireframe mode.
+     */
+    void drawPass(Pass* pass, MeshPart* part, bool wireframe);
+
     /**
      * Clones the model and returns a new model.
      * 
@@ -7,11 +7,6 @@
 #include "PhysicsCharacter.h"
 #include "Game.h"
 
-// Node dirty flags
-#define NODE_DIRTY_WORLD 1
-#define NODE_DIRTY_BOUNDS 2
-#define NODE_DIRTY_ALL (NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS)
-
 // Node property flags
 #define NODE_FLAG_VISIBLE 1
 #define NODE_FLAG_TRANSPARENT 2
@@ -20,10 +15,13 @@
 namespace gameplay
 {
 
+// The node currently being notified by a flattened scene's descendant walk (see transformChanged()).
+static Node* __flattenedNotifyNode = NULL;
+
 Node::Node(const char* id)
     : _scene(NULL), _firstChild(NULL), _nextSibling(NULL), _prevSibling(NULL), _parent(NULL), _childCount(NULL),
     _nodeFlags(NODE_FLAG_VISIBLE), _camera(NULL), _light(NULL), _model(NULL), _form(NULL), _audioSource(NULL), _particleEmitter(NULL),
-    _collisionObject(NULL), _dirtyBits(NODE_DIRTY_ALL), _notifyHierarchyChanged(true), _userData(NULL)
+    _collisionObject(NULL), _dirtyBits(NODE_DIRTY_ALL), _notifyHierarchyChanged(true), _userData(NULL), _transformIndex(0), _spatialProxy(-1), _lodClips(NULL)
 {
     if (id)
     {
@@ -52,6 +50,16 @@ Node::~Node()
     SAFE_RELEASE(_form);
     SAFE_DELETE(_collisionObject);
 
+    // Clips do not retain their LOD nodes, so detach them from this node.
+    if (_lodClips)
+    {
+        for (unsigned int i = 0, count = _lodClips->size(); i < count; ++i)
+        {
+            (*_lodClips)[i]->_lodNode = NULL;
+        }
+        SAFE_DELETE(_lodClips);
+    }
+
     // Cleanup user data
     if (_userData)
     {
@@ -127,6 +135,13 @@ void Node::addChild(Node* child)
     {
         hierarchyChanged();
     }
+
+    // Index the new subtree if our scene maintains a spatial index.
+    Scene* scene = getScene();
+    if (scene && scene->_spatialIndex)
+    {
+        scene->addSpatialProxies(child);
+    }
 }
 
 void Node::removeChild(Node* child)
@@ -158,6 +173,13 @@ void Node::removeAllChildren()
 
 void Node::remove()
 {
+    // Drop our subtree from our scene's spatial index.
+    Scene* scene = getScene();
+    if (scene && scene->_spatialIndex)
+    {
+        scene->removeSpatialProxies(this);
+    }
+
     // Re-link our neighbours.
     if (_prevSibling)
     {
@@ -370,6 +392,14 @@ const Matrix& Node::getWorldMatrix() const
 {
     if (_dirtyBits & NODE_DIRTY_WORLD)
     {
+        // Flattened scenes resolve all of their pending world matrices in a single pass.
+        Scene* scene = getScene();
+        if (scene && scene->_flattenedTransforms)
+        {
+            scene->updateTransforms();
+            return _world;
+        }
+
         // Clear our dirty flag immediately to prevent this block from being entered if our
         // parent calls our getWorldMatrix() method as a result of the following calculations.
         _dirtyBits &= ~NODE_DIRTY_WORLD;
@@ -577,6 +607,13 @@ Vector3 Node::getActiveCameraTranslationView() const
 
 void Node::hierarchyChanged()
 {
+    // The flattened node order of our scene no longer matches the hierarchy.
+    Scene* scene = getScene();
+    if (scene)
+    {
+        scene->_transformOrderDirty = true;
+    }
+
     // When our hierarchy changes our world transform is affected, so we must dirty it.
     transformChanged();
 }
@@ -585,14 +622,38 @@ void Node::transformChanged()
 {
     // Our local transform was changed, so mark our world matrices dirty.
     _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS;
+    spatialBoundsChanged();
 
-    // Notify our children that their transform has also changed (since transforms are inherited).
-    Joint* rootJoint = NULL;
-    Node* n = getFirstChild();
-    while (n)
+    // Descendants notified by a flattened scene's walk are reached by that walk,
+    // so they must not walk their own subtree again.
+    if (this != __flattenedNotifyNode)
     {
-        n->transformChanged();
-        n = n->getNextSibling();
+        Scene* scene = getScene();
+        if (scene && scene->_flattenedTransforms && !scene->_transformOrderDirty)
+        {
+            // Our subtree occupies a contiguous range of the scene's flattened arrays.
+            const unsigned int begin = _transformIndex;
+            const unsigned int end = scene->_transformSubtreeEnds[begin];
+            scene->setTransformsDirty(begin, end);
+
+            Node* previous = __flattenedNotifyNode;
+            for (unsigned int i = begin + 1; i < end; ++i)
+            {
+                __flattenedNotifyNode = scene->_transformNodes[i];
+                __flattenedNotifyNode->transformChanged();
+            }
+            __flattenedNotifyNode = previous;
+        }
+        else
+        {
+            // Notify our children that their transform has also changed (since transforms are inherited).
+            Node* n = getFirstChild();
+            while (n)
+            {
+                n->transformChanged();
+                n = n->getNextSibling();
+            }
+        }
     }
 
     Transform::transformChanged();
@@ -602,12 +663,27 @@ void Node::setBoundsDirty()
 {
     // Mark ourself and our parent nodes as dirty
     _dirtyBits |= NODE_DIRTY_BOUNDS;
+    spatialBoundsChanged();
 
     // Mark our parent bounds as dirty as well
     if (_parent)
         _parent->setBoundsDirty();
 }
 
+void Node::spatialBoundsChanged()
+{
+    // Each indexed node is queued at most once until its scene next updates the index.
+    if (_spatialProxy >= 0 && !(_dirtyBits & NODE_DIRTY_SPATIAL))
+    {
+        Scene* scene = getScene();
+        if (scene)
+        {
+            _dirtyBits |= NODE_DIRTY_SPATIAL;
+            scene->_spatialUpdates.push_back(this);
+        }
+    }
+}
+
 Animation* Node::getAnimation(const char* id) const
 {
     Animation* animation = ((AnimationTarget*)this)->getAnimation(id);
@@ -738,6 +814,13 @@ void Node::setModel(Model* model)
             _model->addRef();
             _model->setNode(this);
         }
+
+        // Only nodes with models are indexed, so the node may need to be added to or removed from the index.
+        Scene* scene = getScene();
+        if (scene && scene->_spatialIndex)
+        {
+            scene->updateSpatialProxy(this);
+        }
     }
 }
 
@@ -777,54 +860,16 @@ const BoundingSphere& Node::getBoundingSphere() const
     {
         _dirtyBits &= ~NODE_DIRTY_BOUNDS;
 
-        const Matrix& worldMatrix = getWorldMatrix();
-
         // Start with our local bounding sphere
         // TODO: Incorporate bounds from entities other than mesh (i.e. emitters, audiosource, etc)
-        bool empty = true;
-        if (_model && _model->getMesh())
-        {
-            _bounds.set(_model->getMesh()->getBoundingSphere());
-            empty = false;
-        }
-        else
+        bool empty = !getModelBoundingSphere(&_bounds);
+        if (empty)
         {
             // Empty bounding sphere, set the world translation with zero radius
-            worldMatrix.getTranslation(&_bounds.center);
+            getWorldMatrix().getTranslation(&_bounds.center);
             _bounds.radius = 0;
         }
 
-        // Transform the sphere (if not empty) into world space.
-        if (!empty)
-        {
-            bool applyWorldTransform = true;
-            if (_model && _model->getSkin())
-            {
-                // Special case: If the root joint of our mesh skin is parented by any nodes, 
-                // multiply the world matrix of the root joint's parent by this node's
-                // world matrix. This computes a final world matrix used for transforming this
-                // node's bounding volume. This allows us to store a much smaller bounding
-                // volume approximation than would otherwise be possible for skinned meshes,
-                // since joint parent nodes that are not in the matrix pallette do not need to
-                // be considered as directly transforming vertices on the GPU (they can instead
-                // be applied directly to the bounding volume transformation below).
-                Node* jointParent = _model->getSkin()->getRootJoint()->getParent();
-                if (jointParent)
-                {
-                    // TODO: Should we protect against the case where joints are nested directly
-                    // in the node hierachy of the model (this is normally not the case)?
-                    Matrix boundsMatrix;
-                    Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
-                    _bounds.transform(boundsMatrix);
-                    applyWorldTransform = false;
-                }
-            }
-            if (applyWorldTransform)
-            {
-                _bounds.transform(getWorldMatrix());
-            }
-        }
-
         // Merge this world-space bounding sphere with our childrens' bounding volumes.
         for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
         {
@@ -847,6 +892,42 @@ const BoundingSphere& Node::getBoundingSphere() const
     return _bounds;
 }
 
+bool Node::getModelBoundingSphere(BoundingSphere* sphere) const
+{
+    assert(sphere);
+
+    if (!_model || !_model->getMesh())
+        return false;
+
+    sphere->set(_model->getMesh()->getBoundingSphere());
+
+    // Transform the sphere into world space.
+    if (_model->getSkin())
+    {
+        // Special case: If the root joint of our mesh skin is parented by any nodes, 
+        // multiply the world matrix of the root joint's parent by this node's
+        // world matrix. This computes a final world matrix used for transforming this
+        // node's bounding volume. This allows us to store a much smaller bounding
+        // volume approximation than would otherwise be possible for skinned meshes,
+        // since joint parent nodes that are not in the matrix pallette do not need to
+        // be considered as directly transforming vertices on the GPU (they can instead
+        // be applied directly to the bounding volume transformation below).
+        Node* jointParent = _model->getSkin()->getRootJoint()->getParent();
+        if (jointParent)
+        {
+            // TODO: Should we protect against the case where joints are nested directly
+            // in the node hierachy of the model (this is normally not the case)?
+            Matrix boundsMatrix;
+            Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
+            sphere->transform(boundsMatrix);
+            return true;
+        }
+    }
+
+    sphere->transform(getWorldMatrix());
+    return true;
+}
+
 
 Node* Node::clone() const
 {
@@ -13,6 +13,12 @@
 #include "PhysicsCollisionShape.h"
 #include "BoundingBox.h"
 
+// Node dirty flags
+#define NODE_DIRTY_WORLD 1
+#define NODE_DIRTY_BOUNDS 2
+#define NODE_DIRTY_ALL (NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS)
+#define NODE_DIRTY_SPATIAL 4
+
 namespace gameplay
 {
 
@@ -28,6 +34,7 @@ class Node : public Transform, public Ref
     friend class Scene;
     friend class Bundle;
     friend class MeshSkin;
+    friend class AnimationClip;
 
 public:
 
@@ -619,6 +626,20 @@ protected:
      */
     void setBoundsDirty();
 
+    /**
+     * Computes the world-space bounding sphere of the node's model, excluding its children.
+     *
+     * @param sphere The sphere to store the result in.
+     *
+     * @return true if the node has a model with a mesh, false otherwise.
+     */
+    bool getModelBoundingSphere(BoundingSphere* sphere) const;
+
+    /**
+     * Queues the node's proxy in its scene's spatial index for an update.
+     */
+    void spatialBoundsChanged();
+
 private:
 
     /**
@@ -753,6 +774,21 @@ protected:
      * Pointer to custom UserData and cleanup call back that can be stored in a Node.
      */
     UserData* _userData;
+
+    /**
+     * Index of the Node in its scene's flattened transform arrays (valid only while flattened transforms are enabled).
+     */
+    unsigned int _transformIndex;
+
+    /**
+     * The Node's proxy in its scene's spatial index, or -1 if the node is not indexed.
+     */
+    int _spatialProxy;
+
+    /**
+     * The animation clips whose level of detail node is this Node (see AnimationClip::setLodNode), or NULL if there are none.
+     */
+    std::vector<AnimationClip*>* _lodClips;
 };
 
 /**
@@ -5,16 +5,18 @@
 #include "Scene.h"
 #include "Quaternion.h"
 #include "Properties.h"
+#include "MathUtil.h"
 
 #define PARTICLE_COUNT_MAX                       100
 #define PARTICLE_EMISSION_RATE                   10
 #define PARTICLE_EMISSION_RATE_TIME_INTERVAL     1000.0f / (float)PARTICLE_EMISSION_RATE
+#define PARTICLE_ROTATION_BLOCK_SIZE             256
 
 namespace gameplay
 {
 
 ParticleEmitter::ParticleEmitter(SpriteBatch* batch, unsigned int particleCountMax) :
-    _particleCountMax(particleCountMax), _particleCount(0), _particles(NULL),
+    _particleCountMax(particleCountMax), _particleCount(0), _particleCapacity(0), _particleData(NULL), _particleFrames(NULL), _spriteVertices(NULL), _spriteCount(0),
     _emissionRate(PARTICLE_EMISSION_RATE), _started(false), _ellipsoid(false),
     _sizeStartMin(1.0f), _sizeStartMax(1.0f), _sizeEndMin(1.0f), _sizeEndMax(1.0f),
     _energyMin(1000L), _energyMax(1000L),
@@ -24,13 +26,23 @@ ParticleEmitter::ParticleEmitter(SpriteBatch* batch, unsigned int particleCountM
     _acceleration(Vector3::zero()), _accelerationVar(Vector3::zero()),
     _rotationPerParticleSpeedMin(0.0f), _rotationPerParticleSpeedMax(0.0f),
     _rotationSpeedMin(0.0f), _rotationSpeedMax(0.0f),
-    _rotationAxis(Vector3::zero()), _rotation(Matrix::identity()),
+    _rotationAxis(Vector3::zero()),
     _spriteBatch(batch), _spriteTextureBlending(BLEND_TRANSPARENT),  _spriteTextureWidth(0), _spriteTextureHeight(0), _spriteTextureWidthRatio(0), _spriteTextureHeightRatio(0), _spriteTextureCoords(NULL),
     _spriteAnimated(false),  _spriteLooped(false), _spriteFrameCount(1), _spriteFrameRandomOffset(0),_spriteFrameDuration(0L), _spriteFrameDurationSecs(0.0f), _spritePercentPerFrame(0.0f),
     _node(NULL), _orbitPosition(false), _orbitVelocity(false), _orbitAcceleration(false),
-    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _timeLast(0L), _timeRunning(0L)
-{
-    _particles = new Particle[particleCountMax];
+    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _timeLast(0L), _timeRunning(0L),
+    _randomState((unsigned int)rand())
+{
+    // Zero the padding at the end of the arrays, which is updated along with the particles.
+    _particleCapacity = (particleCountMax + 3) & ~3;
+    _particleData = new float[_particleCapacity * PARTICLE_ARRAY_COUNT];
+    memset(_particleData, 0, _particleCapacity * PARTICLE_ARRAY_COUNT * sizeof(float));
+    for (unsigned int i = 0; i < PARTICLE_ARRAY_COUNT; ++i)
+    {
+        _particleArrays[i] = &_particleData[i * _particleCapacity];
+    }
+    _particleFrames = new unsigned int[_particleCapacity];
+    memset(_particleFrames, 0, _particleCapacity * sizeof(unsigned int));
 
     _spriteBatch->getStateBlock()->setDepthWrite(false);
     _spriteBatch->getStateBlock()->setDepthTest(true);
@@ -44,7 +56,9 @@ ParticleEmitter::ParticleEmitter(SpriteBatch* batch, unsigned int particleCountM
 ParticleEmitter::~ParticleEmitter()
 {
     SAFE_DELETE(_spriteBatch);
-    SAFE_DELETE_ARRAY(_particles);
+    SAFE_DELETE_ARRAY(_particleData);
+    SAFE_DELETE_ARRAY(_particleFrames);
+    SAFE_DELETE_ARRAY(_spriteVertices);
     SAFE_DELETE_ARRAY(_spriteTextureCoords);
 }
 
@@ -251,7 +265,7 @@ bool ParticleEmitter::isActive() const
     bool active = false;
     for (unsigned int i = 0; i < _particleCount; i++)
     {
-        if (_particles[i]._energy > 0)
+        if (_particleArrays[AGE][i] < _particleArrays[ENERGY][i])
         {
             active = true;
             break;
@@ -279,63 +293,99 @@ void ParticleEmitter::emit(unsigned int particleCount)
     world.m[14] = 0.0f;
 
     // Emit the new particles.
+    float** a = _particleArrays;
     for (unsigned int i = 0; i < particleCount; i++)
     {
-        Particle* p = &_particles[_particleCount];
-
-        generateColor(_colorStart, _colorStartVar, &p->_colorStart);
-        generateColor(_colorEnd, _colorEndVar, &p->_colorEnd);
-        p->_color.set(p->_colorStart);
-
-        p->_energy = p->_energyStart = generateScalar(_energyMin, _energyMax);
-        p->_size = p->_sizeStart = generateScalar(_sizeStartMin, _sizeStartMax);
-        p->_sizeEnd = generateScalar(_sizeEndMin, _sizeEndMax);
-        p->_rotationPerParticleSpeed = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
-        p->_angle = generateScalar(0.0f, p->_rotationPerParticleSpeed);
-        p->_rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
+        unsigned int p = _particleCount;
+        Vector4 colorStart;
+        Vector4 colorEnd;
+        generateColor(_colorStart, _colorStartVar, &colorStart);
+        generateColor(_colorEnd, _colorEndVar, &colorEnd);
+        a[COLOR_START_R][p] = a[COLOR_R][p] = colorStart.x;
+        a[COLOR_START_G][p] = a[COLOR_G][p] = colorStart.y;
+        a[COLOR_START_B][p] = a[COLOR_B][p] = colorStart.z;
+        a[COLOR_START_A][p] = a[COLOR_A][p] = colorStart.w;
+        a[COLOR_END_R][p] = colorEnd.x;
+        a[COLOR_END_G][p] = colorEnd.y;
+        a[COLOR_END_B][p] = colorEnd.z;
+        a[COLOR_END_A][p] = colorEnd.w;
+
+        long energy = (long)generateScalar(_energyMin, _energyMax);
+        a[AGE][p] = 0.0f;
+        a[ENERGY][p] = (float)energy;
+        a[ENERGY_INVERSE][p] = energy > 0 ? 1.0f / (float)energy : 0.0f;
+        a[PERCENT][p] = 0.0f;
+        a[SIZE][p] = a[SIZE_START][p] = generateScalar(_sizeStartMin, _sizeStartMax);
+        a[SIZE_END][p] = generateScalar(_sizeEndMin, _sizeEndMax);
+        a[ROTATION_PER_PARTICLE_SPEED][p] = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
+        a[ANGLE][p] = generateScalar(0.0f, a[ROTATION_PER_PARTICLE_SPEED][p]);
+        float rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
 
         // Only initial position can be generated within an ellipsoidal domain.
-        generateVector(_position, _positionVar, &p->_position, _ellipsoid);
-        generateVector(_velocity, _velocityVar, &p->_velocity, false);
-        generateVector(_acceleration, _accelerationVar, &p->_acceleration, false);
-        generateVector(_rotationAxis, _rotationAxisVar, &p->_rotationAxis, false);
+        Vector3 position;
+        Vector3 velocity;
+        Vector3 acceleration;
+        Vector3 rotationAxis;
+        generateVector(_position, _positionVar, &position, _ellipsoid);
+        generateVector(_velocity, _velocityVar, &velocity, false);
+        generateVector(_acceleration, _accelerationVar, &acceleration, false);
+        generateVector(_rotationAxis, _rotationAxisVar, &rotationAxis, false);
 
         // Initial position, velocity and acceleration can all be relative to the emitter's transform.
         // Rotate specified properties by the node's rotation.
         if (_orbitPosition)
         {
-            world.transformPoint(p->_position, &p->_position);
+            world.transformPoint(position, &position);
         }
 
         if (_orbitVelocity)
         {
-            world.transformPoint(p->_velocity, &p->_velocity);
+            world.transformPoint(velocity, &velocity);
         }
 
         if (_orbitAcceleration)
         {
-            world.transformPoint(p->_acceleration, &p->_acceleration);
+            world.transformPoint(acceleration, &acceleration);
         }
 
         // The rotation axis always orbits the node.
-        if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+        if (rotationSpeed != 0.0f && !rotationAxis.isZero())
         {
-            world.transformPoint(p->_rotationAxis, &p->_rotationAxis);
+            world.transformPoint(rotationAxis, &rotationAxis);
+            rotationAxis.normalize();
+        }
+        else
+        {
+            rotationSpeed = 0.0f;
         }
 
         // Translate position relative to the node's world space.
-        p->_position.add(translation);
+        position.add(translation);
+
+        a[POSITION_X][p] = position.x;
+        a[POSITION_Y][p] = position.y;
+        a[POSITION_Z][p] = position.z;
+        a[VELOCITY_X][p] = velocity.x;
+        a[VELOCITY_Y][p] = velocity.y;
+        a[VELOCITY_Z][p] = velocity.z;
+        a[ACCELERATION_X][p] = acceleration.x;
+        a[ACCELERATION_Y][p] = acceleration.y;
+        a[ACCELERATION_Z][p] = acceleration.z;
+        a[ROTATION_AXIS_X][p] = rotationAxis.x;
+        a[ROTATION_AXIS_Y][p] = rotationAxis.y;
+        a[ROTATION_AXIS_Z][p] = rotationAxis.z;
+        a[ROTATION_SPEED][p] = rotationSpeed;
 
         // Initial sprite frame.
         if (_spriteFrameRandomOffset > 0)
         {
-            p->_frame = rand() % _spriteFrameRandomOffset;
+            _particleFrames[p] = nextRandom() % _spriteFrameRandomOffset;
         }
         else
         {
-            p->_frame = 0;
+            _particleFrames[p] = 0;
         }
-        p->_timeOnCurrentFrame = 0.0f;
+        a[TIME_ON_CURRENT_FRAME][p] = 0.0f;
 
         ++_particleCount;
     }
@@ -671,35 +721,44 @@ void ParticleEmitter::setOrbit(bool orbitPosition, bool orbitVelocity, bool orbi
     _orbitAcceleration = orbitAcceleration;
 }
 
+unsigned int ParticleEmitter::nextRandom()
+{
+    // Linear congruential generator (constants from Numerical Recipes).
+    _randomState = _randomState * 1664525u + 1013904223u;
+    return _randomState;
+}
+
+float ParticleEmitter::generateRandom()
+{
+    // The low bits of a linear congruential generator are the least random, so use the top 24 bits.
+    return (float)(nextRandom() >> 8) * (1.0f / 16777216.0f);
+}
+
 long ParticleEmitter::generateScalar(long min, long max)
 {
-    // Note: this is not a very good RNG, but it should be suitable for our purposes.
-    long r = 0;
-    for (unsigned int i = 0; i < sizeof(long)/sizeof(int); i++)
-    {
-        r = r << 8; // sizeof(int) * CHAR_BITS
-        r |= rand();
-    }
+    if (max <= min)
+        return min;
 
-    // Now we have a random long between 0 and MAX_LONG.  We need to clamp it between min and max.
-    r %= max - min;
-    r += min;
+    // Combine two values for ranges wider than 32 bits.
+    unsigned long r = nextRandom();
+    if (sizeof(long) > sizeof(unsigned int))
+        r = (r << 16 << 16) | nextRandom();
 
-    return r;
+    return min + (long)(r % (unsigned long)(max - min));
 }
 
 float ParticleEmitter::generateScalar(float min, float max)
 {
-    return min + (max - min) * MATH_RANDOM_0_1();
+    return min + (max - min) * generateRandom();
 }
 
 void ParticleEmitter::generateVectorInRect(const Vector3& base, const Vector3& variance, Vector3* dst)
 {
     // Scale each component of the variance vector by a random float
     // between -1 and 1, then add this to the corresponding base component.
-    dst->x = base.x + variance.x * MATH_RANDOM_MINUS1_1();
-    dst->y = base.y + variance.y * MATH_RANDOM_MINUS1_1();
-    dst->z = base.z + variance.z * MATH_RANDOM_MINUS1_1();
+    dst->x = base.x + variance.x * (2.0f * generateRandom() - 1.0f);
+    dst->y = base.y + variance.y * (2.0f * generateRandom() - 1.0f);
+    dst->z = base.z + variance.z * (2.0f * generateRandom() - 1.0f);
 }
 
 void ParticleEmitter::generateVectorInEllipsoid(const Vector3& center, const Vector3& scale, Vector3* dst)
@@ -707,9 +766,9 @@ void ParticleEmitter::generateVectorInEllipsoid(const Vector3& center, const Vec
     // Generate a point within a unit cube, then reject if the point is not in a unit sphere.
     do
     {
-        dst->x = MATH_RANDOM_MINUS1_1();
-        dst->y = MATH_RANDOM_MINUS1_1();
-        dst->z = MATH_RANDOM_MINUS1_1();
+        dst->x = (2.0f * generateRandom() - 1.0f);
+        dst->y = (2.0f * generateRandom() - 1.0f);
+        dst->z = (2.0f * generateRandom() - 1.0f);
     } while (dst->length() > 1.0f);
     
     // Scale this point by the scaling vector.
@@ -737,10 +796,10 @@ void ParticleEmitter::generateColor(const Vector4& base, const Vector4& variance
 {
     // Scale each component of the variance color by a random float
     // between -1 and 1, then add this to the corresponding base component.
-    dst->x = base.x + variance.x * MATH_RANDOM_MINUS1_1();
-    dst->y = base.y + variance.y * MATH_RANDOM_MINUS1_1();
-    dst->z = base.z + variance.z * MATH_RANDOM_MINUS1_1();
-    dst->w = base.w + variance.w * MATH_RANDOM_MINUS1_1();
+    dst->x = base.x + variance.x * (2.0f * generateRandom() - 1.0f);
+    dst->y = base.y + variance.y * (2.0f * generateRandom() - 1.0f);
+    dst->z = base.z + variance.z * (2.0f * generateRandom() - 1.0f);
+    dst->w = base.w + variance.w * (2.0f * generateRandom() - 1.0f);
 }
 
 ParticleEmitter::TextureBlending ParticleEmitter::getTextureBlendingFromString(const char* str)
@@ -792,91 +851,100 @@ void ParticleEmitter::update(long elapsedTime)
         emit(emitCount);
     }
 
-    // Now update all currently living particles.
-    for (unsigned int particlesIndex = 0; particlesIndex < _particleCount; ++particlesIndex)
-    {
-        Particle* p = &_particles[particlesIndex];
-        p->_energy -= elapsedTime;
-
-        if (p->_energy > 0L)
-        {
-            if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
-            {
-                Matrix::createRotation(p->_rotationAxis, p->_rotationSpeed * elapsedSecs, &_rotation);
-
-                _rotation.transformPoint(p->_velocity, &p->_velocity);
-                _rotation.transformPoint(p->_acceleration, &p->_acceleration);
-            }
-
-            // Particle is still alive.
-            p->_velocity.x += p->_acceleration.x * elapsedSecs;
-            p->_velocity.y += p->_acceleration.y * elapsedSecs;
-            p->_velocity.z += p->_acceleration.z * elapsedSecs;
-
-            p->_position.x += p->_velocity.x * elapsedSecs;
-            p->_position.y += p->_velocity.y * elapsedSecs;
-            p->_position.z += p->_velocity.z * elapsedSecs;
+    // Now update all currently living particles, four at a time. The padding at the end of the
+    // arrays is updated as well, and the particles that died are removed afterwards.
+    unsigned int count = (_particleCount + 3) & ~3;
+    float** a = _particleArrays;
+    MathUtil::accumulateArray(a[AGE], (float)elapsedTime, a[ENERGY_INVERSE], a[PERCENT], count);
 
-            p->_angle += p->_rotationPerParticleSpeed * elapsedSecs;
+    rotateParticles(elapsedSecs, count);
 
-            // Simple linear interpolation of color and size.
-            float percent = 1.0f - ((float)p->_energy / (float)p->_energyStart);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        MathUtil::addScaledArray(a[ACCELERATION_X + i], elapsedSecs, a[VELOCITY_X + i], count);
+        MathUtil::addScaledArray(a[VELOCITY_X + i], elapsedSecs, a[POSITION_X + i], count);
+    }
+    MathUtil::addScaledArray(a[ROTATION_PER_PARTICLE_SPEED], elapsedSecs, a[ANGLE], count);
 
-            p->_color.x = p->_colorStart.x + (p->_colorEnd.x - p->_colorStart.x) * percent;
-            p->_color.y = p->_colorStart.y + (p->_colorEnd.y - p->_colorStart.y) * percent;
-            p->_color.z = p->_colorStart.z + (p->_colorEnd.z - p->_colorStart.z) * percent;
-            p->_color.w = p->_colorStart.w + (p->_colorEnd.w - p->_colorStart.w) * percent;
+    // Simple linear interpolation of color and size.
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        MathUtil::lerpArray(a[COLOR_START_R + i], a[COLOR_END_R + i], a[PERCENT], a[COLOR_R + i], count);
+    }
+    MathUtil::lerpArray(a[SIZE_START], a[SIZE_END], a[PERCENT], a[SIZE], count);
 
-            p->_size = p->_sizeStart + (p->_sizeEnd - p->_sizeStart) * percent;
+    // Handle sprite animations.
+    if (_spriteAnimated)
+    {
+        updateFrames(elapsedSecs, count);
+    }
 
-            // Handle sprite animations.
-            if (_spriteAnimated)
+    // Move the particle furthest from the start of the arrays into the place of each dead
+    // particle, and re-use the slot at the end of the list of living particles.
+    for (unsigned int i = 0; i < _particleCount;)
+    {
+        if (a[AGE][i] >= a[ENERGY][i])
+        {
+            --_particleCount;
+            if (i != _particleCount)
             {
-                if (!_spriteLooped)
-                {
-                    // The last frame should finish exactly when the particle dies.
-                    float percentSpent = 0.0f;
-                    for (unsigned int i = 0; i < p->_frame; i++)
-                    {
-                        percentSpent += _spritePercentPerFrame;
-                    }
-                    p->_timeOnCurrentFrame = percent - percentSpent;
-                    if (p->_frame < _spriteFrameCount - 1 &&
-                        p->_timeOnCurrentFrame >= _spritePercentPerFrame)
-                    {
-                        ++p->_frame;
-                    }
-                }
-                else
-                {
-                    // _spriteFrameDurationSecs is an absolute time measured in seconds,
-                    // and the animation repeats indefinitely.
-                    p->_timeOnCurrentFrame += elapsedSecs;
-                    if (p->_timeOnCurrentFrame >= _spriteFrameDurationSecs)
-                    {
-                        p->_timeOnCurrentFrame -= _spriteFrameDurationSecs;
-                        ++p->_frame;
-                        if (p->_frame == _spriteFrameCount)
-                        {
-                            p->_frame = 0;
-                        }
-                    }
-                }
+                copyParticle(_particleCount, i);
             }
         }
         else
         {
-            // Particle is dead.  Move the particle furthest from the start of the array
-            // down to take its place, and re-use the slot at the end of the list of living particles.
-            if (particlesIndex != _particleCount - 1)
-            {
-                _particles[particlesIndex] = _particles[_particleCount - 1];
-            }
-            --_particleCount;
+            ++i;
+        }
+    }
+}
+
+void ParticleEmitter::rotateParticles(float elapsedSecs, unsigned int count)
+{
+    // The sines and cosines of the angles are computed a block of particles at a time, so that they fit on the
+    // stack. Particles that do not rotate have a rotation speed of zero, which rotates them by the identity.
+    float s[PARTICLE_ROTATION_BLOCK_SIZE];
+    float c[PARTICLE_ROTATION_BLOCK_SIZE];
+    float** a = _particleArrays;
+    for (unsigned int i = 0; i < count; i += PARTICLE_ROTATION_BLOCK_SIZE)
+    {
+        unsigned int blockSize = std::min(count - i, (unsigned int)PARTICLE_ROTATION_BLOCK_SIZE);
+        MathUtil::sinCosArray(&a[ROTATION_SPEED][i], elapsedSecs, s, c, blockSize);
+
+        // Rotate the velocity and the acceleration.
+        for (unsigned int j = VELOCITY_X; j <= ACCELERATION_X; j += 3)
+        {
+            MathUtil::rotateArrays(&a[ROTATION_AXIS_X][i], &a[ROTATION_AXIS_Y][i], &a[ROTATION_AXIS_Z][i], s, c,
+                                   &a[j][i], &a[j + 1][i], &a[j + 2][i], blockSize);
         }
     }
 }
 
+void ParticleEmitter::updateFrames(float elapsedSecs, unsigned int count)
+{
+    if (!_spriteLooped)
+    {
+        // The last frame should finish exactly when the particle dies.
+        MathUtil::advanceFrames(_particleArrays[PERCENT], _spritePercentPerFrame, _spriteFrameCount - 1,
+                                _particleArrays[TIME_ON_CURRENT_FRAME], _particleFrames, count);
+    }
+    else
+    {
+        // _spriteFrameDurationSecs is an absolute time measured in seconds,
+        // and the animation repeats indefinitely.
+        MathUtil::loopFrames(elapsedSecs, _spriteFrameDurationSecs, _spriteFrameCount,
+                             _particleArrays[TIME_ON_CURRENT_FRAME], _particleFrames, count);
+    }
+}
+
+void ParticleEmitter::copyParticle(unsigned int src, unsigned int dst)
+{
+    for (unsigned int i = 0; i < PARTICLE_ARRAY_COUNT; ++i)
+    {
+        _particleArrays[i][dst] = _particleArrays[i][src];
+    }
+    _particleFrames[dst] = _particleFrames[src];
+}
+
 void ParticleEmitter::draw()
 {
     if (!isActive())
@@ -886,37 +954,65 @@ void ParticleEmitter::draw()
 
     if (_particleCount > 0)
     {
-        // Set our node's view projection matrix to this emitter's effect.
-        if (_node)
-        {
-            _spriteBatch->setProjectionMatrix(_node->getViewProjectionMatrix());
-        }
+        Vector3 right;
+        Vector3 up;
+        getCameraVectors(&right, &up);
+        computeSprites(right, up);
+        drawSprites();
+    }
+}
 
-        // Begin sprite batch drawing
-        _spriteBatch->begin();
+void ParticleEmitter::getCameraVectors(Vector3* right, Vector3* up) const
+{
+    // 3D Rotation so that particles always face the camera.
+    const Matrix& cameraWorldMatrix = _node->getScene()->getActiveCamera()->getNode()->getWorldMatrix();
+    cameraWorldMatrix.getRightVector(right);
+    cameraWorldMatrix.getUpVector(up);
+}
 
-        // 2D Rotation.
-        Vector2 pivot(0.5f, 0.5f);
+void ParticleEmitter::computeSprites(const Vector3& right, const Vector3& up)
+{
+    if (!_spriteVertices)
+    {
+        _spriteVertices = new float[_particleCountMax * 4 * 9];
+    }
 
-        // 3D Rotation so that particles always face the camera.
-        const Matrix& cameraWorldMatrix = _node->getScene()->getActiveCamera()->getNode()->getWorldMatrix();
-        Vector3 right;
-        cameraWorldMatrix.getRightVector(&right);
-        Vector3 up;
-        cameraWorldMatrix.getUpVector(&up);
+    // 2D Rotation.
+    Vector2 pivot(0.5f, 0.5f);
 
-        for (unsigned int i = 0; i < _particleCount; i++)
-        {
-            Particle* p = &_particles[i];
+    float** a = _particleArrays;
+    for (unsigned int i = 0; i < _particleCount; i++)
+    {
+        Vector3 position(a[POSITION_X][i], a[POSITION_Y][i], a[POSITION_Z][i]);
+        Vector4 color(a[COLOR_R][i], a[COLOR_G][i], a[COLOR_B][i], a[COLOR_A][i]);
+        const float* texCoords = &_spriteTextureCoords[_particleFrames[i] * 4];
 
-            _spriteBatch->draw(p->_position, right, up, p->_size, p->_size,
-                               _spriteTextureCoords[p->_frame * 4], _spriteTextureCoords[p->_frame * 4 + 1], _spriteTextureCoords[p->_frame * 4 + 2], _spriteTextureCoords[p->_frame * 4 + 3],
-                               p->_color, pivot, p->_angle);
-        }
+        SpriteBatch::computeSprite(position, right, up, a[SIZE][i], a[SIZE][i],
+                                   texCoords[0], texCoords[1], texCoords[2], texCoords[3],
+                                   color, pivot, a[ANGLE][i], &_spriteVertices[i * 4 * 9]);
+    }
+    _spriteCount = _particleCount;
+}
+
+void ParticleEmitter::drawSprites()
+{
+    if (_spriteCount == 0)
+    {
+        return;
+    }
 
-        // Render.
-        _spriteBatch->end();
+    // Set our node's view projection matrix to this emitter's effect.
+    if (_node)
+    {
+        _spriteBatch->setProjectionMatrix(_node->getViewProjectionMatrix());
     }
+
+    // Begin sprite batch drawing
+    _spriteBatch->begin();
+    _spriteBatch->addSprites(_spriteVertices, _spriteCount);
+
+    // Render.
+    _spriteBatch->end();
 }
 
 }
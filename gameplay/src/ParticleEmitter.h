@@ -139,6 +139,7 @@ class Node;
 class ParticleEmitter : public Ref
 {
     friend class Node;
+    friend class ParticleManager;
 
 public:
 
@@ -630,6 +631,19 @@ private:
      */
     void setNode(Node* node);
 
+    /**
+     * Advances the random number generator of this emitter and returns its next value.
+     *
+     * Each emitter has its own generator instead of using rand(), so that emitters updated
+     * on different threads by a ParticleManager share no state.
+     */
+    unsigned int nextRandom();
+
+    /**
+     * Generates a random float in the range [0, 1).
+     */
+    float generateRandom();
+
     /**
      * Generates a scalar within the range defined by min and max.
      */
@@ -662,34 +676,80 @@ private:
     void setTextureBlending(TextureBlending blending);
 
     /**
-     * Defines the data for a single particle in the system.
+     * Rotates the velocity and acceleration of the particles that have a rotation speed around their rotation axes.
+     *
+     * count is the number of particles to update, rounded up to a multiple of four.
      */
-    class Particle
-    {
+    void rotateParticles(float elapsedSecs, unsigned int count);
+
+    /**
+     * Advances the sprite animation frames of the particles.
+     *
+     * count is the number of particles to update, rounded up to a multiple of four.
+     */
+    void updateFrames(float elapsedSecs, unsigned int count);
+
+    /**
+     * Copies the particle at index src over the particle at index dst.
+     */
+    void copyParticle(unsigned int src, unsigned int dst);
+
+    /**
+     * Gets the right and up vectors of the active camera of the node's scene, which the particles face.
+     */
+    void getCameraVectors(Vector3* right, Vector3* up) const;
+
+    /**
+     * Computes the vertices of the sprites of the living particles.
+     *
+     * This method does not modify the sprite batch or read the scene, so the sprites of different
+     * emitters may be computed on different threads.
+     */
+    void computeSprites(const Vector3& right, const Vector3& up);
 
-    public:
-        Vector3 _position;
-        Vector3 _velocity;
-        Vector3 _acceleration;
-        Vector4 _colorStart;
-        Vector4 _colorEnd;
-        Vector4 _color;
-        float _rotationPerParticleSpeed;
-        Vector3 _rotationAxis;
-        float _rotationSpeed;
-        float _angle;
-        long _energyStart;
-        long _energy;
-        float _sizeStart;
-        float _sizeEnd;
-        float _size;
-        unsigned int _frame;
-        float _timeOnCurrentFrame;
+    /**
+     * Draws the sprites computed by the last call to computeSprites().
+     */
+    void drawSprites();
+
+    /**
+     * Identifies the arrays that hold the data of the particles in the system.
+     *
+     * Each component of the particles is kept in its own array, so that the particles can be
+     * updated several at a time with the array kernels of MathUtil. The components of vectors
+     * and colors are consecutive, so that the array of component i is at X (or R) + i.
+     */
+    enum ParticleArray
+    {
+        POSITION_X, POSITION_Y, POSITION_Z,
+        VELOCITY_X, VELOCITY_Y, VELOCITY_Z,
+        ACCELERATION_X, ACCELERATION_Y, ACCELERATION_Z,
+        COLOR_START_R, COLOR_START_G, COLOR_START_B, COLOR_START_A,
+        COLOR_END_R, COLOR_END_G, COLOR_END_B, COLOR_END_A,
+        COLOR_R, COLOR_G, COLOR_B, COLOR_A,
+        SIZE_START,
+        SIZE_END,
+        SIZE,
+        ROTATION_PER_PARTICLE_SPEED,
+        ANGLE,
+        ROTATION_AXIS_X, ROTATION_AXIS_Y, ROTATION_AXIS_Z,  // Normalized.
+        ROTATION_SPEED,                                     // Zero if the particle does not rotate.
+        AGE,                                                // Time since emission, in milliseconds.
+        ENERGY,                                             // Lifetime, in milliseconds.
+        ENERGY_INVERSE,
+        PERCENT,                                            // Fraction of the lifetime that has passed.
+        TIME_ON_CURRENT_FRAME,
+        PARTICLE_ARRAY_COUNT
     };
 
     unsigned int _particleCountMax;
     unsigned int _particleCount;
-    Particle* _particles;
+    unsigned int _particleCapacity;                         // The length of the particle arrays, _particleCountMax rounded up to a multiple of four.
+    float* _particleData;
+    float* _particleArrays[PARTICLE_ARRAY_COUNT];
+    unsigned int* _particleFrames;
+    float* _spriteVertices;                                 // The vertices of the sprites of the particles, four per particle.
+    unsigned int _spriteCount;
     unsigned int _emissionRate;
     bool _started;
     bool _ellipsoid;
@@ -715,7 +775,6 @@ private:
     float _rotationSpeedMax;
     Vector3 _rotationAxis;
     Vector3 _rotationAxisVar;
-    Matrix _rotation;
     SpriteBatch* _spriteBatch;
     TextureBlending _spriteTextureBlending;
     float _spriteTextureWidth;
@@ -737,6 +796,7 @@ private:
     float _timePerEmission;
     long _timeLast;
     long _timeRunning;
+    unsigned int _randomState;
 };
 
 }
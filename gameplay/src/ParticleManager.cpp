@@ -0,0 +1,154 @@
+#include "Base.h"
+#include "ParticleManager.h"
+#include "Node.h"
+#include "Scene.h"
+
+namespace gameplay
+{
+
+ParticleManager::ParticleManager()
+    : _threadPool(NULL), _elapsedTime(0)
+{
+}
+
+ParticleManager::ParticleManager(const ParticleManager& copy)
+{
+    // hidden
+}
+
+ParticleManager::~ParticleManager()
+{
+    for (unsigned int i = 0, count = _emitters.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_emitters[i]);
+    }
+    SAFE_DELETE(_threadPool);
+}
+
+ParticleManager* ParticleManager::create(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+
+    ParticleManager* manager = new ParticleManager();
+    if (threadCount > 1)
+        manager->_threadPool = ThreadPool::create(threadCount);
+
+    return manager;
+}
+
+unsigned int ParticleManager::getThreadCount() const
+{
+    return _threadPool ? _threadPool->getThreadCount() : 1;
+}
+
+void ParticleManager::addEmitter(ParticleEmitter* emitter)
+{
+    assert(emitter);
+
+    if (std::find(_emitters.begin(), _emitters.end(), emitter) != _emitters.end())
+    {
+        // The emitter is already registered with this manager.
+        return;
+    }
+
+    emitter->addRef();
+    _emitters.push_back(emitter);
+}
+
+void ParticleManager::removeEmitter(ParticleEmitter* emitter)
+{
+    std::vector<ParticleEmitter*>::iterator itr = std::find(_emitters.begin(), _emitters.end(), emitter);
+    if (itr != _emitters.end())
+    {
+        _emitters.erase(itr);
+        SAFE_RELEASE(emitter);
+    }
+}
+
+unsigned int ParticleManager::getEmitterCount() const
+{
+    return _emitters.size();
+}
+
+ParticleEmitter* ParticleManager::getEmitter(unsigned int index) const
+{
+    assert(index < _emitters.size());
+
+    return _emitters[index];
+}
+
+void ParticleManager::update(long elapsedTime)
+{
+    // Emitters read the world matrices of their nodes when emitting. Nodes compute their world
+    // matrices lazily, so do it here to keep the worker threads from writing to shared nodes.
+    for (unsigned int i = 0, count = _emitters.size(); i < count; ++i)
+    {
+        Node* node = _emitters[i]->getNode();
+        if (node)
+            node->getWorldMatrix();
+    }
+
+    _elapsedTime = elapsedTime;
+    if (_threadPool)
+    {
+        _threadPool->run(updateEmitter, this, _emitters.size());
+    }
+    else
+    {
+        for (unsigned int i = 0, count = _emitters.size(); i < count; ++i)
+        {
+            updateEmitter(this, i);
+        }
+    }
+}
+
+void ParticleManager::draw()
+{
+    // Find the emitters to draw and the cameras they face on the calling thread, since that reads the scene.
+    for (unsigned int i = 0, count = _emitters.size(); i < count; ++i)
+    {
+        ParticleEmitter* emitter = _emitters[i];
+        Node* node = emitter->getNode();
+        if (!emitter->isActive() || emitter->getParticlesCount() == 0 || !node || !node->getScene() || !node->getScene()->getActiveCamera())
+            continue;
+
+        DrawItem item;
+        item.emitter = emitter;
+        emitter->getCameraVectors(&item.right, &item.up);
+        _drawItems.push_back(item);
+    }
+
+    if (_threadPool)
+    {
+        _threadPool->run(computeSprites, this, _drawItems.size());
+    }
+    else
+    {
+        for (unsigned int i = 0, count = _drawItems.size(); i < count; ++i)
+        {
+            computeSprites(this, i);
+        }
+    }
+
+    for (unsigned int i = 0, count = _drawItems.size(); i < count; ++i)
+    {
+        _drawItems[i].emitter->drawSprites();
+    }
+    _drawItems.clear();
+}
+
+void ParticleManager::updateEmitter(void* cookie, unsigned int index)
+{
+    ParticleManager* manager = static_cast<ParticleManager*>(cookie);
+    manager->_emitters[index]->update(manager->_elapsedTime);
+}
+
+void ParticleManager::computeSprites(void* cookie, unsigned int index)
+{
+    ParticleManager* manager = static_cast<ParticleManager*>(cookie);
+    DrawItem& item = manager->_drawItems[index];
+    item.emitter->computeSprites(item.right, item.up);
+}
+
+}
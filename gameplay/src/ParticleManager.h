@@ -0,0 +1,131 @@
+#ifndef PARTICLEMANAGER_H_
+#define PARTICLEMANAGER_H_
+
+#include "ParticleEmitter.h"
+#include "ThreadPool.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a class for updating and drawing many particle emitters at once.
+ *
+ * Emitters are independent of each other, so a particle manager updates the emitters
+ * registered with it on a pool of worker threads. When drawing, the camera-facing sprites
+ * of every emitter are also computed in parallel, into vertex arrays owned by each emitter,
+ * and only the submission of those vertices to the sprite batches and the draw calls are
+ * made on the calling thread.
+ *
+ * Emitters must be attached to nodes in a scene with an active camera to be drawn. While an
+ * emitter is registered, it should only be updated and drawn through the manager.
+ */
+class ParticleManager
+{
+public:
+
+    /**
+     * Creates a new particle manager.
+     *
+     * @param threadCount The number of threads to use, including the calling thread.
+     *      A value of 1 updates serially. A value of 0 uses one thread for each processor.
+     *
+     * @return The new particle manager.
+     */
+    static ParticleManager* create(unsigned int threadCount = 0);
+
+    /**
+     * Destructor. Releases all registered emitters.
+     */
+    ~ParticleManager();
+
+    /**
+     * Gets the number of threads used to update emitters.
+     *
+     * @return The thread count, including the calling thread.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Registers an emitter with the manager. The emitter's reference count is increased.
+     * An emitter that is already registered is not added again.
+     *
+     * @param emitter The emitter to add.
+     */
+    void addEmitter(ParticleEmitter* emitter);
+
+    /**
+     * Unregisters an emitter and releases it.
+     *
+     * @param emitter The emitter to remove.
+     */
+    void removeEmitter(ParticleEmitter* emitter);
+
+    /**
+     * Gets the number of registered emitters.
+     *
+     * @return The emitter count.
+     */
+    unsigned int getEmitterCount() const;
+
+    /**
+     * Gets a registered emitter.
+     *
+     * @param index The index of the emitter.
+     *
+     * @return The emitter.
+     */
+    ParticleEmitter* getEmitter(unsigned int index) const;
+
+    /**
+     * Updates all registered emitters.
+     *
+     * @param elapsedTime The amount of time that has passed since the last call to update(), in milliseconds.
+     */
+    void update(long elapsedTime);
+
+    /**
+     * Draws all registered emitters, in the order they were added.
+     */
+    void draw();
+
+private:
+
+    /**
+     * An emitter to draw and the camera vectors its particles face.
+     */
+    struct DrawItem
+    {
+        ParticleEmitter* emitter;
+        Vector3 right;
+        Vector3 up;
+    };
+
+    /**
+     * Constructor.
+     */
+    ParticleManager();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ParticleManager(const ParticleManager& copy);
+
+    /**
+     * Updates the emitter at the given index.
+     */
+    static void updateEmitter(void* cookie, unsigned int index);
+
+    /**
+     * Computes the sprites of the draw item at the given index.
+     */
+    static void computeSprites(void* cookie, unsigned int index);
+
+    ThreadPool* _threadPool;                    // The worker threads used to update emitters, or NULL to update serially.
+    std::vector<ParticleEmitter*> _emitters;
+    std::vector<DrawItem> _drawItems;
+    long _elapsedTime;
+};
+
+}
+
+#endif
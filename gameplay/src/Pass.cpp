@@ -56,6 +56,11 @@ void Pass::setVertexAttributeBinding(VertexAttributeBinding* binding)
     }
 }
 
+VertexAttributeBinding* Pass::getVertexAttributeBinding() const
+{
+    return _vaBinding;
+}
+
 void Pass::bind()
 {
     // Bind our effect
@@ -50,6 +50,13 @@ public:
      */
     void setVertexAttributeBinding(VertexAttributeBinding* binding);
 
+    /**
+     * Gets the vertex attribute binding of this pass.
+     *
+     * @return The VertexAttributeBinding, or NULL if none is set.
+     */
+    VertexAttributeBinding* getVertexAttributeBinding() const;
+
     /**
      * Binds the render state for this pass.
      *
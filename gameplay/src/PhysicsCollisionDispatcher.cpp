@@ -0,0 +1,228 @@
+#include "Base.h"
+#include "PhysicsCollisionDispatcher.h"
+
+namespace gameplay
+{
+
+PhysicsCollisionConfiguration::ConvexConvexAlgorithm::ConvexConvexAlgorithm(btPersistentManifold* manifold, const btCollisionAlgorithmConstructionInfo& ci,
+                                                                             btCollisionObject* body0, btCollisionObject* body1, btConvexPenetrationDepthSolver* pdSolver,
+                                                                             int numPerturbationIterations, int minimumPointsPerturbationThreshold)
+    : btConvexConvexAlgorithm(manifold, ci, body0, body1, &_simplexSolver, pdSolver, numPerturbationIterations, minimumPointsPerturbationThreshold)
+{
+    // The base class only stores the address of the simplex solver, so it may be constructed after the base.
+}
+
+PhysicsCollisionConfiguration::ConvexConvexCreateFunc::ConvexConvexCreateFunc(btConvexPenetrationDepthSolver* pdSolver)
+    : btConvexConvexAlgorithm::CreateFunc(NULL, pdSolver)
+{
+}
+
+btCollisionAlgorithm* PhysicsCollisionConfiguration::ConvexConvexCreateFunc::CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci,
+                                                                                                       btCollisionObject* body0, btCollisionObject* body1)
+{
+    void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(ConvexConvexAlgorithm));
+    return new (mem) ConvexConvexAlgorithm(ci.m_manifold, ci, body0, body1, m_pdSolver, m_numPerturbationIterations, m_minimumPointsPerturbationThreshold);
+}
+
+PhysicsCollisionConfiguration::PhysicsCollisionConfiguration()
+    : btDefaultCollisionConfiguration(getConstructionInfo())
+{
+    // Replace the default convex-convex create function, whose algorithms all share m_simplexSolver.
+    m_convexConvexCreateFunc->~btCollisionAlgorithmCreateFunc();
+    btAlignedFree(m_convexConvexCreateFunc);
+    void* mem = btAlignedAlloc(sizeof(ConvexConvexCreateFunc), 16);
+    m_convexConvexCreateFunc = new (mem) ConvexConvexCreateFunc(m_pdSolver);
+}
+
+btDefaultCollisionConstructionInfo PhysicsCollisionConfiguration::getConstructionInfo()
+{
+    // The collision algorithm pool must be able to hold the larger convex-convex algorithm.
+    btDefaultCollisionConstructionInfo info;
+    info.m_customCollisionAlgorithmMaxElementSize = sizeof(ConvexConvexAlgorithm);
+    return info;
+}
+
+PhysicsCollisionDispatcher::PhysicsCollisionDispatcher(PhysicsCollisionConfiguration* configuration)
+    : btCollisionDispatcher(configuration), _threadPool(NULL), _parallel(false), _dispatchInfo(NULL)
+{
+#ifdef WIN32
+    InitializeCriticalSection(&_mutex);
+#else
+    pthread_mutex_init(&_mutex, NULL);
+#endif
+}
+
+PhysicsCollisionDispatcher::~PhysicsCollisionDispatcher()
+{
+#ifdef WIN32
+    DeleteCriticalSection(&_mutex);
+#else
+    pthread_mutex_destroy(&_mutex);
+#endif
+}
+
+void PhysicsCollisionDispatcher::setThreadPool(ThreadPool* threadPool)
+{
+    _threadPool = threadPool;
+}
+
+btPersistentManifold* PhysicsCollisionDispatcher::getNewManifold(void* body0, void* body1)
+{
+    if (!_parallel)
+        return btCollisionDispatcher::getNewManifold(body0, body1);
+
+    lock();
+    btPersistentManifold* manifold = btCollisionDispatcher::getNewManifold(body0, body1);
+    unlock();
+    return manifold;
+}
+
+void PhysicsCollisionDispatcher::releaseManifold(btPersistentManifold* manifold)
+{
+    if (!_parallel)
+    {
+        btCollisionDispatcher::releaseManifold(manifold);
+        return;
+    }
+
+    lock();
+    btCollisionDispatcher::releaseManifold(manifold);
+    unlock();
+}
+
+void* PhysicsCollisionDispatcher::allocateCollisionAlgorithm(int size)
+{
+    if (!_parallel)
+        return btCollisionDispatcher::allocateCollisionAlgorithm(size);
+
+    lock();
+    void* ptr = btCollisionDispatcher::allocateCollisionAlgorithm(size);
+    unlock();
+    return ptr;
+}
+
+void PhysicsCollisionDispatcher::freeCollisionAlgorithm(void* ptr)
+{
+    if (!_parallel)
+    {
+        btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+        return;
+    }
+
+    lock();
+    btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+    unlock();
+}
+
+void PhysicsCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher)
+{
+    // Continuous dispatch accumulates the time of impact in the shared dispatch info, so it is never run in parallel.
+    int pairCount = pairCache->getNumOverlappingPairs();
+    if (!_threadPool || _threadPool->getThreadCount() < 2 || pairCount == 0 ||
+        dispatchInfo.m_dispatchFunc != btDispatcherInfo::DISPATCH_DISCRETE)
+    {
+        btCollisionDispatcher::dispatchAllCollisionPairs(pairCache, dispatchInfo, dispatcher);
+        return;
+    }
+
+    // Sort the pairs by what the collision algorithms processing them may modify.
+    btBroadphasePair* pairs = pairCache->getOverlappingPairArrayPtr();
+    for (int i = 0; i < pairCount; ++i)
+    {
+        btBroadphasePair* pair = &pairs[i];
+        btCollisionObject* object0 = static_cast<btCollisionObject*>(pair->m_pProxy0->m_clientObject);
+        btCollisionObject* object1 = static_cast<btCollisionObject*>(pair->m_pProxy1->m_clientObject);
+        const btCollisionShape* shape0 = object0->getCollisionShape();
+        const btCollisionShape* shape1 = object1->getCollisionShape();
+
+        // Planes are excluded from meshes, since the convex-plane algorithm perturbs the convex object.
+        bool mesh0 = shape0->isConcave() && shape0->getShapeType() != STATIC_PLANE_PROXYTYPE;
+        bool mesh1 = shape1->isConcave() && shape1->getShapeType() != STATIC_PLANE_PROXYTYPE;
+        if (shape0->isConvex() && shape1->isConvex())
+        {
+            _convexPairs.push_back(pair);
+        }
+        else if ((mesh0 && shape1->isConvex()) || (mesh1 && shape0->isConvex()))
+        {
+            MeshPair meshPair;
+            meshPair.mesh = mesh0 ? object0 : object1;
+            meshPair.pair = pair;
+            _meshPairs.push_back(meshPair);
+        }
+        else
+        {
+            _serialPairs.push_back(pair);
+        }
+    }
+
+    // Group the mesh pairs by mesh object, so that each mesh is only used by one thread at a time.
+    std::sort(_meshPairs.begin(), _meshPairs.end(), compareMeshPairs);
+    for (unsigned int i = 0, count = _meshPairs.size(); i < count; ++i)
+    {
+        if (i == 0 || _meshPairs[i].mesh != _meshPairs[i - 1].mesh)
+            _meshGroups.push_back(i);
+    }
+    unsigned int groupCount = _meshGroups.size();
+    _meshGroups.push_back(_meshPairs.size());
+
+    _dispatchInfo = &dispatchInfo;
+    _parallel = true;
+    _threadPool->run(processPairs, this, _convexPairs.size() + groupCount);
+    _parallel = false;
+
+    btNearCallback nearCallback = getNearCallback();
+    for (unsigned int i = 0, count = _serialPairs.size(); i < count; ++i)
+    {
+        nearCallback(*_serialPairs[i], *this, dispatchInfo);
+    }
+
+    _convexPairs.clear();
+    _meshPairs.clear();
+    _meshGroups.clear();
+    _serialPairs.clear();
+}
+
+void PhysicsCollisionDispatcher::processPairs(void* cookie, unsigned int index)
+{
+    PhysicsCollisionDispatcher* dispatcher = static_cast<PhysicsCollisionDispatcher*>(cookie);
+    btNearCallback nearCallback = dispatcher->getNearCallback();
+    const btDispatcherInfo& dispatchInfo = *dispatcher->_dispatchInfo;
+
+    unsigned int convexCount = dispatcher->_convexPairs.size();
+    if (index < convexCount)
+    {
+        nearCallback(*dispatcher->_convexPairs[index], *dispatcher, dispatchInfo);
+        return;
+    }
+
+    unsigned int group = index - convexCount;
+    for (unsigned int i = dispatcher->_meshGroups[group], end = dispatcher->_meshGroups[group + 1]; i < end; ++i)
+    {
+        nearCallback(*dispatcher->_meshPairs[i].pair, *dispatcher, dispatchInfo);
+    }
+}
+
+bool PhysicsCollisionDispatcher::compareMeshPairs(const MeshPair& a, const MeshPair& b)
+{
+    return a.mesh < b.mesh;
+}
+
+void PhysicsCollisionDispatcher::lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&_mutex);
+#else
+    pthread_mutex_lock(&_mutex);
+#endif
+}
+
+void PhysicsCollisionDispatcher::unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&_mutex);
+#else
+    pthread_mutex_unlock(&_mutex);
+#endif
+}
+
+}
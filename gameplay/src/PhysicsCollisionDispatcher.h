@@ -0,0 +1,164 @@
+#ifndef PHYSICSCOLLISIONDISPATCHER_H_
+#define PHYSICSCOLLISIONDISPATCHER_H_
+
+#include "ThreadPool.h"
+#include "BulletCollision/CollisionDispatch/btConvexConvexAlgorithm.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+
+namespace gameplay
+{
+
+/**
+ * Collision configuration that allows collision pairs to be processed concurrently.
+ *
+ * Bullet's default configuration shares a single simplex solver between all convex-convex
+ * collision algorithms, which makes it impossible to run two of them at the same time. Here
+ * each convex-convex algorithm owns its simplex solver instead.
+ *
+ * @see btDefaultCollisionConfiguration
+ */
+class PhysicsCollisionConfiguration : public btDefaultCollisionConfiguration
+{
+    friend class PhysicsController;
+
+private:
+
+    /**
+     * A convex-convex collision algorithm with its own simplex solver.
+     */
+    class ConvexConvexAlgorithm : public btConvexConvexAlgorithm
+    {
+    public:
+
+        ConvexConvexAlgorithm(btPersistentManifold* manifold, const btCollisionAlgorithmConstructionInfo& ci, btCollisionObject* body0, btCollisionObject* body1,
+                              btConvexPenetrationDepthSolver* pdSolver, int numPerturbationIterations, int minimumPointsPerturbationThreshold);
+
+    private:
+
+        btVoronoiSimplexSolver _simplexSolver;
+    };
+
+    /**
+     * Creates ConvexConvexAlgorithm instances.
+     */
+    struct ConvexConvexCreateFunc : public btConvexConvexAlgorithm::CreateFunc
+    {
+        ConvexConvexCreateFunc(btConvexPenetrationDepthSolver* pdSolver);
+
+        virtual btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, btCollisionObject* body0, btCollisionObject* body1);
+    };
+
+    /**
+     * Constructor.
+     */
+    PhysicsCollisionConfiguration();
+
+    /**
+     * Returns the construction info of the configuration, sized for ConvexConvexAlgorithm.
+     */
+    static btDefaultCollisionConstructionInfo getConstructionInfo();
+};
+
+/**
+ * Collision dispatcher that runs the narrowphase of collision pairs on a thread pool.
+ *
+ * Pairs of convex objects are processed in parallel. Pairs of a convex object and a triangle
+ * mesh or heightfield are processed in parallel with each other as long as they involve
+ * different meshes, since Bullet temporarily replaces the shape of the mesh object while
+ * processing such a pair. Other pairs (compound shapes, planes) are processed on the calling
+ * thread afterwards. Allocations made by collision algorithms are serialized with a lock.
+ *
+ * Without a thread pool, the dispatcher behaves exactly like btCollisionDispatcher.
+ *
+ * The dispatcher must be used with a PhysicsCollisionConfiguration.
+ *
+ * @see btCollisionDispatcher
+ */
+class PhysicsCollisionDispatcher : public btCollisionDispatcher
+{
+    friend class PhysicsController;
+
+public:
+
+    /**
+     * @see btCollisionDispatcher::getNewManifold
+     */
+    virtual btPersistentManifold* getNewManifold(void* body0, void* body1);
+
+    /**
+     * @see btCollisionDispatcher::releaseManifold
+     */
+    virtual void releaseManifold(btPersistentManifold* manifold);
+
+    /**
+     * @see btCollisionDispatcher::allocateCollisionAlgorithm
+     */
+    virtual void* allocateCollisionAlgorithm(int size);
+
+    /**
+     * @see btCollisionDispatcher::freeCollisionAlgorithm
+     */
+    virtual void freeCollisionAlgorithm(void* ptr);
+
+    /**
+     * @see btCollisionDispatcher::dispatchAllCollisionPairs
+     */
+    virtual void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher);
+
+private:
+
+    /**
+     * A pair of a convex object and the mesh object it is tested against.
+     */
+    struct MeshPair
+    {
+        btCollisionObject* mesh;
+        btBroadphasePair* pair;
+    };
+
+    /**
+     * Constructor.
+     */
+    PhysicsCollisionDispatcher(PhysicsCollisionConfiguration* configuration);
+
+    /**
+     * Destructor.
+     */
+    ~PhysicsCollisionDispatcher();
+
+    /**
+     * Sets the thread pool to process collision pairs on, or NULL to process them on the calling thread.
+     */
+    void setThreadPool(ThreadPool* threadPool);
+
+    /**
+     * Processes a convex pair, or a group of mesh pairs that share the same mesh object.
+     */
+    static void processPairs(void* cookie, unsigned int index);
+
+    /**
+     * Orders mesh pairs by mesh object.
+     */
+    static bool compareMeshPairs(const MeshPair& a, const MeshPair& b);
+
+    void lock();
+
+    void unlock();
+
+    ThreadPool* _threadPool;
+    bool _parallel;                                 // True while pairs are being processed on the thread pool.
+    const btDispatcherInfo* _dispatchInfo;
+    std::vector<btBroadphasePair*> _convexPairs;
+    std::vector<MeshPair> _meshPairs;
+    std::vector<unsigned int> _meshGroups;          // The index of the first pair of each group of mesh pairs, followed by the number of mesh pairs.
+    std::vector<btBroadphasePair*> _serialPairs;
+#ifdef WIN32
+    CRITICAL_SECTION _mutex;
+#else
+    pthread_mutex_t _mutex;
+#endif
+};
+
+}
+
+#endif
@@ -172,6 +172,15 @@ public:
     /**
      * Adds a collision listener for this collision object.
      * 
+     * The listener is notified after each physics update in which this object starts or stops
+     * touching another object (or the given object). Contacts involving a dynamic object are read
+     * from the results of the simulation step, so they do not cost any extra collision tests.
+     * 
+     * Bullet does not test kinematic or static objects against each other during the step, so
+     * listeners on a kinematic or static object are also served by a collision query after each
+     * update: against the given object if it is kinematic or static too, or against the whole
+     * world if no object is given. Prefer listening on the dynamic object of a pair when possible.
+     * 
      * @param listener The listener to add.
      * @param object Optional collision object used to filter the collision event.
      */
@@ -15,16 +15,15 @@
 namespace gameplay
 {
 
-const int PhysicsController::DIRTY         = 0x01;
-const int PhysicsController::COLLISION     = 0x02;
-const int PhysicsController::REGISTERED    = 0x04;
-const int PhysicsController::REMOVE        = 0x08;
+const int PhysicsController::REGISTERED    = 0x01;
+const int PhysicsController::REMOVE        = 0x02;
 
 PhysicsController::PhysicsController()
   : _collisionConfiguration(NULL), _dispatcher(NULL),
-    _overlappingPairCache(NULL), _solver(NULL), _world(NULL), _ghostPairCallback(NULL),
+    _overlappingPairCache(NULL), _solver(NULL), _world(NULL), _threadPool(NULL), _ghostPairCallback(NULL),
     _debugDrawer(NULL), _status(PhysicsController::Listener::DEACTIVATED), _listeners(NULL),
-    _gravity(btScalar(0.0), btScalar(-9.8), btScalar(0.0))
+    _gravity(btScalar(0.0), btScalar(-9.8), btScalar(0.0)), _fixedTimeStep(1.0f / 60.0f), _maxSubSteps(10), _localTime(0.0f),
+    _contactFrame(0)
 {
     // Default gravity is 9.8 along the negative Y axis.
 }
@@ -127,6 +126,64 @@ void PhysicsController::setGravity(const Vector3& gravity)
         _world->setGravity(BV(_gravity));
 }
 
+void PhysicsController::setTimeStep(float fixedTimeStep, unsigned int maxSubSteps)
+{
+    assert(fixedTimeStep > 0.0f);
+
+    // Bullet keeps its accumulated time across a change of step mode. After variable steps it
+    // holds the duration of the last step, which has already been simulated, so restart the
+    // accumulator and its mirror whenever the mode changes.
+    if ((maxSubSteps == 0) != (_maxSubSteps == 0))
+    {
+        _localTime = 0.0f;
+        if (_world)
+            _world->resetLocalTime();
+    }
+
+    _fixedTimeStep = fixedTimeStep;
+    _maxSubSteps = maxSubSteps;
+}
+
+float PhysicsController::getFixedTimeStep() const
+{
+    return _fixedTimeStep;
+}
+
+unsigned int PhysicsController::getMaxSubSteps() const
+{
+    return _maxSubSteps;
+}
+
+float PhysicsController::getInterpolationAlpha() const
+{
+    return _maxSubSteps > 0 ? _localTime / _fixedTimeStep : 0.0f;
+}
+
+unsigned int PhysicsController::getThreadCount() const
+{
+    return _threadPool ? _threadPool->getThreadCount() : 1;
+}
+
+void PhysicsController::setThreadCount(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+
+    if (threadCount == getThreadCount())
+        return;
+
+    // Detach the old pool before deleting it.
+    if (_dispatcher)
+        _dispatcher->setThreadPool(NULL);
+
+    SAFE_DELETE(_threadPool);
+    if (threadCount > 1)
+        _threadPool = ThreadPool::create(threadCount);
+
+    if (_dispatcher)
+        _dispatcher->setThreadPool(_threadPool);
+}
+
 void PhysicsController::drawDebug(const Matrix& viewProjection)
 {
     _debugDrawer->begin(viewProjection);
@@ -243,83 +300,16 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
     return false;
 }
 
-btScalar PhysicsController::addSingleResult(btManifoldPoint& cp, const btCollisionObject* a, int partIdA, int indexA, 
-    const btCollisionObject* b, int partIdB, int indexB)
-{
-    // Get pointers to the PhysicsCollisionObject objects.
-    PhysicsCollisionObject* rbA = Game::getInstance()->getPhysicsController()->getCollisionObject(a);
-    PhysicsCollisionObject* rbB = Game::getInstance()->getPhysicsController()->getCollisionObject(b);
-
-    // If the given rigid body pair has collided in the past, then
-    // we notify the listeners only if the pair was not colliding
-    // during the previous frame. Otherwise, it's a new pair, so add a
-    // new entry to the cache with the appropriate listeners and notify them.
-    PhysicsCollisionObject::CollisionPair pair(rbA, rbB);
-
-    CollisionInfo* collisionInfo;
-    if (_collisionStatus.count(pair) > 0)
-    {
-        collisionInfo = &_collisionStatus[pair];
-    }
-    else
-    {
-        // Add a new collision pair for these objects
-        collisionInfo = &_collisionStatus[pair];
-
-        // Add the appropriate listeners.
-        PhysicsCollisionObject::CollisionPair p1(pair.objectA, NULL);
-        if (_collisionStatus.count(p1) > 0)
-        {
-            const CollisionInfo& ci = _collisionStatus[p1];
-            std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = ci._listeners.begin();
-            for (; iter != ci._listeners.end(); iter++)
-            {
-                collisionInfo->_listeners.push_back(*iter);
-            }
-        }
-        PhysicsCollisionObject::CollisionPair p2(pair.objectB, NULL);
-        if (_collisionStatus.count(p2) > 0)
-        {
-            const CollisionInfo& ci = _collisionStatus[p2];
-            std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = ci._listeners.begin();
-            for (; iter != ci._listeners.end(); iter++)
-            {
-                collisionInfo->_listeners.push_back(*iter);
-            }
-        }
-    }
-
-    // Fire collision event
-    if ((collisionInfo->_status & COLLISION) == 0)
-    {
-        std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = collisionInfo->_listeners.begin();
-        for (; iter != collisionInfo->_listeners.end(); iter++)
-        {
-            if ((collisionInfo->_status & REMOVE) == 0)
-            {
-                (*iter)->collisionEvent(PhysicsCollisionObject::CollisionListener::COLLIDING, pair, Vector3(cp.getPositionWorldOnA().x(), cp.getPositionWorldOnA().y(), cp.getPositionWorldOnA().z()),
-                    Vector3(cp.getPositionWorldOnB().x(), cp.getPositionWorldOnB().y(), cp.getPositionWorldOnB().z()));
-            }
-        }
-    }
-
-    // Update the collision status cache (we remove the dirty bit
-    // set in the controller's update so that this particular collision pair's
-    // status is not reset to 'no collision' when the controller's update completes).
-    collisionInfo->_status &= ~DIRTY;
-    collisionInfo->_status |= COLLISION;
-    return 0.0f;
-}
-
 void PhysicsController::initialize()
 {
-    _collisionConfiguration = new btDefaultCollisionConfiguration();
-    _dispatcher = new btCollisionDispatcher(_collisionConfiguration);
+    _collisionConfiguration = new PhysicsCollisionConfiguration();
+    _dispatcher = new PhysicsCollisionDispatcher(_collisionConfiguration);
+    _dispatcher->setThreadPool(_threadPool);
     _overlappingPairCache = new btDbvtBroadphase();
     _solver = new btSequentialImpulseConstraintSolver();
 
     // Create the world.
-    _world = new btDiscreteDynamicsWorld(_dispatcher, _overlappingPairCache, _solver, _collisionConfiguration);
+    _world = new DynamicsWorld(_dispatcher, _overlappingPairCache, _solver, _collisionConfiguration);
     _world->setGravity(BV(_gravity));
 
     // Register ghost pair callback so bullet detects collisions with ghost objects (used for character collisions).
@@ -342,6 +332,8 @@ void PhysicsController::finalize()
     SAFE_DELETE(_overlappingPairCache);
     SAFE_DELETE(_dispatcher);
     SAFE_DELETE(_collisionConfiguration);
+    SAFE_DELETE(_threadPool);
+    _contacts.clear();
 }
 
 void PhysicsController::pause()
@@ -356,12 +348,25 @@ void PhysicsController::resume()
 
 void PhysicsController::update(long elapsedTime)
 {
-    // Update the physics simulation, with a maximum
-    // of 10 simulation steps being performed in a given frame.
-    //
     // Note that stepSimulation takes elapsed time in seconds
     // so we divide by 1000 to convert from milliseconds.
-    _world->stepSimulation((float)elapsedTime * 0.001, 10);
+    btScalar timeStep = (float)elapsedTime * 0.001f;
+    if (_maxSubSteps > 0)
+    {
+        // Bullet keeps the accumulated time internally, so track it the same way
+        // it does to be able to report the interpolation alpha.
+        _localTime += timeStep;
+        if (_localTime >= _fixedTimeStep)
+        {
+            int steps = (int)(_localTime / _fixedTimeStep);
+            _localTime -= steps * _fixedTimeStep;
+        }
+        _world->stepSimulation(timeStep, (int)_maxSubSteps, _fixedTimeStep);
+    }
+    else
+    {
+        _world->stepSimulation(timeStep, 0);
+    }
 
     // If we have status listeners, then check if our status has changed.
     if (_listeners)
@@ -405,14 +410,7 @@ void PhysicsController::update(long elapsedTime)
         }
     }
 
-    // All statuses are set with the DIRTY bit before collision processing occurs.
-    // During collision processing, if a collision occurs, the status is 
-    // set to COLLISION and the DIRTY bit is cleared. Then, after collision processing 
-    // is finished, if a given status is still dirty, the COLLISION bit is cleared.
-    //
     // If an entry was marked for removal in the last frame, remove it now.
-
-    // Dirty the collision status cache entries.
     std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.begin();
     for (; iter != _collisionStatus.end();)
     {
@@ -424,43 +422,163 @@ void PhysicsController::update(long elapsedTime)
         }
         else
         {
-            iter->second._status |= DIRTY;
             iter++;
         }
     }
 
-    // Go through the collision status cache and perform all registered collision tests.
-    iter = _collisionStatus.begin();
+    // Without collision listeners there is nothing to track contacts for.
+    if (_collisionStatus.empty())
+        _contacts.clear();
+    else
+        updateContacts();
+}
+
+void PhysicsController::updateContacts()
+{
+    // Every pair of objects in contact that involves a dynamic object has a contact manifold with at least
+    // one point in the dispatcher, so those contacts are found without any collision queries. Pairs found in a previous update are
+    // stamped with the current frame; pairs that are not stamped are no longer in contact.
+    ++_contactFrame;
+    for (int i = 0, count = _dispatcher->getNumManifolds(); i < count; ++i)
+    {
+        const btPersistentManifold* manifold = _dispatcher->getManifoldByIndexInternal(i);
+        if (manifold->getNumContacts() == 0)
+            continue;
+
+        PhysicsCollisionObject* objectA = getCollisionObject(static_cast<const btCollisionObject*>(manifold->getBody0()));
+        PhysicsCollisionObject* objectB = getCollisionObject(static_cast<const btCollisionObject*>(manifold->getBody1()));
+        if (objectA && objectB)
+            addContact(objectA, objectB, manifold->getContactPoint(0));
+    }
+
+    testStaticContacts();
+
+    // Removing a contact moves the last one into its place, so iterate backwards.
+    for (int i = _contacts.size() - 1; i >= 0; --i)
+    {
+        Contact contact = *_contacts.getAtIndex(i);
+        if (contact.frame == _contactFrame)
+            continue;
+
+        ContactEvent event;
+        event.type = PhysicsCollisionObject::CollisionListener::NOT_COLLIDING;
+        event.objectA = contact.objectA;
+        event.objectB = contact.objectB;
+        _contactEvents.push_back(event);
+        _contacts.remove(ContactKey(contact.objectA, contact.objectB));
+    }
+
+    // Listeners are notified once the contact set is up to date, since they may add or remove objects.
+    for (unsigned int i = 0; i < _contactEvents.size(); ++i)
+    {
+        fireContactEvent(_contactEvents[i]);
+    }
+    _contactEvents.clear();
+}
+
+void PhysicsController::testStaticContacts()
+{
+    // Kinematic and static objects are not tested against each other during the step, so there are no
+    // manifolds for their contacts. Poll them for the listeners that could be interested, as was done
+    // for every listener before contacts were read from the manifolds.
+    std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.begin();
     for (; iter != _collisionStatus.end(); iter++)
     {
-        // If this collision pair was one that was registered for listening, then perform the collision test.
-        // (In the case where we register for all collisions with a rigid body, there will be a lot
-        // of collision pairs in the status cache that we did not explicitly register for.)
-        if ((iter->second._status & REGISTERED) != 0 && (iter->second._status & REMOVE) == 0)
+        if ((iter->second._status & REGISTERED) == 0 || (iter->second._status & REMOVE) != 0)
+            continue;
+
+        btCollisionObject* objectA = iter->first.objectA->getCollisionObject();
+        if (!objectA->isStaticOrKinematicObject())
+            continue;
+
+        if (iter->first.objectB)
         {
-            if (iter->first.objectB)
-                _world->contactPairTest(iter->first.objectA->getCollisionObject(), iter->first.objectB->getCollisionObject(), *this);
-            else
-                _world->contactTest(iter->first.objectA->getCollisionObject(), *this);
+            btCollisionObject* objectB = iter->first.objectB->getCollisionObject();
+            if (objectB->isStaticOrKinematicObject())
+                _world->contactPairTest(objectA, objectB, *this);
+        }
+        else
+        {
+            _world->contactTest(objectA, *this);
         }
     }
+}
 
-    // Update all the collision status cache entries.
-    iter = _collisionStatus.begin();
-    for (; iter != _collisionStatus.end(); iter++)
+btScalar PhysicsController::addSingleResult(btManifoldPoint& cp, const btCollisionObject* a, int partIdA, int indexA, 
+    const btCollisionObject* b, int partIdB, int indexB)
+{
+    // Contacts with dynamic objects are already found from the manifolds.
+    if (!a->isStaticOrKinematicObject() || !b->isStaticOrKinematicObject())
+        return 0.0f;
+
+    PhysicsCollisionObject* objectA = getCollisionObject(a);
+    PhysicsCollisionObject* objectB = getCollisionObject(b);
+    if (objectA && objectB)
+        addContact(objectA, objectB, cp);
+    return 0.0f;
+}
+
+void PhysicsController::addContact(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB, const btManifoldPoint& point)
+{
+    ContactKey key(objectA, objectB);
+    Contact* contact = _contacts.find(key);
+    if (contact)
     {
-        if ((iter->second._status & DIRTY) != 0)
+        contact->frame = _contactFrame;
+        return;
+    }
+
+    Contact newContact;
+    newContact.objectA = objectA;
+    newContact.objectB = objectB;
+    newContact.frame = _contactFrame;
+    _contacts.insert(key, newContact);
+
+    ContactEvent event;
+    event.type = PhysicsCollisionObject::CollisionListener::COLLIDING;
+    event.objectA = objectA;
+    event.objectB = objectB;
+    event.contactPointA.set(point.getPositionWorldOnA().x(), point.getPositionWorldOnA().y(), point.getPositionWorldOnA().z());
+    event.contactPointB.set(point.getPositionWorldOnB().x(), point.getPositionWorldOnB().y(), point.getPositionWorldOnB().z());
+    _contactEvents.push_back(event);
+}
+
+void PhysicsController::fireContactEvent(const ContactEvent& event)
+{
+    // Listeners registered for this pair receive the pair, and its contact points, in the order they registered it.
+    // The pair ordering does not reliably match swapped keys, so look up both orders explicitly.
+    std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.find(PhysicsCollisionObject::CollisionPair(event.objectA, event.objectB));
+    if (iter == _collisionStatus.end() || iter->first.objectA != event.objectA)
+        iter = _collisionStatus.find(PhysicsCollisionObject::CollisionPair(event.objectB, event.objectA));
+    if (iter != _collisionStatus.end() && iter->first.objectB != NULL)
+    {
+        const PhysicsCollisionObject::CollisionPair& registeredPair = iter->first;
+        bool swapped = registeredPair.objectA != event.objectA;
+        const Vector3& contactPointA = swapped ? event.contactPointB : event.contactPointA;
+        const Vector3& contactPointB = swapped ? event.contactPointA : event.contactPointB;
+        std::vector<PhysicsCollisionObject::CollisionListener*>& listeners = iter->second._listeners;
+        for (unsigned int i = 0; i < listeners.size() && event.objectA && (iter->second._status & REMOVE) == 0; ++i)
         {
-            if ((iter->second._status & COLLISION) != 0 && iter->first.objectB)
-            {
-                unsigned int size = iter->second._listeners.size();
-                for (unsigned int i = 0; i < size; i++)
-                {
-                    iter->second._listeners[i]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, iter->first);
-                }
-            }
+            listeners[i]->collisionEvent(event.type, registeredPair, contactPointA, contactPointB);
+        }
+    }
 
-            iter->second._status &= ~COLLISION;
+    // Listeners registered for all collisions of either object receive the pair with that object first.
+    for (unsigned int j = 0; j < 2 && event.objectA; ++j)
+    {
+        PhysicsCollisionObject* object = j == 0 ? event.objectA : event.objectB;
+        PhysicsCollisionObject* other = j == 0 ? event.objectB : event.objectA;
+        iter = _collisionStatus.find(PhysicsCollisionObject::CollisionPair(object, NULL));
+        if (iter == _collisionStatus.end())
+            continue;
+
+        PhysicsCollisionObject::CollisionPair objectPair(object, other);
+        const Vector3& contactPointA = j == 0 ? event.contactPointA : event.contactPointB;
+        const Vector3& contactPointB = j == 0 ? event.contactPointB : event.contactPointA;
+        std::vector<PhysicsCollisionObject::CollisionListener*>& listeners = iter->second._listeners;
+        for (unsigned int i = 0; i < listeners.size() && event.objectA && (iter->second._status & REMOVE) == 0; ++i)
+        {
+            listeners[i]->collisionEvent(event.type, objectPair, contactPointA, contactPointB);
         }
     }
 }
@@ -541,6 +659,34 @@ void PhysicsController::removeCollisionObject(PhysicsCollisionObject* object)
         if (iter->first.objectA == object || iter->first.objectB == object)
             iter->second._status |= REMOVE;
     }
+
+    // Forget the object's contacts, and cancel its pending contact events.
+    for (int i = _contacts.size() - 1; i >= 0; --i)
+    {
+        const Contact* contact = _contacts.getAtIndex(i);
+        if (contact->objectA == object || contact->objectB == object)
+            _contacts.remove(ContactKey(contact->objectA, contact->objectB));
+    }
+    for (unsigned int i = 0, count = _contactEvents.size(); i < count; ++i)
+    {
+        if (_contactEvents[i].objectA == object || _contactEvents[i].objectB == object)
+            _contactEvents[i].objectA = NULL;
+    }
+}
+
+PhysicsController::ContactKey::ContactKey(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB)
+    : objectA(objectA < objectB ? objectA : objectB), objectB(objectA < objectB ? objectB : objectA)
+{
+}
+
+unsigned int PhysicsController::ContactKey::getHash() const
+{
+    return btHashPtr(objectA).getHash() * 31 + btHashPtr(objectB).getHash();
+}
+
+bool PhysicsController::ContactKey::equals(const ContactKey& key) const
+{
+    return objectA == key.objectA && objectB == key.objectB;
 }
 
 PhysicsCollisionObject* PhysicsController::getCollisionObject(const btCollisionObject* collisionObject) const
@@ -1187,7 +1333,7 @@ PhysicsController::DebugDrawer::DebugDrawer()
         VertexFormat::Element(VertexFormat::POSITION, 3),
         VertexFormat::Element(VertexFormat::COLOR, 4),
     };
-    _meshBatch = MeshBatch::create(VertexFormat(elements, 2), Mesh::LINES, material, false);
+    _meshBatch = MeshBatch::create(VertexFormat(elements, 2), Mesh::LINES, material, false, 1024, 1024, true);
 
     SAFE_RELEASE(material);
     SAFE_RELEASE(effect);
@@ -1206,8 +1352,9 @@ void PhysicsController::DebugDrawer::begin(const Matrix& viewProjection)
 
 void PhysicsController::DebugDrawer::end()
 {
+    static const unsigned int viewProjectionMatrixId = Effect::getUniformNameId("u_viewProjectionMatrix");
     _meshBatch->end();
-    _meshBatch->getMaterial()->getParameter("u_viewProjectionMatrix")->setValue(_viewProjection);
+    _meshBatch->getMaterial()->getParameter(viewProjectionMatrixId)->setValue(_viewProjection);
     _meshBatch->draw();
 }
 
@@ -1265,4 +1412,15 @@ int PhysicsController::DebugDrawer::getDebugMode() const
     return _mode;
 }
 
+PhysicsController::DynamicsWorld::DynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache,
+                                                btConstraintSolver* solver, btCollisionConfiguration* collisionConfiguration)
+    : btDiscreteDynamicsWorld(dispatcher, pairCache, solver, collisionConfiguration)
+{
+}
+
+void PhysicsController::DynamicsWorld::resetLocalTime()
+{
+    m_localTime = btScalar(0.0);
+}
+
 }
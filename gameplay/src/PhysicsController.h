@@ -9,6 +9,8 @@
 #include "PhysicsSpringConstraint.h"
 #include "PhysicsCollisionObject.h"
 #include "MeshBatch.h"
+#include "PhysicsCollisionDispatcher.h"
+#include "LinearMath/btHashMap.h"
 
 namespace gameplay
 {
@@ -220,6 +222,75 @@ public:
      */
     void setGravity(const Vector3& gravity);
 
+    /**
+     * Sets how the simulation advances with the frame time.
+     *
+     * By default, the simulation runs in fixed steps of 1/60th of a second. The time of each frame
+     * is accumulated and as many whole steps are simulated as fit in the accumulated time, up to
+     * the given maximum; time beyond that is discarded, which bounds the cost of a slow frame.
+     * Nodes of active rigid bodies are then moved to their transforms extrapolated for the time
+     * left over in the accumulator (see getInterpolationAlpha()), so that motion looks smooth
+     * whatever the frame rate.
+     *
+     * A maximum of zero steps disables the fixed step: each frame is simulated as a single step
+     * of the frame's duration. Switching between fixed and variable steps discards the time left
+     * over in the accumulator.
+     *
+     * @param fixedTimeStep The duration of a simulation step, in seconds.
+     * @param maxSubSteps The maximum number of steps simulated per frame, or zero for variable steps.
+     */
+    void setTimeStep(float fixedTimeStep, unsigned int maxSubSteps);
+
+    /**
+     * Gets the duration of a simulation step.
+     *
+     * @return The duration of a fixed simulation step, in seconds.
+     */
+    float getFixedTimeStep() const;
+
+    /**
+     * Gets the maximum number of simulation steps per frame.
+     *
+     * @return The maximum number of steps, or zero if each frame is simulated as a single variable step.
+     */
+    unsigned int getMaxSubSteps() const;
+
+    /**
+     * Gets how far the transforms of the rigid body nodes are ahead of the last simulated step.
+     *
+     * This is the time left over in the accumulator after the last update, as a fraction of the
+     * fixed time step. Bullet does not interpolate between the last two steps: it extrapolates
+     * each active body from its last simulated transform, along its velocities, by this much of
+     * a step. Other state that is updated per step can be extrapolated by the same alpha to stay
+     * consistent with the nodes.
+     *
+     * @return The interpolation alpha, from 0 up to (but excluding) 1, or always 0 with variable steps.
+     */
+    float getInterpolationAlpha() const;
+
+    /**
+     * Gets the number of threads used to simulate physics.
+     *
+     * @return The thread count, including the main thread.
+     * @see setThreadCount(unsigned int)
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Sets the number of threads used to simulate physics.
+     *
+     * By default the simulation runs on the main thread. With more than one thread, the
+     * narrowphase collision tests of each step are spread across a pool of worker threads.
+     * Continuous collision detection is always run on the main thread. Constraints are
+     * always solved on the main thread, since Bullet's constraint solver records its timings
+     * with a global profiler that is not thread-safe. Listeners and collision callbacks are
+     * still called on the main thread.
+     *
+     * @param threadCount The number of threads to use, including the main thread. A value of 1
+     *      simulates serially. A value of 0 uses one thread for each processor.
+     */
+    void setThreadCount(unsigned int threadCount);
+
     /**
      * Draws debugging information (rigid body outlines, etc.) using the given view projection matrix.
      * 
@@ -260,8 +331,6 @@ protected:
 private:
 
     // Internal constants for the collision status cache.
-    static const int DIRTY;
-    static const int COLLISION;
     static const int REGISTERED;
     static const int REMOVE;
 
@@ -274,6 +343,37 @@ private:
         int _status;
     };
 
+    // Identifies a pair of collision objects in contact, regardless of their order (used as the key of the contact set).
+    struct ContactKey
+    {
+        ContactKey(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB);
+
+        unsigned int getHash() const;
+
+        bool equals(const ContactKey& key) const;
+
+        PhysicsCollisionObject* objectA;
+        PhysicsCollisionObject* objectB;
+    };
+
+    // Represents a pair of collision objects in contact and the last update they were found in contact in.
+    struct Contact
+    {
+        PhysicsCollisionObject* objectA;
+        PhysicsCollisionObject* objectB;
+        unsigned int frame;
+    };
+
+    // Represents a pair of collision objects that started or stopped being in contact during an update.
+    struct ContactEvent
+    {
+        PhysicsCollisionObject::CollisionListener::EventType type;
+        PhysicsCollisionObject* objectA;                    // NULL if the event was cancelled by the removal of one of the objects.
+        PhysicsCollisionObject* objectB;
+        Vector3 contactPointA;
+        Vector3 contactPointB;
+    };
+
     /**
      * Constructor.
      */
@@ -315,6 +415,20 @@ private:
     // Removes the given collision listener.
     void removeCollisionListener(PhysicsCollisionObject::CollisionListener* listener, PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB);
 
+    // Finds the pairs of objects that started or stopped being in contact in the last update from the
+    // dispatcher's contact manifolds, and notifies their collision listeners.
+    void updateContacts();
+
+    // Runs collision queries for the listeners on kinematic and static objects, whose contacts with
+    // each other have no contact manifolds (see addSingleResult()).
+    void testStaticContacts();
+
+    // Marks two objects as in contact in the current update, queueing a COLLIDING event if they were not before.
+    void addContact(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB, const btManifoldPoint& point);
+
+    // Notifies the collision listeners registered for the objects of a contact event.
+    void fireContactEvent(const ContactEvent& event);
+
     // Adds the given collision object to the world.
     void addCollisionObject(PhysicsCollisionObject* object);
     
@@ -433,18 +547,41 @@ private:
         MeshBatch* _meshBatch;
     };
 
-    btDefaultCollisionConfiguration* _collisionConfiguration;
-    btCollisionDispatcher* _dispatcher;
+    // Bullet dynamics world whose step accumulator can be restarted.
+    class DynamicsWorld : public btDiscreteDynamicsWorld
+    {
+    public:
+
+        /**
+         * Constructor.
+         */
+        DynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache, btConstraintSolver* solver, btCollisionConfiguration* collisionConfiguration);
+
+        /**
+         * Discards the time accumulated towards the next fixed step.
+         */
+        void resetLocalTime();
+    };
+
+    PhysicsCollisionConfiguration* _collisionConfiguration;
+    PhysicsCollisionDispatcher* _dispatcher;
     btBroadphaseInterface* _overlappingPairCache;
     btSequentialImpulseConstraintSolver* _solver;
-    btDynamicsWorld* _world;
+    DynamicsWorld* _world;
+    ThreadPool* _threadPool;                        // The worker threads used to simulate physics, or NULL to simulate serially.
     btGhostPairCallback* _ghostPairCallback;
     std::vector<PhysicsCollisionShape*> _shapes;
     DebugDrawer* _debugDrawer;
     Listener::EventType _status;
     std::vector<Listener*>* _listeners;
     Vector3 _gravity;
+    float _fixedTimeStep;
+    unsigned int _maxSubSteps;
+    float _localTime;
     std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo> _collisionStatus;
+    btHashMap<ContactKey, Contact> _contacts;              // The pairs of objects in contact, found from the contact manifolds.
+    std::vector<ContactEvent> _contactEvents;
+    unsigned int _contactFrame;
 
 };
 
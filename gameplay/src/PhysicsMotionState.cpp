@@ -31,6 +31,8 @@ void PhysicsMotionState::getWorldTransform(btTransform &transform) const
 
 void PhysicsMotionState::setWorldTransform(const btTransform &transform)
 {
+    // With fixed time steps, Bullet passes the transform interpolated for the time left
+    // over after the last step rather than the simulated one.
     _worldTransform = transform * _centerOfMassOffset;
         
     const btQuaternion& rot = _worldTransform.getRotation();
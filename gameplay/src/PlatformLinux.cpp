@@ -0,0 +1,298 @@
+#if defined(__linux__) && !defined(__ANDROID__)
+
+#include "Base.h"
+#include "Platform.h"
+#include "FileSystem.h"
+#include "Game.h"
+#include "Form.h"
+#include <unistd.h>
+#include <time.h>
+#include <EGL/egl.h>
+
+// Default to 720p
+#define WINDOW_WIDTH    1280
+#define WINDOW_HEIGHT   720
+
+// Number of frames the message pump will run before exiting (zero runs until the game exits).
+unsigned int __frameLimit = 0;
+// Fixed amount of virtual time (in milliseconds) the clock advances after each frame.
+long __frameTime = 16L;
+
+static long __timeAbsolute;
+static bool __vsync = WINDOW_VSYNC;
+static EGLDisplay __eglDisplay = EGL_NO_DISPLAY;
+static EGLContext __eglContext = EGL_NO_CONTEXT;
+static EGLSurface __eglSurface = EGL_NO_SURFACE;
+static EGLConfig __eglConfig = 0;
+
+namespace gameplay
+{
+
+extern void printError(const char* format, ...)
+{
+    va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    fprintf(stderr, "\n");
+    va_end(argptr);
+}
+
+/**
+ * Convert the timespec into milliseconds.
+ */
+static double timespec2millis(struct timespec* a)
+{
+    return a->tv_sec * 1000.0 + a->tv_nsec / 1000000.0;
+}
+
+Platform::Platform(Game* game)
+    : _game(game)
+{
+}
+
+Platform::Platform(const Platform& copy)
+{
+    // hidden
+}
+
+Platform::~Platform()
+{
+    if (__eglDisplay != EGL_NO_DISPLAY)
+    {
+        eglMakeCurrent(__eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    if (__eglSurface != EGL_NO_SURFACE)
+    {
+        eglDestroySurface(__eglDisplay, __eglSurface);
+        __eglSurface = EGL_NO_SURFACE;
+    }
+
+    if (__eglContext != EGL_NO_CONTEXT)
+    {
+        eglDestroyContext(__eglDisplay, __eglContext);
+        __eglContext = EGL_NO_CONTEXT;
+    }
+
+    if (__eglDisplay != EGL_NO_DISPLAY)
+    {
+        eglTerminate(__eglDisplay);
+        __eglDisplay = EGL_NO_DISPLAY;
+    }
+}
+
+Platform* Platform::create(Game* game)
+{
+    FileSystem::setResourcePath("./");
+
+    // There is no audio hardware on a headless machine, so let OpenAL Soft fall back to
+    // its null output device unless the environment already selected a driver.
+    setenv("ALSOFT_DRIVERS", "null", 0);
+
+    Platform* platform = new Platform(game);
+
+    // Create an offscreen (pbuffer) desktop GL context. No display server is required.
+    const EGLint configAttribs[] =
+    {
+        EGL_SURFACE_TYPE,       EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE,    EGL_OPENGL_BIT,
+        EGL_RED_SIZE,           8,
+        EGL_GREEN_SIZE,         8,
+        EGL_BLUE_SIZE,          8,
+        EGL_ALPHA_SIZE,         8,
+        EGL_DEPTH_SIZE,         24,
+        EGL_STENCIL_SIZE,       8,
+        EGL_NONE
+    };
+    const EGLint surfaceAttribs[] =
+    {
+        EGL_WIDTH,  WINDOW_WIDTH,
+        EGL_HEIGHT, WINDOW_HEIGHT,
+        EGL_NONE
+    };
+    EGLint configCount;
+
+    __eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (__eglDisplay == EGL_NO_DISPLAY || eglInitialize(__eglDisplay, NULL, NULL) != EGL_TRUE)
+    {
+        printError("eglInitialize failed: 0x%x", eglGetError());
+        goto error;
+    }
+
+    if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
+    {
+        printError("eglBindAPI failed: 0x%x", eglGetError());
+        goto error;
+    }
+
+    if (eglChooseConfig(__eglDisplay, configAttribs, &__eglConfig, 1, &configCount) != EGL_TRUE || configCount == 0)
+    {
+        printError("eglChooseConfig failed: 0x%x", eglGetError());
+        goto error;
+    }
+
+    __eglSurface = eglCreatePbufferSurface(__eglDisplay, __eglConfig, surfaceAttribs);
+    if (__eglSurface == EGL_NO_SURFACE)
+    {
+        printError("eglCreatePbufferSurface failed: 0x%x", eglGetError());
+        goto error;
+    }
+
+    __eglContext = eglCreateContext(__eglDisplay, __eglConfig, EGL_NO_CONTEXT, NULL);
+    if (__eglContext == EGL_NO_CONTEXT)
+    {
+        printError("eglCreateContext failed: 0x%x", eglGetError());
+        goto error;
+    }
+
+    if (eglMakeCurrent(__eglDisplay, __eglSurface, __eglSurface, __eglContext) != EGL_TRUE)
+    {
+        printError("eglMakeCurrent failed: 0x%x", eglGetError());
+        goto error;
+    }
+
+    // A pbuffer is never presented, so never wait on vertical sync.
+    __vsync = false;
+    eglSwapInterval(__eglDisplay, 0);
+
+    return platform;
+
+error:
+
+    delete platform;
+    return NULL;
+}
+
+int Platform::enterMessagePump()
+{
+    // The clock is virtual: it starts at zero and advances by a fixed amount after every frame,
+    // so every run of the same game produces the same sequence of elapsed times.
+    __timeAbsolute = 0L;
+
+    if (_game->getState() != Game::RUNNING)
+        _game->run(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    struct timespec wallStart;
+    struct timespec wallEnd;
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+
+    // Run frames back to back as fast as possible.
+    unsigned int frameCount = 0;
+    while (true)
+    {
+        // If we are done, then exit.
+        if (_game->getState() == Game::UNINITIALIZED)
+            break;
+
+        if (__frameLimit > 0 && frameCount >= __frameLimit)
+        {
+            _game->exit();
+            break;
+        }
+
+        _game->frame();
+        ++frameCount;
+
+        __timeAbsolute += __frameTime;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+    double wallTime = timespec2millis(&wallEnd) - timespec2millis(&wallStart);
+    fprintf(stdout, "frames: %u, virtual time: %ld ms, wall time: %.3f ms, %.4f ms/frame, %.1f frames/s\n",
+        frameCount, __timeAbsolute, wallTime,
+        frameCount > 0 ? wallTime / frameCount : 0.0,
+        wallTime > 0.0 ? frameCount * 1000.0 / wallTime : 0.0);
+
+    return 0;
+}
+
+void Platform::signalShutdown()
+{
+    // nothing to do
+}
+
+unsigned int Platform::getDisplayWidth()
+{
+    return WINDOW_WIDTH;
+}
+
+unsigned int Platform::getDisplayHeight()
+{
+    return WINDOW_HEIGHT;
+}
+
+long Platform::getAbsoluteTime()
+{
+    return __timeAbsolute;
+}
+
+void Platform::setAbsoluteTime(long time)
+{
+    __timeAbsolute = time;
+}
+
+bool Platform::isVsync()
+{
+    return __vsync;
+}
+
+void Platform::setVsync(bool enable)
+{
+    // Offscreen surfaces are never presented; vsync would only throttle the frame loop.
+}
+
+int Platform::getOrientationAngle()
+{
+    return 0;
+}
+
+void Platform::setMultiTouch(bool enabled)
+{
+}
+
+bool Platform::isMultiTouch()
+{
+    return false;
+}
+
+void Platform::getAccelerometerValues(float* pitch, float* roll)
+{
+    if (pitch)
+        *pitch = 0.0f;
+    if (roll)
+        *roll = 0.0f;
+}
+
+void Platform::swapBuffers()
+{
+    if (__eglDisplay && __eglSurface)
+        eglSwapBuffers(__eglDisplay, __eglSurface);
+}
+
+void Platform::displayKeyboard(bool display)
+{
+    // Do nothing.
+}
+
+void Platform::touchEventInternal(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (!Form::touchEventInternal(evt, x, y, contactIndex))
+    {
+        Game::getInstance()->touchEvent(evt, x, y, contactIndex);
+    }
+}
+
+void Platform::keyEventInternal(Keyboard::KeyEvent evt, int key)
+{
+    gameplay::Game::getInstance()->keyEvent(evt, key);
+    Form::keyEventInternal(evt, key);
+}
+
+void Platform::sleep(long ms)
+{
+    usleep(ms * 1000);
+}
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Base.h"
 #include "Quaternion.h"
+#include "MathUtil.h"
 
 namespace gameplay
 {
@@ -266,6 +267,24 @@ void Quaternion::slerp(const Quaternion& q1, const Quaternion& q2, float t, Quat
     slerp(q1.x, q1.y, q1.z, q1.w, q2.x, q2.y, q2.z, q2.w, t, &dst->x, &dst->y, &dst->z, &dst->w);
 }
 
+void Quaternion::slerp(const Quaternion* q1, const Quaternion* q2, const float* t, Quaternion* dst, unsigned int count)
+{
+    assert(q1);
+    assert(q2);
+    assert(t);
+    assert(dst);
+
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        MathUtil::slerpQuaternion4((const float*)&q1[i], (const float*)&q2[i], &t[i], (float*)&dst[i]);
+    }
+    for (; i < count; ++i)
+    {
+        slerp(q1[i].x, q1[i].y, q1[i].z, q1[i].w, q2[i].x, q2[i].y, q2[i].z, q2[i].w, t[i], &dst[i].x, &dst[i].y, &dst[i].z, &dst[i].w);
+    }
+}
+
 void Quaternion::squad(const Quaternion& q1, const Quaternion& q2, const Quaternion& s1, const Quaternion& s2, float t, Quaternion* dst)
 {
     assert(dst);
@@ -41,6 +41,7 @@ class Matrix;
 class Quaternion
 {
     friend class Curve;
+    friend class MathUtil;
 
 public:
 
@@ -312,6 +313,21 @@ public:
      * @param dst A quaternion to store the result in.
      */
     static void slerp(const Quaternion& q1, const Quaternion& q2, float t, Quaternion* dst);
+
+    /**
+     * Interpolates between arrays of quaternions using spherical linear interpolation,
+     * so that dst[i] = slerp(q1[i], q2[i], t[i]).
+     *
+     * Quaternions are processed four at a time using the SIMD kernels when available.
+     * The same restrictions on the inputs apply as for the single quaternion version.
+     *
+     * @param q1 The array of first quaternions.
+     * @param q2 The array of second quaternions.
+     * @param t The array of interpolation coefficients.
+     * @param dst An array to store the results in (may be the same as q1 or q2).
+     * @param count The number of elements in each array.
+     */
+    static void slerp(const Quaternion* q1, const Quaternion* q2, const float* t, Quaternion* dst, unsigned int count);
     
     /**
      * Interpolates over a series of quaternions using spherical spline interpolation.
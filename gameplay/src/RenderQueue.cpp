@@ -0,0 +1,241 @@
+#include "Base.h"
+#include "RenderQueue.h"
+#include "Model.h"
+#include "Node.h"
+#include "Scene.h"
+#include "Camera.h"
+
+// Sort key layout. The layer (opaque or transparent) comes first, so that transparent items
+// are drawn last. Opaque keys continue with the pass index, so that multi-pass techniques draw
+// their passes in order. Transparent keys continue with the depth and then the pass index, so
+// that all passes of a far item blend before those of a nearer one.
+#define RENDERQUEUE_LAYER_SHIFT         63
+#define RENDERQUEUE_PASS_SHIFT          61
+#define RENDERQUEUE_PASS_BITS           2
+#define RENDERQUEUE_PASS_MAX            3
+#define RENDERQUEUE_EFFECT_BITS         16
+#define RENDERQUEUE_STATE_BITS          13
+#define RENDERQUEUE_TEXTURE_BITS        16
+#define RENDERQUEUE_DEPTH_BITS          16
+
+namespace gameplay
+{
+
+/**
+ * Hashes a pointer for use in a sort key.
+ *
+ * Sort keys only keep the low bits of the hash, so distinct pointers may share a
+ * value. This only affects how well items are grouped, not how they are drawn.
+ */
+static unsigned int hashPointer(const void* pointer)
+{
+    size_t value = (size_t)pointer;
+    value ^= value >> 16;
+    value *= 0x45d9f3b;
+    value ^= value >> 16;
+    return (unsigned int)value;
+}
+
+unsigned int RenderQueue::getStateId(Pass* pass)
+{
+    unsigned int id = 0;
+    for (RenderState* rs = pass; rs; rs = rs->_parent)
+    {
+        id = id * 31 + (rs->_state ? hashPointer(rs->_state) : 0);
+    }
+    return id;
+}
+
+const Texture* RenderQueue::getTexture(Pass* pass)
+{
+    for (RenderState* rs = pass; rs; rs = rs->_parent)
+    {
+        for (unsigned int i = 0, count = rs->_parameters.size(); i < count; ++i)
+        {
+            MaterialParameter* parameter = rs->_parameters[i];
+            if (parameter->_type == MaterialParameter::SAMPLER && parameter->_value.samplerValue)
+            {
+                return parameter->_value.samplerValue->getTexture();
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Converts a non-negative distance into an integer that sorts in the same order.
+ */
+static unsigned int quantizeDepth(float distance)
+{
+    // The bit patterns of non-negative floats sort like the values themselves, so the
+    // sign, exponent and leading mantissa bits give a coarse but monotonic depth.
+    union
+    {
+        float f;
+        unsigned int i;
+    } bits;
+    bits.f = distance > 0.0f ? distance : 0.0f;
+    return bits.i >> (32 - RENDERQUEUE_DEPTH_BITS);
+}
+
+RenderQueue::RenderQueue() : _bindCount(0), _savedBindCount(0)
+{
+}
+
+RenderQueue::RenderQueue(const RenderQueue& copy)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+RenderQueue* RenderQueue::create(unsigned int initialCapacity)
+{
+    RenderQueue* queue = new RenderQueue();
+    queue->_items.reserve(initialCapacity);
+    return queue;
+}
+
+void RenderQueue::add(Model* model)
+{
+    assert(model);
+
+    Node* node = model->getNode();
+    assert(node);
+
+    // Measure the distance from the active camera to the center of the model's bounds.
+    unsigned int depth = 0;
+    Scene* scene = node->getScene();
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (camera && camera->getNode())
+    {
+        Vector3 cameraPosition = camera->getNode()->getTranslationWorld();
+        depth = quantizeDepth(cameraPosition.distanceSquared(node->getBoundingSphere().center));
+    }
+
+    bool transparent = node->isTransparent();
+    Mesh* mesh = model->getMesh();
+    unsigned int partCount = mesh->getPartCount();
+    if (partCount == 0)
+    {
+        add(model, NULL, model->_material, transparent, depth);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < partCount; ++i)
+        {
+            add(model, mesh->getPart(i), model->getMaterial(i), transparent, depth);
+        }
+    }
+}
+
+void RenderQueue::add(Model* model, MeshPart* part, Material* material, bool transparent, unsigned int depth)
+{
+    if (material == NULL)
+        return;
+
+    Technique* technique = material->getTechnique();
+    for (unsigned int i = 0, count = technique->getPassCount(); i < count; ++i)
+    {
+        Item item;
+        item.model = model;
+        item.part = part;
+        item.pass = technique->getPass(i);
+        item.state = getStateId(item.pass);
+        item.texture = getTexture(item.pass);
+
+        unsigned long long effectKey = hashPointer(item.pass->getEffect()) & ((1 << RENDERQUEUE_EFFECT_BITS) - 1);
+        unsigned long long stateKey = item.state & ((1 << RENDERQUEUE_STATE_BITS) - 1);
+        unsigned long long textureKey = hashPointer(item.texture) & ((1 << RENDERQUEUE_TEXTURE_BITS) - 1);
+        unsigned long long passKey = i < RENDERQUEUE_PASS_MAX ? i : RENDERQUEUE_PASS_MAX;
+
+        if (transparent)
+        {
+            // Transparent items are drawn back to front, each with its passes in order, and only
+            // grouped by state at equal depths.
+            unsigned long long depthKey = ((1 << RENDERQUEUE_DEPTH_BITS) - 1) - depth;
+            item.key = 1ULL << RENDERQUEUE_LAYER_SHIFT;
+            item.key |= depthKey << (RENDERQUEUE_PASS_BITS + RENDERQUEUE_EFFECT_BITS + RENDERQUEUE_STATE_BITS + RENDERQUEUE_TEXTURE_BITS);
+            item.key |= passKey << (RENDERQUEUE_EFFECT_BITS + RENDERQUEUE_STATE_BITS + RENDERQUEUE_TEXTURE_BITS);
+            item.key |= effectKey << (RENDERQUEUE_STATE_BITS + RENDERQUEUE_TEXTURE_BITS);
+            item.key |= stateKey << RENDERQUEUE_TEXTURE_BITS;
+            item.key |= textureKey;
+        }
+        else
+        {
+            // Opaque items are grouped by effect, state and texture, then drawn front to back.
+            item.key = passKey << RENDERQUEUE_PASS_SHIFT;
+            item.key |= effectKey << (RENDERQUEUE_STATE_BITS + RENDERQUEUE_TEXTURE_BITS + RENDERQUEUE_DEPTH_BITS);
+            item.key |= stateKey << (RENDERQUEUE_TEXTURE_BITS + RENDERQUEUE_DEPTH_BITS);
+            item.key |= textureKey << RENDERQUEUE_DEPTH_BITS;
+            item.key |= depth;
+        }
+
+        _items.push_back(item);
+    }
+}
+
+void RenderQueue::draw(bool wireframe)
+{
+    unsigned int unsortedBindCount = countBinds();
+
+    // Sort by key, keeping items with equal keys in the order they were added.
+    std::stable_sort(_items.begin(), _items.end(), compareItems);
+
+    _bindCount = countBinds();
+    _savedBindCount = unsortedBindCount > _bindCount ? unsortedBindCount - _bindCount : 0;
+
+    for (unsigned int i = 0, count = _items.size(); i < count; ++i)
+    {
+        const Item& item = _items[i];
+        item.model->drawPass(item.pass, item.part, wireframe);
+    }
+}
+
+void RenderQueue::clear()
+{
+    _items.clear();
+}
+
+unsigned int RenderQueue::getItemCount() const
+{
+    return _items.size();
+}
+
+unsigned int RenderQueue::getBindCount() const
+{
+    return _bindCount;
+}
+
+unsigned int RenderQueue::getSavedBindCount() const
+{
+    return _savedBindCount;
+}
+
+unsigned int RenderQueue::countBinds() const
+{
+    // This only models the binds: it counts the changes between consecutive items, not the
+    // GL calls actually made by Model::drawPass().
+    unsigned int binds = 0;
+    const Item* previous = NULL;
+    for (unsigned int i = 0, count = _items.size(); i < count; ++i)
+    {
+        const Item* item = &_items[i];
+        if (!previous || previous->pass->getEffect() != item->pass->getEffect())
+            ++binds;
+        if (!previous || previous->state != item->state)
+            ++binds;
+        if (!previous || previous->texture != item->texture)
+            ++binds;
+        previous = item;
+    }
+    return binds;
+}
+
+bool RenderQueue::compareItems(const Item& a, const Item& b)
+{
+    return a.key < b.key;
+}
+
+}
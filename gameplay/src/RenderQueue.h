@@ -0,0 +1,156 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+namespace gameplay
+{
+
+class Model;
+class MeshPart;
+class Material;
+class Pass;
+class Texture;
+
+/**
+ * Defines a queue of draw calls that are sorted by render state before being submitted.
+ *
+ * Models added to the queue are split into one item per mesh part and pass. When the
+ * queue is drawn, the items are sorted by a 64-bit key and then submitted in order.
+ * Opaque items are grouped by effect, render state block and texture, and drawn front
+ * to back. Transparent items (see Node::isTransparent()) are drawn after all opaque
+ * items, back to front, with all the passes of an item drawn before moving to the next
+ * nearer item.
+ *
+ * A render queue is typically filled once per frame while visiting the scene, drawn,
+ * and then cleared.
+ */
+class RenderQueue
+{
+public:
+
+    /**
+     * Creates a new render queue.
+     *
+     * @param initialCapacity The initial number of draw items to reserve space for.
+     *
+     * @return The new render queue.
+     */
+    static RenderQueue* create(unsigned int initialCapacity = 0);
+
+    /**
+     * Destructor.
+     */
+    ~RenderQueue();
+
+    /**
+     * Adds the mesh parts and passes of the given model to the queue.
+     *
+     * The model must be attached to a node. The distance used for depth sorting is
+     * measured from the active camera of the node's scene.
+     *
+     * @param model The model to add.
+     */
+    void add(Model* model);
+
+    /**
+     * Sorts and draws all items in the queue.
+     *
+     * The queue is not cleared, so it can be drawn again (for example, into
+     * another render target) before calling clear().
+     *
+     * @param wireframe If true, draw the models in wireframe mode.
+     */
+    void draw(bool wireframe = false);
+
+    /**
+     * Removes all items from the queue.
+     */
+    void clear();
+
+    /**
+     * Gets the number of draw items in the queue.
+     *
+     * @return The number of draw items.
+     */
+    unsigned int getItemCount() const;
+
+    /**
+     * Gets the number of effect, state block and texture changes made by the last call to draw().
+     *
+     * The count is computed by comparing consecutive items in the sorted queue, not by
+     * counting the GL calls made while drawing. It does not see binds that passes make
+     * regardless of the previous item, such as re-applying unchanged material parameters.
+     *
+     * @return The number of bind changes.
+     */
+    unsigned int getBindCount() const;
+
+    /**
+     * Gets the number of effect, state block and texture changes that the last call to draw()
+     * avoided by sorting, compared to drawing the items in the order they were added.
+     *
+     * Like getBindCount(), this is computed from the order of the items rather than measured.
+     *
+     * @return The number of bind changes saved.
+     */
+    unsigned int getSavedBindCount() const;
+
+private:
+
+    /**
+     * A single draw call.
+     */
+    struct Item
+    {
+        unsigned long long key;
+        Model* model;
+        MeshPart* part;
+        Pass* pass;
+        unsigned int state;
+        const Texture* texture;
+    };
+
+    /**
+     * Constructor.
+     */
+    RenderQueue();
+
+    /**
+     * Hidden copy constructor.
+     */
+    RenderQueue(const RenderQueue& copy);
+
+    /**
+     * Adds an item for each pass of the given material.
+     */
+    void add(Model* model, MeshPart* part, Material* material, bool transparent, unsigned int depth);
+
+    /**
+     * Combines the state blocks of a pass and its parents into a single identifier.
+     */
+    static unsigned int getStateId(Pass* pass);
+
+    /**
+     * Returns the texture of the first sampler parameter of a pass or its parents, or NULL.
+     */
+    static const Texture* getTexture(Pass* pass);
+
+    /**
+     * Counts the effect, state block and texture changes needed to draw the items in their current order.
+     *
+     * This simulates the binds from the items alone; no GL calls are inspected.
+     */
+    unsigned int countBinds() const;
+
+    /**
+     * Compares the keys of two items.
+     */
+    static bool compareItems(const Item& a, const Item& b);
+
+    std::vector<Item> _items;
+    unsigned int _bindCount;
+    unsigned int _savedBindCount;
+};
+
+}
+
+#endif
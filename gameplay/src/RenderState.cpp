@@ -54,20 +54,36 @@ MaterialParameter* RenderState::getParameter(const char* name) const
 {
     assert(name);
 
+    // A name that has never been seen cannot belong to an existing parameter.
+    unsigned int nameId;
+    if (Effect::findUniformNameId(name, &nameId))
+    {
+        return getParameter(nameId);
+    }
+
+    // Create a new parameter and store it in our list
+    MaterialParameter* param = new MaterialParameter(name);
+    _parameters.push_back(param);
+
+    return param;
+}
+
+MaterialParameter* RenderState::getParameter(unsigned int nameId) const
+{
     MaterialParameter* param;
 
     // Search for an existing parameter with this name
     for (unsigned int i = 0, count = _parameters.size(); i < count; ++i)
     {
         param = _parameters[i];
-        if (strcmp(param->getName(), name) == 0)
+        if (param->_nameId == nameId)
         {
             return param;
         }
     }
 
     // Create a new parameter and store it in our list
-    param = new MaterialParameter(name);
+    param = new MaterialParameter(Effect::getUniformName(nameId), nameId);
     _parameters.push_back(param);
 
     return param;
@@ -75,26 +91,45 @@ MaterialParameter* RenderState::getParameter(const char* name) const
 
 void RenderState::setParameterAutoBinding(const char* name, AutoBinding autoBinding)
 {
+    // Find the existing auto binding for this parameter. A name that has never been seen has none.
+    unsigned int nameId;
+    std::vector<AutoBindingEntry>::iterator itr = _autoBindings.end();
+    if (Effect::findUniformNameId(name, &nameId))
+    {
+        for (itr = _autoBindings.begin(); itr != _autoBindings.end(); ++itr)
+        {
+            if (itr->parameter->_nameId == nameId)
+                break;
+        }
+    }
+
     // Store the auto-binding
     if (autoBinding == NONE)
     {
         // Clear current auto binding
-        std::map<std::string, AutoBinding>::iterator itr = _autoBindings.find(name);
         if (itr != _autoBindings.end())
         {
             _autoBindings.erase(itr);
         }
     }
+    else if (itr != _autoBindings.end())
+    {
+        itr->binding = autoBinding;
+    }
     else
     {
-        // Set new auto binding
-        _autoBindings[name] = autoBinding;
+        // Set new auto binding, resolving its parameter once up front
+        AutoBindingEntry entry;
+        entry.parameter = getParameter(name);
+        entry.binding = autoBinding;
+        _autoBindings.push_back(entry);
+        itr = _autoBindings.end() - 1;
     }
 
     // If we have a currently set node binding, apply the auto binding immediately
-    if (_nodeBinding)
+    if (_nodeBinding && autoBinding != NONE)
     {
-        applyAutoBinding(name, autoBinding);
+        applyAutoBinding(itr->parameter, autoBinding);
     }
 }
 
@@ -186,57 +221,55 @@ void RenderState::setNodeBinding(Node* node)
     if (_nodeBinding)
     {
         // Apply all existing auto-bindings using this node
-        std::map<std::string, AutoBinding>::const_iterator itr = _autoBindings.begin();
-        while (itr != _autoBindings.end())
+        for (unsigned int i = 0, count = _autoBindings.size(); i < count; ++i)
         {
-            applyAutoBinding(itr->first.c_str(), itr->second);
-            itr++;
+            applyAutoBinding(_autoBindings[i].parameter, _autoBindings[i].binding);
         }
     }
 }
 
-void RenderState::applyAutoBinding(const char* uniformName, AutoBinding autoBinding)
+void RenderState::applyAutoBinding(MaterialParameter* parameter, AutoBinding autoBinding)
 {
     switch (autoBinding)
     {
     case WORLD_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getWorldMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getWorldMatrix);
         break;
 
     case VIEW_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getViewMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getViewMatrix);
         break;
 
     case PROJECTION_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getProjectionMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getProjectionMatrix);
         break;
 
     case WORLD_VIEW_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getWorldViewMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getWorldViewMatrix);
         break;
 
     case VIEW_PROJECTION_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getViewProjectionMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getViewProjectionMatrix);
         break;
 
     case WORLD_VIEW_PROJECTION_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getWorldViewProjectionMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getWorldViewProjectionMatrix);
         break;
 
     case INVERSE_TRANSPOSE_WORLD_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getInverseTransposeWorldMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getInverseTransposeWorldMatrix);
         break;
 
     case INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getInverseTransposeWorldViewMatrix);
+        parameter->bindValue(_nodeBinding, &Node::getInverseTransposeWorldViewMatrix);
         break;
 
     case CAMERA_WORLD_POSITION:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getActiveCameraTranslationWorld);
+        parameter->bindValue(_nodeBinding, &Node::getActiveCameraTranslationWorld);
         break;
 
     case CAMERA_VIEW_POSITION:
-        getParameter(uniformName)->bindValue(_nodeBinding, &Node::getActiveCameraTranslationView);
+        parameter->bindValue(_nodeBinding, &Node::getActiveCameraTranslationView);
         break;
 
     case MATRIX_PALETTE:
@@ -245,7 +278,7 @@ void RenderState::applyAutoBinding(const char* uniformName, AutoBinding autoBind
             MeshSkin* skin = model ? model->getSkin() : NULL;
             if (skin)
             {
-                getParameter(uniformName)->bindValue(skin, &MeshSkin::getMatrixPalette, &MeshSkin::getMatrixPaletteSize);
+                parameter->bindValue(skin, &MeshSkin::getMatrixPalette, &MeshSkin::getMatrixPaletteSize);
             }
         }
         break;
@@ -274,9 +307,13 @@ void RenderState::bind(Pass* pass)
     Effect* effect = pass->getEffect();
     while (rs = getTopmost(rs))
     {
+        const std::vector<Uniform*>& uniforms = rs->getUniformTable(effect);
         for (unsigned int i = 0, count = rs->_parameters.size(); i < count; ++i)
         {
-            rs->_parameters[i]->bind(effect);
+            if (uniforms[i])
+            {
+                rs->_parameters[i]->bind(effect, uniforms[i]);
+            }
         }
 
         if (rs->_state)
@@ -286,6 +323,41 @@ void RenderState::bind(Pass* pass)
     }
 }
 
+const std::vector<Uniform*>& RenderState::getUniformTable(Effect* effect)
+{
+    // Find the table for this effect. Render states are used with very few effects, so search linearly.
+    UniformTable* table = NULL;
+    for (unsigned int i = 0, count = _uniformTables.size(); i < count; ++i)
+    {
+        if (_uniformTables[i].effect == effect)
+        {
+            table = &_uniformTables[i];
+            break;
+        }
+    }
+    if (table == NULL)
+    {
+        _uniformTables.push_back(UniformTable());
+        table = &_uniformTables.back();
+        table->effect = effect;
+    }
+
+    // Resolve the uniforms of any parameters added since the table was last used.
+    for (unsigned int i = table->uniforms.size(), count = _parameters.size(); i < count; ++i)
+    {
+        MaterialParameter* parameter = _parameters[i];
+        Uniform* uniform = effect->getUniformByNameId(parameter->_nameId);
+        if (!uniform)
+        {
+            // This parameter was not found in the specified effect, so it is never bound to it.
+            WARN_VARG("Warning: Material parameter '%s' not found in effect '%s'.", parameter->getName(), effect->getId());
+        }
+        table->uniforms.push_back(uniform);
+    }
+
+    return table->uniforms;
+}
+
 RenderState* RenderState::getTopmost(RenderState* below)
 {
     RenderState* rs = this;
@@ -310,10 +382,6 @@ RenderState* RenderState::getTopmost(RenderState* below)
 
 void RenderState::cloneInto(RenderState* renderState, NodeCloneContext& context) const
 {
-    for (std::map<std::string, AutoBinding>::const_iterator it = _autoBindings.begin(); it != _autoBindings.end(); ++it)
-    {
-        renderState->setParameterAutoBinding(it->first.c_str(), it->second);
-    }
     for (std::vector<MaterialParameter*>::const_iterator it = _parameters.begin(); it != _parameters.end(); ++it)
     {
         const MaterialParameter* param = *it;
@@ -323,6 +391,12 @@ void RenderState::cloneInto(RenderState* renderState, NodeCloneContext& context)
 
         renderState->_parameters.push_back(paramCopy);
     }
+
+    // Auto-bindings refer to the copied parameters, so set them after the parameters are copied.
+    for (std::vector<AutoBindingEntry>::const_iterator it = _autoBindings.begin(); it != _autoBindings.end(); ++it)
+    {
+        renderState->setParameterAutoBinding(it->parameter->getName(), it->binding);
+    }
     renderState->_parent = _parent;
     if (Node* node = context.findClonedNode(_nodeBinding))
     {
@@ -7,6 +7,8 @@ namespace gameplay
 {
 
 class MaterialParameter;
+class Effect;
+class Uniform;
 class Node;
 class NodeCloneContext;
 class Pass;
@@ -21,6 +23,8 @@ class RenderState : public Ref
     friend class Technique;
     friend class Pass;
     friend class Model;
+    friend class RenderQueue;
+    friend class StaticBatcher;
 
 public:
 
@@ -115,6 +119,7 @@ public:
     {
         friend class RenderState;
         friend class Game;
+        friend class StaticBatcher;
 
     public:
 
@@ -237,6 +242,19 @@ public:
      */
     MaterialParameter* getParameter(const char* name) const;
 
+    /**
+     * Returns a MaterialParameter for the specified name identifier.
+     *
+     * This avoids looking up the name of a parameter that is accessed often, such as
+     * every frame: the identifier can be looked up once with Effect::getUniformNameId()
+     * and cached by the caller.
+     *
+     * @param nameId The identifier of the material parameter (uniform) name.
+     *
+     * @return A MaterialParameter for the specified name identifier.
+     */
+    MaterialParameter* getParameter(unsigned int nameId) const;
+
     /**
      * Sets a material parameter auto-binding.
      *
@@ -322,7 +340,15 @@ protected:
     /**
      * Applies the specified auto-binding.
      */
-    void applyAutoBinding(const char* uniformName, AutoBinding binding);
+    void applyAutoBinding(MaterialParameter* parameter, AutoBinding binding);
+
+    /**
+     * Returns the uniforms of the given effect that this render state's parameters are bound to.
+     *
+     * The table is built the first time a parameter is bound to the effect, and is indexed
+     * like the parameters. Parameters that are not used by the effect map to NULL.
+     */
+    const std::vector<Uniform*>& getUniformTable(Effect* effect);
 
     /**
      * Binds the render state for this RenderState and any of its parents, top-down, 
@@ -357,15 +383,38 @@ private:
 
 protected:
 
+    /**
+     * A parameter with an auto-binding.
+     */
+    struct AutoBindingEntry
+    {
+        MaterialParameter* parameter;
+        AutoBinding binding;
+    };
+
+    /**
+     * The uniforms of an effect that the parameters are bound to.
+     */
+    struct UniformTable
+    {
+        Effect* effect;
+        std::vector<Uniform*> uniforms;
+    };
+
     /**
      * Collection of MaterialParameter's to be applied to the gamplay::Effect.
      */
     mutable std::vector<MaterialParameter*> _parameters;
     
     /**
-     * Map of IDs to AutoBindings.
+     * The parameters with auto-bindings.
+     */
+    std::vector<AutoBindingEntry> _autoBindings;
+
+    /**
+     * The uniform tables for the effects that the parameters have been bound to.
      */
-    std::map<std::string, AutoBinding> _autoBindings;
+    std::vector<UniformTable> _uniformTables;
 
     /**
      * The Node bound to the RenderState.
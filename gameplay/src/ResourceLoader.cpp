@@ -0,0 +1,491 @@
+#include "Base.h"
+#include "ResourceLoader.h"
+#include "ThreadPool.h"
+#include "Game.h"
+#include "Image.h"
+#include "Texture.h"
+#include "AudioSource.h"
+#include "Bundle.h"
+
+// The maximum number of worker threads. Loading is mostly bound by file I/O,
+// so a couple of threads are enough to overlap reading with decoding.
+#define RESOURCELOADER_MAX_THREADS 2
+
+// The default time spent completing requests each frame, in milliseconds.
+#define RESOURCELOADER_DEFAULT_FRAME_BUDGET 4
+
+// The stride used to touch the pages of a mapped bundle.
+#define RESOURCELOADER_PAGE_SIZE 4096
+
+namespace gameplay
+{
+
+ResourceLoader::Request::Request(Type type, const char* path, bool generateMipmaps, Listener* listener)
+    : _type(type), _state(PENDING), _path(path), _generateMipmaps(generateMipmaps), _cancelled(false), _error(false),
+      _listener(listener), _image(NULL),
+#ifndef __ANDROID__
+      _pcm(NULL),
+#endif
+      _texture(NULL), _audioSource(NULL), _bundle(NULL)
+{
+}
+
+ResourceLoader::Request::Request(const Request& copy)
+{
+}
+
+ResourceLoader::Request::~Request()
+{
+    SAFE_RELEASE(_image);
+#ifndef __ANDROID__
+    SAFE_DELETE(_pcm);
+#endif
+    SAFE_RELEASE(_texture);
+    SAFE_RELEASE(_audioSource);
+    SAFE_RELEASE(_bundle);
+}
+
+ResourceLoader::Request::Type ResourceLoader::Request::getType() const
+{
+    return _type;
+}
+
+ResourceLoader::Request::State ResourceLoader::Request::getState() const
+{
+    return _state;
+}
+
+const char* ResourceLoader::Request::getPath() const
+{
+    return _path.c_str();
+}
+
+Texture* ResourceLoader::Request::getTexture() const
+{
+    return _texture;
+}
+
+AudioSource* ResourceLoader::Request::getAudioSource() const
+{
+    return _audioSource;
+}
+
+Bundle* ResourceLoader::Request::getBundle() const
+{
+    return _bundle;
+}
+
+void ResourceLoader::Request::load()
+{
+    const char* path = _path.c_str();
+
+    switch (_type)
+    {
+    case TEXTURE:
+        {
+            // Decode PNG images here. Other formats are loaded synchronously when the request completes.
+            const char* ext = strrchr(path, '.');
+            if (ext && strlen(ext) == 4 && tolower(ext[1]) == 'p' && tolower(ext[2]) == 'n' && tolower(ext[3]) == 'g')
+            {
+                _image = Image::create(path);
+                _error = (_image == NULL);
+            }
+        }
+        break;
+
+    case AUDIO_SOURCE:
+#ifndef __ANDROID__
+        // Decode sample data here. Audio properties files are loaded synchronously when the request completes.
+        if (_path.find(".audio") == _path.npos)
+        {
+            _pcm = new AudioBuffer::PCMData();
+            if (!AudioBuffer::decode(path, _pcm))
+            {
+                SAFE_DELETE(_pcm);
+                _error = true;
+            }
+        }
+#endif
+        break;
+
+    case BUNDLE:
+        _bundle = Bundle::create(path);
+        if (_bundle)
+        {
+            // Touch every page of the mapped file so that reading objects from the bundle does not wait on disk access.
+            if (_bundle->_data)
+            {
+                volatile unsigned char sum = 0;
+                for (unsigned int i = 0; i < _bundle->_dataSize; i += RESOURCELOADER_PAGE_SIZE)
+                {
+                    sum += _bundle->_data[i];
+                }
+            }
+
+            // Decode meshes, animations and fonts here, leaving only GL object creation to the main thread.
+            _bundle->preload();
+        }
+        else
+        {
+            _error = true;
+        }
+        break;
+    }
+}
+
+void ResourceLoader::Request::complete()
+{
+    if (_cancelled)
+    {
+        _state = CANCELLED;
+        return;
+    }
+
+    if (!_error)
+    {
+        const char* path = _path.c_str();
+
+        switch (_type)
+        {
+        case TEXTURE:
+            if (_image)
+            {
+                // The texture may have been loaded synchronously while the image was decoded.
+                _texture = Texture::find(path, _generateMipmaps);
+                if (!_texture)
+                {
+                    _texture = Texture::create(_image, _generateMipmaps);
+                    if (_texture)
+                        _texture->cache(path);
+                }
+                SAFE_RELEASE(_image);
+            }
+            else
+            {
+                _texture = Texture::create(path, _generateMipmaps);
+            }
+            break;
+
+        case AUDIO_SOURCE:
+#ifndef __ANDROID__
+            if (_pcm)
+            {
+                AudioBuffer* buffer = AudioBuffer::create(path, _pcm);
+                SAFE_DELETE(_pcm);
+                if (buffer)
+                    _audioSource = AudioSource::create(buffer);
+            }
+            else
+#endif
+            {
+                _audioSource = AudioSource::create(path);
+            }
+            break;
+
+        case BUNDLE:
+            break;
+        }
+    }
+
+    _state = (_texture || _audioSource || _bundle) ? COMPLETE : FAILED;
+}
+
+ResourceLoader::ResourceLoader()
+    : _pending(0), _frameBudget(RESOURCELOADER_DEFAULT_FRAME_BUDGET), _exit(false)
+{
+#ifdef WIN32
+    InitializeCriticalSection(&_mutex);
+    InitializeConditionVariable(&_workCondition);
+    InitializeConditionVariable(&_doneCondition);
+#else
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_workCondition, NULL);
+    pthread_cond_init(&_doneCondition, NULL);
+#endif
+}
+
+ResourceLoader::ResourceLoader(const ResourceLoader& copy)
+{
+}
+
+ResourceLoader::~ResourceLoader()
+{
+#ifdef WIN32
+    DeleteCriticalSection(&_mutex);
+#else
+    pthread_cond_destroy(&_doneCondition);
+    pthread_cond_destroy(&_workCondition);
+    pthread_mutex_destroy(&_mutex);
+#endif
+}
+
+void ResourceLoader::initialize()
+{
+    _exit = false;
+
+    // Leave a processor for the main thread where possible.
+    unsigned int threadCount = ThreadPool::getProcessorCount();
+    threadCount = threadCount > 1 ? threadCount - 1 : 1;
+    if (threadCount > RESOURCELOADER_MAX_THREADS)
+        threadCount = RESOURCELOADER_MAX_THREADS;
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+#ifdef WIN32
+        HANDLE thread = CreateThread(NULL, 0, workerMain, this, 0, NULL);
+        if (thread == NULL)
+        {
+            WARN_VARG("Failed to create resource loader thread (error %u).", (unsigned int)GetLastError());
+            break;
+        }
+#else
+        pthread_t thread;
+        int result = pthread_create(&thread, NULL, workerMain, this);
+        if (result != 0)
+        {
+            WARN_VARG("Failed to create resource loader thread (error %d).", result);
+            break;
+        }
+#endif
+        _threads.push_back(thread);
+    }
+}
+
+void ResourceLoader::finalize()
+{
+    lock();
+    _exit = true;
+#ifdef WIN32
+    WakeAllConditionVariable(&_workCondition);
+#else
+    pthread_cond_broadcast(&_workCondition);
+#endif
+    unlock();
+
+    for (unsigned int i = 0; i < _threads.size(); ++i)
+    {
+#ifdef WIN32
+        WaitForSingleObject(_threads[i], INFINITE);
+        CloseHandle(_threads[i]);
+#else
+        pthread_join(_threads[i], NULL);
+#endif
+    }
+    _threads.clear();
+
+    // Cancel and release the requests that did not finish.
+    _completeQueue.splice(_completeQueue.end(), _loadQueue);
+    while (!_completeQueue.empty())
+    {
+        Request* request = _completeQueue.front();
+        _completeQueue.pop_front();
+        request->_cancelled = true;
+        complete(request);
+    }
+}
+
+void ResourceLoader::update()
+{
+    if (_pending == 0)
+        return;
+
+    long startTime = Game::getAbsoluteTime();
+    while (true)
+    {
+        lock();
+        if (_completeQueue.empty())
+        {
+            unlock();
+            break;
+        }
+        Request* request = _completeQueue.front();
+        _completeQueue.pop_front();
+        unlock();
+
+        complete(request);
+
+        if (_frameBudget > 0 && Game::getAbsoluteTime() - startTime >= (long)_frameBudget)
+            break;
+    }
+}
+
+void ResourceLoader::finish()
+{
+    while (_pending > 0)
+    {
+        lock();
+        while (_completeQueue.empty())
+        {
+            // Without worker threads, load the requests on the calling thread.
+            if (_threads.empty() && !_loadQueue.empty())
+            {
+                Request* request = _loadQueue.front();
+                _loadQueue.pop_front();
+                if (!request->_cancelled)
+                    request->load();
+                _completeQueue.push_back(request);
+                break;
+            }
+#ifdef WIN32
+            SleepConditionVariableCS(&_doneCondition, &_mutex, INFINITE);
+#else
+            pthread_cond_wait(&_doneCondition, &_mutex);
+#endif
+        }
+        Request* request = _completeQueue.front();
+        _completeQueue.pop_front();
+        unlock();
+
+        complete(request);
+    }
+}
+
+ResourceLoader::Request* ResourceLoader::loadTexture(const char* path, bool generateMipmaps, Listener* listener)
+{
+    assert(path);
+
+    return queue(new Request(Request::TEXTURE, path, generateMipmaps, listener));
+}
+
+ResourceLoader::Request* ResourceLoader::loadAudioSource(const char* path, Listener* listener)
+{
+    assert(path);
+
+    return queue(new Request(Request::AUDIO_SOURCE, path, false, listener));
+}
+
+ResourceLoader::Request* ResourceLoader::loadBundle(const char* path, Listener* listener)
+{
+    assert(path);
+
+    return queue(new Request(Request::BUNDLE, path, false, listener));
+}
+
+void ResourceLoader::cancel(Request* request)
+{
+    assert(request);
+
+    lock();
+    request->_cancelled = true;
+    unlock();
+}
+
+unsigned int ResourceLoader::getPendingCount() const
+{
+    return _pending;
+}
+
+void ResourceLoader::setFrameBudget(unsigned int milliseconds)
+{
+    _frameBudget = milliseconds;
+}
+
+unsigned int ResourceLoader::getFrameBudget() const
+{
+    return _frameBudget;
+}
+
+ResourceLoader::Request* ResourceLoader::queue(Request* request)
+{
+    // The loader holds a reference until the request completes.
+    request->addRef();
+    ++_pending;
+
+    lock();
+    if (_threads.empty())
+    {
+        // Without worker threads, load the request now and complete it on the next update.
+        unlock();
+        request->load();
+        lock();
+        _completeQueue.push_back(request);
+    }
+    else
+    {
+        _loadQueue.push_back(request);
+#ifdef WIN32
+        WakeConditionVariable(&_workCondition);
+#else
+        pthread_cond_signal(&_workCondition);
+#endif
+    }
+    unlock();
+
+    return request;
+}
+
+void ResourceLoader::complete(Request* request)
+{
+    request->complete();
+    --_pending;
+
+    if (request->_state != Request::CANCELLED && request->_listener)
+    {
+        request->_listener->resourceLoaded(request);
+    }
+    request->release();
+}
+
+void ResourceLoader::lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&_mutex);
+#else
+    pthread_mutex_lock(&_mutex);
+#endif
+}
+
+void ResourceLoader::unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&_mutex);
+#else
+    pthread_mutex_unlock(&_mutex);
+#endif
+}
+
+#ifdef WIN32
+DWORD WINAPI ResourceLoader::workerMain(LPVOID arg)
+#else
+void* ResourceLoader::workerMain(void* arg)
+#endif
+{
+    ResourceLoader* loader = static_cast<ResourceLoader*>(arg);
+
+    loader->lock();
+    while (true)
+    {
+        // Wait for a new request, or for the loader to be finalized.
+        while (!loader->_exit && loader->_loadQueue.empty())
+        {
+#ifdef WIN32
+            SleepConditionVariableCS(&loader->_workCondition, &loader->_mutex, INFINITE);
+#else
+            pthread_cond_wait(&loader->_workCondition, &loader->_mutex);
+#endif
+        }
+        if (loader->_exit)
+            break;
+
+        Request* request = loader->_loadQueue.front();
+        loader->_loadQueue.pop_front();
+        bool cancelled = request->_cancelled;
+        loader->unlock();
+
+        if (!cancelled)
+            request->load();
+
+        loader->lock();
+        loader->_completeQueue.push_back(request);
+#ifdef WIN32
+        WakeConditionVariable(&loader->_doneCondition);
+#else
+        pthread_cond_signal(&loader->_doneCondition);
+#endif
+    }
+    loader->unlock();
+
+    return 0;
+}
+
+}
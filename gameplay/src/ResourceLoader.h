@@ -0,0 +1,341 @@
+#ifndef RESOURCELOADER_H_
+#define RESOURCELOADER_H_
+
+#include "Ref.h"
+#include "AudioBuffer.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace gameplay
+{
+
+class Image;
+class Texture;
+class AudioSource;
+class Bundle;
+
+/**
+ * Defines a class for loading resources in the background.
+ *
+ * File I/O and decoding (PNG images, WAV and Ogg audio, bundle contents) run on
+ * background worker threads. The graphics and audio objects are then created on
+ * the main thread, at the start of each frame, where the resource loader completes
+ * as many requests as fit within its frame budget.
+ *
+ * Each load method returns a request that can be polled for its state, and
+ * optionally notifies a listener on the main thread once the request is done.
+ * Models, scenes and fonts are created on the main thread from a bundle that
+ * was loaded in the background, using the mesh, animation and font data that
+ * was already decoded on the worker thread.
+ */
+class ResourceLoader
+{
+    friend class Game;
+
+public:
+
+    class Listener;
+
+    /**
+     * Defines a background load request and its result.
+     */
+    class Request : public Ref
+    {
+        friend class ResourceLoader;
+
+    public:
+
+        /**
+         * The types of resources that can be loaded.
+         */
+        enum Type
+        {
+            TEXTURE,
+            AUDIO_SOURCE,
+            BUNDLE
+        };
+
+        /**
+         * The states of a request.
+         */
+        enum State
+        {
+            PENDING,
+            COMPLETE,
+            FAILED,
+            CANCELLED
+        };
+
+        /**
+         * Gets the type of resource being loaded.
+         *
+         * @return The resource type.
+         */
+        Type getType() const;
+
+        /**
+         * Gets the current state of the request.
+         *
+         * @return The request state.
+         */
+        State getState() const;
+
+        /**
+         * Gets the path of the resource being loaded.
+         *
+         * @return The resource path.
+         */
+        const char* getPath() const;
+
+        /**
+         * Gets the loaded texture.
+         *
+         * The request holds a reference to the texture, so callers that keep
+         * the texture beyond the lifetime of the request must add a reference.
+         *
+         * @return The texture, or NULL if the request is not a completed texture request.
+         */
+        Texture* getTexture() const;
+
+        /**
+         * Gets the loaded audio source.
+         *
+         * The request holds a reference to the audio source, so callers that keep
+         * the audio source beyond the lifetime of the request must add a reference.
+         *
+         * @return The audio source, or NULL if the request is not a completed audio source request.
+         */
+        AudioSource* getAudioSource() const;
+
+        /**
+         * Gets the loaded bundle.
+         *
+         * The request holds a reference to the bundle, so callers that keep
+         * the bundle beyond the lifetime of the request must add a reference.
+         *
+         * @return The bundle, or NULL if the request is not a completed bundle request.
+         */
+        Bundle* getBundle() const;
+
+    private:
+
+        /**
+         * Constructor.
+         */
+        Request(Type type, const char* path, bool generateMipmaps, Listener* listener);
+
+        /**
+         * Hidden copy constructor.
+         */
+        Request(const Request& copy);
+
+        /**
+         * Destructor.
+         */
+        ~Request();
+
+        /**
+         * Loads and decodes the resource data. Called on a worker thread.
+         */
+        void load();
+
+        /**
+         * Creates the resource from the decoded data. Called on the main thread.
+         */
+        void complete();
+
+        Type _type;
+        State _state;
+        std::string _path;
+        bool _generateMipmaps;
+        bool _cancelled;
+        bool _error;
+        Listener* _listener;
+        Image* _image;
+#ifndef __ANDROID__
+        AudioBuffer::PCMData* _pcm;
+#endif
+        Texture* _texture;
+        AudioSource* _audioSource;
+        Bundle* _bundle;
+    };
+
+    /**
+     * Defines an interface for receiving notification of completed requests.
+     */
+    class Listener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~Listener() { }
+
+        /**
+         * Handles when a request has completed or failed. Called on the main thread.
+         *
+         * @param request The request that finished.
+         */
+        virtual void resourceLoaded(Request* request) = 0;
+    };
+
+    /**
+     * Loads a texture in the background.
+     *
+     * @param path The path to the texture.
+     * @param generateMipmaps true to auto-generate a full mipmap chain, false otherwise.
+     * @param listener The listener to notify when the request finishes, or NULL.
+     *
+     * @return The new request. The caller must release it when it is no longer needed.
+     */
+    Request* loadTexture(const char* path, bool generateMipmaps = false, Listener* listener = NULL);
+
+    /**
+     * Loads an audio source in the background.
+     *
+     * @param path The path to the audio file or .audio properties file.
+     * @param listener The listener to notify when the request finishes, or NULL.
+     *
+     * @return The new request. The caller must release it when it is no longer needed.
+     */
+    Request* loadAudioSource(const char* path, Listener* listener = NULL);
+
+    /**
+     * Loads a bundle in the background.
+     *
+     * The bundle header and reference table are parsed, the file contents are
+     * paged in, and the vertex, index, animation key and font data are decoded on
+     * a worker thread. Loading scenes, meshes and fonts from the bundle on the main
+     * thread then only creates the GPU buffers, textures and engine objects.
+     *
+     * @param path The path to the bundle.
+     * @param listener The listener to notify when the request finishes, or NULL.
+     *
+     * @return The new request. The caller must release it when it is no longer needed.
+     */
+    Request* loadBundle(const char* path, Listener* listener = NULL);
+
+    /**
+     * Cancels a request that has not finished yet.
+     *
+     * The listener of a cancelled request is not notified and no resource is created for it.
+     *
+     * @param request The request to cancel.
+     */
+    void cancel(Request* request);
+
+    /**
+     * Blocks until all outstanding requests have finished and their listeners have been notified.
+     */
+    void finish();
+
+    /**
+     * Gets the number of requests that have not finished yet.
+     *
+     * @return The number of pending requests.
+     */
+    unsigned int getPendingCount() const;
+
+    /**
+     * Sets the time spent each frame completing requests on the main thread.
+     *
+     * At least one finished request is completed each frame, regardless of the budget.
+     *
+     * @param milliseconds The frame budget in milliseconds, or 0 to complete all finished requests every frame.
+     */
+    void setFrameBudget(unsigned int milliseconds);
+
+    /**
+     * Gets the time spent each frame completing requests on the main thread.
+     *
+     * @return The frame budget in milliseconds.
+     */
+    unsigned int getFrameBudget() const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    ResourceLoader();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ResourceLoader(const ResourceLoader& copy);
+
+    /**
+     * Destructor.
+     */
+    ~ResourceLoader();
+
+    /**
+     * Starts the worker threads. Called by Game.
+     */
+    void initialize();
+
+    /**
+     * Cancels all outstanding requests and stops the worker threads. Called by Game.
+     */
+    void finalize();
+
+    /**
+     * Completes finished requests on the main thread, within the frame budget. Called once per frame by Game.
+     */
+    void update();
+
+    /**
+     * Queues a new request for the worker threads.
+     */
+    Request* queue(Request* request);
+
+    /**
+     * Completes the given request and notifies its listener.
+     */
+    void complete(Request* request);
+
+    /**
+     * Acquires the loader's lock.
+     */
+    void lock();
+
+    /**
+     * Releases the loader's lock.
+     */
+    void unlock();
+
+    /**
+     * Entry point of the worker threads.
+     */
+#ifdef WIN32
+    static DWORD WINAPI workerMain(LPVOID arg);
+#else
+    static void* workerMain(void* arg);
+#endif
+
+#ifdef WIN32
+    std::vector<HANDLE> _threads;
+    CRITICAL_SECTION _mutex;
+    CONDITION_VARIABLE _workCondition;
+    CONDITION_VARIABLE _doneCondition;
+#else
+    std::vector<pthread_t> _threads;
+    pthread_mutex_t _mutex;
+    pthread_cond_t _workCondition;
+    pthread_cond_t _doneCondition;
+#endif
+    std::list<Request*> _loadQueue;         // Requests waiting to be loaded by a worker thread.
+    std::list<Request*> _completeQueue;     // Requests loaded by a worker thread, waiting to be completed.
+    unsigned int _pending;                  // The number of requests that have not been completed.
+    unsigned int _frameBudget;              // The time spent completing requests each frame, in milliseconds.
+    bool _exit;                             // Set when the worker threads should exit.
+};
+
+}
+
+#endif
@@ -4,11 +4,14 @@
 #include "SceneLoader.h"
 #include "MeshSkin.h"
 #include "Joint.h"
+#include "BoundingVolumeTree.h"
 
 namespace gameplay
 {
 
-Scene::Scene() : _activeCamera(NULL), _firstNode(NULL), _lastNode(NULL), _nodeCount(0), _bindAudioListenerToCamera(true), _debugBatch(NULL)
+Scene::Scene() : _activeCamera(NULL), _firstNode(NULL), _lastNode(NULL), _nodeCount(0), _bindAudioListenerToCamera(true), _debugBatch(NULL),
+    _flattenedTransforms(false), _transformOrderDirty(true), _transformDirtyBegin(0), _transformDirtyEnd(0),
+    _spatialIndex(NULL), _threadPool(NULL)
 {
 }
 
@@ -32,6 +35,9 @@ Scene::~Scene()
 
     // Remove all nodes from the scene
     removeAllNodes();
+
+    SAFE_DELETE(_spatialIndex);
+    SAFE_DELETE(_threadPool);
 }
 
 Scene* Scene::createScene()
@@ -167,6 +173,13 @@ void Scene::addNode(Node* node)
 
     ++_nodeCount;
 
+    if (_spatialIndex)
+    {
+        addSpatialProxies(node);
+    }
+
+    _transformOrderDirty = true;
+
     // If we don't have an active camera set, then check for one and set it.
     if (_activeCamera == NULL)
     {
@@ -200,6 +213,8 @@ void Scene::removeNode(Node* node)
     SAFE_RELEASE(node);
 
     --_nodeCount;
+
+    _transformOrderDirty = true;
 }
 
 void Scene::removeAllNodes()
@@ -280,6 +295,297 @@ void Scene::setAmbientColor(float red, float green, float blue)
     _ambientColor.set(red, green, blue);
 }
 
+bool Scene::isFlattenedTransforms() const
+{
+    return _flattenedTransforms;
+}
+
+void Scene::setFlattenedTransforms(bool flattened)
+{
+    if (_flattenedTransforms != flattened)
+    {
+        _flattenedTransforms = flattened;
+        _transformOrderDirty = true;
+
+        if (!flattened)
+        {
+            // Release the flattened arrays; nodes fall back to lazy resolution.
+            std::vector<Node*>().swap(_transformNodes);
+            std::vector<int>().swap(_transformParents);
+            std::vector<unsigned int>().swap(_transformSubtreeEnds);
+            std::vector<Matrix>().swap(_worldMatrices);
+            std::vector<unsigned char>().swap(_transformDirty);
+            _transformDirtyBegin = _transformDirtyEnd = 0;
+        }
+    }
+}
+
+void Scene::rebuildTransformOrder()
+{
+    _transformNodes.clear();
+    _transformParents.clear();
+    _transformSubtreeEnds.clear();
+
+    // Depth-first pre-order traversal so that every parent precedes its children
+    // and every subtree occupies a contiguous range of the arrays.
+    std::vector<Node*> stack;
+    for (Node* node = _lastNode; node != NULL; node = node->_prevSibling)
+    {
+        stack.push_back(node);
+    }
+
+    std::vector<unsigned int> open;
+    while (!stack.empty())
+    {
+        Node* node = stack.back();
+        stack.pop_back();
+
+        // Close every open subtree that this node is not a descendant of.
+        while (!open.empty() && _transformNodes[open.back()] != node->_parent)
+        {
+            _transformSubtreeEnds[open.back()] = _transformNodes.size();
+            open.pop_back();
+        }
+
+        node->_transformIndex = _transformNodes.size();
+        _transformNodes.push_back(node);
+        _transformParents.push_back(open.empty() ? -1 : (int)open.back());
+        _transformSubtreeEnds.push_back(0);
+        open.push_back(node->_transformIndex);
+
+        // Children are linked in arbitrary order; push them so the first child is visited first.
+        Node* child = node->_firstChild;
+        if (child)
+        {
+            while (child->_nextSibling)
+                child = child->_nextSibling;
+            for (; child != NULL; child = child->_prevSibling)
+            {
+                stack.push_back(child);
+            }
+        }
+    }
+    while (!open.empty())
+    {
+        _transformSubtreeEnds[open.back()] = _transformNodes.size();
+        open.pop_back();
+    }
+
+    _worldMatrices.resize(_transformNodes.size());
+    _transformDirty.assign(_transformNodes.size(), 0);
+    _transformOrderDirty = false;
+
+    setTransformsDirty(0, _transformNodes.size());
+}
+
+void Scene::setTransformsDirty(unsigned int begin, unsigned int end)
+{
+    if (begin >= end)
+        return;
+
+    memset(&_transformDirty[begin], 1, end - begin);
+
+    if (_transformDirtyBegin == _transformDirtyEnd)
+    {
+        _transformDirtyBegin = begin;
+        _transformDirtyEnd = end;
+    }
+    else
+    {
+        _transformDirtyBegin = std::min(_transformDirtyBegin, begin);
+        _transformDirtyEnd = std::max(_transformDirtyEnd, end);
+    }
+}
+
+void Scene::updateTransforms()
+{
+    if (!_flattenedTransforms)
+        return;
+
+    if (_transformOrderDirty)
+        rebuildTransformOrder();
+
+    const unsigned int end = _transformDirtyEnd;
+    for (unsigned int i = _transformDirtyBegin; i < end; ++i)
+    {
+        if (!_transformDirty[i])
+            continue;
+
+        _transformDirty[i] = 0;
+
+        Node* node = _transformNodes[i];
+        node->_dirtyBits &= ~NODE_DIRTY_WORLD;
+
+        // Parents always precede their children, so the parent world matrix is already resolved.
+        int parent = _transformParents[i];
+        if (parent >= 0 && (!node->_collisionObject || node->_collisionObject->isKinematic()))
+        {
+            Matrix::multiply(_worldMatrices[parent], node->getMatrix(), &_worldMatrices[i]);
+        }
+        else
+        {
+            _worldMatrices[i] = node->getMatrix();
+        }
+        node->_world = _worldMatrices[i];
+    }
+
+    _transformDirtyBegin = _transformDirtyEnd = 0;
+}
+
+unsigned int Scene::getThreadCount() const
+{
+    return _threadPool ? _threadPool->getThreadCount() : 1;
+}
+
+void Scene::setThreadCount(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+
+    if (threadCount == getThreadCount())
+        return;
+
+    SAFE_DELETE(_threadPool);
+    if (threadCount > 1)
+        _threadPool = ThreadPool::create(threadCount);
+}
+
+void Scene::updateMatrixPalettes()
+{
+    visit(this, &Scene::collectSkin);
+
+    if (_threadPool)
+    {
+        _threadPool->run(computeMatrixPalette, this, _skins.size());
+    }
+    else
+    {
+        for (unsigned int i = 0, count = _skins.size(); i < count; ++i)
+        {
+            computeMatrixPalette(this, i);
+        }
+    }
+
+    _skins.clear();
+}
+
+bool Scene::collectSkin(Node* node)
+{
+    Model* model = node->getModel();
+    MeshSkin* skin = model ? model->getSkin() : NULL;
+    if (!skin || !skin->_matrixPalette || !skin->_matrixPaletteDirty)
+        return true;
+
+    // Nodes compute their world matrices lazily, so do it here to keep the worker threads from writing to shared joints.
+    for (unsigned int i = 0, count = skin->getJointCount(); i < count; ++i)
+    {
+        skin->getJoint(i)->getWorldMatrix();
+    }
+    skin->_matrixPaletteDirty = false;
+    _skins.push_back(skin);
+    return true;
+}
+
+void Scene::computeMatrixPalette(void* cookie, unsigned int index)
+{
+    Scene* scene = static_cast<Scene*>(cookie);
+    scene->_skins[index]->computeMatrixPalette();
+}
+
+unsigned int Scene::findVisibleNodes(const Frustum& frustum, std::vector<Node*>& nodes)
+{
+    if (_spatialIndex)
+    {
+        updateSpatialIndex();
+    }
+    else
+    {
+        buildSpatialIndex();
+    }
+
+    _spatialResults.clear();
+    unsigned int count = _spatialIndex->query(frustum, _spatialResults);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        nodes.push_back(static_cast<Node*>(_spatialResults[i]));
+    }
+
+    return count;
+}
+
+void Scene::buildSpatialIndex()
+{
+    _spatialIndex = new BoundingVolumeTree();
+    for (Node* node = _firstNode; node != NULL; node = node->_nextSibling)
+    {
+        addSpatialProxies(node);
+    }
+}
+
+void Scene::updateSpatialIndex()
+{
+    for (unsigned int i = 0, count = _spatialUpdates.size(); i < count; ++i)
+    {
+        Node* node = _spatialUpdates[i];
+        node->_dirtyBits &= ~NODE_DIRTY_SPATIAL;
+        updateSpatialProxy(node);
+    }
+    _spatialUpdates.clear();
+}
+
+void Scene::addSpatialProxies(Node* node)
+{
+    updateSpatialProxy(node);
+
+    for (Node* child = node->_firstChild; child != NULL; child = child->_nextSibling)
+    {
+        addSpatialProxies(child);
+    }
+}
+
+void Scene::removeSpatialProxies(Node* node)
+{
+    if (node->_spatialProxy >= 0)
+    {
+        _spatialIndex->destroyProxy(node->_spatialProxy);
+        node->_spatialProxy = -1;
+    }
+
+    if (node->_dirtyBits & NODE_DIRTY_SPATIAL)
+    {
+        node->_dirtyBits &= ~NODE_DIRTY_SPATIAL;
+        _spatialUpdates.erase(std::find(_spatialUpdates.begin(), _spatialUpdates.end(), node));
+    }
+
+    for (Node* child = node->_firstChild; child != NULL; child = child->_nextSibling)
+    {
+        removeSpatialProxies(child);
+    }
+}
+
+void Scene::updateSpatialProxy(Node* node)
+{
+    BoundingSphere sphere;
+    if (node->getModelBoundingSphere(&sphere))
+    {
+        BoundingBox box;
+        box.set(sphere);
+        if (node->_spatialProxy >= 0)
+        {
+            _spatialIndex->moveProxy(node->_spatialProxy, box);
+        }
+        else
+        {
+            node->_spatialProxy = _spatialIndex->createProxy(box, node);
+        }
+    }
+    else if (node->_spatialProxy >= 0)
+    {
+        _spatialIndex->destroyProxy(node->_spatialProxy);
+        node->_spatialProxy = -1;
+    }
+}
+
 Material* createDebugMaterial()
 {
     // Vertex shader for drawing colored lines.
@@ -500,7 +806,7 @@ void Scene::drawDebug(unsigned int debugFlags)
             VertexFormat::Element(VertexFormat::COLOR, 4)
         };
 
-        _debugBatch = MeshBatch::create(VertexFormat(elements, 2), Mesh::LINES, material, false);
+        _debugBatch = MeshBatch::create(VertexFormat(elements, 2), Mesh::LINES, material, false, 1024, 1024, true);
 
         SAFE_RELEASE(material);
     }
@@ -516,8 +822,9 @@ void Scene::drawDebug(unsigned int debugFlags)
 
     _debugBatch->end();
 
+    static const unsigned int viewProjectionMatrixId = Effect::getUniformNameId("u_viewProjectionMatrix");
     if (_activeCamera)
-        _debugBatch->getMaterial()->getParameter("u_viewProjectionMatrix")->setValue(_activeCamera->getViewProjectionMatrix());
+        _debugBatch->getMaterial()->getParameter(viewProjectionMatrixId)->setValue(_activeCamera->getViewProjectionMatrix());
 
     _debugBatch->draw();
 }
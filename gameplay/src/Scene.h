@@ -3,15 +3,20 @@
 
 #include "Node.h"
 #include "MeshBatch.h"
+#include "ThreadPool.h"
 
 namespace gameplay
 {
 
+class BoundingVolumeTree;
+
 /**
  * Represents the root container for a hierarchy of nodes.
  */
 class Scene : public Ref
 {
+    friend class Node;
+
 public:
 
     /**
@@ -33,6 +38,9 @@ public:
     /**
      * Loads a scene from the given '.scene' file.
      * 
+     * If the scene sets 'staticBatching = true', the models of its static nodes are merged
+     * after loading (see StaticBatcher), using 'staticBatchingChunkSize' as the chunk size.
+     *
      * @param filePath The path to the '.scene' file to load from.
      * @return The loaded scene or <code>NULL</code> if the scene
      *      could not be loaded from the given file.
@@ -158,6 +166,66 @@ public:
      */
     void setAmbientColor(float red, float green, float blue);
 
+    /**
+     * Returns whether world transforms for this scene are resolved in a single linear pass.
+     *
+     * @return true if flattened transforms are enabled (false by default).
+     * @see setFlattenedTransforms(bool)
+     */
+    bool isFlattenedTransforms() const;
+
+    /**
+     * Sets whether world transforms for this scene are resolved in a single linear pass.
+     *
+     * When enabled, the scene keeps its nodes in a flattened array ordered so that every
+     * parent precedes its children, along with a contiguous array of world matrices and
+     * dirty flags. A change to a node's transform marks the node and its descendants dirty
+     * by walking a contiguous range of that array, rather than by recursing through the
+     * node hierarchy. Dirty world matrices are then resolved together by updateTransforms().
+     *
+     * Node::getWorldMatrix() returns the same results in either mode. When called on a dirty
+     * node of a flattened scene it resolves all pending changes through updateTransforms().
+     *
+     * @param flattened true to enable flattened transforms, false to use lazy per-node resolution.
+     */
+    void setFlattenedTransforms(bool flattened);
+
+    /**
+     * Resolves all dirty world matrices in the scene in a single pass.
+     *
+     * This is typically called once per frame, after game logic and animation updated the scene
+     * and before it is drawn. It does nothing unless flattened transforms are enabled.
+     */
+    void updateTransforms();
+
+    /**
+     * Gets the number of threads used by updateMatrixPalettes().
+     *
+     * @return The thread count, including the calling thread.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Sets the number of threads used by updateMatrixPalettes().
+     *
+     * @param threadCount The number of threads to use, including the calling thread. A value of 1
+     *      updates serially (the default). A value of 0 uses one thread for each processor.
+     */
+    void setThreadCount(unsigned int threadCount);
+
+    /**
+     * Computes the matrix palettes of all skinned models in the scene for the current frame.
+     *
+     * The world matrices of the joints are resolved on the calling thread, and then the palettes
+     * are computed on the scene's worker threads. Only skins whose joints changed since their
+     * palette was last computed are updated. This is typically called once per frame, after game
+     * logic and animation updated the scene and before it is drawn. Skins that are not updated
+     * this way compute their palettes when they are next drawn.
+     *
+     * @see MeshSkin::getMatrixPalette()
+     */
+    void updateMatrixPalettes();
+
     /**
      * Visits each node in the scene and calls the specified method pointer.
      *
@@ -191,6 +259,54 @@ public:
     template <class T, class C>
     void visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie);
 
+    /**
+     * Finds the nodes with models whose bounds intersect the given frustum.
+     *
+     * The scene keeps the bounds of every node that has a model in a dynamic bounding
+     * volume hierarchy, so the cost of this query grows with the number of nodes near the
+     * frustum rather than with the size of the scene. The hierarchy is built on the first
+     * query and afterwards updated incrementally as nodes move, change their models, or
+     * are added to and removed from the scene.
+     *
+     * Nodes are found in no particular order. The test is conservative: a node may be
+     * returned when its bounds are close to, but outside of, the frustum.
+     *
+     * @param frustum The frustum to test against, typically the active camera's frustum.
+     * @param nodes Vector of nodes to be populated with the nodes found.
+     *
+     * @return The number of nodes found.
+     */
+    unsigned int findVisibleNodes(const Frustum& frustum, std::vector<Node*>& nodes);
+
+    /**
+     * Visits each node with a model whose bounds intersect the given frustum and calls the specified method pointer.
+     *
+     * Unlike visit(), the scene hierarchy is not traversed; only the nodes found by
+     * findVisibleNodes() are visited. The traversal continues while visitMethod returns
+     * true. Returning false will cause the traversal to stop.
+     *
+     * @param frustum The frustum to test against, typically the active camera's frustum.
+     * @param instance The pointer to an instance of the object that contains visitMethod.
+     * @param visitMethod The pointer to the class method to call for each visible node.
+     */
+    template <class T>
+    void visitVisible(const Frustum& frustum, T* instance, bool (T::*visitMethod)(Node*));
+
+    /**
+     * Visits each node with a model whose bounds intersect the given frustum and calls the specified method pointer.
+     *
+     * Unlike visit(), the scene hierarchy is not traversed; only the nodes found by
+     * findVisibleNodes() are visited. The traversal continues while visitMethod returns
+     * true. Returning false will cause the traversal to stop.
+     *
+     * @param frustum The frustum to test against, typically the active camera's frustum.
+     * @param instance The pointer to an instance of the object that contains visitMethod.
+     * @param visitMethod The pointer to the class method to call for each visible node.
+     * @param cookie An optional user-defined parameter that will be passed to each invocation of visitMethod.
+     */
+    template <class T, class C>
+    void visitVisible(const Frustum& frustum, T* instance, bool (T::*visitMethod)(Node*,C), C cookie);
+
     /**
      * Draws debugging information (bounding volumes, etc.) for the scene.
      *
@@ -228,6 +344,51 @@ private:
     template <class T, class C>
     bool visitNode(Node* node, T* instance, bool (T::*visitMethod)(Node*,C), C cookie);
 
+    /**
+     * Collects the skin of the given node's model if its palette is out of date, resolving the world matrices of its joints.
+     */
+    bool collectSkin(Node* node);
+
+    /**
+     * Computes the matrix palette of the collected skin at the given index.
+     */
+    static void computeMatrixPalette(void* cookie, unsigned int index);
+
+    /**
+     * Rebuilds the flattened parent-before-child node array and marks every entry dirty.
+     */
+    void rebuildTransformOrder();
+
+    /**
+     * Marks the contiguous range of flattened entries [begin, end) dirty.
+     */
+    void setTransformsDirty(unsigned int begin, unsigned int end);
+
+    /**
+     * Creates the spatial index and adds every node with a model to it.
+     */
+    void buildSpatialIndex();
+
+    /**
+     * Refits the proxies of the nodes that moved since the last query.
+     */
+    void updateSpatialIndex();
+
+    /**
+     * Adds the given node and its descendants to the spatial index.
+     */
+    void addSpatialProxies(Node* node);
+
+    /**
+     * Removes the given node and its descendants from the spatial index.
+     */
+    void removeSpatialProxies(Node* node);
+
+    /**
+     * Adds, moves or removes the proxy of a single node, depending on whether it has a model.
+     */
+    void updateSpatialProxy(Node* node);
+
     std::string _id;
     Camera* _activeCamera;
     Node* _firstNode;
@@ -236,6 +397,20 @@ private:
     Vector3 _ambientColor;
     bool _bindAudioListenerToCamera;
     MeshBatch* _debugBatch;
+    bool _flattenedTransforms;
+    bool _transformOrderDirty;
+    std::vector<Node*> _transformNodes;
+    std::vector<int> _transformParents;
+    std::vector<unsigned int> _transformSubtreeEnds;
+    std::vector<Matrix> _worldMatrices;
+    std::vector<unsigned char> _transformDirty;
+    unsigned int _transformDirtyBegin;
+    unsigned int _transformDirtyEnd;
+    BoundingVolumeTree* _spatialIndex;
+    std::vector<Node*> _spatialUpdates;
+    std::vector<void*> _spatialResults;
+    ThreadPool* _threadPool;
+    std::vector<MeshSkin*> _skins;
 };
 
 template <class T>
@@ -259,6 +434,30 @@ void Scene::visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
     }
 }
 
+template <class T>
+void Scene::visitVisible(const Frustum& frustum, T* instance, bool (T::*visitMethod)(Node*))
+{
+    std::vector<Node*> nodes;
+    findVisibleNodes(frustum, nodes);
+    for (unsigned int i = 0, count = nodes.size(); i < count; ++i)
+    {
+        if (!(instance->*visitMethod)(nodes[i]))
+            return;
+    }
+}
+
+template <class T, class C>
+void Scene::visitVisible(const Frustum& frustum, T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
+{
+    std::vector<Node*> nodes;
+    findVisibleNodes(frustum, nodes);
+    for (unsigned int i = 0, count = nodes.size(); i < count; ++i)
+    {
+        if (!(instance->*visitMethod)(nodes[i], cookie))
+            return;
+    }
+}
+
 template <class T>
 bool Scene::visitNode(Node* node, T* instance, bool (T::*visitMethod)(Node*))
 {
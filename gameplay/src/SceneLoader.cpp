@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "Game.h"
 #include "Bundle.h"
+#include "StaticBatcher.h"
 #include "SceneLoader.h"
 
 namespace gameplay
@@ -84,6 +85,10 @@ Scene* SceneLoader::load(const char* filePath)
     if (physics)
         loadPhysics(physics, scene);
 
+    // Merge the models of static nodes, now that their materials, transforms and physics are set up.
+    if (sceneProperties->getBool("staticBatching"))
+        StaticBatcher::batch(scene, sceneProperties->getFloat("staticBatchingChunkSize"));
+
     // Clean up all loaded properties objects.
     std::map<std::string, Properties*>::iterator iter = _propertiesFromFile.begin();
     for (; iter != _propertiesFromFile.end(); iter++)
@@ -199,7 +199,8 @@ SpriteBatch* SpriteBatch::create(Texture* texture, Effect* effect, unsigned int
     VertexFormat vertexFormat(vertexElements, 3);
 
     // Create the mesh batch
-    MeshBatch* meshBatch = MeshBatch::create(vertexFormat, Mesh::TRIANGLE_STRIP, material, true, initialCapacity > 0 ? initialCapacity : SPRITE_BATCH_DEFAULT_SIZE);
+    MeshBatch* meshBatch = MeshBatch::create(vertexFormat, Mesh::TRIANGLE_STRIP, material, true,
+        initialCapacity > 0 ? initialCapacity : SPRITE_BATCH_DEFAULT_SIZE, 1024, true);
     material->release(); // don't call SAFE_RELEASE since material is used below
 
     // Create the batch
@@ -301,6 +302,17 @@ void SpriteBatch::draw(const Vector3& dst, float width, float height, float u1,
 
 void SpriteBatch::draw(const Vector3& position, const Vector3& right, const Vector3& forward, float width, float height,
     float u1, float v1, float u2, float v2, const Vector4& color, const Vector2& rotationPoint, float rotationAngle)
+{
+    SpriteVertex v[4];
+    computeSprite(position, right, forward, width, height, u1, v1, u2, v2, color, rotationPoint, rotationAngle, &v[0].x);
+
+    // Add the sprite vertex data to the batch.
+    static const unsigned short indices[4] = { 0, 1, 2, 3 };
+    _batch->add(v, 4, const_cast<unsigned short*>(indices), 4);
+}
+
+void SpriteBatch::computeSprite(const Vector3& position, const Vector3& right, const Vector3& forward, float width, float height,
+    float u1, float v1, float u2, float v2, const Vector4& color, const Vector2& rotationPoint, float rotationAngle, float* vertices)
 {
     // Calculate the vertex positions.
     Vector3 p[4];
@@ -309,28 +321,65 @@ void SpriteBatch::draw(const Vector3& position, const Vector3& right, const Vect
     p[2] = p[0] + height * forward;
     p[3] = p[1] + height * forward;
 
-    // Calculate the rotation point.
-    Vector3 rp = p[0] + (rotationPoint.x * width * right) + (rotationPoint.y * height * forward);
-
-    // Rotate all points the specified amount about the given point (about the up vector).
-    Vector3 u;
-    Vector3::cross(right, forward, &u);
-    Matrix rotation;
-    Matrix::createRotation(u, rotationAngle, &rotation);
-    p[0] = (rotation * (p[0] - rp)) + rp;
-    p[1] = (rotation * (p[1] - rp)) + rp;
-    p[2] = (rotation * (p[2] - rp)) + rp;
-    p[3] = (rotation * (p[3] - rp)) + rp;
+    if (rotationAngle != 0.0f)
+    {
+        // Calculate the rotation point.
+        Vector3 rp = p[0] + (rotationPoint.x * width * right) + (rotationPoint.y * height * forward);
+
+        // Rotate all points the specified amount about the given point (about the up vector).
+        Vector3 u;
+        Vector3::cross(right, forward, &u);
+        Matrix rotation;
+        Matrix::createRotation(u, rotationAngle, &rotation);
+        p[0] = (rotation * (p[0] - rp)) + rp;
+        p[1] = (rotation * (p[1] - rp)) + rp;
+        p[2] = (rotation * (p[2] - rp)) + rp;
+        p[3] = (rotation * (p[3] - rp)) + rp;
+    }
 
-    // Add the sprite vertex data to the batch.
-    static SpriteVertex v[4];
+    SpriteVertex* v = reinterpret_cast<SpriteVertex*>(vertices);
     ADD_SPRITE_VERTEX(v[0], p[0].x, p[0].y, p[0].z, u1, v1, color.x, color.y, color.z, color.w);
     ADD_SPRITE_VERTEX(v[1], p[1].x, p[1].y, p[1].z, u2, v1, color.x, color.y, color.z, color.w);
     ADD_SPRITE_VERTEX(v[2], p[2].x, p[2].y, p[2].z, u1, v2, color.x, color.y, color.z, color.w);
     ADD_SPRITE_VERTEX(v[3], p[3].x, p[3].y, p[3].z, u2, v2, color.x, color.y, color.z, color.w);
-    
-    static const unsigned short indices[4] = { 0, 1, 2, 3 };
-    _batch->add(v, 4, const_cast<unsigned short*>(indices), 4);
+}
+
+void SpriteBatch::addSprites(const float* vertices, unsigned int spriteCount)
+{
+    // Add the sprites in strips of as many sprites as can be indexed with 16-bit indices.
+    const unsigned int maxSprites = MESHBATCH_MAX_DRAW_VERTICES / 4;
+    unsigned int stripSprites = std::min(spriteCount, maxSprites);
+    if (stripSprites == 0)
+        return;
+
+    // Each sprite after the first is joined to the previous one by repeating the previous
+    // sprite's last vertex and its own first vertex.
+    unsigned int indexCount = stripSprites * 6 - 2;
+    if (_spriteIndices.size() < indexCount)
+    {
+        _spriteIndices.resize(indexCount);
+        for (unsigned int i = 0; i < stripSprites; ++i)
+        {
+            unsigned short* index = &_spriteIndices[i == 0 ? 0 : i * 6 - 2];
+            unsigned short first = (unsigned short)(i * 4);
+            if (i > 0)
+            {
+                *index++ = first - 1;
+                *index++ = first;
+            }
+            index[0] = first;
+            index[1] = first + 1;
+            index[2] = first + 2;
+            index[3] = first + 3;
+        }
+    }
+
+    SpriteVertex* v = reinterpret_cast<SpriteVertex*>(const_cast<float*>(vertices));
+    for (unsigned int i = 0; i < spriteCount; i += maxSprites)
+    {
+        unsigned int count = std::min(spriteCount - i, maxSprites);
+        _batch->add(&v[i * 4], count * 4, &_spriteIndices[0], count * 6 - 2);
+    }
 }
 
 void SpriteBatch::draw(float x, float y, float width, float height, float u1, float v1, float u2, float v2, const Vector4& color)
@@ -443,7 +492,8 @@ Material* SpriteBatch::getMaterial()
 void SpriteBatch::setProjectionMatrix(const Matrix& matrix)
 {
     // Bind the specified matrix to a parameter named 'u_projectionMatrix' (assumed to exist).
-    _batch->getMaterial()->getParameter("u_projectionMatrix")->setValue(matrix);
+    static const unsigned int projectionMatrixId = Effect::getUniformNameId("u_projectionMatrix");
+    _batch->getMaterial()->getParameter(projectionMatrixId)->setValue(matrix);
 }
 
 const Matrix& SpriteBatch::getOrthoMatrix() const
@@ -25,6 +25,7 @@ namespace gameplay
 class SpriteBatch
 {
     friend class Bundle;
+    friend class ParticleEmitter;
 
 public:
 
@@ -267,11 +268,31 @@ private:
 
     const Matrix& getOrthoMatrix() const;
 
+    /**
+     * Computes the vertices of a sprite the way draw(const Vector3&, const Vector3&, const Vector3&, ...)
+     * does, without adding them to the batch.
+     *
+     * The four vertices are stored in triangle strip order as nine floats each: the position,
+     * texture coordinates and color. This method may be called from several threads at once.
+     */
+    static void computeSprite(const Vector3& position, const Vector3& right, const Vector3& forward, float width, float height,
+                              float u1, float v1, float u2, float v2, const Vector4& color, const Vector2& rotationPoint, float rotationAngle,
+                              float* vertices);
+
+    /**
+     * Adds sprites whose vertices were computed by computeSprite().
+     *
+     * @param vertices The vertices of the sprites, four per sprite.
+     * @param spriteCount The number of sprites.
+     */
+    void addSprites(const float* vertices, unsigned int spriteCount);
+
     MeshBatch* _batch;
     bool _customEffect;
     float _textureWidthRatio;
     float _textureHeightRatio;
     mutable Matrix _projectionMatrix;
+    std::vector<unsigned short> _spriteIndices;     // The indices of a strip of sprites joined by degenerate triangles, used by addSprites().
 };
 
 }
@@ -0,0 +1,497 @@
+#include "Base.h"
+#include "StaticBatcher.h"
+#include "Technique.h"
+#include "Pass.h"
+#include "MeshPart.h"
+
+namespace gameplay
+{
+
+StaticBatcher::StaticBatcher()
+{
+}
+
+unsigned int StaticBatcher::batch(Scene* scene, float chunkSize)
+{
+    assert(scene);
+
+    std::vector<Node*> candidates;
+    for (Node* node = scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        findCandidates(node, false, candidates);
+    }
+
+    std::map<std::string, Bundle::MeshData*> meshData;
+    std::vector<Batch*> batches;
+    for (unsigned int i = 0, count = candidates.size(); i < count; ++i)
+    {
+        Node* node = candidates[i];
+        Model* model = node->getModel();
+        const char* url = model->getMesh()->getUrl();
+
+        // Read the vertex and index data of each mesh once, however many nodes share it.
+        Bundle::MeshData* data;
+        std::map<std::string, Bundle::MeshData*>::iterator itr = meshData.find(url);
+        if (itr == meshData.end())
+        {
+            data = Bundle::readMeshData(url);
+            meshData[url] = data;
+        }
+        else
+        {
+            data = itr->second;
+        }
+        if (data == NULL || !isTriangleList(data) || data->vertexCount > STATICBATCHER_MAX_VERTICES ||
+            data->parts.size() != model->getMeshPartCount())
+        {
+            continue;
+        }
+
+        // A mesh without parts is drawn with the shared material.
+        unsigned int partCount = data->parts.size();
+        unsigned int materialCount = partCount > 0 ? partCount : 1;
+        std::vector<Material*> materials(materialCount);
+        for (unsigned int j = 0; j < materialCount; ++j)
+        {
+            materials[j] = partCount > 0 ? model->getMaterial(j) : model->getMaterial();
+        }
+        if (std::find(materials.begin(), materials.end(), (Material*)NULL) != materials.end())
+            continue;
+
+        // Find the chunk containing the center of the node's bounds.
+        int chunk[3] = { 0, 0, 0 };
+        if (chunkSize > 0.0f)
+        {
+            const BoundingSphere& sphere = node->getBoundingSphere();
+            chunk[0] = (int)floor(sphere.center.x / chunkSize);
+            chunk[1] = (int)floor(sphere.center.y / chunkSize);
+            chunk[2] = (int)floor(sphere.center.z / chunkSize);
+        }
+
+        Batch* batch = NULL;
+        for (unsigned int j = 0, batchCount = batches.size(); j < batchCount; ++j)
+        {
+            Batch* b = batches[j];
+            if (!b->closed && *b->vertexFormat == data->vertexFormat &&
+                b->chunk[0] == chunk[0] && b->chunk[1] == chunk[1] && b->chunk[2] == chunk[2])
+            {
+                batch = b;
+                break;
+            }
+        }
+        if (batch && batch->vertexCount + data->vertexCount > STATICBATCHER_MAX_VERTICES)
+        {
+            // The batch is full, so start a new one for the same chunk.
+            batch->closed = true;
+            batch = NULL;
+        }
+        if (batch == NULL)
+        {
+            batch = new Batch();
+            batch->vertexFormat = &data->vertexFormat;
+            batch->chunk[0] = chunk[0];
+            batch->chunk[1] = chunk[1];
+            batch->chunk[2] = chunk[2];
+            batch->vertexCount = 0;
+            batch->closed = false;
+            batches.push_back(batch);
+        }
+
+        Source source;
+        source.node = node;
+        source.data = data;
+        for (unsigned int j = 0; j < materialCount; ++j)
+        {
+            unsigned int index = 0;
+            unsigned int batchMaterialCount = batch->materials.size();
+            while (index < batchMaterialCount && !isEquivalent(batch->materials[index], materials[j]))
+            {
+                ++index;
+            }
+            if (index == batchMaterialCount)
+            {
+                batch->materials.push_back(materials[j]);
+            }
+            source.partMaterials.push_back(index);
+        }
+        batch->sources.push_back(source);
+        batch->vertexCount += data->vertexCount;
+    }
+
+    // Merging a single model would not save any draw calls.
+    unsigned int mergedCount = 0;
+    for (unsigned int i = 0, count = batches.size(); i < count; ++i)
+    {
+        Batch* batch = batches[i];
+        if (batch->sources.size() > 1 && build(scene, batch))
+        {
+            mergedCount += batch->sources.size();
+        }
+        SAFE_DELETE(batch);
+    }
+
+    for (std::map<std::string, Bundle::MeshData*>::iterator itr = meshData.begin(); itr != meshData.end(); ++itr)
+    {
+        SAFE_DELETE(itr->second);
+    }
+
+    return mergedCount;
+}
+
+void StaticBatcher::findCandidates(Node* node, bool moving, std::vector<Node*>& candidates)
+{
+    // The world transform of a node changes with those of its ancestors.
+    moving = moving || isMoving(node);
+
+    Model* model = node->getModel();
+    if (model && !moving && !node->isDynamic() && !node->isTransparent() && model->getSkin() == NULL && strlen(model->getMesh()->getUrl()) > 0)
+    {
+        candidates.push_back(node);
+    }
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        findCandidates(child, moving, candidates);
+    }
+}
+
+bool StaticBatcher::isMoving(Node* node)
+{
+    if (node->getAnimation() != NULL)
+        return true;
+
+    PhysicsCollisionObject* object = node->getCollisionObject();
+    return object && (object->isKinematic() || object->isDynamic());
+}
+
+bool StaticBatcher::isTriangleList(const Bundle::MeshData* data)
+{
+    if (data->parts.empty())
+    {
+        return data->primitiveType == Mesh::TRIANGLES && data->vertexCount % 3 == 0;
+    }
+
+    for (unsigned int i = 0, count = data->parts.size(); i < count; ++i)
+    {
+        if (data->parts[i]->primitiveType != Mesh::TRIANGLES)
+            return false;
+    }
+    return true;
+}
+
+Node* StaticBatcher::build(Scene* scene, Batch* batch)
+{
+    const VertexFormat& vertexFormat = *batch->vertexFormat;
+    unsigned int vertexSize = vertexFormat.getVertexSize();
+    unsigned int sourceCount = batch->sources.size();
+
+    // Copy the vertices of each model into world space.
+    unsigned char* vertices = new unsigned char[batch->vertexCount * vertexSize];
+    std::vector<unsigned int> firstVertices(sourceCount);
+    std::vector<bool> mirrored(sourceCount);
+    BoundingBox bounds;
+    unsigned int vertexCount = 0;
+    for (unsigned int i = 0; i < sourceCount; ++i)
+    {
+        const Source& source = batch->sources[i];
+        unsigned char* sourceVertices = vertices + vertexCount * vertexSize;
+        memcpy(sourceVertices, source.data->vertexData, source.data->vertexCount * vertexSize);
+
+        BoundingBox box;
+        transformVertices(vertexFormat, (float*)sourceVertices, source.data->vertexCount, source.node, &box);
+        if (i == 0)
+            bounds.set(box);
+        else
+            bounds.merge(box);
+
+        // A transform with a negative determinant mirrors the model, which reverses the winding of its triangles.
+        mirrored[i] = source.node->getWorldMatrix().determinant() < 0.0f;
+        firstVertices[i] = vertexCount;
+        vertexCount += source.data->vertexCount;
+    }
+
+    Mesh* mesh = Mesh::createMesh(vertexFormat, vertexCount, false);
+    if (mesh == NULL)
+    {
+        LOG_ERROR("Failed to create a merged static mesh.");
+        SAFE_DELETE_ARRAY(vertices);
+        return NULL;
+    }
+    mesh->setVertexData(vertices, 0, vertexCount);
+    SAFE_DELETE_ARRAY(vertices);
+
+    BoundingSphere sphere;
+    sphere.set(bounds);
+    mesh->setBoundingBox(bounds);
+    mesh->setBoundingSphere(sphere);
+
+    // Create one part per material, holding the indices of every model part that uses it.
+    std::vector<unsigned short> indices;
+    for (unsigned int m = 0, materialCount = batch->materials.size(); m < materialCount; ++m)
+    {
+        indices.clear();
+        for (unsigned int i = 0; i < sourceCount; ++i)
+        {
+            const Source& source = batch->sources[i];
+            unsigned int firstVertex = firstVertices[i];
+            unsigned int firstIndex = indices.size();
+            if (source.data->parts.empty())
+            {
+                if (source.partMaterials[0] == m)
+                {
+                    for (unsigned int v = 0; v < source.data->vertexCount; ++v)
+                    {
+                        indices.push_back((unsigned short)(firstVertex + v));
+                    }
+                }
+            }
+
+            for (unsigned int p = 0, partCount = source.data->parts.size(); p < partCount; ++p)
+            {
+                if (source.partMaterials[p] != m)
+                    continue;
+
+                const Bundle::MeshPartData* part = source.data->parts[p];
+                for (unsigned int k = 0; k < part->indexCount; ++k)
+                {
+                    unsigned int vertex;
+                    switch (part->indexFormat)
+                    {
+                    case Mesh::INDEX8:
+                        vertex = ((const unsigned char*)part->indexData)[k];
+                        break;
+                    case Mesh::INDEX16:
+                        vertex = ((const unsigned short*)part->indexData)[k];
+                        break;
+                    default:
+                        vertex = ((const unsigned int*)part->indexData)[k];
+                        break;
+                    }
+                    indices.push_back((unsigned short)(firstVertex + vertex));
+                }
+            }
+
+            // Restore the winding of mirrored models, so that they are not culled as back faces.
+            if (mirrored[i])
+            {
+                for (unsigned int k = firstIndex, indexCount = indices.size(); k + 2 < indexCount; k += 3)
+                {
+                    std::swap(indices[k + 1], indices[k + 2]);
+                }
+            }
+        }
+
+        MeshPart* part = mesh->addPart(Mesh::TRIANGLES, Mesh::INDEX16, indices.size(), false);
+        if (part == NULL)
+        {
+            LOG_ERROR("Failed to create a merged static mesh part.");
+            SAFE_RELEASE(mesh);
+            return NULL;
+        }
+        if (!indices.empty())
+        {
+            part->setIndexData(&indices[0], 0, indices.size());
+        }
+    }
+
+    Model* model = Model::create(mesh);
+    SAFE_RELEASE(mesh);
+    for (unsigned int m = 0, materialCount = batch->materials.size(); m < materialCount; ++m)
+    {
+        model->setMaterial(batch->materials[m], m);
+    }
+
+    // The merged model now references the materials, so the original models can be released.
+    for (unsigned int i = 0; i < sourceCount; ++i)
+    {
+        batch->sources[i].node->setModel(NULL);
+    }
+
+    // Name the node after the first batch index not already used in the scene, so that
+    // batching a scene again does not create nodes with duplicate ids.
+    char id[32];
+    unsigned int index = 0;
+    do
+    {
+        sprintf(id, "staticBatch%u", index++);
+    } while (scene->findNode(id) != NULL);
+    Node* node = scene->addNode(id);
+    node->setModel(model);
+    SAFE_RELEASE(model);
+
+    return node;
+}
+
+void StaticBatcher::transformVertices(const VertexFormat& vertexFormat, float* vertices, unsigned int vertexCount, Node* node, BoundingBox* bounds)
+{
+    const Matrix& worldMatrix = node->getWorldMatrix();
+    const Matrix& normalMatrix = node->getInverseTransposeWorldMatrix();
+    unsigned int stride = vertexFormat.getVertexSize() / sizeof(float);
+    unsigned int elementCount = vertexFormat.getElementCount();
+
+    Vector3 min, max;
+    for (unsigned int v = 0; v < vertexCount; ++v)
+    {
+        float* element = vertices + v * stride;
+        for (unsigned int i = 0; i < elementCount; element += vertexFormat.getElement(i).size, ++i)
+        {
+            const VertexFormat::Element& e = vertexFormat.getElement(i);
+            if (e.size < 3)
+                continue;
+
+            Vector3 value(element[0], element[1], element[2]);
+            switch (e.usage)
+            {
+            case VertexFormat::POSITION:
+                worldMatrix.transformPoint(&value);
+                if (v == 0)
+                {
+                    min = max = value;
+                }
+                else
+                {
+                    min.set(std::min(min.x, value.x), std::min(min.y, value.y), std::min(min.z, value.z));
+                    max.set(std::max(max.x, value.x), std::max(max.y, value.y), std::max(max.z, value.z));
+                }
+                break;
+            case VertexFormat::NORMAL:
+                normalMatrix.transformVector(&value);
+                value.normalize();
+                break;
+            case VertexFormat::TANGENT:
+            case VertexFormat::BINORMAL:
+                worldMatrix.transformVector(&value);
+                value.normalize();
+                break;
+            default:
+                continue;
+            }
+            element[0] = value.x;
+            element[1] = value.y;
+            element[2] = value.z;
+        }
+    }
+
+    bounds->set(min, max);
+}
+
+bool StaticBatcher::isEquivalent(Material* a, Material* b)
+{
+    if (a == b)
+        return true;
+
+    unsigned int techniqueCount = a->getTechniqueCount();
+    if (techniqueCount != b->getTechniqueCount() || strcmp(a->getTechnique()->getId(), b->getTechnique()->getId()) != 0)
+        return false;
+    if (!isEquivalent(static_cast<RenderState*>(a), static_cast<RenderState*>(b)))
+        return false;
+
+    for (unsigned int i = 0; i < techniqueCount; ++i)
+    {
+        Technique* ta = a->getTechnique(i);
+        Technique* tb = b->getTechnique(i);
+        unsigned int passCount = ta->getPassCount();
+        if (strcmp(ta->getId(), tb->getId()) != 0 || passCount != tb->getPassCount() || !isEquivalent(ta, tb))
+            return false;
+
+        for (unsigned int j = 0; j < passCount; ++j)
+        {
+            Pass* pa = ta->getPass(j);
+            Pass* pb = tb->getPass(j);
+            if (pa->getEffect() != pb->getEffect() || !isEquivalent(pa, pb))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool StaticBatcher::isEquivalent(RenderState* a, RenderState* b)
+{
+    RenderState::StateBlock* sa = a->_state;
+    RenderState::StateBlock* sb = b->_state;
+    if (sa != sb)
+    {
+        if (sa == NULL || sb == NULL || sa->_bits != sb->_bits ||
+            sa->_blendEnabled != sb->_blendEnabled || sa->_cullFaceEnabled != sb->_cullFaceEnabled ||
+            sa->_depthTestEnabled != sb->_depthTestEnabled || sa->_depthWriteEnabled != sb->_depthWriteEnabled ||
+            sa->_srcBlend != sb->_srcBlend || sa->_dstBlend != sb->_dstBlend)
+        {
+            return false;
+        }
+    }
+
+    if (a->_parameters.size() != b->_parameters.size() || a->_autoBindings.size() != b->_autoBindings.size())
+        return false;
+
+    // Auto-bound parameters are bound to each material's own node, so only their bindings are compared.
+    for (unsigned int i = 0, count = a->_autoBindings.size(); i < count; ++i)
+    {
+        const RenderState::AutoBindingEntry& ea = a->_autoBindings[i];
+        const RenderState::AutoBindingEntry& eb = b->_autoBindings[i];
+        if (ea.binding != eb.binding || ea.parameter->_nameId != eb.parameter->_nameId)
+            return false;
+    }
+
+    for (unsigned int i = 0, count = a->_parameters.size(); i < count; ++i)
+    {
+        MaterialParameter* pa = a->_parameters[i];
+        MaterialParameter* pb = b->_parameters[i];
+        if (pa->_nameId != pb->_nameId)
+            return false;
+
+        bool autoBound = false;
+        for (unsigned int j = 0, autoCount = a->_autoBindings.size(); j < autoCount && !autoBound; ++j)
+        {
+            autoBound = (a->_autoBindings[j].parameter == pa);
+        }
+        if (!autoBound && !isEquivalent(pa, pb))
+            return false;
+    }
+    return true;
+}
+
+bool StaticBatcher::isEquivalent(MaterialParameter* a, MaterialParameter* b)
+{
+    if (a->_type != b->_type || a->_count != b->_count)
+        return false;
+
+    unsigned int components = 0;
+    switch (a->_type)
+    {
+    case MaterialParameter::NONE:
+        return true;
+    case MaterialParameter::FLOAT:
+        if (a->_count == 1)
+            return a->_value.floatValue == b->_value.floatValue;
+        components = 1;
+        break;
+    case MaterialParameter::INT:
+        if (a->_count == 1)
+            return a->_value.intValue == b->_value.intValue;
+        return memcmp(a->_value.intPtrValue, b->_value.intPtrValue, sizeof(int) * a->_count) == 0;
+    case MaterialParameter::VECTOR2:
+        components = 2;
+        break;
+    case MaterialParameter::VECTOR3:
+        components = 3;
+        break;
+    case MaterialParameter::VECTOR4:
+        components = 4;
+        break;
+    case MaterialParameter::MATRIX:
+        components = 16;
+        break;
+    case MaterialParameter::SAMPLER:
+        {
+            const Texture::Sampler* sa = a->_value.samplerValue;
+            const Texture::Sampler* sb = b->_value.samplerValue;
+            return sa == sb || (sa && sb && sa->_texture == sb->_texture && sa->_wrapS == sb->_wrapS && sa->_wrapT == sb->_wrapT &&
+                                sa->_minFilter == sb->_minFilter && sa->_magFilter == sb->_magFilter);
+        }
+    case MaterialParameter::METHOD:
+        return a->_value.method == b->_value.method;
+    }
+    return memcmp(a->_value.floatPtrValue, b->_value.floatPtrValue, sizeof(float) * components * a->_count) == 0;
+}
+
+}
@@ -0,0 +1,129 @@
+#ifndef STATICBATCHER_H_
+#define STATICBATCHER_H_
+
+#include "Scene.h"
+#include "Bundle.h"
+
+// The maximum number of vertices in a merged mesh, so that it can be drawn with 16-bit indices.
+#define STATICBATCHER_MAX_VERTICES (USHRT_MAX + 1)
+
+namespace gameplay
+{
+
+/**
+ * Defines a scene optimization that merges static models into a few large meshes.
+ *
+ * Levels are often built from many small static models that share materials. Drawing each of
+ * them separately costs a draw call and a material bind per model. batch() merges the models
+ * of static nodes (see Node::isDynamic()) into combined meshes with one part per material, so
+ * that the same geometry takes one draw call per material and region of the scene.
+ *
+ * The vertices of each model are transformed into world space when they are merged, so the
+ * merged models must not move afterwards. Models are only merged with models that have the
+ * same vertex format and lie in the same chunk of a regular grid, which keeps the merged
+ * meshes small enough to be culled effectively. Two materials are considered the same when
+ * they use the same effects, render states and parameter values, so materials loaded from
+ * the same material file for different nodes are merged.
+ *
+ * Only triangle list models that were loaded from a bundle can be merged, since their vertex
+ * data is read back from the bundle. Skinned and transparent models are never merged, and
+ * neither are the models of nodes that can move at runtime without being flagged as dynamic:
+ * nodes that are the targets of animations or that have a kinematic or dynamic collision
+ * object, and the descendants of such nodes.
+ */
+class StaticBatcher
+{
+public:
+
+    /**
+     * Merges the models of the static nodes in a scene.
+     *
+     * The merged models are removed from their nodes and drawn by new nodes added to the root
+     * of the scene. The nodes themselves, and anything else attached to them, are kept.
+     *
+     * @param scene The scene to optimize.
+     * @param chunkSize The size of the grid cells that limit which models are merged together,
+     *      or zero to merge models regardless of their position.
+     *
+     * @return The number of nodes whose models were merged.
+     */
+    static unsigned int batch(Scene* scene, float chunkSize = 0.0f);
+
+private:
+
+    /**
+     * A node whose model is merged into a batch.
+     */
+    struct Source
+    {
+        Node* node;
+        Bundle::MeshData* data;
+        std::vector<unsigned int> partMaterials;    // The index in the batch's materials of each part's material.
+    };
+
+    /**
+     * A set of models merged into one mesh.
+     */
+    struct Batch
+    {
+        const VertexFormat* vertexFormat;
+        int chunk[3];
+        unsigned int vertexCount;
+        bool closed;
+        std::vector<Source> sources;
+        std::vector<Material*> materials;
+    };
+
+    /**
+     * Hidden constructor.
+     */
+    StaticBatcher();
+
+    /**
+     * Appends the nodes in a hierarchy that have models that could be merged.
+     *
+     * @param node The root of the hierarchy.
+     * @param moving Whether an ancestor of the node can move.
+     * @param candidates The list to append the nodes to.
+     */
+    static void findCandidates(Node* node, bool moving, std::vector<Node*>& candidates);
+
+    /**
+     * Determines whether a node can move by itself, through an animation or its collision object.
+     */
+    static bool isMoving(Node* node);
+
+    /**
+     * Determines whether mesh data contains only triangle lists.
+     */
+    static bool isTriangleList(const Bundle::MeshData* data);
+
+    /**
+     * Creates the merged mesh of a batch and a node to draw it, and removes the merged models from their nodes.
+     */
+    static Node* build(Scene* scene, Batch* batch);
+
+    /**
+     * Transforms the positions, normals, tangents and binormals of vertices into world space.
+     */
+    static void transformVertices(const VertexFormat& vertexFormat, float* vertices, unsigned int vertexCount, Node* node, BoundingBox* bounds);
+
+    /**
+     * Determines whether two materials draw the same way.
+     */
+    static bool isEquivalent(Material* a, Material* b);
+
+    /**
+     * Determines whether two render states have the same state block, parameters and auto-bindings.
+     */
+    static bool isEquivalent(RenderState* a, RenderState* b);
+
+    /**
+     * Determines whether two material parameters have the same value.
+     */
+    static bool isEquivalent(MaterialParameter* a, MaterialParameter* b);
+};
+
+}
+
+#endif
@@ -38,26 +38,9 @@ Texture::~Texture()
 Texture* Texture::create(const char* path, bool generateMipmaps)
 {
     // Search texture cache first.
-    for (unsigned int i = 0, count = __textureCache.size(); i < count; ++i)
-    {
-        Texture* t = __textureCache[i];
-        if (t->_path == path)
-        {
-            // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the 
-            // texture to generate its mipmap chain if it hasn't already done so.
-            if (generateMipmaps)
-            {
-                t->generateMipmaps();
-            }
-
-            // Found a match.
-            t->addRef();
-
-            return t;
-        }
-    }
-
-    Texture* texture = NULL;
+    Texture* texture = find(path, generateMipmaps);
+    if (texture)
+        return texture;
 
     // Filter loading based on file extension.
     const char* ext = strrchr(path, '.');
@@ -88,12 +71,7 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
 
     if (texture)
     {
-        texture->_path = path;
-        texture->_cached = true;
-
-        // Add to texture cache.
-        __textureCache.push_back(texture);
-
+        texture->cache(path);
         return texture;
     }
 
@@ -101,6 +79,39 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     return NULL;
 }
 
+Texture* Texture::find(const char* path, bool generateMipmaps)
+{
+    for (unsigned int i = 0, count = __textureCache.size(); i < count; ++i)
+    {
+        Texture* t = __textureCache[i];
+        if (t->_path == path)
+        {
+            // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the 
+            // texture to generate its mipmap chain if it hasn't already done so.
+            if (generateMipmaps)
+            {
+                t->generateMipmaps();
+            }
+
+            // Found a match.
+            t->addRef();
+
+            return t;
+        }
+    }
+
+    return NULL;
+}
+
+void Texture::cache(const char* path)
+{
+    _path = path;
+    _cached = true;
+
+    // Add to texture cache.
+    __textureCache.push_back(this);
+}
+
 Texture* Texture::create(Image* image, bool generateMipmaps)
 {
     switch (image->getFormat())
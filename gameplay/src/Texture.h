@@ -18,6 +18,7 @@ class Image;
 class Texture : public Ref
 {
     friend class Sampler;
+    friend class ResourceLoader;
 
 public:
 
@@ -71,6 +72,7 @@ public:
     class Sampler : public Ref
     {
         friend class Texture;
+        friend class StaticBatcher;
 
     public:
 
@@ -213,6 +215,23 @@ private:
      */
     virtual ~Texture();
 
+    /**
+     * Finds a texture loaded from the given path in the texture cache.
+     *
+     * @param path The path the texture was loaded from.
+     * @param generateMipmaps true to generate the mipmap chain of the cached texture if it has none.
+     *
+     * @return The cached texture with an added reference, or NULL if it is not cached.
+     */
+    static Texture* find(const char* path, bool generateMipmaps);
+
+    /**
+     * Adds this texture to the texture cache under the given path.
+     *
+     * @param path The path the texture was loaded from.
+     */
+    void cache(const char* path);
+
 #ifdef USE_PVRTC
     static Texture* createCompressedPVRTC(const char* path);
 #endif
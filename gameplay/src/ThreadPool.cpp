@@ -0,0 +1,242 @@
+#include "Base.h"
+#include "ThreadPool.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+// The number of batches each thread is expected to process during a run,
+// trading lock traffic against load balancing between threads.
+#define THREADPOOL_BATCHES_PER_THREAD 4
+
+namespace gameplay
+{
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : _task(NULL), _cookie(NULL), _count(0), _next(0), _batchSize(1), _busy(0), _generation(0), _exit(false)
+{
+#ifdef WIN32
+    InitializeCriticalSection(&_mutex);
+    InitializeConditionVariable(&_workCondition);
+    InitializeConditionVariable(&_doneCondition);
+#else
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_workCondition, NULL);
+    pthread_cond_init(&_doneCondition, NULL);
+#endif
+
+    // The calling thread also runs tasks, so create one fewer worker than requested.
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+#ifdef WIN32
+        HANDLE thread = CreateThread(NULL, 0, workerMain, this, 0, NULL);
+        if (thread == NULL)
+        {
+            WARN_VARG("Failed to create thread pool worker (error %u).", (unsigned int)GetLastError());
+            break;
+        }
+#else
+        pthread_t thread;
+        int result = pthread_create(&thread, NULL, workerMain, this);
+        if (result != 0)
+        {
+            WARN_VARG("Failed to create thread pool worker (error %d).", result);
+            break;
+        }
+#endif
+        _threads.push_back(thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    lock();
+    _exit = true;
+#ifdef WIN32
+    WakeAllConditionVariable(&_workCondition);
+#else
+    pthread_cond_broadcast(&_workCondition);
+#endif
+    unlock();
+
+    for (unsigned int i = 0; i < _threads.size(); ++i)
+    {
+#ifdef WIN32
+        WaitForSingleObject(_threads[i], INFINITE);
+        CloseHandle(_threads[i]);
+#else
+        pthread_join(_threads[i], NULL);
+#endif
+    }
+
+#ifdef WIN32
+    DeleteCriticalSection(&_mutex);
+#else
+    pthread_cond_destroy(&_doneCondition);
+    pthread_cond_destroy(&_workCondition);
+    pthread_mutex_destroy(&_mutex);
+#endif
+}
+
+ThreadPool* ThreadPool::create(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = getProcessorCount();
+
+    return new ThreadPool(threadCount);
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return _threads.size() + 1;
+}
+
+unsigned int ThreadPool::getProcessorCount()
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (unsigned int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned int)count : 1;
+#endif
+}
+
+void ThreadPool::run(Task task, void* cookie, unsigned int count)
+{
+    assert(task);
+
+    if (count == 0)
+        return;
+
+    // Run small loops, or all loops without workers, directly on the calling thread.
+    if (_threads.empty() || count == 1)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            task(cookie, i);
+        }
+        return;
+    }
+
+    lock();
+    _task = task;
+    _cookie = cookie;
+    _count = count;
+    _next = 0;
+    _batchSize = count / (getThreadCount() * THREADPOOL_BATCHES_PER_THREAD);
+    if (_batchSize == 0)
+        _batchSize = 1;
+    _busy = _threads.size();
+    ++_generation;
+#ifdef WIN32
+    WakeAllConditionVariable(&_workCondition);
+#else
+    pthread_cond_broadcast(&_workCondition);
+#endif
+    unlock();
+
+    process();
+
+    // Wait for the workers to finish their last batches.
+    lock();
+    while (_busy > 0)
+    {
+#ifdef WIN32
+        SleepConditionVariableCS(&_doneCondition, &_mutex, INFINITE);
+#else
+        pthread_cond_wait(&_doneCondition, &_mutex);
+#endif
+    }
+    _task = NULL;
+    _cookie = NULL;
+    unlock();
+}
+
+void ThreadPool::process()
+{
+    while (true)
+    {
+        lock();
+        unsigned int begin = _next;
+        unsigned int end = begin + _batchSize;
+        if (end > _count)
+            end = _count;
+        _next = end;
+        Task task = _task;
+        void* cookie = _cookie;
+        unlock();
+
+        if (begin >= end)
+            break;
+
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            task(cookie, i);
+        }
+    }
+}
+
+void ThreadPool::lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&_mutex);
+#else
+    pthread_mutex_lock(&_mutex);
+#endif
+}
+
+void ThreadPool::unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&_mutex);
+#else
+    pthread_mutex_unlock(&_mutex);
+#endif
+}
+
+#ifdef WIN32
+DWORD WINAPI ThreadPool::workerMain(LPVOID arg)
+#else
+void* ThreadPool::workerMain(void* arg)
+#endif
+{
+    ThreadPool* pool = static_cast<ThreadPool*>(arg);
+    unsigned int generation = 0;
+
+    pool->lock();
+    while (true)
+    {
+        // Wait for a new run, or for the pool to be destroyed.
+        while (!pool->_exit && pool->_generation == generation)
+        {
+#ifdef WIN32
+            SleepConditionVariableCS(&pool->_workCondition, &pool->_mutex, INFINITE);
+#else
+            pthread_cond_wait(&pool->_workCondition, &pool->_mutex);
+#endif
+        }
+        if (pool->_exit)
+            break;
+        generation = pool->_generation;
+        pool->unlock();
+
+        pool->process();
+
+        pool->lock();
+        if (--pool->_busy == 0)
+        {
+#ifdef WIN32
+            WakeConditionVariable(&pool->_doneCondition);
+#else
+            pthread_cond_signal(&pool->_doneCondition);
+#endif
+        }
+    }
+    pool->unlock();
+
+    return 0;
+}
+
+}
@@ -0,0 +1,143 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace gameplay
+{
+
+/**
+ * Defines a fixed-size pool of worker threads for running data-parallel loops.
+ *
+ * A thread pool runs a task once for each index in a range, spreading the indices
+ * across its worker threads and the calling thread. The call returns once every index
+ * has been processed, so the caller may safely read the results immediately.
+ *
+ * Tasks run concurrently and must only write to data owned by their index. They
+ * must not call back into engine systems that are not thread-safe (for example,
+ * rendering, audio, scripting, or listener callbacks).
+ */
+class ThreadPool
+{
+public:
+
+    /**
+     * Defines the function run for each index of a parallel loop.
+     *
+     * @param cookie The user-defined value passed to run().
+     * @param index The index of the item to process.
+     */
+    typedef void (*Task)(void* cookie, unsigned int index);
+
+    /**
+     * Creates a new thread pool.
+     *
+     * @param threadCount The total number of threads used to run tasks, including the calling thread.
+     *      A value of 0 uses one thread for each processor. A value of 1 creates no worker threads
+     *      and runs all tasks on the calling thread.
+     *
+     * @return The new thread pool.
+     */
+    static ThreadPool* create(unsigned int threadCount = 0);
+
+    /**
+     * Destructor. Stops and joins all worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Gets the total number of threads used to run tasks, including the calling thread.
+     *
+     * @return The thread count.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Runs the given task once for every index in [0, count) and waits for all of them to complete.
+     *
+     * Indices are handed out in small contiguous batches. The order in which indices
+     * are processed, and the thread that processes each index, are not specified.
+     * This method must not be called from within a task.
+     *
+     * @param task The task to run.
+     * @param cookie A user-defined value passed to each invocation of the task.
+     * @param count The number of indices to process.
+     */
+    void run(Task task, void* cookie, unsigned int count);
+
+    /**
+     * Gets the number of processors available to the application.
+     *
+     * @return The processor count (at least 1).
+     */
+    static unsigned int getProcessorCount();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    ThreadPool(unsigned int threadCount);
+
+    /**
+     * Hidden copy constructor.
+     */
+    ThreadPool(const ThreadPool& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ThreadPool& operator=(const ThreadPool&);
+
+    /**
+     * Processes batches of indices for the current run until none remain.
+     */
+    void process();
+
+    /**
+     * Acquires the pool's lock.
+     */
+    void lock();
+
+    /**
+     * Releases the pool's lock.
+     */
+    void unlock();
+
+    /**
+     * Entry point of the worker threads.
+     */
+#ifdef WIN32
+    static DWORD WINAPI workerMain(LPVOID arg);
+#else
+    static void* workerMain(void* arg);
+#endif
+
+#ifdef WIN32
+    std::vector<HANDLE> _threads;
+    CRITICAL_SECTION _mutex;
+    CONDITION_VARIABLE _workCondition;
+    CONDITION_VARIABLE _doneCondition;
+#else
+    std::vector<pthread_t> _threads;
+    pthread_mutex_t _mutex;
+    pthread_cond_t _workCondition;
+    pthread_cond_t _doneCondition;
+#endif
+    Task _task;                     // The task of the current run.
+    void* _cookie;                  // The cookie of the current run.
+    unsigned int _count;            // The number of indices in the current run.
+    unsigned int _next;             // The next index to hand out.
+    unsigned int _batchSize;        // The number of indices handed out at a time.
+    unsigned int _busy;             // The number of workers that have not finished the current run.
+    unsigned int _generation;       // Incremented for every run, to wake the workers.
+    bool _exit;                     // Set when the workers should exit.
+};
+
+}
+
+#endif
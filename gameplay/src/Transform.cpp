@@ -7,28 +7,28 @@ namespace gameplay
 {
 
 Transform::Transform()
-    : _matrixDirtyBits(0), _listeners(NULL)
+    : _matrixDirtyBits(0), _listeners(NULL), _animationPoseIndex(0)
 {
     _targetType = AnimationTarget::TRANSFORM;
     _scale.set(Vector3::one());
 }
 
 Transform::Transform(const Vector3& scale, const Quaternion& rotation, const Vector3& translation)
-    : _matrixDirtyBits(0), _listeners(NULL)
+    : _matrixDirtyBits(0), _listeners(NULL), _animationPoseIndex(0)
 {
     _targetType = AnimationTarget::TRANSFORM;
     set(scale, rotation, translation);
 }
 
 Transform::Transform(const Vector3& scale, const Matrix& rotation, const Vector3& translation)
-    : _matrixDirtyBits(0), _listeners(NULL)
+    : _matrixDirtyBits(0), _listeners(NULL), _animationPoseIndex(0)
 {
     _targetType = AnimationTarget::TRANSFORM;
     set(scale, rotation, translation);
 }
 
 Transform::Transform(const Transform& copy)
-    : _matrixDirtyBits(0), _listeners(NULL)
+    : _matrixDirtyBits(0), _listeners(NULL), _animationPoseIndex(0)
 {
     _targetType = AnimationTarget::TRANSFORM;
     set(copy);
@@ -661,84 +661,145 @@ void Transform::setAnimationPropertyValue(int propertyId, AnimationValue* value,
 {
     assert(blendWeight >= 0.0f && blendWeight <= 1.0f);
 
+    Vector3 scale(_scale);
+    Quaternion rotation(_rotation);
+    Vector3 translation(_translation);
+    blendAnimationValue(propertyId, value, blendWeight, &scale, &rotation, &translation);
+    commitAnimationPose(scale, rotation, translation);
+}
+
+void Transform::dirty(char matrixDirtyBits)
+{
+    _matrixDirtyBits |= matrixDirtyBits;
+    transformChanged();
+}
+
+void Transform::addListener(Transform::Listener* listener, long cookie)
+{
+    if (_listeners == NULL)
+        _listeners = new std::list<TransformListener>();
+
+    TransformListener l;
+    l.listener = listener;
+    l.cookie = cookie;
+    _listeners->push_back(l);
+}
+
+void Transform::removeListener(Transform::Listener* listener)
+{
+    if (_listeners)
+    {
+        for (std::list<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); itr++)
+        {
+            if ((*itr).listener == listener)
+            {
+                _listeners->erase(itr);
+                break;
+            }
+        }
+    }
+}
+
+void Transform::transformChanged()
+{
+    if (_listeners)
+    {
+        for (std::list<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); itr++)
+        {
+            TransformListener& l = *itr;
+            l.listener->transformChanged(this, l.cookie);
+        }
+    }
+}
+
+void Transform::cloneInto(Transform* transform, NodeCloneContext &context) const
+{
+    AnimationTarget::cloneInto(transform, context);
+    transform->_scale.set(_scale);
+    transform->_rotation.set(_rotation);
+    transform->_translation.set(_translation);
+}
+
+void Transform::blendAnimationValue(int propertyId, AnimationValue* value, float blendWeight, Vector3* scale, Quaternion* rotation, Vector3* translation)
+{
     switch (propertyId)
     {
         case ANIMATE_SCALE_UNIT:
         {
-            applyAnimationValueScaleX(value->getFloat(0), blendWeight);
-            applyAnimationValueScaleY(value->getFloat(0), blendWeight);
-            applyAnimationValueScaleZ(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_SCALE_X_BIT, value->getFloat(0), blendWeight, &scale->x);
+            blendAnimationValueScalar(ANIMATION_SCALE_Y_BIT, value->getFloat(0), blendWeight, &scale->y);
+            blendAnimationValueScalar(ANIMATION_SCALE_Z_BIT, value->getFloat(0), blendWeight, &scale->z);
             break;
-        }   
+        }
         case ANIMATE_SCALE:
         {
-            applyAnimationValueScaleX(value->getFloat(0), blendWeight);
-            applyAnimationValueScaleY(value->getFloat(1), blendWeight);
-            applyAnimationValueScaleZ(value->getFloat(2), blendWeight);
+            blendAnimationValueScalar(ANIMATION_SCALE_X_BIT, value->getFloat(0), blendWeight, &scale->x);
+            blendAnimationValueScalar(ANIMATION_SCALE_Y_BIT, value->getFloat(1), blendWeight, &scale->y);
+            blendAnimationValueScalar(ANIMATION_SCALE_Z_BIT, value->getFloat(2), blendWeight, &scale->z);
             break;
         }
         case ANIMATE_SCALE_X:
         {
-            applyAnimationValueScaleX(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_SCALE_X_BIT, value->getFloat(0), blendWeight, &scale->x);
             break;
         }
         case ANIMATE_SCALE_Y:
         {
-            applyAnimationValueScaleY(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_SCALE_Y_BIT, value->getFloat(0), blendWeight, &scale->y);
             break;
         }
         case ANIMATE_SCALE_Z:
         {
-            applyAnimationValueScaleZ(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_SCALE_Z_BIT, value->getFloat(0), blendWeight, &scale->z);
             break;
         }
         case ANIMATE_ROTATE:
         {
             Quaternion q(value->getFloat(0), value->getFloat(1), value->getFloat(2), value->getFloat(3));
-            applyAnimationValueRotation(&q, blendWeight);
+            blendAnimationValueRotation(q, blendWeight, rotation);
             break;
         }
         case ANIMATE_TRANSLATE:
         {
-            applyAnimationValueTranslationX(value->getFloat(0), blendWeight);
-            applyAnimationValueTranslationY(value->getFloat(1), blendWeight);
-            applyAnimationValueTranslationZ(value->getFloat(2), blendWeight);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_X_BIT, value->getFloat(0), blendWeight, &translation->x);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Y_BIT, value->getFloat(1), blendWeight, &translation->y);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Z_BIT, value->getFloat(2), blendWeight, &translation->z);
             break;
         }
         case ANIMATE_TRANSLATE_X:
         {
-            applyAnimationValueTranslationX(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_X_BIT, value->getFloat(0), blendWeight, &translation->x);
             break;
         }
         case ANIMATE_TRANSLATE_Y:
         {
-            applyAnimationValueTranslationY(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Y_BIT, value->getFloat(0), blendWeight, &translation->y);
             break;
         }
         case ANIMATE_TRANSLATE_Z:
         {
-            applyAnimationValueTranslationZ(value->getFloat(0), blendWeight);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Z_BIT, value->getFloat(0), blendWeight, &translation->z);
             break;
         }
         case ANIMATE_ROTATE_TRANSLATE:
         {
             Quaternion q(value->getFloat(0), value->getFloat(1), value->getFloat(2), value->getFloat(3));
-            applyAnimationValueRotation(&q, blendWeight);
-            applyAnimationValueTranslationX(value->getFloat(4), blendWeight);
-            applyAnimationValueTranslationY(value->getFloat(5), blendWeight);
-            applyAnimationValueTranslationZ(value->getFloat(6), blendWeight);
+            blendAnimationValueRotation(q, blendWeight, rotation);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_X_BIT, value->getFloat(4), blendWeight, &translation->x);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Y_BIT, value->getFloat(5), blendWeight, &translation->y);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Z_BIT, value->getFloat(6), blendWeight, &translation->z);
             break;
         }
         case ANIMATE_SCALE_ROTATE_TRANSLATE:
         {
-            applyAnimationValueScaleX(value->getFloat(0), blendWeight);
-            applyAnimationValueScaleY(value->getFloat(1), blendWeight);
-            applyAnimationValueScaleZ(value->getFloat(2), blendWeight);
+            blendAnimationValueScalar(ANIMATION_SCALE_X_BIT, value->getFloat(0), blendWeight, &scale->x);
+            blendAnimationValueScalar(ANIMATION_SCALE_Y_BIT, value->getFloat(1), blendWeight, &scale->y);
+            blendAnimationValueScalar(ANIMATION_SCALE_Z_BIT, value->getFloat(2), blendWeight, &scale->z);
             Quaternion q(value->getFloat(3), value->getFloat(4), value->getFloat(5), value->getFloat(6));
-            applyAnimationValueRotation(&q, blendWeight);
-            applyAnimationValueTranslationX(value->getFloat(7), blendWeight);
-            applyAnimationValueTranslationY(value->getFloat(8), blendWeight);
-            applyAnimationValueTranslationZ(value->getFloat(9), blendWeight);
+            blendAnimationValueRotation(q, blendWeight, rotation);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_X_BIT, value->getFloat(7), blendWeight, &translation->x);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Y_BIT, value->getFloat(8), blendWeight, &translation->y);
+            blendAnimationValueScalar(ANIMATION_TRANSLATION_Z_BIT, value->getFloat(9), blendWeight, &translation->z);
             break;
         }
         default:
@@ -746,126 +807,72 @@ void Transform::setAnimationPropertyValue(int propertyId, AnimationValue* value,
     }
 }
 
-void Transform::dirty(char matrixDirtyBits)
-{
-    _matrixDirtyBits |= matrixDirtyBits;
-    transformChanged();
-}
-
-void Transform::addListener(Transform::Listener* listener, long cookie)
-{
-    if (_listeners == NULL)
-        _listeners = new std::list<TransformListener>();
-
-    TransformListener l;
-    l.listener = listener;
-    l.cookie = cookie;
-    _listeners->push_back(l);
-}
-
-void Transform::removeListener(Transform::Listener* listener)
+void Transform::commitAnimationPose(const Vector3& scale, const Quaternion& rotation, const Vector3& translation)
 {
-    if (_listeners)
+    char matrixDirtyBits = 0;
+    if ((_animationPropertyBitFlag & (ANIMATION_SCALE_X_BIT | ANIMATION_SCALE_Y_BIT | ANIMATION_SCALE_Z_BIT)) != 0)
     {
-        for (std::list<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); itr++)
-        {
-            if ((*itr).listener == listener)
-            {
-                _listeners->erase(itr);
-                break;
-            }
-        }
+        if ((_animationPropertyBitFlag & ANIMATION_SCALE_X_BIT) == ANIMATION_SCALE_X_BIT)
+            _scale.x = scale.x;
+        if ((_animationPropertyBitFlag & ANIMATION_SCALE_Y_BIT) == ANIMATION_SCALE_Y_BIT)
+            _scale.y = scale.y;
+        if ((_animationPropertyBitFlag & ANIMATION_SCALE_Z_BIT) == ANIMATION_SCALE_Z_BIT)
+            _scale.z = scale.z;
+        matrixDirtyBits |= DIRTY_SCALE;
     }
-}
-
-void Transform::transformChanged()
-{
-    if (_listeners)
+    if ((_animationPropertyBitFlag & ANIMATION_ROTATION_BIT) == ANIMATION_ROTATION_BIT)
     {
-        for (std::list<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); itr++)
-        {
-            TransformListener& l = *itr;
-            l.listener->transformChanged(this, l.cookie);
-        }
+        _rotation.set(rotation);
+        matrixDirtyBits |= DIRTY_ROTATION;
+    }
+    if ((_animationPropertyBitFlag & (ANIMATION_TRANSLATION_X_BIT | ANIMATION_TRANSLATION_Y_BIT | ANIMATION_TRANSLATION_Z_BIT)) != 0)
+    {
+        if ((_animationPropertyBitFlag & ANIMATION_TRANSLATION_X_BIT) == ANIMATION_TRANSLATION_X_BIT)
+            _translation.x = translation.x;
+        if ((_animationPropertyBitFlag & ANIMATION_TRANSLATION_Y_BIT) == ANIMATION_TRANSLATION_Y_BIT)
+            _translation.y = translation.y;
+        if ((_animationPropertyBitFlag & ANIMATION_TRANSLATION_Z_BIT) == ANIMATION_TRANSLATION_Z_BIT)
+            _translation.z = translation.z;
+        matrixDirtyBits |= DIRTY_TRANSLATION;
     }
-}
-
-void Transform::cloneInto(Transform* transform, NodeCloneContext &context) const
-{
-    AnimationTarget::cloneInto(transform, context);
-    transform->_scale.set(_scale);
-    transform->_rotation.set(_rotation);
-    transform->_translation.set(_translation);
-}
-
-void Transform::applyAnimationValueScaleX(float sx, float blendWeight)
-{
-    if ((_animationPropertyBitFlag & ANIMATION_SCALE_X_BIT) != ANIMATION_SCALE_X_BIT)
-        _animationPropertyBitFlag |= ANIMATION_SCALE_X_BIT;
-    else
-        sx = Curve::lerp(blendWeight, _scale.x, sx);
-
-    setScaleX(sx);
-}
-
-void Transform::applyAnimationValueScaleY(float sy, float blendWeight)
-{
-    if ((_animationPropertyBitFlag & ANIMATION_SCALE_Y_BIT) != ANIMATION_SCALE_Y_BIT)
-        _animationPropertyBitFlag |= ANIMATION_SCALE_Y_BIT;
-    else
-        sy = Curve::lerp(blendWeight, _scale.y, sy);
 
-    setScaleY(sy);
+    if (matrixDirtyBits)
+        dirty(matrixDirtyBits);
 }
 
-void Transform::applyAnimationValueScaleZ(float sz, float blendWeight)
+void Transform::blendAnimationValueScalar(char bit, float value, float blendWeight, float* result)
 {
-    if ((_animationPropertyBitFlag & ANIMATION_SCALE_Z_BIT) != ANIMATION_SCALE_Z_BIT)
-        _animationPropertyBitFlag |= ANIMATION_SCALE_Z_BIT;
+    if ((_animationPropertyBitFlag & bit) != bit)
+    {
+        _animationPropertyBitFlag |= bit;
+        *result = value;
+    }
     else
-        sz = Curve::lerp(blendWeight, _scale.z, sz);
-
-    setScaleZ(sz);
+    {
+        *result = Curve::lerp(blendWeight, *result, value);
+    }
 }
 
-void Transform::applyAnimationValueRotation(Quaternion* q, float blendWeight)
+void Transform::blendAnimationValueRotation(const Quaternion& q, float blendWeight, Quaternion* result)
 {
     if ((_animationPropertyBitFlag & ANIMATION_ROTATION_BIT) != ANIMATION_ROTATION_BIT)
+    {
         _animationPropertyBitFlag |= ANIMATION_ROTATION_BIT;
-    else
-        Quaternion::slerp(_rotation, *q, blendWeight, q);
-     
-    setRotation(*q);
-}
-
-void Transform::applyAnimationValueTranslationX(float tx, float blendWeight)
-{
-    if ((_animationPropertyBitFlag & ANIMATION_TRANSLATION_X_BIT) != ANIMATION_TRANSLATION_X_BIT)
-        _animationPropertyBitFlag |= ANIMATION_TRANSLATION_X_BIT;
-    else
-        tx = Curve::lerp(blendWeight, _translation.x, tx);
-
-    setTranslationX(tx);
-}
-
-void Transform::applyAnimationValueTranslationY(float ty, float blendWeight)
-{
-    if ((_animationPropertyBitFlag & ANIMATION_TRANSLATION_Y_BIT) != ANIMATION_TRANSLATION_Y_BIT)
-        _animationPropertyBitFlag |= ANIMATION_TRANSLATION_Y_BIT;
-    else
-        ty = Curve::lerp(blendWeight, _translation.y, ty);
-
-    setTranslationY(ty);
-}
-
-void Transform::applyAnimationValueTranslationZ(float tz, float blendWeight)
-{
-    if ((_animationPropertyBitFlag & ANIMATION_TRANSLATION_Z_BIT) != ANIMATION_TRANSLATION_Z_BIT)
-        _animationPropertyBitFlag |= ANIMATION_TRANSLATION_Z_BIT;
-    else
-        tz = Curve::lerp(blendWeight, _translation.z, tz);
+        result->set(q);
+        return;
+    }
 
-    setTranslationZ(tz);
+    // Blend along the shorter arc and renormalize. This is much cheaper than slerp and very
+    // close to it for the small angles between the poses of blended clips.
+    float t1 = 1.0f - blendWeight;
+    float t2 = blendWeight;
+    if (result->x * q.x + result->y * q.y + result->z * q.z + result->w * q.w < 0.0f)
+        t2 = -t2;
+    result->x = t1 * result->x + t2 * q.x;
+    result->y = t1 * result->y + t2 * q.y;
+    result->z = t1 * result->z + t2 * q.z;
+    result->w = t1 * result->w + t2 * q.w;
+    result->normalize();
 }
 
 }
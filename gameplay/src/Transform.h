@@ -29,6 +29,8 @@ class NodeCloneContext;
  */
 class Transform : public AnimationTarget
 {
+    friend class AnimationController;
+
 public:
 
     /**
@@ -819,13 +821,23 @@ private:
     static const char ANIMATION_TRANSLATION_Y_BIT = 0x20; 
     static const char ANIMATION_TRANSLATION_Z_BIT = 0x40; 
 
-    void applyAnimationValueScaleX(float sx, float blendWeight);
-    void applyAnimationValueScaleY(float sy, float blendWeight);
-    void applyAnimationValueScaleZ(float sz, float blendWeight);
-    void applyAnimationValueRotation(Quaternion* q, float blendWeight);
-    void applyAnimationValueTranslationX(float tx, float blendWeight);
-    void applyAnimationValueTranslationY(float ty, float blendWeight);
-    void applyAnimationValueTranslationZ(float tz, float blendWeight);
+    /**
+     * Blends an animation value into a pose without modifying the transform.
+     *
+     * The first value of each component since the animation property bit flag was cleared
+     * replaces the component of the pose; later values are blended into it with blendWeight.
+     */
+    void blendAnimationValue(int propertyId, AnimationValue* value, float blendWeight, Vector3* scale, Quaternion* rotation, Vector3* translation);
+
+    /**
+     * Writes the animated components of a pose to the transform, firing a single transform change.
+     */
+    void commitAnimationPose(const Vector3& scale, const Quaternion& rotation, const Vector3& translation);
+
+    void blendAnimationValueScalar(char bit, float value, float blendWeight, float* result);
+    void blendAnimationValueRotation(const Quaternion& q, float blendWeight, Quaternion* result);
+
+    unsigned int _animationPoseIndex;   // The index of the transform's pose in the AnimationController while it is animating.
 };
 
 }
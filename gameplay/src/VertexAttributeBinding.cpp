@@ -10,7 +10,7 @@ static GLuint __maxVertexAttribs = 0;
 static std::vector<VertexAttributeBinding*> __vertexAttributeBindingCache;
 
 VertexAttributeBinding::VertexAttributeBinding() :
-    _handle(0), _attributes(NULL), _mesh(NULL), _effect(NULL)
+    _handle(0), _attributes(NULL), _mesh(NULL), _effect(NULL), _vertexBuffer(0)
 {
 }
 
@@ -67,6 +67,17 @@ VertexAttributeBinding* VertexAttributeBinding::create(const VertexFormat& verte
     return create(NULL, vertexFormat, vertexPointer, effect);
 }
 
+VertexAttributeBinding* VertexAttributeBinding::create(VertexBufferHandle vertexBuffer, const VertexFormat& vertexFormat, Effect* effect)
+{
+    // Use a software binding with offsets into the vertex buffer, which is bound along with the attributes.
+    VertexAttributeBinding* b = create(NULL, vertexFormat, NULL, effect);
+    if (b)
+    {
+        b->_vertexBuffer = vertexBuffer;
+    }
+    return b;
+}
+
 VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect)
 {
     // One-time initialization.
@@ -195,7 +206,7 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
 
         if (attrib == -1)
         {
-            WARN_VARG("Warning: Vertex element with usage '%s' in mesh '%s' does not correspond to an attribute in effect '%s'.", VertexFormat::toString(e.usage), mesh->getUrl(), effect->getId());
+            WARN_VARG("Warning: Vertex element with usage '%s' in mesh '%s' does not correspond to an attribute in effect '%s'.", VertexFormat::toString(e.usage), mesh ? mesh->getUrl() : "", effect->getId());
         }
         else
         {
@@ -252,7 +263,7 @@ void VertexAttributeBinding::bind()
         }
         else
         {
-            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
         }
 
         for (unsigned int i = 0; i < __maxVertexAttribs; ++i)
@@ -277,7 +288,7 @@ void VertexAttributeBinding::unbind()
     else
     {
         // Software mode
-        if (_mesh)
+        if (_mesh || _vertexBuffer)
         {
             GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
         }
@@ -66,6 +66,20 @@ public:
      */
     static VertexAttributeBinding* create(const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect);
 
+    /**
+     * Creates a vertex attribute binding for vertices stored at the start of a vertex buffer object.
+     *
+     * This is used for vertex buffers whose contents are streamed by custom code, such as a
+     * streaming MeshBatch. The binding does not take ownership of the vertex buffer.
+     *
+     * @param vertexBuffer The vertex buffer object.
+     * @param vertexFormat The vertex format.
+     * @param effect The effect.
+     * 
+     * @return A VertexAttributeBinding for the requested parameters.
+     */
+    static VertexAttributeBinding* create(VertexBufferHandle vertexBuffer, const VertexFormat& vertexFormat, Effect* effect);
+
     /**
      * Binds this vertex array object.
      */
@@ -107,6 +121,7 @@ private:
     VertexAttribute* _attributes;
     Mesh* _mesh;
     Effect* _effect;
+    VertexBufferHandle _vertexBuffer;
 };
 
 }
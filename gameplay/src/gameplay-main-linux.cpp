@@ -0,0 +1,37 @@
+#if defined(__linux__) && !defined(__ANDROID__)
+
+#include "gameplay.h"
+
+using namespace gameplay;
+
+extern unsigned int __frameLimit;
+extern long __frameTime;
+
+/**
+ * Main entry point.
+ *
+ * Runs the game headless. Optional arguments:
+ *   -frames <count>   Number of frames to run before exiting (default: until the game exits).
+ *   -frametime <ms>   Virtual time the clock advances per frame, in milliseconds (default: 16).
+ */
+int main(int argc, char** argv)
+{
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-frames") == 0)
+            __frameLimit = (unsigned int)atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-frametime") == 0)
+            __frameTime = atol(argv[i + 1]);
+    }
+
+    Game* game = Game::getInstance();
+    assert(game != NULL);
+    Platform* platform = Platform::create(game);
+    if (!platform)
+        return EXIT_FAILURE;
+    int result = platform->enterMessagePump();
+    delete platform;
+    return result;
+}
+
+#endif
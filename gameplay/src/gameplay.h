@@ -7,6 +7,7 @@
 #include "Mouse.h"
 #include "FileSystem.h"
 #include "Bundle.h"
+#include "ResourceLoader.h"
 
 // Math
 #include "Rectangle.h"
@@ -33,6 +34,9 @@
 #include "VertexFormat.h"
 #include "VertexAttributeBinding.h"
 #include "Model.h"
+#include "InstancedModel.h"
+#include "RenderQueue.h"
+#include "StaticBatcher.h"
 #include "Camera.h"
 #include "Light.h"
 #include "Scene.h"
@@ -41,6 +45,7 @@
 #include "Font.h"
 #include "SpriteBatch.h"
 #include "ParticleEmitter.h"
+#include "ParticleManager.h"
 #include "FrameBuffer.h"
 #include "RenderTarget.h"
 #include "DepthStencilTarget.h"